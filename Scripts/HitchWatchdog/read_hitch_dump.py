@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""Reader for the dumps written by the Levels_v0 hitch watchdog (FLevelsHitchWatchdog).
+
+Prints the frames leading up to the hitch and what the hitch frame had more of
+than the frames before it. Several dumps can be given at once, --csv writes all
+their frames to one file for a spreadsheet.
+
+Example:
+    read_hitch_dump.py Saved/Hitches/Hitch_2026.10.19-12.00.00_81234.bin
+    read_hitch_dump.py Saved/Hitches/*.bin --last 0 --csv hitches.csv
+"""
+
+import argparse
+import csv
+import datetime
+import struct
+import sys
+
+# keep in step with FLevelsHitchDumpHeader and FLevelsHitchFrame
+HEADER = struct.Struct("<4sHHIfq64s32s")
+FRAME = struct.Struct("<IfffHHHHHHHHBBBB")
+MAGIC = b"LHCH"
+VERSION = 1
+
+FRAME_FIELDS = ["frame", "frame_ms", "work_ms", "gc_ms", "queries", "transitions", "characters", "modes",
+                "projectiles", "emitters", "timers", "async_packages", "levels_added", "levels_removed", "gcs", "reserved"]
+
+CUSTOM_MODES = ["none", "slide", "wallrun_l", "wallrun_r", "climb", "ledge", "mantle", "sprint", "crouch"]
+MODE_BITS = {13: "walk", 14: "fall", 15: "other"}
+
+
+def mode_names(mask):
+    names = [name for bit, name in enumerate(CUSTOM_MODES) if mask & (1 << bit)]
+    names += [name for bit, name in sorted(MODE_BITS.items()) if mask & (1 << bit)]
+    return "+".join(names) or "-"
+
+
+def read_dump(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size:
+        raise ValueError("%s is too short for a hitch dump" % path)
+
+    magic, version, frame_size, num_frames, budget_ms, unix_time, map_name, reason = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("%s is not a hitch dump" % path)
+    if version != VERSION or frame_size != FRAME.size:
+        raise ValueError("%s is version %d with %d byte frames, this reader knows version %d with %d byte frames"
+                         % (path, version, frame_size, VERSION, FRAME.size))
+
+    frames = []
+    for index in range(num_frames):
+        offset = HEADER.size + index * FRAME.size
+        if offset + FRAME.size > len(data):
+            break
+        frames.append(dict(zip(FRAME_FIELDS, FRAME.unpack_from(data, offset))))
+
+    header = {
+        "budget_ms": budget_ms,
+        "time": datetime.datetime.utcfromtimestamp(unix_time),
+        "map": map_name.rstrip(b"\0").decode("utf-8", "replace"),
+        "reason": reason.rstrip(b"\0").decode("utf-8", "replace"),
+    }
+    return header, frames
+
+
+def median(values):
+    ordered = sorted(values)
+    return ordered[len(ordered) // 2] if ordered else 0
+
+
+def print_dump(path, header, frames, last):
+    print("%s: %s, %s, budget %.1fms, %d frames (%s)" % (path, header["map"] or "no map", header["time"], header["budget_ms"],
+                                                         len(frames), header["reason"]))
+    if not frames:
+        return
+
+    columns = ["frame", "frame_ms", "work_ms", "gc_ms", "queries", "transitions", "characters", "projectiles",
+               "emitters", "timers", "async_packages", "levels_added", "levels_removed"]
+    print(" ".join("%10s" % name[:10] for name in columns) + "  modes")
+    for frame in frames[-last:] if last > 0 else frames:
+        marker = " <" if frame["work_ms"] > header["budget_ms"] else ""
+        print(" ".join("%10.2f" % frame[name] if isinstance(frame[name], float) else "%10d" % frame[name] for name in columns)
+              + "  " + mode_names(frame["modes"]) + marker)
+
+    # what the hitch frame had that the frames before it usually didn't
+    hitch, before = frames[-1], frames[:-1]
+    if before:
+        notes = []
+        for name in ["gc_ms", "queries", "transitions", "projectiles", "emitters", "timers", "async_packages",
+                     "levels_added", "levels_removed", "gcs"]:
+            usual = median([f[name] for f in before])
+            if hitch[name] > max(usual * 2, usual + 1):
+                notes.append("%s %s (usually %s)" % (name, round(hitch[name], 2), round(usual, 2)))
+        print("hitch frame: " + (", ".join(notes) if notes else "nothing recorded stands out"))
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dumps", nargs="+")
+    parser.add_argument("--last", type=int, default=30, help="frames printed per dump, 0 for all")
+    parser.add_argument("--csv", help="also write every frame of every dump to this file")
+    opts = parser.parse_args()
+
+    rows = []
+    failed = 0
+    for path in opts.dumps:
+        try:
+            header, frames = read_dump(path)
+        except (OSError, ValueError) as error:
+            print(error, file=sys.stderr)
+            failed += 1
+            continue
+        print_dump(path, header, frames, opts.last)
+        for frame in frames:
+            row = {"dump": path, "map": header["map"]}
+            row.update(frame)
+            row["modes"] = mode_names(frame["modes"])
+            rows.append(row)
+
+    if opts.csv and rows:
+        with open(opts.csv, "w", newline="") as f:
+            writer = csv.DictWriter(f, fieldnames=list(rows[0].keys()))
+            writer.writeheader()
+            writer.writerows(rows)
+        print("frames written to %s" % opts.csv)
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
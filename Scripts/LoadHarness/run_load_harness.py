@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Localhost load harness for the Levels_v0 dedicated server.
+
+Starts Levels_v0Server headless, connects N -nullrhi bot clients over loopback
+(-LevelsBot drives ALevels_v0Character through ULevelsScriptedInputComponent),
+lets the session settle and then reads the CSV written by ULevelsServerMetrics.
+Repeats for every requested player count and prints one summary row per count.
+
+Example:
+    run_load_harness.py --server Binaries/Linux/Levels_v0Server \\
+        --client Binaries/Linux/Levels_v0 --players 8 16 32 64 --duration 60
+
+Replication graph against the default net driver:
+    run_load_harness.py ... --players 32 64 100 --label repgraph
+    run_load_harness.py ... --players 32 64 100 --label default --no-repgraph
+"""
+
+import argparse
+import csv
+import os
+import subprocess
+import sys
+import time
+
+
+def percentile(values, pct):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, int(round(pct / 100.0 * (len(ordered) - 1))))
+    return ordered[index]
+
+
+def launch(args, log_path):
+    log = open(log_path, "w")
+    return subprocess.Popen(args, stdout=log, stderr=subprocess.STDOUT), log
+
+
+def stop(processes):
+    for proc, _ in processes:
+        if proc.poll() is None:
+            proc.terminate()
+    deadline = time.time() + 10
+    for proc, log in processes:
+        try:
+            proc.wait(timeout=max(0.1, deadline - time.time()))
+        except subprocess.TimeoutExpired:
+            proc.kill()
+        log.close()
+
+
+def run_step(opts, players, out_dir):
+    metrics_path = os.path.abspath(os.path.join(out_dir, "server_%d.csv" % players))
+    if os.path.exists(metrics_path):
+        os.remove(metrics_path)
+
+    server_args = [opts.server, opts.map, "-server", "-log", "-unattended", "-nosound",
+                   "-port=%d" % opts.port, "-LevelsMetrics=%s" % metrics_path]
+    server_args += ["-ini:%s" % ini for ini in opts.ini]
+    if opts.no_repgraph:
+        server_args.append("-ini:Engine:[/Script/OnlineSubsystemUtils.IpNetDriver]:ReplicationDriverClassName=None")
+    server_args += opts.server_arg
+
+    processes = [launch(server_args, os.path.join(out_dir, "server_%d.log" % players))]
+    try:
+        time.sleep(opts.server_boot)
+        for i in range(players):
+            client_args = [opts.client, "127.0.0.1:%d" % opts.port, "-game", "-nullrhi", "-nosound",
+                           "-unattended", "-nosplash", "-LevelsBot", "-LevelsBotSeed=%d" % i]
+            if opts.trace:
+                client_args.append("-LevelsInputTrace=%s" % os.path.abspath(opts.trace))
+            client_args += opts.client_arg
+            processes.append(launch(client_args, os.path.join(out_dir, "client_%d_%d.log" % (players, i))))
+            time.sleep(opts.client_stagger)
+
+        time.sleep(opts.warmup + opts.duration)
+    finally:
+        stop(processes)
+
+    return summarize(metrics_path, players, opts.warmup)
+
+
+def summarize(metrics_path, players, warmup):
+    if not os.path.exists(metrics_path):
+        print("no metrics written for %d players (%s)" % (players, metrics_path), file=sys.stderr)
+        return None
+
+    with open(metrics_path, newline="") as f:
+        rows = list(csv.DictReader(f))
+    if not rows:
+        return None
+
+    # the warmup counts from the last join, a client that never connected mustn't hold the window open forever
+    connected = max(int(r["players"]) for r in rows)
+    joined = next(float(r["time"]) for r in rows if int(r["players"]) >= connected)
+    start = joined + warmup
+    settled = [r for r in rows if float(r["time"]) >= start and int(r["players"]) > 0] or rows
+
+    def column(name):
+        return [float(r[name]) for r in settled]
+
+    frame_avg = column("frame_work_ms_avg")
+    return {
+        "target": players,
+        "connected": connected,
+        "tick_avg_ms": sum(frame_avg) / len(frame_avg),
+        "tick_p95_ms": percentile(frame_avg, 95),
+        "tick_max_ms": max(column("frame_work_ms_max")),
+        "out_bps_conn": sum(column("out_bytes_per_sec_per_conn")) / len(settled),
+        "in_bps_conn": sum(column("in_bytes_per_sec_per_conn")) / len(settled),
+        "corrections_s": sum(column("corrections_per_sec")) / len(settled),
+        "peak_mb": max(column("used_physical_mb")),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--server", required=True, help="path to the Levels_v0Server executable")
+    parser.add_argument("--client", required=True, help="path to the Levels_v0 game executable")
+    parser.add_argument("--map", default="/Game/FirstPersonCPP/Maps/FirstPersonExampleMap")
+    parser.add_argument("--players", type=int, nargs="+", default=[4, 8, 16, 32])
+    parser.add_argument("--port", type=int, default=7777)
+    parser.add_argument("--duration", type=float, default=60.0, help="seconds measured per step")
+    parser.add_argument("--warmup", type=float, default=10.0, help="seconds ignored after the last client joins")
+    parser.add_argument("--server-boot", type=float, default=10.0)
+    parser.add_argument("--client-stagger", type=float, default=0.5)
+    parser.add_argument("--trace", help="input trace csv replayed by every bot instead of the built-in loop")
+    parser.add_argument("--ini", action="append", default=[],
+                        help="config override passed to the server, e.g. Engine:[/Script/OnlineSubsystemUtils.IpNetDriver]:NetServerMaxTickRate=60")
+    parser.add_argument("--no-repgraph", action="store_true",
+                        help="run the server with the default net driver relevancy instead of ULevelsReplicationGraph")
+    parser.add_argument("--server-arg", action="append", default=[])
+    parser.add_argument("--client-arg", action="append", default=[])
+    parser.add_argument("--out", default="Saved/LoadHarness")
+    parser.add_argument("--label", default="", help="tag added to the summary file name")
+    opts = parser.parse_args()
+
+    os.makedirs(opts.out, exist_ok=True)
+    results = []
+    for players in opts.players:
+        print("running %d players..." % players, flush=True)
+        result = run_step(opts, players, opts.out)
+        if result:
+            results.append(result)
+
+    if not results:
+        return 1
+
+    fields = list(results[0].keys())
+    summary_path = os.path.join(opts.out, "summary%s.csv" % ("_" + opts.label if opts.label else ""))
+    with open(summary_path, "w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=fields)
+        writer.writeheader()
+        writer.writerows(results)
+
+    print(" ".join("%14s" % name for name in fields))
+    for r in results:
+        print(" ".join("%14.2f" % r[name] if isinstance(r[name], float) else "%14d" % r[name] for name in fields))
+    print("summary written to %s" % summary_path)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
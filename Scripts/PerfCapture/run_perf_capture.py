@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Scripted route performance capture for Levels_v0.
+
+Launches the game once per map with -LevelsPerfCapture, which replays a recorded
+input trace through ULevelsScriptedInputComponent with the CSV profiler running
+and quits at the end of the route (see ULevelsPerfCapture). Every run writes
+<map>.csv from the profiler and <map>_modes.csv with frame time, game thread work
+and parkour scene queries per movement mode and trigger state. The per mode rows
+of all maps are merged into one summary, most expensive first.
+
+Example:
+    run_perf_capture.py --game Binaries/Linux/Levels_v0 --route Saved/Parkour/demo_route.csv
+
+One route per map, in the same order as --maps:
+    run_perf_capture.py --game ... --maps /Game/StarterContent/Maps/StarterMap \\
+        /Game/PolygonPrototype/Maps/Demonstration --route starter.csv demo.csv
+"""
+
+import argparse
+import csv
+import os
+import subprocess
+import sys
+
+DEFAULT_MAPS = [
+    "/Game/FirstPersonCPP/Maps/FirstPersonExampleMap",
+    "/Game/PolygonPrototype/Maps/Demonstration",
+    "/Game/StarterContent/Maps/StarterMap",
+]
+
+
+def run_map(opts, map_path, route, out_dir):
+    map_name = map_path.rsplit("/", 1)[-1]
+    modes_path = os.path.join(out_dir, "%s_modes.csv" % map_name)
+    if os.path.exists(modes_path):
+        os.remove(modes_path)
+
+    args = [opts.game, map_path, "-game", "-log", "-unattended", "-nosound", "-nosplash",
+            "-windowed", "-ResX=%d" % opts.res[0], "-ResY=%d" % opts.res[1],
+            "-LevelsPerfCapture=%s" % os.path.abspath(route),
+            "-LevelsPerfCaptureOut=%s" % out_dir,
+            "-LevelsPerfCaptureWarmup=%g" % opts.warmup]
+    if opts.fixed_fps:
+        args.append("-FPS=%d" % opts.fixed_fps)
+    args += opts.game_arg
+
+    with open(os.path.join(out_dir, "%s.log" % map_name), "w") as log:
+        try:
+            subprocess.run(args, stdout=log, stderr=subprocess.STDOUT, timeout=opts.timeout)
+        except subprocess.TimeoutExpired:
+            print("%s did not finish within %ds" % (map_name, opts.timeout), file=sys.stderr)
+
+    if not os.path.exists(modes_path):
+        print("no mode summary written for %s (%s)" % (map_name, modes_path), file=sys.stderr)
+        return []
+
+    with open(modes_path, newline="") as f:
+        return list(csv.DictReader(f))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--game", required=True, help="path to the Levels_v0 game executable")
+    parser.add_argument("--maps", nargs="+", default=DEFAULT_MAPS)
+    parser.add_argument("--route", nargs="+", required=True,
+                        help="input trace csv replayed on every map, or one per map")
+    parser.add_argument("--warmup", type=float, default=2.0, help="seconds to wait after the character spawns")
+    parser.add_argument("--res", type=int, nargs=2, default=[1920, 1080])
+    parser.add_argument("--fixed-fps", type=int, default=0,
+                        help="run with a fixed frame rate instead of real time, times are then only relative")
+    parser.add_argument("--timeout", type=int, default=600, help="seconds before a run is given up on")
+    parser.add_argument("--game-arg", action="append", default=[])
+    parser.add_argument("--out", default="Saved/Profiling/LevelsPerf")
+    opts = parser.parse_args()
+
+    if len(opts.route) != 1 and len(opts.route) != len(opts.maps):
+        parser.error("pass one route, or one per map")
+
+    out_dir = os.path.abspath(opts.out)
+    os.makedirs(out_dir, exist_ok=True)
+    rows = []
+    for i, map_path in enumerate(opts.maps):
+        route = opts.route[i if len(opts.route) > 1 else 0]
+        print("capturing %s..." % map_path, flush=True)
+        rows += run_map(opts, map_path, route, out_dir)
+
+    if not rows:
+        return 1
+
+    rows.sort(key=lambda r: float(r["frame_ms_p95"]), reverse=True)
+    summary_path = os.path.join(out_dir, "summary_modes.csv")
+    with open(summary_path, "w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=list(rows[0].keys()))
+        writer.writeheader()
+        writer.writerows(rows)
+
+    fields = ["map", "mode", "frames", "frame_ms_p50", "frame_ms_p95", "frame_ms_p99", "queries_mean", "queries_max"]
+    print(" ".join("%24s" % name if name in ("map", "mode") else "%12s" % name for name in fields))
+    for r in rows:
+        print(" ".join("%24s" % r[name] if name in ("map", "mode") else "%12s" % r[name] for name in fields))
+    print("summary written to %s" % summary_path)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsAnimInstance.h"
+#include "Levels_v0Character.h"
+
+void FLevelsAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	const ALevels_v0Character* Character = Cast<ALevels_v0Character>(InAnimInstance->TryGetPawnOwner());
+	const ULevelsPlayerMovementComponent* Movement = Character ? Cast<ULevelsPlayerMovementComponent>(Character->GetCharacterMovement()) : nullptr;
+	if (!Movement)
+	{
+		RawMovementMode = MOVE_None;
+		RawCustomMovementMode = MOVE_CustomNone;
+		return;
+	}
+
+	Velocity = Movement->Velocity;
+	Location = Character->GetActorLocation();
+	RawMovementMode = Movement->MovementMode;
+	RawCustomMovementMode = Movement->CustomMovementMode;
+	bRawZoomedIn = Character->isZoomedIn;
+
+	const LevelsParkour::FVec3& Position = Movement->GetParkourSim().State.MantlePosition;
+	MantlePosition = FVector(Position.X, Position.Y, Position.Z);
+}
+
+void FLevelsAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	Super::Update(DeltaSeconds);
+
+	MovementMode = (EMovementMode)RawMovementMode;
+	//parkour modes sit on top of walking and falling, never under MOVE_Custom
+	CustomMovementMode = (ECustomMovementMode)RawCustomMovementMode;
+	isZoomedIn = bRawZoomedIn;
+	Speed = Velocity.Size2D();
+	bInAir = MovementMode == MOVE_Falling;
+	bSliding = CustomMovementMode == MOVE_Slide;
+
+	switch (CustomMovementMode)
+	{
+	case MOVE_LeftWallRun:
+		WallRunSide = -1.f;
+		break;
+	case MOVE_RightWallRun:
+		WallRunSide = 1.f;
+		break;
+	default:
+		WallRunSide = 0.f;
+		break;
+	}
+
+	const float ToLedge = FVector::Dist(Location, MantlePosition);
+	if (CustomMovementMode == MOVE_Mantle)
+	{
+		if (!bMantling)
+		{
+			MantleStartDistance = ToLedge;
+		}
+		MantleProgress = MantleStartDistance > KINDA_SMALL_NUMBER ? FMath::Clamp(1.f - ToLedge / MantleStartDistance, 0.f, 1.f) : 1.f;
+	}
+	else
+	{
+		MantleProgress = 0.f;
+	}
+	bMantling = CustomMovementMode == MOVE_Mantle;
+}
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "LevelsPlayerMovementComponent.h"
+#include "LevelsAnimInstance.generated.h"
+
+/**
+ * Parkour state for the anim graphs. The game thread only copies raw values out of the character in PreUpdate,
+ * everything the graphs read is worked out in Update on an animation worker thread.
+ */
+USTRUCT(BlueprintType)
+struct LEVELS_V0_API FLevelsAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FLevelsAnimInstanceProxy() {}
+	FLevelsAnimInstanceProxy(UAnimInstance* InAnimInstance) : FAnimInstanceProxy(InAnimInstance) {}
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Parkour")
+		TEnumAsByte<EMovementMode> MovementMode = MOVE_None;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Parkour")
+		TEnumAsByte<ECustomMovementMode> CustomMovementMode = MOVE_CustomNone;
+
+	/** -1 running along a wall on the left, 1 on the right, 0 off walls */
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Parkour")
+		float WallRunSide = 0.f;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Parkour")
+		bool bSliding = false;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Parkour")
+		bool bMantling = false;
+
+	/** 0 when a mantle starts, 1 at the ledge */
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Parkour")
+		float MantleProgress = 0.f;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Parkour")
+		bool bInAir = false;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Parkour")
+		bool isZoomedIn = false;
+
+	/** Ground speed */
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Parkour")
+		float Speed = 0.f;
+
+protected:
+
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+
+private:
+
+	//copied on the game thread, read on the worker
+	FVector Velocity = FVector::ZeroVector;
+	FVector Location = FVector::ZeroVector;
+	FVector MantlePosition = FVector::ZeroVector;
+	uint8 RawMovementMode = MOVE_None;
+	uint8 RawCustomMovementMode = MOVE_CustomNone;
+	bool bRawZoomedIn = false;
+
+	//distance to the ledge when the current mantle started
+	float MantleStartDistance = 0.f;
+};
+
+/**
+ * Native base for the character anim blueprints. Its update runs off the game thread, so blueprints based on it
+ * should read the proxy's values straight from the graph (fast path) and leave the event graph empty.
+ */
+UCLASS(Transient, Blueprintable)
+class LEVELS_V0_API ULevelsAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+
+private:
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Parkour", meta = (AllowPrivateAccess = "true"))
+		FLevelsAnimInstanceProxy Proxy;
+
+	//the proxy is a member so the graph can read it, the engine must not delete it
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override { return &Proxy; }
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override {}
+};
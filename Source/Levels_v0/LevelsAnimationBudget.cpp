@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsAnimationBudget.h"
+#include "Levels_v0.h"
+#include "IAnimationBudgetAllocator.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Budgeted Meshes"), STAT_LevelsBudgetedMeshes, STATGROUP_Levels);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Anim Updates Skipped"), STAT_LevelsAnimUpdatesSkipped, STATGROUP_Levels);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Anim Evaluations Skipped"), STAT_LevelsAnimEvaluationsSkipped, STATGROUP_Levels);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Anim Frames Interpolated"), STAT_LevelsAnimInterpolated, STATGROUP_Levels);
+
+TArray<TWeakObjectPtr<USkeletalMeshComponentBudgeted>> FLevelsAnimationBudget::Meshes;
+FLevelsAnimationBudgetStats FLevelsAnimationBudget::Stats;
+FDelegateHandle FLevelsAnimationBudget::EndFrameHandle;
+
+//distance at which a remote character is half as significant as one right next to the camera
+static float SignificanceHalfDistance = 1500.f;
+static FAutoConsoleVariableRef CVarSignificanceHalfDistance(
+	TEXT("Levels.AnimBudget.HalfDistance"),
+	SignificanceHalfDistance,
+	TEXT("Distance in cm at which a budgeted character mesh has half the significance of one at the camera"));
+
+static FAutoConsoleCommand AnimBudgetCommand(
+	TEXT("Levels.AnimBudget"),
+	TEXT("Prints how much animation work the budget allocator skipped on character meshes. \"Levels.AnimBudget reset\" clears the totals"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			FLevelsAnimationBudget::ResetStats();
+			return;
+		}
+
+		const FLevelsAnimationBudgetStats& Stats = FLevelsAnimationBudget::GetStats();
+		const double MeshFrames = FMath::Max<int64>(Stats.MeshFrames, 1);
+		GLog->Logf(TEXT("%d budgeted meshes, %lld mesh frames over %lld frames"), Stats.LastMeshes, Stats.MeshFrames, Stats.Frames);
+		GLog->Logf(TEXT("  updates skipped     %10lld  %5.1f%%"), Stats.UpdatesSkipped, 100.0 * Stats.UpdatesSkipped / MeshFrames);
+		GLog->Logf(TEXT("  evaluations skipped %10lld  %5.1f%%"), Stats.EvaluationsSkipped, 100.0 * Stats.EvaluationsSkipped / MeshFrames);
+		GLog->Logf(TEXT("  interpolated        %10lld  %5.1f%%"), Stats.Interpolated, 100.0 * Stats.Interpolated / MeshFrames);
+	}));
+
+void FLevelsAnimationBudget::Startup()
+{
+	USkeletalMeshComponentBudgeted::OnCalculateSignificance().BindStatic(&FLevelsAnimationBudget::CalculateSignificance);
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FLevelsAnimationBudget::OnEndFrame);
+}
+
+void FLevelsAnimationBudget::Shutdown()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	EndFrameHandle.Reset();
+	USkeletalMeshComponentBudgeted::OnCalculateSignificance().Unbind();
+	Meshes.Reset();
+}
+
+void FLevelsAnimationBudget::Register(USkeletalMeshComponent* Mesh)
+{
+	USkeletalMeshComponentBudgeted* Budgeted = Cast<USkeletalMeshComponentBudgeted>(Mesh);
+	UWorld* World = Budgeted ? Budgeted->GetWorld() : nullptr;
+	IAnimationBudgetAllocator* Allocator = World ? IAnimationBudgetAllocator::Get(World) : nullptr;
+	if (!Allocator)
+	{
+		return;
+	}
+
+	Budgeted->SetAutoCalculateSignificance(true);
+	Allocator->RegisterComponent(Budgeted);
+	Meshes.AddUnique(Budgeted);
+}
+
+void FLevelsAnimationBudget::Unregister(USkeletalMeshComponent* Mesh)
+{
+	USkeletalMeshComponentBudgeted* Budgeted = Cast<USkeletalMeshComponentBudgeted>(Mesh);
+	UWorld* World = Budgeted ? Budgeted->GetWorld() : nullptr;
+	if (IAnimationBudgetAllocator* Allocator = World ? IAnimationBudgetAllocator::Get(World) : nullptr)
+	{
+		Allocator->UnregisterComponent(Budgeted);
+	}
+	Meshes.Remove(Budgeted);
+}
+
+float FLevelsAnimationBudget::CalculateSignificance(USkeletalMeshComponentBudgeted* Mesh)
+{
+	const APawn* Pawn = Cast<APawn>(Mesh->GetOwner());
+	if (Pawn && Pawn->IsLocallyControlled() && Pawn->IsPlayerControlled())
+	{
+		return 1.f;
+	}
+
+	//nearest local view, a server with no viewers treats everything as far away
+	const FVector Location = Mesh->GetComponentLocation();
+	float NearestDistSquared = BIG_NUMBER;
+	for (FConstPlayerControllerIterator It = Mesh->GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* Controller = It->Get();
+		if (Controller && Controller->IsLocalController() && Controller->PlayerCameraManager)
+		{
+			NearestDistSquared = FMath::Min(NearestDistSquared, FVector::DistSquared(Controller->PlayerCameraManager->GetCameraLocation(), Location));
+		}
+	}
+
+	//just under the local player so their own character always goes first
+	const float HalfDistance = FMath::Max(SignificanceHalfDistance, 1.f);
+	return 0.99f / (1.f + NearestDistSquared / (HalfDistance * HalfDistance));
+}
+
+void FLevelsAnimationBudget::OnEndFrame()
+{
+	Meshes.RemoveAll([](const TWeakObjectPtr<USkeletalMeshComponentBudgeted>& Mesh) { return !Mesh.IsValid() || !Mesh->IsRegistered(); });
+	if (Meshes.Num() == 0)
+	{
+		return;
+	}
+
+	int32 UpdatesSkipped = 0;
+	int32 EvaluationsSkipped = 0;
+	int32 Interpolated = 0;
+	for (const TWeakObjectPtr<USkeletalMeshComponentBudgeted>& Mesh : Meshes)
+	{
+		const FAnimUpdateRateParameters* RateParams = Mesh->AnimUpdateRateParams;
+		const bool bSkippedUpdate = !Mesh->IsComponentTickEnabled() || (RateParams && RateParams->ShouldSkipUpdate());
+		UpdatesSkipped += bSkippedUpdate ? 1 : 0;
+		EvaluationsSkipped += !bSkippedUpdate && RateParams && RateParams->ShouldSkipEvaluation() ? 1 : 0;
+		Interpolated += bSkippedUpdate && RateParams && RateParams->ShouldInterpolateSkippedFrames() ? 1 : 0;
+	}
+
+	SET_DWORD_STAT(STAT_LevelsBudgetedMeshes, Meshes.Num());
+	SET_DWORD_STAT(STAT_LevelsAnimUpdatesSkipped, UpdatesSkipped);
+	SET_DWORD_STAT(STAT_LevelsAnimEvaluationsSkipped, EvaluationsSkipped);
+	SET_DWORD_STAT(STAT_LevelsAnimInterpolated, Interpolated);
+
+	++Stats.Frames;
+	Stats.MeshFrames += Meshes.Num();
+	Stats.UpdatesSkipped += UpdatesSkipped;
+	Stats.EvaluationsSkipped += EvaluationsSkipped;
+	Stats.Interpolated += Interpolated;
+	Stats.LastMeshes = Meshes.Num();
+}
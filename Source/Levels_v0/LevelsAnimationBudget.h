@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USkeletalMeshComponent;
+class USkeletalMeshComponentBudgeted;
+
+/** Animation work done and skipped by budgeted character meshes, counted once per mesh per frame */
+struct FLevelsAnimationBudgetStats
+{
+	int64 Frames = 0;
+	int64 MeshFrames = 0;
+	//frames a mesh didn't tick or update its animation
+	int64 UpdatesSkipped = 0;
+	//frames a mesh updated but reused its last pose
+	int64 EvaluationsSkipped = 0;
+	//skipped frames filled in by interpolating between poses
+	int64 Interpolated = 0;
+	int32 LastMeshes = 0;
+};
+
+/**
+ * Puts the third person meshes of remote players and bots under the engine's animation budget allocator,
+ * which lowers their update rate, interpolates and skips evaluation to keep animation inside a fixed number of
+ * milliseconds a frame. The budget and its falloff are the allocator's a.Budget.* console variables, set in
+ * DefaultEngine.ini. Meshes are ordered by significance: nearness to the closest local view, with locally
+ * controlled characters always first.
+ *
+ * Started by the game module. "stat Levels" shows this frame's skipped work, Levels.AnimBudget the totals and
+ * "Levels.AnimBudget reset" clears them.
+ */
+class LEVELS_V0_API FLevelsAnimationBudget
+{
+public:
+
+	static void Startup();
+
+	static void Shutdown();
+
+	/** Hands a character mesh to its world's allocator, does nothing for meshes that aren't budgeted */
+	static void Register(USkeletalMeshComponent* Mesh);
+
+	/** Takes a mesh back, its animation ticks at full rate again */
+	static void Unregister(USkeletalMeshComponent* Mesh);
+
+	/** The allocator's ordering, 1 for the local player's own character falling towards 0 with distance */
+	static float CalculateSignificance(USkeletalMeshComponentBudgeted* Mesh);
+
+	static const FLevelsAnimationBudgetStats& GetStats() { return Stats; }
+
+	static void ResetStats() { Stats = FLevelsAnimationBudgetStats(); }
+
+private:
+
+	static void OnEndFrame();
+
+	static TArray<TWeakObjectPtr<USkeletalMeshComponentBudgeted>> Meshes;
+	static FLevelsAnimationBudgetStats Stats;
+	static FDelegateHandle EndFrameHandle;
+};
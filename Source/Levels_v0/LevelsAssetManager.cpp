@@ -0,0 +1,323 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsAssetManager.h"
+#include "Levels_v0Character.h"
+#include "Levels_v0GameMode.h"
+#include "Levels_v0HUD.h"
+#include "Engine/Engine.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#if WITH_EDITOR
+#include "Interfaces/ITargetPlatform.h"
+#include "Settings/ProjectPackagingSettings.h"
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogLevelsAssets, Log, All);
+
+const FPrimaryAssetType ULevelsAssetManager::CharacterType = TEXT("Levels_v0Character");
+const FName ULevelsAssetManager::GameBundle = TEXT("Game");
+const FName ULevelsAssetManager::ClientBundle = TEXT("Client");
+
+ULevelsAssetManager& ULevelsAssetManager::Get()
+{
+	check(GEngine);
+
+	if (ULevelsAssetManager* Singleton = Cast<ULevelsAssetManager>(GEngine->AssetManager))
+	{
+		return *Singleton;
+	}
+
+	UE_LOG(LogLevelsAssets, Fatal, TEXT("AssetManagerClassName in DefaultEngine.ini must be set to LevelsAssetManager"));
+	return *NewObject<ULevelsAssetManager>();
+}
+
+bool ULevelsAssetManager::ShouldLoadClientContent()
+{
+	return !IsRunningDedicatedServer();
+}
+
+void ULevelsAssetManager::StartInitialLoading()
+{
+	Super::StartInitialLoading();
+
+	//everything the first map needs that used to be hard loaded by the CDO constructors
+	TArray<FSoftObjectPath> StartupAssets;
+	GetDefault<ALevels_v0GameMode>()->GetStartupAssets(StartupAssets);
+	GetDefault<ALevels_v0HUD>()->GetStartupAssets(StartupAssets);
+
+	if (StartupAssets.Num() > 0)
+	{
+		StartupHandle = GetStreamableManager().RequestAsyncLoad(StartupAssets,
+			FStreamableDelegate::CreateUObject(this, &ULevelsAssetManager::OnStartupAssetsLoaded), FStreamableManager::AsyncLoadHighPriority);
+	}
+}
+
+void ULevelsAssetManager::OnStartupAssetsLoaded()
+{
+	//the default pawn is loaded now, start on the assets it only references softly
+	if (UClass* PawnClass = GetDefault<ALevels_v0GameMode>()->DefaultPawnSoftClass.Get())
+	{
+		LoadCharacterBundle(PawnClass, GameBundle);
+		LoadCharacterBundle(PawnClass, ClientBundle);
+	}
+}
+
+void ULevelsAssetManager::LoadCharacterBundle(UClass* CharacterClass, FName BundleName)
+{
+	if (CharacterClass == nullptr || !CharacterClass->IsChildOf(ALevels_v0Character::StaticClass()))
+	{
+		return;
+	}
+
+	if (BundleName == ClientBundle && !ShouldLoadClientContent())
+	{
+		return;
+	}
+
+	const TPair<FName, FName> Key(CharacterClass->GetFName(), BundleName);
+	if (CharacterBundleHandles.Contains(Key))
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> BundleAssets;
+	CharacterClass->GetDefaultObject<ALevels_v0Character>()->GetBundleAssets(BundleName, BundleAssets);
+
+	TSharedPtr<FStreamableHandle> Handle;
+	if (BundleAssets.Num() > 0)
+	{
+		Handle = GetStreamableManager().RequestAsyncLoad(BundleAssets, FStreamableDelegate(), FStreamableManager::DefaultAsyncLoadPriority);
+	}
+	CharacterBundleHandles.Add(Key, Handle);
+}
+
+void ULevelsAssetManager::NoteSynchronousLoad(const FSoftObjectPath& Path)
+{
+	UE_LOG(LogLevelsAssets, Warning, TEXT("%s was not streamed in ahead of time, loading it synchronously"), *Path.ToString());
+}
+
+#if WITH_EDITOR
+
+bool ULevelsAssetManager::ShouldCookForPlatform(const UPackage* Package, const ITargetPlatform* TargetPlatform)
+{
+	if (!Super::ShouldCookForPlatform(Package, TargetPlatform))
+	{
+		return false;
+	}
+
+	if (TargetPlatform == nullptr || !TargetPlatform->IsServerOnly())
+	{
+		return true;
+	}
+
+	const FName PackageName = Package->GetFName();
+	if (GetClientBundlePackages().Contains(PackageName))
+	{
+		return false;
+	}
+
+	const FString PackageString = PackageName.ToString();
+	for (const FDirectoryPath& Directory : ClientOnlyDirectories)
+	{
+		if (!Directory.Path.IsEmpty() && PackageString.StartsWith(Directory.Path + TEXT("/")))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool ULevelsAssetManager::GetPackageChunkIds(FName PackageName, const ITargetPlatform* TargetPlatform, const TArray<int32>& ExistingChunkList, TArray<int32>& OutChunkList, TArray<int32>* OutOverrideChunkList) const
+{
+	const bool bHasChunks = Super::GetPackageChunkIds(PackageName, TargetPlatform, ExistingChunkList, OutChunkList, OutOverrideChunkList);
+
+	//maps keep the chunk of their PrimaryAssetRules, and whatever the startup map needs stays in chunk 0
+	if (GetPrimaryAssetIdForPackage(PackageName).IsValid() || OutChunkList.Contains(0))
+	{
+		return bHasChunks;
+	}
+
+	const FString PackageString = PackageName.ToString();
+	for (const FLevelsContentPackChunk& Pack : ContentPackChunks)
+	{
+		if (Pack.ChunkId >= 0 && !Pack.Directory.Path.IsEmpty() && PackageString.StartsWith(Pack.Directory.Path + TEXT("/")))
+		{
+			OutChunkList.Reset();
+			OutChunkList.Add(Pack.ChunkId);
+			if (OutOverrideChunkList)
+			{
+				OutOverrideChunkList->Reset();
+				OutOverrideChunkList->Add(Pack.ChunkId);
+			}
+			return true;
+		}
+	}
+
+	return bHasChunks;
+}
+
+const TSet<FName>& ULevelsAssetManager::GetClientBundlePackages()
+{
+	if (!ClientBundlePackages.IsSet())
+	{
+		ClientBundlePackages.Emplace();
+
+		TArray<FPrimaryAssetId> CharacterIds;
+		GetPrimaryAssetIdList(CharacterType, CharacterIds);
+		for (const FPrimaryAssetId& CharacterId : CharacterIds)
+		{
+			//character blueprints are loaded by the cook anyway, their defaults know the bundle contents
+			UClass* CharacterClass = TSoftClassPtr<ALevels_v0Character>(GetPrimaryAssetPath(CharacterId)).LoadSynchronous();
+			if (CharacterClass == nullptr)
+			{
+				continue;
+			}
+
+			TArray<FSoftObjectPath> BundleAssets;
+			CharacterClass->GetDefaultObject<ALevels_v0Character>()->GetBundleAssets(ClientBundle, BundleAssets);
+			for (const FSoftObjectPath& Path : BundleAssets)
+			{
+				ClientBundlePackages->Add(FName(*Path.GetLongPackageName()));
+			}
+		}
+
+		UE_LOG(LogLevelsAssets, Display, TEXT("Server cook leaves out %d client bundle packages"), ClientBundlePackages->Num());
+	}
+
+	return ClientBundlePackages.GetValue();
+}
+
+static FAutoConsoleCommand AuditCookContentCommand(
+	TEXT("Levels.AuditCookContent"),
+	TEXT("Reports cooked and stripped uncooked bytes for each bundled content pack"),
+	FConsoleCommandDelegate::CreateLambda([]() { ULevelsAssetManager::Get().AuditCookContent(); }));
+
+void ULevelsAssetManager::AuditCookContent() const
+{
+	//content packs that ship with the project, everything else under /Game is reported as one bucket
+	static const TCHAR* PackRoots[] = {
+		TEXT("/Game/StarterContent/"),
+		TEXT("/Game/FPS_Weapon_Bundle/"),
+		TEXT("/Game/FuturisticRevolver/"),
+		TEXT("/Game/AnimStarterPack/"),
+		TEXT("/Game/PolygonPrototype/"),
+		TEXT("/Game/")
+	};
+	const int32 NumPacks = UE_ARRAY_COUNT(PackRoots);
+
+	IAssetRegistry& AssetRegistry = GetAssetRegistry();
+
+	//roots: every primary asset the asset manager will let the cooker pick up
+	TArray<FName> PendingPackages;
+	TArray<FPrimaryAssetTypeInfo> TypeInfos;
+	GetPrimaryAssetTypeInfoList(TypeInfos);
+	for (const FPrimaryAssetTypeInfo& TypeInfo : TypeInfos)
+	{
+		TArray<FPrimaryAssetId> AssetIds;
+		GetPrimaryAssetIdList(TypeInfo.PrimaryAssetType, AssetIds);
+		for (const FPrimaryAssetId& AssetId : AssetIds)
+		{
+			if (GetPrimaryAssetRules(AssetId).CookRule == EPrimaryAssetCookRule::NeverCook)
+			{
+				continue;
+			}
+			const FSoftObjectPath AssetPath = GetPrimaryAssetPath(AssetId);
+			if (AssetPath.IsValid())
+			{
+				PendingPackages.Add(FName(*AssetPath.GetLongPackageName()));
+			}
+		}
+	}
+
+	//directories the packaging settings cook regardless of references are roots as well
+	for (const FDirectoryPath& Directory : GetDefault<UProjectPackagingSettings>()->DirectoriesToAlwaysCook)
+	{
+		TArray<FAssetData> DirectoryAssets;
+		AssetRegistry.GetAssetsByPath(FName(*Directory.Path), DirectoryAssets, true);
+		for (const FAssetData& Asset : DirectoryAssets)
+		{
+			PendingPackages.Add(Asset.PackageName);
+		}
+	}
+
+	//everything those roots pull in, hard or soft
+	TSet<FName> CookedPackages;
+	while (PendingPackages.Num() > 0)
+	{
+		const FName PackageName = PendingPackages.Pop(false);
+		bool bAlreadyCooked = false;
+		CookedPackages.Add(PackageName, &bAlreadyCooked);
+		if (bAlreadyCooked)
+		{
+			continue;
+		}
+
+		TArray<FName> Dependencies;
+		AssetRegistry.GetDependencies(PackageName, Dependencies, UE::AssetRegistry::EDependencyCategory::Package);
+		for (const FName& Dependency : Dependencies)
+		{
+			if (!CookedPackages.Contains(Dependency))
+			{
+				PendingPackages.Add(Dependency);
+			}
+		}
+	}
+
+	//bucket every package under /Game by pack. Sizes are the uncooked editor packages, the asset
+	//registry has no cooked sizes before a cook, so read them as relative not as pak sizes
+	TArray<int64> TotalBytes;
+	TArray<int64> CookedBytes;
+	TotalBytes.SetNumZeroed(NumPacks);
+	CookedBytes.SetNumZeroed(NumPacks);
+
+	TArray<FAssetData> AllAssets;
+	AssetRegistry.GetAssetsByPath(TEXT("/Game"), AllAssets, true);
+	TSet<FName> SeenPackages;
+	for (const FAssetData& Asset : AllAssets)
+	{
+		bool bAlreadySeen = false;
+		SeenPackages.Add(Asset.PackageName, &bAlreadySeen);
+		if (bAlreadySeen)
+		{
+			continue;
+		}
+
+		const FAssetPackageData* PackageData = AssetRegistry.GetAssetPackageData(Asset.PackageName);
+		const int64 DiskSize = PackageData ? PackageData->DiskSize : 0;
+		const FString PackageString = Asset.PackageName.ToString();
+
+		for (int32 PackIndex = 0; PackIndex < NumPacks; ++PackIndex)
+		{
+			if (PackageString.StartsWith(PackRoots[PackIndex]))
+			{
+				TotalBytes[PackIndex] += DiskSize;
+				if (CookedPackages.Contains(Asset.PackageName))
+				{
+					CookedBytes[PackIndex] += DiskSize;
+				}
+				break;
+			}
+		}
+	}
+
+	FString Report = TEXT("Pack,UncookedTotalBytes,UncookedReachableBytes,UncookedStrippedBytes\n");
+	int64 TotalStripped = 0;
+	for (int32 PackIndex = 0; PackIndex < NumPacks; ++PackIndex)
+	{
+		const int64 Stripped = TotalBytes[PackIndex] - CookedBytes[PackIndex];
+		TotalStripped += Stripped;
+		UE_LOG(LogLevelsAssets, Display, TEXT("%-28s uncooked: total %10.2f MB  cooked %10.2f MB  stripped %10.2f MB"), PackRoots[PackIndex],
+			TotalBytes[PackIndex] / (1024.0 * 1024.0), CookedBytes[PackIndex] / (1024.0 * 1024.0), Stripped / (1024.0 * 1024.0));
+		Report += FString::Printf(TEXT("%s,%lld,%lld,%lld\n"), PackRoots[PackIndex], TotalBytes[PackIndex], CookedBytes[PackIndex], Stripped);
+	}
+	UE_LOG(LogLevelsAssets, Display, TEXT("Cook strips %.2f MB (uncooked) of unreferenced content"), TotalStripped / (1024.0 * 1024.0));
+
+	const FString ReportPath = FPaths::ProjectSavedDir() / TEXT("Audit") / TEXT("CookContentAudit.csv");
+	FFileHelper::SaveStringToFile(Report, *ReportPath);
+	UE_LOG(LogLevelsAssets, Display, TEXT("Wrote %s"), *ReportPath);
+}
+
+#endif
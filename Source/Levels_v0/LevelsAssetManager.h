@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetManager.h"
+#include "Misc/Optional.h"
+#include "LevelsAssetManager.generated.h"
+
+/** A bundled content pack and the chunk its content is packaged into */
+USTRUCT()
+struct FLevelsContentPackChunk
+{
+	GENERATED_BODY()
+
+	/** Root folder of the pack */
+	UPROPERTY(Config)
+		FDirectoryPath Directory;
+
+	/** Chunk its content goes to, unless the startup map needs it in chunk 0 */
+	UPROPERTY(Config)
+		int32 ChunkId = -1;
+};
+
+/**
+ * Project asset manager. Replaces the ConstructorHelpers hard loads that used to run while the
+ * module's CDOs were built: the game mode, HUD and character now hold soft references, and this
+ * class streams them in asynchronously during startup so they are resident by the time the
+ * first map needs them.
+ *
+ * Presentation lives in the Client bundle and in ClientOnlyDirectories. Dedicated servers never
+ * stream it and server cooks leave it out.
+ *
+ * Set as AssetManagerClassName in DefaultEngine.ini.
+ */
+UCLASS(config = Game)
+class LEVELS_V0_API ULevelsAssetManager : public UAssetManager
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Returns the project asset manager */
+	static ULevelsAssetManager& Get();
+
+	virtual void StartInitialLoading() override;
+
+	/** Primary asset type of the character blueprints */
+	static const FPrimaryAssetType CharacterType;
+
+	/** Bundle holding everything a character needs to play */
+	static const FName GameBundle;
+
+	/** Bundle holding what a character only needs to be seen and heard: sounds, effects, montages, camera shakes */
+	static const FName ClientBundle;
+
+	/** True where presentation content is wanted, false on dedicated servers */
+	static bool ShouldLoadClientContent();
+
+	/** Asynchronously streams the given bundle of a character class. Does nothing if it is already loaded or loading */
+	void LoadCharacterBundle(UClass* CharacterClass, FName BundleName);
+
+	/** Returns the soft class, loading it synchronously only if the startup stream hasn't delivered it yet */
+	template<typename T>
+	static UClass* ResolveClass(const TSoftClassPtr<T>& SoftClass);
+
+	/** Returns the soft object, loading it synchronously only if the startup stream hasn't delivered it yet */
+	template<typename T>
+	static T* ResolveObject(const TSoftObjectPtr<T>& SoftObject);
+
+#if WITH_EDITOR
+	/** Leaves client only content out of server cooks */
+	virtual bool ShouldCookForPlatform(const UPackage* Package, const ITargetPlatform* TargetPlatform) override;
+
+	/** Moves content pack packages out of the map chunks into the chunk of their pack */
+	virtual bool GetPackageChunkIds(FName PackageName, const ITargetPlatform* TargetPlatform, const TArray<int32>& ExistingChunkList, TArray<int32>& OutChunkList, TArray<int32>* OutOverrideChunkList = nullptr) const override;
+
+	/**
+	 * Walks the dependencies of every primary asset and always cooked directory and reports, per
+	 * content pack, how many uncooked bytes are reachable and how many the cook strips. Run with
+	 * Levels.AuditCookContent
+	 */
+	void AuditCookContent() const;
+#endif
+
+	/** Content folders only clients need (UI, view textures). Server cooks skip them */
+	UPROPERTY(Config)
+		TArray<FDirectoryPath> ClientOnlyDirectories;
+
+	/** One chunk per bundled content pack, on top of the per map chunks in PrimaryAssetRules */
+	UPROPERTY(Config)
+		TArray<FLevelsContentPackChunk> ContentPackChunks;
+
+private:
+
+#if WITH_EDITOR
+	/** Packages in the Client bundle of any character primary asset, gathered once per cook */
+	const TSet<FName>& GetClientBundlePackages();
+
+	TOptional<TSet<FName>> ClientBundlePackages;
+#endif
+
+	/** Called when the startup assets have streamed in, kicks off the character bundles */
+	void OnStartupAssetsLoaded();
+
+	/** Logs a synchronous load that should have been covered by the startup stream */
+	static void NoteSynchronousLoad(const FSoftObjectPath& Path);
+
+	TSharedPtr<FStreamableHandle> StartupHandle;
+
+	//keeps the loaded bundles resident, keyed by class and bundle name
+	TMap<TPair<FName, FName>, TSharedPtr<FStreamableHandle>> CharacterBundleHandles;
+};
+
+template<typename T>
+UClass* ULevelsAssetManager::ResolveClass(const TSoftClassPtr<T>& SoftClass)
+{
+	if (SoftClass.IsNull())
+	{
+		return nullptr;
+	}
+	if (UClass* Loaded = SoftClass.Get())
+	{
+		return Loaded;
+	}
+	NoteSynchronousLoad(SoftClass.ToSoftObjectPath());
+	return SoftClass.LoadSynchronous();
+}
+
+template<typename T>
+T* ULevelsAssetManager::ResolveObject(const TSoftObjectPtr<T>& SoftObject)
+{
+	if (SoftObject.IsNull())
+	{
+		return nullptr;
+	}
+	if (T* Loaded = SoftObject.Get())
+	{
+		return Loaded;
+	}
+	NoteSynchronousLoad(SoftObject.ToSoftObjectPath());
+	return SoftObject.LoadSynchronous();
+}
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsCharacterPool.h"
+#include "Levels_v0Character.h"
+#include "LevelsMemoryTags.h"
+#include "Engine/World.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCharacterPool, Log, All);
+
+void ULevelsCharacterPool::Deinitialize()
+{
+	DormantCharacters.Reset();
+
+	Super::Deinitialize();
+}
+
+void ULevelsCharacterPool::Prewarm(UClass* CharacterClass, int32 Count)
+{
+	if (CharacterClass == nullptr || !CharacterClass->IsChildOf(ALevels_v0Character::StaticClass()))
+	{
+		return;
+	}
+
+	for (int32 Index = GetNumDormant(CharacterClass); Index < Count; ++Index)
+	{
+		if (ALevels_v0Character* Character = SpawnDormant(CharacterClass))
+		{
+			DormantCharacters.Add(Character);
+		}
+	}
+
+	UE_LOG(LogCharacterPool, Log, TEXT("Prewarmed %d dormant %s"), GetNumDormant(CharacterClass), *CharacterClass->GetName());
+}
+
+ALevels_v0Character* ULevelsCharacterPool::Acquire(UClass* CharacterClass, const FTransform& SpawnTransform)
+{
+	if (CharacterClass == nullptr || !CharacterClass->IsChildOf(ALevels_v0Character::StaticClass()))
+	{
+		return nullptr;
+	}
+
+	ALevels_v0Character* Character = nullptr;
+
+	//first in, first out: Release adds to the back, so the character that rested longest goes out first and one that
+	//just died stays parked while its cosmetic events drain. Ordered removal keeps that order
+	for (int32 Index = 0; Index < DormantCharacters.Num();)
+	{
+		ALevels_v0Character* Candidate = DormantCharacters[Index];
+		if (Candidate == nullptr || Candidate->IsPendingKill())
+		{
+			DormantCharacters.RemoveAt(Index);
+			continue;
+		}
+		if (Candidate->GetClass() == CharacterClass)
+		{
+			Character = Candidate;
+			DormantCharacters.RemoveAt(Index);
+			break;
+		}
+		++Index;
+	}
+
+	if (Character == nullptr)
+	{
+		//pool ran dry, this is the hitch the pool is here to avoid so make it visible
+		UE_LOG(LogCharacterPool, Warning, TEXT("Character pool empty for %s, spawning during gameplay"), *CharacterClass->GetName());
+		Character = SpawnDormant(CharacterClass);
+		if (Character == nullptr)
+		{
+			return nullptr;
+		}
+	}
+
+	Character->LeavePoolDormancy(SpawnTransform);
+	return Character;
+}
+
+void ULevelsCharacterPool::Release(ALevels_v0Character* Character)
+{
+	if (Character == nullptr || Character->IsPendingKill() || Character->IsPoolDormant())
+	{
+		return;
+	}
+
+	ensureMsgf(Character->GetController() == nullptr, TEXT("Releasing %s while it is still possessed"), *Character->GetName());
+
+	Character->EnterPoolDormancy();
+	DormantCharacters.Add(Character);
+}
+
+int32 ULevelsCharacterPool::GetNumDormant(UClass* CharacterClass) const
+{
+	int32 Count = 0;
+	for (const ALevels_v0Character* Character : DormantCharacters)
+	{
+		if (Character && Character->GetClass() == CharacterClass)
+		{
+			++Count;
+		}
+	}
+	return Count;
+}
+
+ALevels_v0Character* ULevelsCharacterPool::SpawnDormant(UClass* CharacterClass)
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnInfo.ObjectFlags |= RF_Transient;
+
+	LEVELS_LLM_SCOPE(CharacterComponents);
+	ALevels_v0Character* Character = World->SpawnActor<ALevels_v0Character>(CharacterClass, FTransform::Identity, SpawnInfo);
+	if (Character)
+	{
+		Character->EnterPoolDormancy();
+	}
+	return Character;
+}
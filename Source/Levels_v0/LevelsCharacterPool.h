@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LevelsCharacterPool.generated.h"
+
+class ALevels_v0Character;
+
+/**
+ * Keeps dormant characters around so respawns and bot spawns don't pay for component
+ * construction and registration during gameplay. Characters are spawned up front with
+ * Prewarm (during loading), checked out with Acquire and handed back with Release.
+ */
+UCLASS()
+class LEVELS_V0_API ULevelsCharacterPool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	/** Spawns dormant characters of the given class until the pool holds Count of them */
+	void Prewarm(UClass* CharacterClass, int32 Count);
+
+	/** Checks the longest dormant character of the given class out of the pool, spawning a new one if the pool ran dry */
+	ALevels_v0Character* Acquire(UClass* CharacterClass, const FTransform& SpawnTransform);
+
+	/** Returns a character to the pool. The character must already be unpossessed */
+	void Release(ALevels_v0Character* Character);
+
+	/** Number of dormant characters of the given class waiting in the pool */
+	int32 GetNumDormant(UClass* CharacterClass) const;
+
+private:
+
+	/** Spawns a character straight into dormancy */
+	ALevels_v0Character* SpawnDormant(UClass* CharacterClass);
+
+	UPROPERTY()
+		TArray<ALevels_v0Character*> DormantCharacters;
+};
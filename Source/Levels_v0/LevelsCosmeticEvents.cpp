@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsCosmeticEvents.h"
+#include "Levels_v0.h"
+#include "Levels_v0Character.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Cosmetic Events"), STAT_LevelsCosmeticEvents, STATGROUP_Levels);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cosmetic Events"), STAT_LevelsCosmeticEventCount, STATGROUP_Levels);
+
+bool ULevelsCosmeticEvents::ShouldCreateSubsystem(UObject* Outer) const
+{
+	//no local viewer on a dedicated server, nothing to present
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && World->GetNetMode() != NM_DedicatedServer && !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+ETickableTickType ULevelsCosmeticEvents::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId ULevelsCosmeticEvents::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULevelsCosmeticEvents, STATGROUP_Tickables);
+}
+
+UWorld* ULevelsCosmeticEvents::GetTickableGameObjectWorld() const
+{
+	//ticked by its own world's UWorld::Tick, so every world drains its queue, in game, tests and commandlets alike
+	return GetWorld();
+}
+
+void ULevelsCosmeticEvents::Publish(const UWorld* World, ELevelsCosmeticEvent Type, ALevels_v0Character* Character, const FVector& Location, const FVector& Normal)
+{
+	if (ULevelsCosmeticEvents* Events = World ? World->GetSubsystem<ULevelsCosmeticEvents>() : nullptr)
+	{
+		Events->PendingEvents.Enqueue({ Type, Character, Location, Normal });
+	}
+}
+
+void ULevelsCosmeticEvents::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LevelsCosmeticEvents);
+
+	FLevelsCosmeticEvent Event;
+	while (PendingEvents.Dequeue(Event))
+	{
+		INC_DWORD_STAT(STAT_LevelsCosmeticEventCount);
+
+		//the character may have been destroyed or pooled since it published
+		ALevels_v0Character* Character = Event.Character.Get();
+		if (Character && !Character->IsPoolDormant())
+		{
+			Character->PlayCosmeticEvent(Event);
+		}
+
+		OnCosmeticEvent.Broadcast(Event);
+	}
+}
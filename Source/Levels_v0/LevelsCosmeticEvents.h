@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Containers/Queue.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LevelsCosmeticEvents.generated.h"
+
+class ALevels_v0Character;
+
+/** Things the simulation did that something might want to show, shake or play a sound for */
+enum class ELevelsCosmeticEvent : uint8
+{
+	Jumped,
+	Landed,
+	LedgeGrabbed,
+	Mantled,
+	QuickMantled,
+	SlideStarted,
+	ShotFired,
+	ShotImpact,
+};
+
+/** One published event. Kept small, it is copied through the queue */
+struct FLevelsCosmeticEvent
+{
+	ELevelsCosmeticEvent Type;
+	TWeakObjectPtr<ALevels_v0Character> Character;
+	FVector Location;
+	FVector Normal;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FLevelsCosmeticEventDelegate, const FLevelsCosmeticEvent&);
+
+/**
+ * Separates presentation from simulation. Movement and weapon code publish events here instead of
+ * playing camera shakes, emitters and sounds themselves. The queue is drained once per frame on the game
+ * thread and each event is handed to the character that caused it and then to any other listeners.
+ *
+ * The subsystem is never created on dedicated servers, so publishing there is a null check and nothing
+ * cosmetic runs at all.
+ */
+UCLASS()
+class LEVELS_V0_API ULevelsCosmeticEvents : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	// End of FTickableGameObject
+
+	/** Queues an event for this frame. Safe to call from any thread, does nothing where there is no local viewer */
+	static void Publish(const UWorld* World, ELevelsCosmeticEvent Type, ALevels_v0Character* Character, const FVector& Location = FVector::ZeroVector, const FVector& Normal = FVector::UpVector);
+
+	/** Broadcast for every event after the owning character has handled it */
+	FLevelsCosmeticEventDelegate OnCosmeticEvent;
+
+private:
+
+	//multiple producers, drained by the game thread
+	TQueue<FLevelsCosmeticEvent, EQueueMode::Mpsc> PendingEvents;
+};
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "LevelsCosmeticMeshComponent.generated.h"
+
+/**
+ * Skeletal mesh that only exists for players to look at (first person arms, weapon models).
+ * Dedicated servers neither cook nor load it, so the meshes, materials and anim blueprints it
+ * references stay out of server memory. Code using one must cope with it being null on a server.
+ */
+UCLASS(ClassGroup = Rendering, meta = (BlueprintSpawnableComponent))
+class LEVELS_V0_API ULevelsCosmeticMeshComponent : public USkeletalMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool NeedsLoadForServer() const override;
+};
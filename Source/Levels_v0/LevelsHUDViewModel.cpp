@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsHUDViewModel.h"
+#include "Levels_v0Character.h"
+
+void ULevelsHUDViewModel::Refresh(ALevels_v0Character* Character)
+{
+	const bool bForce = BoundCharacter.Get() != Character;
+	BoundCharacter = Character;
+
+	if (Character == nullptr)
+	{
+		return;
+	}
+
+	//health, shown as a rounded percentage like GetHealthIntText
+	const float NewHealthPercent = Character->GetHealth();
+	const int32 NewHealthDisplay = FMath::RoundHalfFromZero(NewHealthPercent * 100);
+	const bool bHealthTextChanged = bForce || NewHealthDisplay != HealthDisplay;
+	if (bHealthTextChanged || FMath::Abs(NewHealthPercent - HealthPercent) > PercentThreshold)
+	{
+		if (bHealthTextChanged)
+		{
+			HealthDisplay = NewHealthDisplay;
+			HealthText = FText::FromString(FString::FromInt(HealthDisplay) + TEXT("%"));
+		}
+		HealthPercent = NewHealthPercent;
+		OnHealthChanged.Broadcast(HealthPercent, HealthText);
+	}
+
+	//speed, shown in whole units/s like GetSpeedIntText
+	const float NewSpeedPercent = Character->GetSpeed();
+	const int32 NewSpeedDisplay = (int32)Character->GetVelocity().Size();
+	const bool bSpeedTextChanged = bForce || NewSpeedDisplay != SpeedDisplay;
+	if (bSpeedTextChanged || FMath::Abs(NewSpeedPercent - SpeedPercent) > PercentThreshold)
+	{
+		if (bSpeedTextChanged)
+		{
+			SpeedDisplay = NewSpeedDisplay;
+			SpeedText = FText::AsNumber(SpeedDisplay, &FNumberFormattingOptions::DefaultNoGrouping());
+		}
+		SpeedPercent = NewSpeedPercent;
+		OnSpeedChanged.Broadcast(SpeedPercent, SpeedText);
+	}
+}
+
+void ULevelsHUDViewModel::BroadcastAll()
+{
+	if (HealthDisplay != INDEX_NONE)
+	{
+		OnHealthChanged.Broadcast(HealthPercent, HealthText);
+	}
+	if (SpeedDisplay != INDEX_NONE)
+	{
+		OnSpeedChanged.Broadcast(SpeedPercent, SpeedText);
+	}
+}
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "LevelsHUDViewModel.generated.h"
+
+class ALevels_v0Character;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FLevelsHUDValueChanged, float, Percent, const FText&, Text);
+
+/**
+ * Sits between the character and the health/speed widget. The HUD samples the character once
+ * per frame through Refresh, and the view model only pushes to the widget when a value moved
+ * past the display threshold or its text would read differently. Text is formatted once per
+ * change and cached, so steady values cost the widget nothing.
+ */
+UCLASS(BlueprintType)
+class LEVELS_V0_API ULevelsHUDViewModel : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Samples the character and broadcasts whatever changed. Passing a new character forces a full push */
+	void Refresh(ALevels_v0Character* Character);
+
+	/** Broadcasts the cached values again, used when a widget binds late */
+	void BroadcastAll();
+
+	/** Fired when the health bar or its text needs to change */
+	UPROPERTY(BlueprintAssignable, Category = "Health")
+		FLevelsHUDValueChanged OnHealthChanged;
+
+	/** Fired when the speed meter or its text needs to change */
+	UPROPERTY(BlueprintAssignable, Category = "Speed")
+		FLevelsHUDValueChanged OnSpeedChanged;
+
+	//how far a bar has to move (0-1) before the widget is told about it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HUD")
+		float PercentThreshold = 0.005f;
+
+	UFUNCTION(BlueprintPure, Category = "Health")
+		float GetHealthPercent() const { return HealthPercent; }
+
+	UFUNCTION(BlueprintPure, Category = "Health")
+		FText GetHealthText() const { return HealthText; }
+
+	UFUNCTION(BlueprintPure, Category = "Speed")
+		float GetSpeedPercent() const { return SpeedPercent; }
+
+	UFUNCTION(BlueprintPure, Category = "Speed")
+		FText GetSpeedText() const { return SpeedText; }
+
+private:
+
+	TWeakObjectPtr<ALevels_v0Character> BoundCharacter;
+
+	//last pushed values
+	float HealthPercent = -1.f;
+	float SpeedPercent = -1.f;
+	int32 HealthDisplay = INDEX_NONE;
+	int32 SpeedDisplay = INDEX_NONE;
+	FText HealthText;
+	FText SpeedText;
+};
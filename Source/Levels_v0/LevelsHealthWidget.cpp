@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsHealthWidget.h"
+#include "LevelsHUDViewModel.h"
+#include "Components/ProgressBar.h"
+#include "Components/TextBlock.h"
+#include "Components/InvalidationBox.h"
+
+void ULevelsHealthWidget::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	//children only invalidate when SetPercent/SetText actually change something, so the box can cache everything else
+	if (InvalidationRoot)
+	{
+		InvalidationRoot->SetCanCache(true);
+	}
+}
+
+void ULevelsHealthWidget::NativeDestruct()
+{
+	SetViewModel(nullptr);
+
+	Super::NativeDestruct();
+}
+
+void ULevelsHealthWidget::SetViewModel(ULevelsHUDViewModel* InViewModel)
+{
+	if (ViewModel == InViewModel)
+	{
+		return;
+	}
+
+	if (ViewModel)
+	{
+		ViewModel->OnHealthChanged.RemoveDynamic(this, &ULevelsHealthWidget::HandleHealthChanged);
+		ViewModel->OnSpeedChanged.RemoveDynamic(this, &ULevelsHealthWidget::HandleSpeedChanged);
+	}
+
+	ViewModel = InViewModel;
+
+	if (ViewModel)
+	{
+		ViewModel->OnHealthChanged.AddDynamic(this, &ULevelsHealthWidget::HandleHealthChanged);
+		ViewModel->OnSpeedChanged.AddDynamic(this, &ULevelsHealthWidget::HandleSpeedChanged);
+		ViewModel->BroadcastAll();
+	}
+}
+
+void ULevelsHealthWidget::HandleHealthChanged(float Percent, const FText& Text)
+{
+	if (HealthBar)
+	{
+		HealthBar->SetPercent(Percent);
+	}
+	if (HealthText)
+	{
+		HealthText->SetText(Text);
+	}
+	OnHealthUpdated(Percent, Text);
+}
+
+void ULevelsHealthWidget::HandleSpeedChanged(float Percent, const FText& Text)
+{
+	if (SpeedBar)
+	{
+		SpeedBar->SetPercent(Percent);
+	}
+	if (SpeedText)
+	{
+		SpeedText->SetText(Text);
+	}
+	OnSpeedUpdated(Percent, Text);
+}
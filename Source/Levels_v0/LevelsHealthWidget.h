@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "LevelsHealthWidget.generated.h"
+
+class ULevelsHUDViewModel;
+class UProgressBar;
+class UTextBlock;
+class UInvalidationBox;
+
+/**
+ * Native parent for the Health_UI widget. Instead of property bindings that poll the character
+ * every frame, it listens to the HUD view model and only touches its bars and text when the
+ * view model says something changed. Everything sits under an invalidation box so Slate can
+ * reuse the cached layout while values are steady.
+ *
+ * Widgets are matched by name, so a designer widget with the same names as below gets driven
+ * automatically. Any that are missing are simply skipped.
+ */
+UCLASS()
+class LEVELS_V0_API ULevelsHealthWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Starts listening to a view model, stops listening to the previous one */
+	void SetViewModel(ULevelsHUDViewModel* InViewModel);
+
+protected:
+
+	virtual void NativeConstruct() override;
+
+	virtual void NativeDestruct() override;
+
+	UFUNCTION()
+		void HandleHealthChanged(float Percent, const FText& Text);
+
+	UFUNCTION()
+		void HandleSpeedChanged(float Percent, const FText& Text);
+
+	/** Blueprint hook for extra presentation when health changes */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Health")
+		void OnHealthUpdated(float Percent, const FText& Text);
+
+	/** Blueprint hook for extra presentation when speed changes */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Speed")
+		void OnSpeedUpdated(float Percent, const FText& Text);
+
+	UPROPERTY(BlueprintReadOnly, Category = "HUD", meta = (BindWidgetOptional))
+		UInvalidationBox* InvalidationRoot;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Health", meta = (BindWidgetOptional))
+		UProgressBar* HealthBar;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Health", meta = (BindWidgetOptional))
+		UTextBlock* HealthText;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Speed", meta = (BindWidgetOptional))
+		UProgressBar* SpeedBar;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Speed", meta = (BindWidgetOptional))
+		UTextBlock* SpeedText;
+
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+		ULevelsHUDViewModel* ViewModel;
+};
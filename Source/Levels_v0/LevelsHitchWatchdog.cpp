@@ -0,0 +1,326 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsHitchWatchdog.h"
+#include "Levels_v0Character.h"
+#include "Levels_v0Projectile.h"
+#include "LevelsPlayerMovementComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogLevelsHitch, Log, All);
+
+FLevelsHitchWatchdog* FLevelsHitchWatchdog::Instance = nullptr;
+int32 FLevelsHitchWatchdog::FrameSceneQueries = 0;
+int32 FLevelsHitchWatchdog::FrameModeTransitions = 0;
+
+namespace
+{
+	//no dump within this long of the last one, and no more than this many per session
+	const double MinSecondsBetweenDumps = 5.0;
+	const int32 MaxDumpsPerSession = 20;
+
+	/** Start of every dump file, followed by NumFrames records oldest first */
+	struct FLevelsHitchDumpHeader
+	{
+		uint8 Magic[4] = { 'L', 'H', 'C', 'H' };
+		uint16 Version = FLevelsHitchWatchdog::DumpVersion;
+		uint16 FrameSize = sizeof(FLevelsHitchFrame);
+		uint32 NumFrames = 0;
+		float BudgetMs = 0.f;
+		int64 UnixTime = 0;
+		//UTF-8, zero padded
+		ANSICHAR MapName[64] = {};
+		ANSICHAR Reason[32] = {};
+	};
+
+	static_assert(sizeof(FLevelsHitchDumpHeader) == 120, "The dump header is read by read_hitch_dump.py, keep it in step");
+
+	uint16 ClampToUint16(int32 Value)
+	{
+		return (uint16)FMath::Clamp(Value, 0, 0xffff);
+	}
+
+	void CopyName(ANSICHAR* Destination, int32 Size, const FString& Name)
+	{
+		FTCHARToUTF8 Converted(*Name);
+		FMemory::Memcpy(Destination, Converted.Get(), FMath::Min(Converted.Length(), Size - 1));
+	}
+}
+
+static FAutoConsoleCommand DumpHitchFramesCommand(
+	TEXT("Levels.DumpHitchFrames"),
+	TEXT("Writes the hitch watchdog's recent frames to disk, needs -LevelsHitchBudget"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		if (FLevelsHitchWatchdog* Watchdog = FLevelsHitchWatchdog::Get())
+		{
+			Watchdog->Dump(TEXT("console"));
+		}
+		else
+		{
+			UE_LOG(LogLevelsHitch, Warning, TEXT("The hitch watchdog is off, start with -LevelsHitchBudget=<ms>"));
+		}
+	}));
+
+void FLevelsHitchWatchdog::Startup()
+{
+	float Budget = 0.f;
+	if (Instance || !FParse::Value(FCommandLine::Get(), TEXT("LevelsHitchBudget="), Budget) || Budget <= 0.f)
+	{
+		return;
+	}
+
+	int32 NumFrames = 300;
+	FParse::Value(FCommandLine::Get(), TEXT("LevelsHitchFrames="), NumFrames);
+
+	FString Directory = TEXT("Hitches");
+	FParse::Value(FCommandLine::Get(), TEXT("LevelsHitchDir="), Directory);
+	if (FPaths::IsRelative(Directory))
+	{
+		Directory = FPaths::ProjectSavedDir() / Directory;
+	}
+
+	Instance = new FLevelsHitchWatchdog(Budget, FMath::Max(NumFrames, 2), Directory);
+	UE_LOG(LogLevelsHitch, Display, TEXT("Hitch watchdog on, %.1fms budget, keeping %d frames"), Budget, Instance->Frames.Num());
+}
+
+void FLevelsHitchWatchdog::Shutdown()
+{
+	delete Instance;
+	Instance = nullptr;
+}
+
+FLevelsHitchWatchdog::FLevelsHitchWatchdog(float InBudgetMs, int32 NumFrames, const FString& InOutputDir)
+	: BudgetMs(InBudgetMs)
+	, OutputDir(InOutputDir)
+{
+	Frames.SetNum(NumFrames);
+
+	BeginFrameHandle = FCoreDelegates::OnBeginFrame.AddRaw(this, &FLevelsHitchWatchdog::OnBeginFrame);
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FLevelsHitchWatchdog::OnEndFrame);
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddRaw(this, &FLevelsHitchWatchdog::OnPreGarbageCollect);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FLevelsHitchWatchdog::OnPostGarbageCollect);
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddRaw(this, &FLevelsHitchWatchdog::OnPreLoadMap);
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FLevelsHitchWatchdog::OnLevelAdded);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FLevelsHitchWatchdog::OnLevelRemoved);
+}
+
+FLevelsHitchWatchdog::~FLevelsHitchWatchdog()
+{
+	FCoreDelegates::OnBeginFrame.Remove(BeginFrameHandle);
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+}
+
+void FLevelsHitchWatchdog::TrackEmitter(UParticleSystemComponent* Emitter)
+{
+	if (Instance && Emitter)
+	{
+		Instance->Emitters.Add(Emitter);
+	}
+}
+
+void FLevelsHitchWatchdog::OnBeginFrame()
+{
+	FrameStartCycles = FPlatformTime::Cycles64();
+	//garbage collection and level streaming land between frames too, those count towards the next one
+	const FLevelsHitchFrame Carried = Current;
+	Current = FLevelsHitchFrame();
+	Current.GarbageCollectMs = Carried.GarbageCollectMs;
+	Current.GarbageCollections = Carried.GarbageCollections;
+	Current.LevelsAdded = Carried.LevelsAdded;
+	Current.LevelsRemoved = Carried.LevelsRemoved;
+	FrameSceneQueries = 0;
+	FrameModeTransitions = 0;
+}
+
+void FLevelsHitchWatchdog::OnEndFrame()
+{
+	if (FrameStartCycles == 0)
+	{
+		return;
+	}
+
+	Current.FrameNumber = (uint32)GFrameCounter;
+	Current.FrameMs = (float)FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - FrameStartCycles);
+	Current.WorkMs = FMath::Max(0.f, Current.FrameMs - (float)(FApp::GetIdleTime() * 1000.0));
+	Current.SceneQueries = ClampToUint16(FrameSceneQueries);
+	Current.ModeTransitions = ClampToUint16(FrameModeTransitions);
+	Current.AsyncPackages = ClampToUint16(GetNumAsyncPackages());
+
+	Emitters.RemoveAllSwap([](const TWeakObjectPtr<UParticleSystemComponent>& Emitter) { return !Emitter.IsValid() || !Emitter->IsActive(); });
+	Current.LiveEmitters = ClampToUint16(Emitters.Num());
+
+	SampleWorlds(Current);
+
+	Frames[NextFrame] = Current;
+	NextFrame = (NextFrame + 1) % Frames.Num();
+	NumRecorded = FMath::Min(NumRecorded + 1, Frames.Num());
+
+	const bool bSkipped = bSkipFrame;
+	bSkipFrame = false;
+	Current = FLevelsHitchFrame();
+
+	//a full ring leaves startup behind, and a map load is a hitch everybody knows about
+	if (bSkipped || NumRecorded < Frames.Num() || Frames[(NextFrame + Frames.Num() - 1) % Frames.Num()].WorkMs <= BudgetMs)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (NumDumps >= MaxDumpsPerSession || Now - LastDumpTime < MinSecondsBetweenDumps)
+	{
+		return;
+	}
+	Dump(TEXT("budget"));
+}
+
+void FLevelsHitchWatchdog::SampleWorlds(FLevelsHitchFrame& Frame) const
+{
+	if (GEngine == nullptr)
+	{
+		return;
+	}
+
+	int32 Characters = 0;
+	int32 Projectiles = 0;
+	int32 LiveTimers = 0;
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		UWorld* World = Context.World();
+		if (World == nullptr || !World->IsGameWorld())
+		{
+			continue;
+		}
+
+		for (TActorIterator<ALevels_v0Character> It(World); It; ++It)
+		{
+			const ULevelsPlayerMovementComponent* Movement = It->CharacterMovement;
+			if (Movement == nullptr || It->IsPoolDormant())
+			{
+				continue;
+			}
+
+			++Characters;
+			LiveTimers += Movement->GetNumLiveTimers();
+			//parkour modes sit on top of walking or falling, both get recorded
+			if (Movement->CustomMovementMode != MOVE_CustomNone && Movement->CustomMovementMode < 13)
+			{
+				Frame.Modes |= 1 << Movement->CustomMovementMode;
+			}
+			if (Movement->MovementMode == MOVE_Walking || Movement->MovementMode == MOVE_NavWalking)
+			{
+				Frame.Modes |= FLevelsHitchFrame::ModeBitWalking;
+			}
+			else if (Movement->MovementMode == MOVE_Falling)
+			{
+				Frame.Modes |= FLevelsHitchFrame::ModeBitFalling;
+			}
+			else
+			{
+				Frame.Modes |= FLevelsHitchFrame::ModeBitOther;
+			}
+		}
+
+		for (TActorIterator<ALevels_v0Projectile> It(World); It; ++It)
+		{
+			++Projectiles;
+		}
+	}
+
+	Frame.Characters = ClampToUint16(Characters);
+	Frame.Projectiles = ClampToUint16(Projectiles);
+	Frame.LiveTimers = ClampToUint16(LiveTimers);
+}
+
+void FLevelsHitchWatchdog::OnPreGarbageCollect()
+{
+	GarbageCollectStartCycles = FPlatformTime::Cycles64();
+}
+
+void FLevelsHitchWatchdog::OnPostGarbageCollect()
+{
+	if (GarbageCollectStartCycles != 0)
+	{
+		Current.GarbageCollectMs += (float)FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - GarbageCollectStartCycles);
+		GarbageCollectStartCycles = 0;
+	}
+	Current.GarbageCollections = (uint8)FMath::Min(Current.GarbageCollections + 1, 0xff);
+}
+
+void FLevelsHitchWatchdog::OnPreLoadMap(const FString& MapName)
+{
+	bSkipFrame = true;
+}
+
+void FLevelsHitchWatchdog::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+	Current.LevelsAdded = (uint8)FMath::Min(Current.LevelsAdded + 1, 0xff);
+}
+
+void FLevelsHitchWatchdog::OnLevelRemoved(ULevel* Level, UWorld* World)
+{
+	Current.LevelsRemoved = (uint8)FMath::Min(Current.LevelsRemoved + 1, 0xff);
+}
+
+FString FLevelsHitchWatchdog::Dump(const TCHAR* Reason)
+{
+	FLevelsHitchDumpHeader Header;
+	Header.NumFrames = NumRecorded;
+	Header.BudgetMs = BudgetMs;
+	Header.UnixTime = FDateTime::UtcNow().ToUnixTimestamp();
+
+	FString MapName;
+	if (GEngine)
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if (Context.World() && Context.World()->IsGameWorld())
+			{
+				MapName = Context.World()->GetMapName();
+				break;
+			}
+		}
+	}
+	CopyName(Header.MapName, UE_ARRAY_COUNT(Header.MapName), MapName);
+	CopyName(Header.Reason, UE_ARRAY_COUNT(Header.Reason), Reason);
+
+	TArray<uint8> Bytes;
+	Bytes.Reserve(sizeof(Header) + NumRecorded * sizeof(FLevelsHitchFrame));
+	Bytes.Append((const uint8*)&Header, sizeof(Header));
+	//oldest first
+	const int32 First = NumRecorded < Frames.Num() ? 0 : NextFrame;
+	for (int32 Index = 0; Index < NumRecorded; ++Index)
+	{
+		Bytes.Append((const uint8*)&Frames[(First + Index) % Frames.Num()], sizeof(FLevelsHitchFrame));
+	}
+
+	const FString Filename = OutputDir / FString::Printf(TEXT("Hitch_%s_%u.bin"), *FDateTime::Now().ToString(), (uint32)GFrameCounter);
+	if (!FFileHelper::SaveArrayToFile(Bytes, *Filename))
+	{
+		UE_LOG(LogLevelsHitch, Error, TEXT("Could not write %s"), *Filename);
+		return FString();
+	}
+
+	LastDumpTime = FPlatformTime::Seconds();
+	++NumDumps;
+	const FLevelsHitchFrame& Last = Frames[(NextFrame + Frames.Num() - 1) % Frames.Num()];
+	UE_LOG(LogLevelsHitch, Warning, TEXT("Frame %u took %.1fms (%.1fms of work, budget %.1fms), wrote the last %d frames to %s"),
+		Last.FrameNumber, Last.FrameMs, Last.WorkMs, BudgetMs, NumRecorded, *Filename);
+	return Filename;
+}
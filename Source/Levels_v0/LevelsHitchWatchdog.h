@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UParticleSystemComponent;
+class ULevel;
+class UWorld;
+
+/**
+ * One frame in the watchdog's black box. The layout is fixed and written to disk as is, so change
+ * FLevelsHitchWatchdog::DumpVersion and Scripts/HitchWatchdog/read_hitch_dump.py along with it.
+ */
+struct FLevelsHitchFrame
+{
+	uint32 FrameNumber = 0;
+	//begin to end of the engine tick, and the same without the time slept to hold the frame rate
+	float FrameMs = 0.f;
+	float WorkMs = 0.f;
+	float GarbageCollectMs = 0.f;
+	//parkour probes and weapon traces
+	uint16 SceneQueries = 0;
+	uint16 ModeTransitions = 0;
+	uint16 Characters = 0;
+	//bit N while some character is in parkour mode N, plus the ModeBit constants for the movement mode under it
+	uint16 Modes = 0;
+	uint16 Projectiles = 0;
+	uint16 LiveEmitters = 0;
+	//parkour cooldowns and polling timers of every character
+	uint16 LiveTimers = 0;
+	uint16 AsyncPackages = 0;
+	uint8 LevelsAdded = 0;
+	uint8 LevelsRemoved = 0;
+	uint8 GarbageCollections = 0;
+	uint8 Reserved = 0;
+
+	static const uint16 ModeBitWalking = 1 << 13;
+	static const uint16 ModeBitFalling = 1 << 14;
+	static const uint16 ModeBitOther = 1 << 15;
+};
+
+static_assert(sizeof(FLevelsHitchFrame) == 36, "FLevelsHitchFrame is written to disk, keep the reader in step");
+
+/**
+ * Keeps a ring of small per frame records for the whole process and writes it out whenever a frame's game
+ * thread work goes over budget, so rare hitches in the field come with the frames that led up to them.
+ * Started by the game module when -LevelsHitchBudget=<ms> is on the command line:
+ *
+ *   -LevelsHitchFrames=<n>   frames kept, default 300
+ *   -LevelsHitchDir=<dir>    where dumps go, default Saved/Hitches
+ *
+ * Dumps are binary, read them with Scripts/HitchWatchdog/read_hitch_dump.py. Map loads don't count as
+ * hitches, dumps are at least a few seconds apart and there are only so many per session. The console
+ * command Levels.DumpHitchFrames writes the ring out on demand.
+ */
+class LEVELS_V0_API FLevelsHitchWatchdog
+{
+public:
+
+	static const uint16 DumpVersion = 1;
+
+	/** Starts the watchdog if the command line asks for it */
+	static void Startup();
+
+	static void Shutdown();
+
+	/** The running watchdog, null when it is off */
+	static FLevelsHitchWatchdog* Get() { return Instance; }
+
+	//cheap enough to call whether the watchdog is running or not
+	static void NoteSceneQuery() { ++FrameSceneQueries; }
+	static void NoteModeTransition() { ++FrameModeTransitions; }
+
+	/** Counts an emitter as live until it finishes */
+	static void TrackEmitter(UParticleSystemComponent* Emitter);
+
+	/** Writes the ring out now, returns the file or an empty string */
+	FString Dump(const TCHAR* Reason);
+
+private:
+
+	FLevelsHitchWatchdog(float InBudgetMs, int32 NumFrames, const FString& InOutputDir);
+	~FLevelsHitchWatchdog();
+
+	void OnBeginFrame();
+	void OnEndFrame();
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+	void OnPreLoadMap(const FString& MapName);
+	void OnLevelAdded(ULevel* Level, UWorld* World);
+	void OnLevelRemoved(ULevel* Level, UWorld* World);
+
+	/** Characters, modes, projectiles and timers of every game world */
+	void SampleWorlds(FLevelsHitchFrame& Frame) const;
+
+	static FLevelsHitchWatchdog* Instance;
+	static int32 FrameSceneQueries;
+	static int32 FrameModeTransitions;
+
+	float BudgetMs;
+	FString OutputDir;
+
+	//oldest record at NextFrame once the ring has wrapped
+	TArray<FLevelsHitchFrame> Frames;
+	int32 NextFrame = 0;
+	int32 NumRecorded = 0;
+
+	FLevelsHitchFrame Current;
+	uint64 FrameStartCycles = 0;
+	uint64 GarbageCollectStartCycles = 0;
+	bool bSkipFrame = false;
+
+	TArray<TWeakObjectPtr<UParticleSystemComponent>> Emitters;
+
+	double LastDumpTime = -1000.0;
+	int32 NumDumps = 0;
+
+	FDelegateHandle BeginFrameHandle;
+	FDelegateHandle EndFrameHandle;
+	FDelegateHandle PreGarbageCollectHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+};
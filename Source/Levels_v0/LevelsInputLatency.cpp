@@ -0,0 +1,401 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsInputLatency.h"
+#include "Levels_v0Character.h"
+#include "LevelsInputScript.h"
+#include "LevelsPlayerMovementComponent.h"
+#include "Framework/Application/IInputProcessor.h"
+#include "Framework/Application/SlateApplication.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerInput.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogLevelsInputLatency, Log, All);
+
+FLevelsInputLatency* FLevelsInputLatency::Instance = nullptr;
+
+namespace
+{
+	//a press that hasn't moved anything by then never will, and a key down nobody bound by then wasn't one of ours
+	const double MaxPressSeconds = 1.0;
+	const double MaxKeySeconds = 0.5;
+	//each series keeps this many presses, later ones still count towards NoMotion only
+	const int32 MaxSamples = 10000;
+
+	//2ms buckets up to 50ms, the last one is everything above
+	const float BucketMs = 2.f;
+	const int32 NumBuckets = 26;
+
+	const TCHAR* StageNames[(int32)FLevelsInputLatency::EStage::Num] = { TEXT("key"), TEXT("bound"), TEXT("checked"), TEXT("moved"), TEXT("camera") };
+
+	FName GetActionName(uint8 Button)
+	{
+		switch (Button)
+		{
+		case ELevelsInputButton::Jump: return TEXT("Jump");
+		case ELevelsInputButton::Crouch: return TEXT("Crouch");
+		case ELevelsInputButton::Sprint: return TEXT("Sprint");
+		default: return NAME_None;
+		}
+	}
+
+	const TCHAR* GetSimulationName(bool bFixedStep)
+	{
+		return bFixedStep ? TEXT("fixed step") : TEXT("timers");
+	}
+
+	/** Value below which Percent of the sorted values fall */
+	float Percentile(const TArray<float>& Sorted, float Percent)
+	{
+		if (Sorted.Num() == 0)
+		{
+			return 0.f;
+		}
+		const int32 Index = FMath::Clamp(FMath::RoundToInt(Percent / 100.f * (Sorted.Num() - 1)), 0, Sorted.Num() - 1);
+		return Sorted[Index];
+	}
+
+	TArray<int32> GetBuckets(const TArray<float>& Samples)
+	{
+		TArray<int32> Buckets;
+		Buckets.SetNumZeroed(NumBuckets);
+		for (float Ms : Samples)
+		{
+			++Buckets[FMath::Clamp(FMath::FloorToInt(Ms / BucketMs), 0, NumBuckets - 1)];
+		}
+		return Buckets;
+	}
+
+	/** Hands every key down to the tracker before Slate routes it anywhere, and never handles it */
+	class FLevelsInputLatencyProcessor : public IInputProcessor
+	{
+	public:
+
+		explicit FLevelsInputLatencyProcessor(FLevelsInputLatency& InOwner) : Owner(InOwner) {}
+
+		virtual void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override {}
+
+		virtual bool HandleKeyDownEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent) override
+		{
+			if (!InKeyEvent.IsRepeat())
+			{
+				Owner.NoteKeyDown(InKeyEvent.GetKey());
+			}
+			return false;
+		}
+
+		virtual bool HandleMouseButtonDownEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override
+		{
+			Owner.NoteKeyDown(MouseEvent.GetEffectingButton());
+			return false;
+		}
+
+	private:
+
+		FLevelsInputLatency& Owner;
+	};
+}
+
+static FAutoConsoleCommand InputLatencyCommand(
+	TEXT("Levels.InputLatency"),
+	TEXT("Prints key to motion latency histograms per parkour action, needs -LevelsInputLatency. \"Levels.InputLatency reset\" clears them"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FLevelsInputLatency* Latency = FLevelsInputLatency::Get();
+		if (Latency == nullptr)
+		{
+			UE_LOG(LogLevelsInputLatency, Warning, TEXT("Input latency tracking is off, start with -LevelsInputLatency"));
+		}
+		else if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			Latency->Reset();
+		}
+		else
+		{
+			GLog->Log(Latency->GetReport());
+		}
+	}));
+
+void FLevelsInputLatency::Startup()
+{
+	if (Instance || !FParse::Param(FCommandLine::Get(), TEXT("LevelsInputLatency")))
+	{
+		return;
+	}
+
+	FString File;
+	FParse::Value(FCommandLine::Get(), TEXT("LevelsInputLatencyOut="), File);
+	if (!File.IsEmpty() && FPaths::IsRelative(File))
+	{
+		File = FPaths::ProjectSavedDir() / File;
+	}
+
+	Instance = new FLevelsInputLatency(File);
+	UE_LOG(LogLevelsInputLatency, Display, TEXT("Input latency tracking on"));
+}
+
+void FLevelsInputLatency::Shutdown()
+{
+	if (Instance && !Instance->OutputFile.IsEmpty())
+	{
+		if (FFileHelper::SaveStringToFile(Instance->GetReportCsv(), *Instance->OutputFile))
+		{
+			UE_LOG(LogLevelsInputLatency, Display, TEXT("Wrote %s"), *Instance->OutputFile);
+		}
+		else
+		{
+			UE_LOG(LogLevelsInputLatency, Error, TEXT("Could not write %s"), *Instance->OutputFile);
+		}
+	}
+
+	delete Instance;
+	Instance = nullptr;
+}
+
+FLevelsInputLatency::FLevelsInputLatency(const FString& InOutputFile)
+	: OutputFile(InOutputFile)
+{
+	BeginFrameHandle = FCoreDelegates::OnBeginFrame.AddRaw(this, &FLevelsInputLatency::OnBeginFrame);
+}
+
+FLevelsInputLatency::~FLevelsInputLatency()
+{
+	FCoreDelegates::OnBeginFrame.Remove(BeginFrameHandle);
+
+	if (InputProcessor.IsValid() && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().UnregisterInputPreProcessor(InputProcessor);
+	}
+}
+
+void FLevelsInputLatency::OnBeginFrame()
+{
+	//Slate can come up after the game module, the processor goes in as soon as it is there
+	if (!InputProcessor.IsValid() && FSlateApplication::IsInitialized())
+	{
+		InputProcessor = MakeShareable(new FLevelsInputLatencyProcessor(*this));
+		FSlateApplication::Get().RegisterInputPreProcessor(InputProcessor, 0);
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	for (auto It = KeyDownSeconds.CreateIterator(); It; ++It)
+	{
+		if (Now - It.Value() > MaxKeySeconds)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (int32 Index = Pending.Num() - 1; Index >= 0; --Index)
+	{
+		const FPending& Press = Pending[Index];
+		if (!Press.Movement.IsValid() || Now - Press.Seconds[(int32)EStage::Bound] > MaxPressSeconds)
+		{
+			Finish(Press, Press.Seconds[(int32)EStage::Moved] > 0.0);
+			Pending.RemoveAtSwap(Index);
+		}
+	}
+}
+
+void FLevelsInputLatency::NoteKeyDown(const FKey& Key)
+{
+	KeyDownSeconds.Add(Key, FPlatformTime::Seconds());
+}
+
+void FLevelsInputLatency::OnAction(ALevels_v0Character* Character, uint8 Button)
+{
+	if (Character == nullptr || !Character->IsLocallyControlled() || Character->CharacterMovement == nullptr)
+	{
+		return;
+	}
+
+	ULevelsPlayerMovementComponent* Movement = Character->CharacterMovement;
+	const double Now = FPlatformTime::Seconds();
+
+	//a press before the last one got anywhere ends that one
+	for (int32 Index = Pending.Num() - 1; Index >= 0; --Index)
+	{
+		if (Pending[Index].Movement == Movement && Pending[Index].Button == Button)
+		{
+			Finish(Pending[Index], Pending[Index].Seconds[(int32)EStage::Moved] > 0.0);
+			Pending.RemoveAtSwap(Index);
+		}
+	}
+
+	FPending& Press = Pending.AddDefaulted_GetRef();
+	Press.Movement = Movement;
+	Press.Button = Button;
+	Press.bFixedStep = Movement->bFixedStepSimulation;
+	Press.Seconds[(int32)EStage::Bound] = Now;
+	Press.Seconds[(int32)EStage::Key] = Now;
+	Press.BoundVelocityZ = Movement->Velocity.Z;
+	Press.BoundMaxWalkSpeed = Movement->MaxWalkSpeed;
+	Press.BoundMode = Movement->MovementMode;
+	Press.BoundCustomMode = Movement->CustomMovementMode;
+	Press.bBoundCrouched = Movement->IsCrouching();
+
+	//the key downs mapped to the action are claimed, so one key press is never timed twice
+	APlayerController* PC = Cast<APlayerController>(Character->GetController());
+	if (PC && PC->PlayerInput)
+	{
+		for (const FInputActionKeyMapping& Mapping : PC->PlayerInput->GetKeysForAction(GetActionName(Button)))
+		{
+			double KeySeconds = 0.0;
+			if (KeyDownSeconds.RemoveAndCopyValue(Mapping.Key, KeySeconds))
+			{
+				Press.Seconds[(int32)EStage::Key] = FMath::Min(Press.Seconds[(int32)EStage::Key], KeySeconds);
+			}
+		}
+	}
+}
+
+void FLevelsInputLatency::OnStage(ULevelsPlayerMovementComponent* Movement, EStage Stage)
+{
+	const double Now = FPlatformTime::Seconds();
+	for (int32 Index = Pending.Num() - 1; Index >= 0; --Index)
+	{
+		FPending& Press = Pending[Index];
+		//stages are reached in order, the camera only counts once there was motion to show
+		if (Press.Movement != Movement || Press.Seconds[(int32)Stage] > 0.0 || Press.Seconds[(int32)Stage - 1] == 0.0)
+		{
+			continue;
+		}
+
+		Press.Seconds[(int32)Stage] = Now;
+		if (Stage == EStage::Camera)
+		{
+			Finish(Press, true);
+			Pending.RemoveAtSwap(Index);
+		}
+	}
+}
+
+void FLevelsInputLatency::OnMovementUpdated(ULevelsPlayerMovementComponent* Movement)
+{
+	const double Now = FPlatformTime::Seconds();
+	for (int32 Index = Pending.Num() - 1; Index >= 0; --Index)
+	{
+		FPending& Press = Pending[Index];
+		if (Press.Movement != Movement || Press.Seconds[(int32)EStage::Moved] > 0.0)
+		{
+			continue;
+		}
+
+		//only what the action itself does counts, steering and friction change the velocity every frame
+		const bool bModeChanged = Movement->MovementMode != Press.BoundMode || Movement->CustomMovementMode != Press.BoundCustomMode;
+		const bool bSpeedCapChanged = Movement->MaxWalkSpeed != Press.BoundMaxWalkSpeed || Movement->IsCrouching() != Press.bBoundCrouched;
+		const bool bJumped = (Press.Button & ELevelsInputButton::Jump) && Movement->Velocity.Z - Press.BoundVelocityZ >= 0.5f * Movement->JumpZVelocity;
+		if (!bModeChanged && !bSpeedCapChanged && !bJumped)
+		{
+			continue;
+		}
+
+		//the timer and the fixed step run the checks inside the movement update as well, it was checked by now at the latest
+		Press.Seconds[(int32)EStage::Moved] = Now;
+		if (Press.Seconds[(int32)EStage::Checked] == 0.0)
+		{
+			Press.Seconds[(int32)EStage::Checked] = Now;
+		}
+	}
+}
+
+void FLevelsInputLatency::Finish(const FPending& Press, bool bMoved)
+{
+	FSeries& Target = FindOrAddSeries(Press.Button, Press.bFixedStep);
+	if (!bMoved)
+	{
+		++Target.NoMotion;
+		return;
+	}
+
+	for (int32 Stage = (int32)EStage::Bound; Stage < (int32)EStage::Num; ++Stage)
+	{
+		if (Press.Seconds[Stage] > 0.0 && Target.StageMs[Stage].Num() < MaxSamples)
+		{
+			Target.StageMs[Stage].Add((float)((Press.Seconds[Stage] - Press.Seconds[(int32)EStage::Key]) * 1000.0));
+		}
+	}
+}
+
+FLevelsInputLatency::FSeries& FLevelsInputLatency::FindOrAddSeries(uint8 Button, bool bFixedStep)
+{
+	for (FSeries& Existing : Series)
+	{
+		if (Existing.Button == Button && Existing.bFixedStep == bFixedStep)
+		{
+			return Existing;
+		}
+	}
+
+	FSeries& Added = Series.AddDefaulted_GetRef();
+	Added.Button = Button;
+	Added.bFixedStep = bFixedStep;
+	return Added;
+}
+
+void FLevelsInputLatency::Reset()
+{
+	Series.Reset();
+	Pending.Reset();
+	KeyDownSeconds.Reset();
+}
+
+FString FLevelsInputLatency::GetReport() const
+{
+	if (Series.Num() == 0)
+	{
+		return TEXT("No parkour presses timed yet");
+	}
+
+	FString Report = FString::Printf(TEXT("Milliseconds from key down, histograms in %.0fms buckets up to %.0fms\n"), BucketMs, BucketMs * (NumBuckets - 1));
+	for (const FSeries& Entry : Series)
+	{
+		Report += FString::Printf(TEXT("%s (%s): %d presses that moved, %d without motion\n"), *GetActionName(Entry.Button).ToString(), GetSimulationName(Entry.bFixedStep),
+			Entry.StageMs[(int32)EStage::Bound].Num(), Entry.NoMotion);
+
+		for (int32 Stage = (int32)EStage::Bound; Stage < (int32)EStage::Num; ++Stage)
+		{
+			TArray<float> Sorted = Entry.StageMs[Stage];
+			Sorted.Sort();
+			Report += FString::Printf(TEXT("  %-8s p50 %6.2f  p95 %6.2f  max %6.2f  |"), StageNames[Stage], Percentile(Sorted, 50.f), Percentile(Sorted, 95.f), Sorted.Num() > 0 ? Sorted.Last() : 0.f);
+			for (int32 Count : GetBuckets(Sorted))
+			{
+				Report += FString::Printf(TEXT("%d|"), Count);
+			}
+			Report += TEXT("\n");
+		}
+	}
+	return Report;
+}
+
+FString FLevelsInputLatency::GetReportCsv() const
+{
+	FString Csv = TEXT("action,simulation,stage,presses,no_motion,p50_ms,p95_ms,max_ms");
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		Csv += Bucket < NumBuckets - 1 ? FString::Printf(TEXT(",ms_%.0f_%.0f"), Bucket * BucketMs, (Bucket + 1) * BucketMs) : FString::Printf(TEXT(",ms_%.0f_up"), Bucket * BucketMs);
+	}
+	Csv += TEXT("\n");
+
+	for (const FSeries& Entry : Series)
+	{
+		for (int32 Stage = (int32)EStage::Bound; Stage < (int32)EStage::Num; ++Stage)
+		{
+			TArray<float> Sorted = Entry.StageMs[Stage];
+			Sorted.Sort();
+			Csv += FString::Printf(TEXT("%s,%s,%s,%d,%d,%.3f,%.3f,%.3f"), *GetActionName(Entry.Button).ToString(), GetSimulationName(Entry.bFixedStep), StageNames[Stage],
+				Sorted.Num(), Entry.NoMotion, Percentile(Sorted, 50.f), Percentile(Sorted, 95.f), Sorted.Num() > 0 ? Sorted.Last() : 0.f);
+			for (int32 Count : GetBuckets(Sorted))
+			{
+				Csv += FString::Printf(TEXT(",%d"), Count);
+			}
+			Csv += TEXT("\n");
+		}
+	}
+	return Csv;
+}
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InputCoreTypes.h"
+
+class ALevels_v0Character;
+class ULevelsPlayerMovementComponent;
+class IInputProcessor;
+
+/**
+ * Follows single parkour presses from the key event to the screen and keeps per action latency histograms,
+ * to measure what the 60Hz movement check timers add and show that fixed step simulation takes it away.
+ * Started by the game module when -LevelsInputLatency is on the command line, every press of a locally
+ * controlled character is timed at:
+ *
+ *   key      Slate handing the platform key event out, before any input binding sees it
+ *   bound    the input binding (JumpPressed, SprintPressed, CrouchStart) running
+ *   checked  the next parkour check, the movement check timer or the fixed step that takes the press
+ *   moved    the first movement update showing the action's own effect: a movement or parkour mode change, the
+ *            jump's upward impulse, or a new speed cap or crouch state, never just any change in velocity
+ *   camera   the first camera update after that
+ *
+ * Scripted input has no key event, its presses start at bound. Levels.InputLatency prints the histograms,
+ * "Levels.InputLatency reset" clears them, and -LevelsInputLatencyOut=<csv> writes them out on exit.
+ */
+class LEVELS_V0_API FLevelsInputLatency
+{
+public:
+
+	enum class EStage : uint8
+	{
+		Key,
+		Bound,
+		Checked,
+		Moved,
+		Camera,
+		Num
+	};
+
+	/** Starts the tracker if the command line asks for it */
+	static void Startup();
+
+	static void Shutdown();
+
+	/** The running tracker, null when it is off */
+	static FLevelsInputLatency* Get() { return Instance; }
+
+	//cheap enough to call whether the tracker is running or not
+	static void NoteAction(ALevels_v0Character* Character, uint8 Button) { if (Instance) { Instance->OnAction(Character, Button); } }
+	static void NoteParkourCheck(ULevelsPlayerMovementComponent* Movement) { if (Instance) { Instance->OnStage(Movement, EStage::Checked); } }
+	static void NoteMovementUpdated(ULevelsPlayerMovementComponent* Movement) { if (Instance) { Instance->OnMovementUpdated(Movement); } }
+	static void NoteCameraUpdated(ULevelsPlayerMovementComponent* Movement) { if (Instance) { Instance->OnStage(Movement, EStage::Camera); } }
+
+	void NoteKeyDown(const FKey& Key);
+
+	/** One histogram per action, simulation and span, as text */
+	FString GetReport() const;
+
+	/** The same as comma separated rows with the buckets as columns */
+	FString GetReportCsv() const;
+
+	void Reset();
+
+private:
+
+	/** A press on its way through the stages, seconds are FPlatformTime::Seconds and zero until reached */
+	struct FPending
+	{
+		TWeakObjectPtr<ULevelsPlayerMovementComponent> Movement;
+		uint8 Button = 0;
+		bool bFixedStep = false;
+		double Seconds[(int32)EStage::Num] = {};
+		float BoundVelocityZ = 0.f;
+		float BoundMaxWalkSpeed = 0.f;
+		uint8 BoundMode = 0;
+		uint8 BoundCustomMode = 0;
+		bool bBoundCrouched = false;
+	};
+
+	/** Finished presses of one action under one kind of simulation, milliseconds from key to each stage */
+	struct FSeries
+	{
+		uint8 Button = 0;
+		bool bFixedStep = false;
+		TArray<float> StageMs[(int32)EStage::Num];
+		//presses that never changed the movement, sprinting while already sprinting and such
+		int32 NoMotion = 0;
+	};
+
+	FLevelsInputLatency(const FString& InOutputFile);
+	~FLevelsInputLatency();
+
+	void OnBeginFrame();
+	void OnAction(ALevels_v0Character* Character, uint8 Button);
+	void OnStage(ULevelsPlayerMovementComponent* Movement, EStage Stage);
+	void OnMovementUpdated(ULevelsPlayerMovementComponent* Movement);
+
+	void Finish(const FPending& Pending, bool bMoved);
+	FSeries& FindOrAddSeries(uint8 Button, bool bFixedStep);
+
+	static FLevelsInputLatency* Instance;
+
+	FString OutputFile;
+
+	TSharedPtr<IInputProcessor> InputProcessor;
+	//last unclaimed key down per key
+	TMap<FKey, double> KeyDownSeconds;
+
+	TArray<FPending> Pending;
+	TArray<FSeries> Series;
+
+	FDelegateHandle BeginFrameHandle;
+};
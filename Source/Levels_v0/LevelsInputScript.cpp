@@ -0,0 +1,175 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsInputScript.h"
+#include "Levels_v0Character.h"
+#include "Misc/FileHelper.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogLevelsInputScript, Log, All);
+
+bool FLevelsInputFrame::LoadTrace(const FString& Filename, TArray<FLevelsInputFrame>& OutFrames)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Filename) || Lines.Num() < 2)
+	{
+		return false;
+	}
+
+	OutFrames.Reset(Lines.Num() - 1);
+
+	//first line is the header
+	for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+	{
+		TArray<FString> Fields;
+		Lines[LineIndex].ParseIntoArray(Fields, TEXT(","));
+		if (Fields.Num() == 0)
+		{
+			continue;
+		}
+		if (Fields.Num() < 5)
+		{
+			UE_LOG(LogLevelsInputScript, Warning, TEXT("%s:%d is not a time,forward,right,yaw,buttons line"), *Filename, LineIndex + 1);
+			return false;
+		}
+
+		FLevelsInputFrame Frame;
+		Frame.Time = FCString::Atof(*Fields[0]);
+		Frame.Forward = FCString::Atof(*Fields[1]);
+		Frame.Right = FCString::Atof(*Fields[2]);
+		Frame.Yaw = FCString::Atof(*Fields[3]);
+		Frame.Buttons = (uint8)FCString::Atoi(*Fields[4]);
+		OutFrames.Add(Frame);
+	}
+	return OutFrames.Num() > 0;
+}
+
+bool FLevelsInputFrame::SaveTrace(const FString& Filename, const TArray<FLevelsInputFrame>& Frames)
+{
+	FString Text = TEXT("time,forward,right,yaw,buttons\n");
+	for (const FLevelsInputFrame& Frame : Frames)
+	{
+		Text += FString::Printf(TEXT("%.4f,%.3f,%.3f,%.3f,%d\n"), Frame.Time, Frame.Forward, Frame.Right, Frame.Yaw, Frame.Buttons);
+	}
+	return FFileHelper::SaveStringToFile(Text, *Filename);
+}
+
+ULevelsScriptedInputComponent::ULevelsScriptedInputComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	//input has to land before the character and its movement tick
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+bool ULevelsScriptedInputComponent::IsBotCommandLine()
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("LevelsBot"));
+}
+
+void ULevelsScriptedInputComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	FParse::Value(FCommandLine::Get(), TEXT("LevelsBotSeed="), Seed);
+	Random.Initialize(Seed);
+
+	FString TraceFile;
+	if (Frames.Num() == 0 && FParse::Value(FCommandLine::Get(), TEXT("LevelsInputTrace="), TraceFile))
+	{
+		TArray<FLevelsInputFrame> Loaded;
+		if (FLevelsInputFrame::LoadTrace(TraceFile, Loaded))
+		{
+			SetTrace(Loaded, true);
+		}
+		else
+		{
+			UE_LOG(LogLevelsInputScript, Warning, TEXT("Could not load input trace %s, using the built-in script"), *TraceFile);
+		}
+	}
+}
+
+void ULevelsScriptedInputComponent::SetTrace(const TArray<FLevelsInputFrame>& InFrames, bool bInLoop)
+{
+	Frames = InFrames;
+	FrameIndex = 0;
+	bLoop = bInLoop;
+	Clock = 0.f;
+}
+
+void ULevelsScriptedInputComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	ALevels_v0Character* Character = Cast<ALevels_v0Character>(GetOwner());
+	if (Character == nullptr || Character->IsPoolDormant())
+	{
+		return;
+	}
+
+	const FLevelsInputFrame Frame = Frames.Num() > 0 ? NextTraceFrame(DeltaTime) : NextScriptedFrame(DeltaTime);
+	Character->ApplyInputFrame(Frame, Previous);
+	Previous = Frame;
+}
+
+FLevelsInputFrame ULevelsScriptedInputComponent::NextTraceFrame(float DeltaTime)
+{
+	Clock += DeltaTime;
+
+	while (FrameIndex + 1 < Frames.Num() && Frames[FrameIndex + 1].Time <= Clock)
+	{
+		++FrameIndex;
+	}
+
+	if (FrameIndex + 1 >= Frames.Num() && bLoop && Clock > Frames.Last().Time)
+	{
+		FrameIndex = 0;
+		Clock = 0.f;
+	}
+
+	return Frames[FrameIndex];
+}
+
+FLevelsInputFrame ULevelsScriptedInputComponent::NextScriptedFrame(float DeltaTime)
+{
+	Clock += DeltaTime;
+
+	if (Clock >= PhaseEndTime)
+	{
+		//pick the next move of the loop, each one held for a short random time
+		Phase = FLevelsInputFrame();
+		Phase.Forward = 1.f;
+		switch (Random.RandRange(0, 5))
+		{
+		case 0:
+			//plain run with a turn
+			Phase.Yaw = Random.FRandRange(-1.5f, 1.5f);
+			break;
+		case 1:
+			Phase.Buttons = ELevelsInputButton::Sprint;
+			break;
+		case 2:
+			//sprint into a slide
+			Phase.Buttons = ELevelsInputButton::Sprint | ELevelsInputButton::Crouch;
+			break;
+		case 3:
+			//jump while strafing, which is how wall runs start
+			Phase.Buttons = ELevelsInputButton::Sprint | ELevelsInputButton::Jump;
+			Phase.Right = Random.FRandRange(-1.f, 1.f);
+			break;
+		case 4:
+			Phase.Buttons = ELevelsInputButton::Fire;
+			Phase.Yaw = Random.FRandRange(-0.5f, 0.5f);
+			break;
+		default:
+			//back off and strafe so bots don't pin themselves against one wall
+			Phase.Forward = -1.f;
+			Phase.Right = Random.FRandRange(-1.f, 1.f);
+			break;
+		}
+		PhaseEndTime = Clock + Random.FRandRange(0.3f, 1.5f);
+	}
+
+	FLevelsInputFrame Frame = Phase;
+	Frame.Time = Clock;
+	return Frame;
+}
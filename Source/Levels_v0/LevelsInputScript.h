@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "LevelsInputScript.generated.h"
+
+class ALevels_v0Character;
+
+/** Buttons held during a scripted input frame */
+namespace ELevelsInputButton
+{
+	enum Type : uint8
+	{
+		Jump = 1 << 0,
+		Crouch = 1 << 1,
+		Sprint = 1 << 2,
+		Fire = 1 << 3
+	};
+}
+
+/**
+ * One frame of player input. Input traces are CSV files with a "time,forward,right,yaw,buttons"
+ * header and one of these per line, so traces recorded in game, written by the offline tools
+ * and replayed by bots all share the same format.
+ */
+struct LEVELS_V0_API FLevelsInputFrame
+{
+	float Time = 0.f;
+	float Forward = 0.f;
+	float Right = 0.f;
+	float Yaw = 0.f;
+	uint8 Buttons = 0;
+
+	bool IsHeld(ELevelsInputButton::Type Button) const { return (Buttons & Button) != 0; }
+
+	/** Loads an input trace, returns false if the file is missing or malformed */
+	static bool LoadTrace(const FString& Filename, TArray<FLevelsInputFrame>& OutFrames);
+
+	/** Saves an input trace */
+	static bool SaveTrace(const FString& Filename, const TArray<FLevelsInputFrame>& Frames);
+};
+
+/**
+ * Drives a character with scripted input, for headless bot clients and load tests. Either
+ * replays a trace given with -LevelsInputTrace=<file> or, without one, runs a seeded loop of
+ * parkour moves: run, sprint, jump, slide, strafe into walls and fire.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class LEVELS_V0_API ULevelsScriptedInputComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	ULevelsScriptedInputComponent();
+
+	virtual void BeginPlay() override;
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Replays the given frames instead of the built-in script */
+	void SetTrace(const TArray<FLevelsInputFrame>& InFrames, bool bInLoop);
+
+	/** Seed for the built-in script */
+	UPROPERTY(EditAnywhere, Category = "Input")
+		int32 Seed = 0;
+
+	/** Returns true if -LevelsBot is on the command line */
+	static bool IsBotCommandLine();
+
+private:
+
+	/** Next frame of the built-in parkour loop */
+	FLevelsInputFrame NextScriptedFrame(float DeltaTime);
+
+	/** Next frame of the trace being replayed */
+	FLevelsInputFrame NextTraceFrame(float DeltaTime);
+
+	TArray<FLevelsInputFrame> Frames;
+	int32 FrameIndex = 0;
+	bool bLoop = true;
+
+	FRandomStream Random;
+	float Clock = 0.f;
+	float PhaseEndTime = 0.f;
+	FLevelsInputFrame Phase;
+	FLevelsInputFrame Previous;
+};
@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsMemoryTags.h"
+#include "Levels_v0Character.h"
+#include "Levels_v0Projectile.h"
+#include "LevelsPlayerMovementComponent.h"
+#include "Blueprint/UserWidget.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/LowLevelMemStats.h"
+#include "Misc/CoreDelegates.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "UObject/UObjectIterator.h"
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+static_assert((int32)ELevelsLLMTag::Movement == (int32)ELLMTag::ProjectTagStart, "Levels LLM tags must start where the engine's project tags do");
+static_assert((int32)ELevelsLLMTag::CharacterComponents <= (int32)ELLMTag::ProjectTagEnd, "Levels LLM tags must stay in the project range");
+
+DECLARE_LLM_MEMORY_STAT(TEXT("Levels_v0"), STAT_LevelsLLM, STATGROUP_LLM);
+DECLARE_LLM_MEMORY_STAT(TEXT("Levels Movement"), STAT_LevelsLLMMovement, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Levels Projectiles"), STAT_LevelsLLMProjectiles, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Levels Weapon FX"), STAT_LevelsLLMWeaponFX, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Levels HUD"), STAT_LevelsLLMHUD, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Levels Character Components"), STAT_LevelsLLMCharacterComponents, STATGROUP_LLMFULL);
+#endif
+
+int64 FLevelsMemoryTags::PeakBytes[LevelsLLMTagCount] = {};
+FDelegateHandle FLevelsMemoryTags::EndFrameHandle;
+
+static const TCHAR* LevelsLLMTagNames[LevelsLLMTagCount] = {
+	TEXT("Movement"),
+	TEXT("Projectiles"),
+	TEXT("WeaponFX"),
+	TEXT("HUD"),
+	TEXT("CharacterComponents"),
+};
+
+static FAutoConsoleCommand MemReportCommand(
+	TEXT("Levels.MemReport"),
+	TEXT("Prints memory, peak, budget and live objects for each Levels_v0 LLM tag. Needs -LLM. \"Levels.MemReport reset\" clears the peaks"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			FLevelsMemoryTags::ResetPeaks();
+			return;
+		}
+
+		if (!FLevelsMemoryTags::IsTracking())
+		{
+			GLog->Log(TEXT("LLM isn't running, start with -LLM for memory amounts. Object counts only:"));
+		}
+		GLog->Logf(TEXT("%-20s %10s %10s %10s %8s"), TEXT("Tag"), TEXT("KB"), TEXT("Peak KB"), TEXT("Budget KB"), TEXT("Objects"));
+		for (const FLevelsMemoryTagReport& Line : FLevelsMemoryTags::GetReport())
+		{
+			GLog->Logf(TEXT("%-20s %10.1f %10.1f %10s %8d%s"), *Line.Name, Line.Bytes / 1024.0, Line.PeakBytes / 1024.0,
+				Line.BudgetBytes > 0 ? *FString::Printf(TEXT("%.0f"), Line.BudgetBytes / 1024.0) : TEXT("-"), Line.Objects,
+				Line.IsOverBudget() ? TEXT("  OVER BUDGET") : TEXT(""));
+		}
+	}));
+
+void FLevelsMemoryTags::Startup()
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	FLowLevelMemTracker& Tracker = FLowLevelMemTracker::Get();
+	Tracker.RegisterProjectTag((int32)ELevelsLLMTag::Movement, TEXT("LevelsMovement"), GET_STATFNAME(STAT_LevelsLLMMovement), GET_STATFNAME(STAT_LevelsLLM));
+	Tracker.RegisterProjectTag((int32)ELevelsLLMTag::Projectiles, TEXT("LevelsProjectiles"), GET_STATFNAME(STAT_LevelsLLMProjectiles), GET_STATFNAME(STAT_LevelsLLM));
+	Tracker.RegisterProjectTag((int32)ELevelsLLMTag::WeaponFX, TEXT("LevelsWeaponFX"), GET_STATFNAME(STAT_LevelsLLMWeaponFX), GET_STATFNAME(STAT_LevelsLLM));
+	Tracker.RegisterProjectTag((int32)ELevelsLLMTag::HUD, TEXT("LevelsHUD"), GET_STATFNAME(STAT_LevelsLLMHUD), GET_STATFNAME(STAT_LevelsLLM));
+	Tracker.RegisterProjectTag((int32)ELevelsLLMTag::CharacterComponents, TEXT("LevelsCharacterComponents"), GET_STATFNAME(STAT_LevelsLLMCharacterComponents), GET_STATFNAME(STAT_LevelsLLM));
+
+	if (FLowLevelMemTracker::IsEnabled())
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FLevelsMemoryTags::SamplePeaks);
+	}
+#endif
+}
+
+void FLevelsMemoryTags::Shutdown()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	EndFrameHandle.Reset();
+}
+
+bool FLevelsMemoryTags::IsTracking()
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	return FLowLevelMemTracker::IsEnabled();
+#else
+	return false;
+#endif
+}
+
+/** Bytes the tracker has against a tag right now */
+static int64 GetTagBytes(int32 Index)
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	if (FLowLevelMemTracker::IsEnabled())
+	{
+		return FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, (ELLMTag)((int32)ELevelsLLMTag::Movement + Index));
+	}
+#endif
+	return 0;
+}
+
+void FLevelsMemoryTags::SamplePeaks()
+{
+	for (int32 Index = 0; Index < LevelsLLMTagCount; ++Index)
+	{
+		PeakBytes[Index] = FMath::Max(PeakBytes[Index], GetTagBytes(Index));
+	}
+}
+
+void FLevelsMemoryTags::ResetPeaks()
+{
+	for (int32 Index = 0; Index < LevelsLLMTagCount; ++Index)
+	{
+		PeakBytes[Index] = GetTagBytes(Index);
+	}
+}
+
+/** Live objects that aren't class defaults or archetypes */
+template <typename ObjectType>
+static int32 CountLiveObjects()
+{
+	int32 Count = 0;
+	for (TObjectIterator<ObjectType> It; It; ++It)
+	{
+		Count += It->IsTemplate() ? 0 : 1;
+	}
+	return Count;
+}
+
+TArray<FLevelsMemoryTagReport> FLevelsMemoryTags::GetReport()
+{
+	SamplePeaks();
+
+	const ULevelsMemoryBudgets* Budgets = GetDefault<ULevelsMemoryBudgets>();
+	const int32 BudgetKB[LevelsLLMTagCount] = { Budgets->MovementKB, Budgets->ProjectilesKB, Budgets->WeaponFXKB, Budgets->HUDKB, Budgets->CharacterComponentsKB };
+
+	//components of every live character, whatever their class
+	int32 CharacterComponents = 0;
+	for (TObjectIterator<ALevels_v0Character> It; It; ++It)
+	{
+		if (!It->IsTemplate())
+		{
+			CharacterComponents += It->GetComponents().Num();
+		}
+	}
+
+	const int32 Objects[LevelsLLMTagCount] = {
+		CountLiveObjects<ULevelsPlayerMovementComponent>(),
+		CountLiveObjects<ALevels_v0Projectile>(),
+		CountLiveObjects<UParticleSystemComponent>(),
+		CountLiveObjects<UUserWidget>(),
+		CharacterComponents
+	};
+
+	TArray<FLevelsMemoryTagReport> Report;
+	for (int32 Index = 0; Index < LevelsLLMTagCount; ++Index)
+	{
+		FLevelsMemoryTagReport& Line = Report.AddDefaulted_GetRef();
+		Line.Name = LevelsLLMTagNames[Index];
+		Line.Bytes = GetTagBytes(Index);
+		Line.PeakBytes = PeakBytes[Index];
+		Line.BudgetBytes = (int64)BudgetKB[Index] * 1024;
+		Line.Objects = Objects[Index];
+	}
+	return Report;
+}
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "UObject/Object.h"
+#include "LevelsMemoryTags.generated.h"
+
+/**
+ * Low level memory tracker tags for this module, in the range the engine leaves to projects. Run with -LLM
+ * to see them under "stat LLMFULL", or print them with peaks, object counts and budgets with Levels.MemReport.
+ */
+enum class ELevelsLLMTag : uint8
+{
+	Movement = 150,
+	Projectiles,
+	WeaponFX,
+	HUD,
+	CharacterComponents,
+};
+
+static const int32 LevelsLLMTagCount = 5;
+
+/** Tags the allocations made in the rest of the scope, compiles to nothing where LLM is compiled out */
+#define LEVELS_LLM_SCOPE(Tag) LLM_SCOPE((ELLMTag)ELevelsLLMTag::Tag)
+
+/** One tag's line of the memory report */
+struct FLevelsMemoryTagReport
+{
+	FString Name;
+	int64 Bytes = 0;
+	//highest amount seen at the end of a frame since the last reset
+	int64 PeakBytes = 0;
+	//zero for no budget
+	int64 BudgetBytes = 0;
+	//live objects of the kind the tag covers
+	int32 Objects = 0;
+
+	bool IsOverBudget() const { return BudgetBytes > 0 && PeakBytes > BudgetBytes; }
+};
+
+/**
+ * Registers the tags and keeps their peaks. Started by the game module; the peaks are sampled at the end of
+ * every frame while LLM is running.
+ */
+class LEVELS_V0_API FLevelsMemoryTags
+{
+public:
+
+	static void Startup();
+
+	static void Shutdown();
+
+	/** Whether the tracker is running, without -LLM every amount reads zero */
+	static bool IsTracking();
+
+	/** Current, peak and budget for every tag */
+	static TArray<FLevelsMemoryTagReport> GetReport();
+
+	static void ResetPeaks();
+
+	/** Folds the current amounts into the peaks, done every engine frame already */
+	static void SamplePeaks();
+
+private:
+
+	static int64 PeakBytes[LevelsLLMTagCount];
+	static FDelegateHandle EndFrameHandle;
+};
+
+/**
+ * Per tag memory budgets, for servers and low end clients set them in the platform or server Game ini:
+ *
+ *   [/Script/Levels_v0.LevelsMemoryBudgets]
+ *   MovementKB=512
+ *
+ * Levels.MemReport marks tags whose peak went over, and the Levels.Memory.Budgets automation test fails on them.
+ */
+UCLASS(config = Game)
+class LEVELS_V0_API ULevelsMemoryBudgets : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(Config)
+		int32 MovementKB = 0;
+
+	UPROPERTY(Config)
+		int32 ProjectilesKB = 0;
+
+	UPROPERTY(Config)
+		int32 WeaponFXKB = 0;
+
+	UPROPERTY(Config)
+		int32 HUDKB = 0;
+
+	UPROPERTY(Config)
+		int32 CharacterComponentsKB = 0;
+};
@@ -0,0 +1,402 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsMultiWorldCommandlet.h"
+#include "Levels_v0Character.h"
+#include "Levels_v0GameMode.h"
+#include "LevelsCharacterPool.h"
+#include "LevelsCosmeticEvents.h"
+#include "LevelsInputScript.h"
+#include "LevelsPlayerMovementComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerStart.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogLevelsMultiWorld, Log, All);
+
+ULevelsMultiWorldCommandlet::ULevelsMultiWorldCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+#if WITH_EDITOR
+
+namespace
+{
+	/** What one character did during the run */
+	struct FMultiWorldCharacter
+	{
+		TWeakObjectPtr<ALevels_v0Character> Character;
+		int32 Seed = 0;
+		FVector LastLocation = FVector::ZeroVector;
+		float Distance = 0.f;
+		float MaxSpeed = 0.f;
+		float MinZ = MAX_flt;
+		//a bit per custom movement mode the character was in
+		uint32 CustomModes = 0;
+		bool bFellOut = false;
+	};
+
+	/** One isolated game world and its game instance */
+	struct FMultiWorldInstance
+	{
+		UWorld* World = nullptr;
+		UGameInstance* GameInstance = nullptr;
+		int32 PIEInstance = 0;
+		TArray<FMultiWorldCharacter> Characters;
+		int32 Shots = 0;
+		FDelegateHandle CosmeticEventHandle;
+	};
+
+	/** Makes a world the current one while it is set up or ticked, like the engine does between PIE instances */
+	struct FMultiWorldScope
+	{
+		UWorld* PreviousWorld;
+		int32 PreviousPIEInstance;
+
+		explicit FMultiWorldScope(const FMultiWorldInstance& Instance)
+			: PreviousWorld(GWorld)
+			, PreviousPIEInstance(GPlayInEditorID)
+		{
+			GWorld = Instance.World;
+			GPlayInEditorID = Instance.PIEInstance;
+		}
+
+		~FMultiWorldScope()
+		{
+			GWorld = PreviousWorld;
+			GPlayInEditorID = PreviousPIEInstance;
+		}
+	};
+}
+
+/** Copies the loaded map into a new game world with its own game instance and starts play in it */
+static bool CreateWorldInstance(const FString& MapPackageName, const FURL& URL, FMultiWorldInstance& Instance)
+{
+	//the PIE instance id gives every copy its own package name and points soft references at the right copy
+	GPlayInEditorID = Instance.PIEInstance;
+	UWorld* World = UWorld::DuplicateWorldForPIE(MapPackageName, nullptr);
+	if (World == nullptr)
+	{
+		return false;
+	}
+	World->AddToRoot();
+	World->WorldType = EWorldType::Game;
+
+	UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+	GameInstance->InitializeStandalone(*FString::Printf(TEXT("LevelsMultiWorld%d"), Instance.PIEInstance));
+
+	//swap the placeholder world the game instance starts with for the copy of the map
+	FWorldContext* Context = GameInstance->GetWorldContext();
+	UWorld* PlaceholderWorld = Context->World();
+	Context->PIEInstance = Instance.PIEInstance;
+	Context->SetCurrentWorld(World);
+	PlaceholderWorld->DestroyWorld(false);
+	World->SetGameInstance(GameInstance);
+
+	Instance.World = World;
+	Instance.GameInstance = GameInstance;
+
+	FMultiWorldScope Scope(Instance);
+	World->InitWorld();
+	if (!World->SetGameMode(URL))
+	{
+		return false;
+	}
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	return World->GetAuthGameMode<ALevels_v0GameMode>() != nullptr;
+}
+
+/** Checks characters out of the world's pool at its player starts and gives each one scripted input */
+static void SpawnCharacters(FMultiWorldInstance& Instance, int32 Count, int32 BaseSeed, const TArray<FLevelsInputFrame>* Trace)
+{
+	UWorld* World = Instance.World;
+	FMultiWorldScope Scope(Instance);
+
+	const ALevels_v0GameMode* GameMode = World->GetAuthGameMode<ALevels_v0GameMode>();
+	UClass* PawnClass = GameMode->DefaultPawnClass;
+	ULevelsCharacterPool* Pool = World->GetSubsystem<ULevelsCharacterPool>();
+	if (PawnClass == nullptr || !PawnClass->IsChildOf(ALevels_v0Character::StaticClass()) || Pool == nullptr)
+	{
+		UE_LOG(LogLevelsMultiWorld, Error, TEXT("%s has no Levels_v0 character to spawn"), *World->GetName());
+		return;
+	}
+
+	TArray<FTransform> Starts;
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	{
+		Starts.Add(It->GetActorTransform());
+	}
+	if (Starts.Num() == 0)
+	{
+		Starts.Add(FTransform::Identity);
+	}
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		//characters sharing a start are lined up to its side
+		FTransform SpawnTransform = Starts[Index % Starts.Num()];
+		SpawnTransform.AddToTranslation(SpawnTransform.GetRotation().GetRightVector() * 150.f * (Index / Starts.Num()));
+
+		ALevels_v0Character* Character = Pool->Acquire(PawnClass, SpawnTransform);
+		if (Character == nullptr)
+		{
+			continue;
+		}
+		Character->SpawnDefaultController();
+
+		FMultiWorldCharacter& Result = Instance.Characters.AddDefaulted_GetRef();
+		Result.Character = Character;
+		Result.Seed = BaseSeed + Instance.PIEInstance * 100 + Index;
+		Result.LastLocation = Character->GetActorLocation();
+
+		ULevelsScriptedInputComponent* ScriptedInput = Character->FindComponentByClass<ULevelsScriptedInputComponent>();
+		if (ScriptedInput == nullptr)
+		{
+			ScriptedInput = NewObject<ULevelsScriptedInputComponent>(Character, TEXT("ScriptedInput"));
+			ScriptedInput->Seed = Result.Seed;
+			ScriptedInput->RegisterComponent();
+		}
+		if (Trace)
+		{
+			ScriptedInput->SetTrace(*Trace, true);
+		}
+	}
+}
+
+/** Adds one step of every character's movement to its results */
+static void RecordStep(FMultiWorldInstance& Instance)
+{
+	for (FMultiWorldCharacter& Result : Instance.Characters)
+	{
+		//falling out of the world destroys the character
+		const ALevels_v0Character* Character = Result.Character.Get();
+		if (Character == nullptr || Character->IsPendingKill())
+		{
+			Result.bFellOut = true;
+			continue;
+		}
+
+		const FVector Location = Character->GetActorLocation();
+		Result.Distance += FVector::Dist(Location, Result.LastLocation);
+		Result.LastLocation = Location;
+		Result.MaxSpeed = FMath::Max(Result.MaxSpeed, Character->GetVelocity().Size());
+		Result.MinZ = FMath::Min(Result.MinZ, Location.Z);
+
+		const UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+		if (Movement && Movement->CustomMovementMode != MOVE_CustomNone && Movement->CustomMovementMode < 32)
+		{
+			Result.CustomModes |= 1u << Movement->CustomMovementMode;
+		}
+	}
+}
+
+/** Ends play in the world and lets go of it and its game instance */
+static void DestroyWorldInstance(FMultiWorldInstance& Instance)
+{
+	if (Instance.World)
+	{
+		FMultiWorldScope Scope(Instance);
+		if (ULevelsCosmeticEvents* CosmeticEvents = Instance.World->GetSubsystem<ULevelsCosmeticEvents>())
+		{
+			CosmeticEvents->OnCosmeticEvent.Remove(Instance.CosmeticEventHandle);
+		}
+		Instance.World->DestroyWorld(false);
+		Instance.World->RemoveFromRoot();
+	}
+	if (Instance.GameInstance)
+	{
+		Instance.GameInstance->Shutdown();
+		Instance.GameInstance->RemoveFromRoot();
+	}
+	if (Instance.World)
+	{
+		GEngine->DestroyWorldContext(Instance.World);
+	}
+}
+
+#endif
+
+int32 ULevelsMultiWorldCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString MapName;
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogLevelsMultiWorld, Error, TEXT("Usage: -run=LevelsMultiWorld -Map=/Game/Path/To/Map [-Worlds=8] [-Characters=2] [-Seconds=30] [-StepRate=60] [-Seed=0] [-Traces=a.csv+b.csv] [-Out=file.csv]"));
+		return 1;
+	}
+
+	int32 NumWorlds = 8;
+	int32 NumCharacters = 2;
+	float Seconds = 30.f;
+	int32 StepRate = 60;
+	int32 Seed = 0;
+	FParse::Value(*Params, TEXT("Worlds="), NumWorlds);
+	FParse::Value(*Params, TEXT("Characters="), NumCharacters);
+	FParse::Value(*Params, TEXT("Seconds="), Seconds);
+	FParse::Value(*Params, TEXT("StepRate="), StepRate);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	NumWorlds = FMath::Max(1, NumWorlds);
+	StepRate = FMath::Max(10, StepRate);
+
+	FString OutputFile = TEXT("MultiWorld/Results.csv");
+	FParse::Value(*Params, TEXT("Out="), OutputFile);
+	if (FPaths::IsRelative(OutputFile))
+	{
+		OutputFile = FPaths::ProjectSavedDir() / OutputFile;
+	}
+
+	//"+" separated since FParse stops values at commas
+	TArray<TArray<FLevelsInputFrame>> Traces;
+	FString TraceList;
+	if (FParse::Value(*Params, TEXT("Traces="), TraceList))
+	{
+		TArray<FString> TraceFiles;
+		TraceList.ParseIntoArray(TraceFiles, TEXT("+"));
+		for (const FString& TraceFile : TraceFiles)
+		{
+			if (!FLevelsInputFrame::LoadTrace(TraceFile, Traces.AddDefaulted_GetRef()))
+			{
+				UE_LOG(LogLevelsMultiWorld, Error, TEXT("Could not load input trace %s"), *TraceFile);
+				return 1;
+			}
+		}
+	}
+
+	//loaded once, every world is a copy of it and shares the assets it references
+	UPackage* MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* MapWorld = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+	if (MapWorld == nullptr)
+	{
+		UE_LOG(LogLevelsMultiWorld, Error, TEXT("Could not load map %s"), *MapName);
+		return 1;
+	}
+	MapWorld->AddToRoot();
+
+	const FURL URL;
+	const int32 PreviousPIEInstance = GPlayInEditorID;
+
+	//reserved up front, the event handlers hold on to their instance
+	TArray<FMultiWorldInstance> Instances;
+	Instances.Reserve(NumWorlds);
+
+	bool bCreated = true;
+	for (int32 WorldIndex = 0; WorldIndex < NumWorlds && bCreated; ++WorldIndex)
+	{
+		FMultiWorldInstance& Instance = Instances.AddDefaulted_GetRef();
+		Instance.PIEInstance = WorldIndex;
+
+		bCreated = CreateWorldInstance(MapPackage->GetName(), URL, Instance);
+		if (!bCreated)
+		{
+			UE_LOG(LogLevelsMultiWorld, Error, TEXT("Could not start world %d of %s with a Levels_v0 game mode"), WorldIndex, *MapName);
+			break;
+		}
+
+		//shots are hitscan, the weapon publishes one event per shot
+		if (ULevelsCosmeticEvents* CosmeticEvents = Instance.World->GetSubsystem<ULevelsCosmeticEvents>())
+		{
+			FMultiWorldInstance* InstancePtr = &Instance;
+			Instance.CosmeticEventHandle = CosmeticEvents->OnCosmeticEvent.AddLambda([InstancePtr](const FLevelsCosmeticEvent& Event)
+			{
+				if (Event.Type == ELevelsCosmeticEvent::ShotFired)
+				{
+					++InstancePtr->Shots;
+				}
+			});
+		}
+
+		SpawnCharacters(Instance, NumCharacters, Seed, Traces.Num() > 0 ? &Traces[WorldIndex % Traces.Num()] : nullptr);
+	}
+
+	int32 Failures = 0;
+	if (bCreated)
+	{
+		//the worlds are isolated but the gameplay framework isn't safe to tick on several threads, so they
+		//take turns on this one and each world's tick still spreads its own work over the task graph
+		const float DeltaTime = 1.f / StepRate;
+		const int32 NumSteps = FMath::CeilToInt(Seconds * StepRate);
+		FApp::SetUseFixedTimeStep(true);
+		FApp::SetFixedDeltaTime(DeltaTime);
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Step = 0; Step < NumSteps; ++Step)
+		{
+			FApp::SetDeltaTime(DeltaTime);
+			FApp::SetCurrentTime(FApp::GetCurrentTime() + DeltaTime);
+
+			//the world tick also ticks the tickable subsystems bound to it, the cosmetic event queue among them
+			for (FMultiWorldInstance& Instance : Instances)
+			{
+				FMultiWorldScope Scope(Instance);
+				Instance.World->Tick(LEVELTICK_All, DeltaTime);
+				RecordStep(Instance);
+			}
+
+			//timers and latent actions run once per frame number
+			++GFrameCounter;
+		}
+		const double WallSeconds = FPlatformTime::Seconds() - StartTime;
+
+		FString Text = TEXT("world,character,seed,distance,max_speed,min_z,custom_modes,shots,result\n");
+		for (const FMultiWorldInstance& Instance : Instances)
+		{
+			int32 WorldFailures = 0;
+			float WorldDistance = 0.f;
+			for (int32 CharacterIndex = 0; CharacterIndex < Instance.Characters.Num(); ++CharacterIndex)
+			{
+				const FMultiWorldCharacter& Result = Instance.Characters[CharacterIndex];
+				const bool bStuck = Result.Distance < 100.f;
+				const TCHAR* Outcome = Result.bFellOut ? TEXT("fell out") : bStuck ? TEXT("stuck") : TEXT("ok");
+				WorldFailures += (Result.bFellOut || bStuck) ? 1 : 0;
+				WorldDistance += Result.Distance;
+
+				Text += FString::Printf(TEXT("%d,%d,%d,%.0f,%.0f,%.0f,0x%x,%d,%s\n"), Instance.PIEInstance, CharacterIndex, Result.Seed,
+					Result.Distance, Result.MaxSpeed, Result.MinZ, Result.CustomModes, Instance.Shots, Outcome);
+			}
+
+			UE_LOG(LogLevelsMultiWorld, Display, TEXT("World %d: %d characters, %.0f units run, %d shots, %d failed"),
+				Instance.PIEInstance, Instance.Characters.Num(), WorldDistance, Instance.Shots, WorldFailures);
+			Failures += WorldFailures;
+		}
+
+		UE_LOG(LogLevelsMultiWorld, Display, TEXT("Simulated %d worlds for %.1fs each in %.1fs"), Instances.Num(), Seconds, WallSeconds);
+
+		if (!FFileHelper::SaveStringToFile(Text, *OutputFile))
+		{
+			UE_LOG(LogLevelsMultiWorld, Error, TEXT("Could not write %s"), *OutputFile);
+		}
+	}
+
+	for (FMultiWorldInstance& Instance : Instances)
+	{
+		DestroyWorldInstance(Instance);
+	}
+	GPlayInEditorID = PreviousPIEInstance;
+	MapWorld->RemoveFromRoot();
+	CollectGarbage(RF_NoFlags);
+
+	if (!bCreated)
+	{
+		return 1;
+	}
+	return Failures > 0 ? 2 : 0;
+#else
+	UE_LOG(LogLevelsMultiWorld, Error, TEXT("LevelsMultiWorld duplicates worlds the way play in editor does and needs an editor build"));
+	return 1;
+#endif
+}
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LevelsMultiWorldCommandlet.generated.h"
+
+/**
+ * Runs many movement and weapon scenarios in one process. The map is loaded once and duplicated
+ * into several game worlds, each with its own game instance, ALevels_v0GameMode and characters
+ * driven by scripted input, so the worlds share every loaded asset but no gameplay state. Worlds
+ * are stepped one after another at a fixed rate and each one is reported on its own.
+ *
+ *   UE4Editor-Cmd Levels_v0.uproject -run=LevelsMultiWorld -nullrhi -Map=/Game/PolygonPrototype/Maps/Demonstration
+ *       [-Worlds=8] [-Characters=2] [-Seconds=30] [-StepRate=60] [-Seed=0] [-Traces=a.csv+b.csv] [-Out=MultiWorld/Results.csv]
+ *
+ * Without -Traces every character runs the seeded parkour loop of ULevelsScriptedInputComponent,
+ * with traces world N replays trace N modulo the count. Returns 2 if a character fell out of its
+ * world or never moved.
+ */
+UCLASS()
+class LEVELS_V0_API ULevelsMultiWorldCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	ULevelsMultiWorldCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,283 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsPerfCapture.h"
+#include "Levels_v0Character.h"
+#include "LevelsPlayerMovementComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogLevelsPerfCapture, Log, All);
+
+CSV_DEFINE_CATEGORY(LevelsParkour, true);
+
+bool ULevelsPerfCapture::ShouldCreateSubsystem(UObject* Outer) const
+{
+	const UWorld* World = Cast<UWorld>(Outer);
+	FString File;
+	return World && World->IsGameWorld() && !IsRunningDedicatedServer() && FParse::Value(FCommandLine::Get(), TEXT("LevelsPerfCapture="), File) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void ULevelsPerfCapture::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FString RouteFile;
+	FParse::Value(FCommandLine::Get(), TEXT("LevelsPerfCapture="), RouteFile);
+	if (!FLevelsInputFrame::LoadTrace(RouteFile, Route))
+	{
+		UE_LOG(LogLevelsPerfCapture, Error, TEXT("Could not load route %s, nothing will be captured"), *RouteFile);
+		State = ECaptureState::Done;
+		return;
+	}
+
+	//relative paths are under Saved, ProfilingDir itself is already relative to the binaries so it is not a default
+	OutputDir = TEXT("Profiling/LevelsPerf");
+	FParse::Value(FCommandLine::Get(), TEXT("LevelsPerfCaptureOut="), OutputDir);
+	if (FPaths::IsRelative(OutputDir))
+	{
+		OutputDir = FPaths::ProjectSavedDir() / OutputDir;
+	}
+	FParse::Value(FCommandLine::Get(), TEXT("LevelsPerfCaptureWarmup="), WarmupSeconds);
+
+	MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+}
+
+ETickableTickType ULevelsPerfCapture::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool ULevelsPerfCapture::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return State != ECaptureState::Done && World && World->HasBegunPlay();
+}
+
+TStatId ULevelsPerfCapture::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULevelsPerfCapture, STATGROUP_Tickables);
+}
+
+UWorld* ULevelsPerfCapture::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void ULevelsPerfCapture::Tick(float DeltaTime)
+{
+	//wall clock, the route plays back in real time
+	StateSeconds += (float)FApp::GetDeltaTime();
+
+	switch (State)
+	{
+	case ECaptureState::WaitingForCharacter:
+	{
+		const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+		Character = Cast<ALevels_v0Character>(PlayerController ? PlayerController->GetPawn() : nullptr);
+		if (Character.IsValid())
+		{
+			State = ECaptureState::WarmingUp;
+			StateSeconds = 0.f;
+		}
+	}
+	break;
+	case ECaptureState::WarmingUp:
+	{
+		//streaming and shader hitches right after spawning aren't what we're measuring
+		if (StateSeconds >= WarmupSeconds)
+		{
+			StartCapture();
+		}
+	}
+	break;
+	case ECaptureState::Capturing:
+	{
+		if (!Character.IsValid() || Character->IsPoolDormant())
+		{
+			UE_LOG(LogLevelsPerfCapture, Warning, TEXT("The character died or was removed before the end of the route"));
+			EndCapture();
+		}
+		else if (StateSeconds > Route.Last().Time)
+		{
+			EndCapture();
+		}
+		else
+		{
+			RecordFrame();
+		}
+	}
+	break;
+	case ECaptureState::Finishing:
+	{
+		//the profiler writes its file on another thread, quitting before it's done would cut it short
+		if (!CsvFile.IsValid() || CsvFile.IsReady())
+		{
+			if (CsvFile.IsValid())
+			{
+				UE_LOG(LogLevelsPerfCapture, Display, TEXT("Wrote %s"), *CsvFile.Get());
+			}
+			State = ECaptureState::Done;
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+	break;
+	default:
+		break;
+	}
+}
+
+void ULevelsPerfCapture::StartCapture()
+{
+	ALevels_v0Character* Player = Character.Get();
+	ULevelsScriptedInputComponent* ScriptedInput = Player->FindComponentByClass<ULevelsScriptedInputComponent>();
+	if (ScriptedInput == nullptr)
+	{
+		ScriptedInput = NewObject<ULevelsScriptedInputComponent>(Player, TEXT("ScriptedInput"));
+		ScriptedInput->RegisterComponent();
+	}
+	ScriptedInput->SetTrace(Route, false);
+
+	LastSceneQueries = Player->CharacterMovement->GetMovementCounters().SceneQueries;
+	PreviousKey.Empty();
+	Samples.Reset();
+
+#if CSV_PROFILER
+	CSV_METADATA(TEXT("LevelsMap"), *MapName);
+	FCsvProfiler::Get()->BeginCapture(-1, OutputDir, MapName + TEXT(".csv"));
+#else
+	UE_LOG(LogLevelsPerfCapture, Warning, TEXT("This build has no CSV profiler, only the per mode summary will be written"));
+#endif
+
+	UE_LOG(LogLevelsPerfCapture, Display, TEXT("Capturing %s over a %.1fs route"), *MapName, Route.Last().Time);
+	State = ECaptureState::Capturing;
+	StateSeconds = 0.f;
+}
+
+FString ULevelsPerfCapture::GetModeKey() const
+{
+	const ALevels_v0Character* Player = Character.Get();
+	const ULevelsPlayerMovementComponent* Movement = Player->CharacterMovement;
+
+	//parkour modes run on top of walking or falling, they take precedence when set
+	FString Key;
+	if (Movement->CustomMovementMode != MOVE_CustomNone)
+	{
+		Key = StaticEnum<ECustomMovementMode>()->GetNameStringByValue(Movement->CustomMovementMode);
+	}
+	else
+	{
+		Key = StaticEnum<EMovementMode>()->GetNameStringByValue(Movement->MovementMode);
+	}
+	Key.RemoveFromStart(TEXT("MOVE_"));
+
+	if (Player->IsFiring())
+	{
+		Key += TEXT(" firing");
+	}
+	return Key;
+}
+
+void ULevelsPerfCapture::RecordFrame()
+{
+	const ALevels_v0Character* Player = Character.Get();
+	const ULevelsPlayerMovementComponent* Movement = Player->CharacterMovement;
+
+	const int32 SceneQueries = Movement->GetMovementCounters().SceneQueries;
+	const int32 FrameSceneQueries = SceneQueries - LastSceneQueries;
+	LastSceneQueries = SceneQueries;
+
+	CSV_CUSTOM_STAT(LevelsParkour, MovementMode, (int32)Movement->MovementMode, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(LevelsParkour, CustomMovementMode, (int32)Movement->CustomMovementMode, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(LevelsParkour, Firing, Player->IsFiring() ? 1 : 0, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(LevelsParkour, SceneQueries, FrameSceneQueries, ECsvCustomStatOp::Set);
+
+	const FString Key = GetModeKey();
+	if (Movement->MovementMode != LastMovementMode || Movement->CustomMovementMode != LastCustomMovementMode)
+	{
+		CSV_EVENT(LevelsParkour, TEXT("%s"), *Key);
+		LastMovementMode = Movement->MovementMode;
+		LastCustomMovementMode = Movement->CustomMovementMode;
+	}
+
+	//the delta is how long the frame before took, and the same for the time the game thread wasn't idle
+	if (!PreviousKey.IsEmpty())
+	{
+		FModeSamples& Previous = Samples.FindOrAdd(PreviousKey);
+		Previous.FrameMs.Add((float)(FApp::GetDeltaTime() * 1000.0));
+		Previous.WorkMs.Add((float)(FMath::Max(0.0, FApp::GetDeltaTime() - FApp::GetIdleTime()) * 1000.0));
+	}
+
+	//the queries were made by this frame's movement, which already ran
+	Samples.FindOrAdd(Key).SceneQueries.Add(FrameSceneQueries);
+	PreviousKey = Key;
+}
+
+void ULevelsPerfCapture::EndCapture()
+{
+#if CSV_PROFILER
+	CsvFile = FCsvProfiler::Get()->EndCapture();
+#endif
+	WriteModeSummary();
+	State = ECaptureState::Finishing;
+}
+
+/** Value below which Percent of the sorted values fall */
+template <typename T>
+static T Percentile(const TArray<T>& Sorted, float Percent)
+{
+	if (Sorted.Num() == 0)
+	{
+		return T(0);
+	}
+	const int32 Index = FMath::Clamp(FMath::RoundToInt(Percent / 100.f * (Sorted.Num() - 1)), 0, Sorted.Num() - 1);
+	return Sorted[Index];
+}
+
+void ULevelsPerfCapture::WriteModeSummary() const
+{
+	int32 TotalFrames = 0;
+	for (const TPair<FString, FModeSamples>& Pair : Samples)
+	{
+		TotalFrames += Pair.Value.SceneQueries.Num();
+	}
+
+	FString Text = TEXT("map,mode,frames,share,frame_ms_p50,frame_ms_p95,frame_ms_p99,frame_ms_max,work_ms_p50,work_ms_p95,work_ms_max,queries_mean,queries_p95,queries_max\n");
+	for (const TPair<FString, FModeSamples>& Pair : Samples)
+	{
+		TArray<float> FrameMs = Pair.Value.FrameMs;
+		TArray<float> WorkMs = Pair.Value.WorkMs;
+		TArray<int32> SceneQueries = Pair.Value.SceneQueries;
+		FrameMs.Sort();
+		WorkMs.Sort();
+		SceneQueries.Sort();
+
+		int64 QueryTotal = 0;
+		for (const int32 Queries : SceneQueries)
+		{
+			QueryTotal += Queries;
+		}
+		const int32 Frames = SceneQueries.Num();
+
+		Text += FString::Printf(TEXT("%s,%s,%d,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%d,%d\n"),
+			*MapName, *Pair.Key, Frames, TotalFrames > 0 ? (float)Frames / TotalFrames : 0.f,
+			Percentile(FrameMs, 50.f), Percentile(FrameMs, 95.f), Percentile(FrameMs, 99.f), FrameMs.Num() > 0 ? FrameMs.Last() : 0.f,
+			Percentile(WorkMs, 50.f), Percentile(WorkMs, 95.f), WorkMs.Num() > 0 ? WorkMs.Last() : 0.f,
+			Frames > 0 ? (float)QueryTotal / Frames : 0.f, Percentile(SceneQueries, 95.f), Frames > 0 ? SceneQueries.Last() : 0);
+	}
+
+	const FString SummaryFile = OutputDir / (MapName + TEXT("_modes.csv"));
+	if (FFileHelper::SaveStringToFile(Text, *SummaryFile))
+	{
+		UE_LOG(LogLevelsPerfCapture, Display, TEXT("Wrote %s, %d frames in %d modes"), *SummaryFile, TotalFrames, Samples.Num());
+	}
+	else
+	{
+		UE_LOG(LogLevelsPerfCapture, Error, TEXT("Could not write %s"), *SummaryFile);
+	}
+}
@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Async/Future.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LevelsInputScript.h"
+#include "LevelsPerfCapture.generated.h"
+
+class ALevels_v0Character;
+
+/**
+ * Scripted performance capture, enabled with -LevelsPerfCapture=<input trace>. Once the local player's
+ * character is in the map and has had a moment to settle it replays the trace (a route recorded in game
+ * or written by ParkourRoute), runs the CSV profiler over it and quits. Every profiler frame is tagged
+ * with the movement mode, the trigger and the parkour scene queries of that frame.
+ *
+ * Next to the profiler's <map>.csv it writes <map>_modes.csv with frame time, game thread work and scene
+ * query distributions for each movement mode, firing or not, so the expensive parkour actions stand out
+ * rather than just the slow frames. Scripts/PerfCapture/run_perf_capture.py runs it over several maps.
+ *
+ *   -LevelsPerfCaptureOut=<dir>        where both files go, relative to Saved, default Saved/Profiling/LevelsPerf
+ *   -LevelsPerfCaptureWarmup=<seconds> wait after the character spawns, default 2
+ */
+UCLASS()
+class LEVELS_V0_API ULevelsPerfCapture : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	// End of FTickableGameObject
+
+private:
+
+	enum class ECaptureState : uint8
+	{
+		WaitingForCharacter,
+		WarmingUp,
+		Capturing,
+		Finishing,
+		Done
+	};
+
+	/** Everything recorded while in one mode */
+	struct FModeSamples
+	{
+		TArray<float> FrameMs;
+		TArray<float> WorkMs;
+		TArray<int32> SceneQueries;
+	};
+
+	/** Hands the route to the character's scripted input and starts the profiler */
+	void StartCapture();
+
+	/** Tags the profiler frame and adds it to the samples of the current mode */
+	void RecordFrame();
+
+	/** Stops the profiler and writes the per mode summary */
+	void EndCapture();
+
+	/** Movement mode of the character as a name, with " firing" added while the trigger is held */
+	FString GetModeKey() const;
+
+	/** Writes <map>_modes.csv */
+	void WriteModeSummary() const;
+
+	TArray<FLevelsInputFrame> Route;
+	FString OutputDir;
+	FString MapName;
+	float WarmupSeconds = 2.f;
+
+	ECaptureState State = ECaptureState::WaitingForCharacter;
+	float StateSeconds = 0.f;
+	TWeakObjectPtr<ALevels_v0Character> Character;
+
+	//frame times only arrive the frame after, so they go to the mode of the frame before
+	FString PreviousKey;
+	int32 LastSceneQueries = 0;
+	uint8 LastMovementMode = 0;
+	uint8 LastCustomMovementMode = 0;
+	TMap<FString, FModeSamples> Samples;
+
+	TSharedFuture<FString> CsvFile;
+};
@@ -2,6 +2,14 @@
 
 #include "Levels_v0Character.h"
 #include "LevelsPlayerMovementComponent.h"
+#include "LevelsServerMetrics.h"
+#include "LevelsHitchWatchdog.h"
+#include "LevelsMemoryTags.h"
+#include "LevelsInputLatency.h"
+#include "LevelsCosmeticEvents.h"
+#include "LevelsAssetManager.h"
+#include "LevelsInputScript.h"
+#include "GameFramework/PlayerController.h"
 #include "GameFramework/Character.h"
 #include "Engine/Classes/Engine/World.h"
 #include "Kismet/KismetSystemLibrary.h"
@@ -12,68 +20,224 @@
 #include "Engine/Classes/GameFramework/Controller.h"
 #include "Engine/Classes/Components/CapsuleComponent.h"
 
-ULevelsPlayerMovementComponent::ULevelsPlayerMovementComponent(const FObjectInitializer& ObjectInitializer)
-	: Super(ObjectInitializer)
+//the core keeps the mode in the same byte the engine replicates
+static_assert((uint8)LevelsParkour::EParkourMode::Crouch == MOVE_Crouch && (uint8)LevelsParkour::EParkourMode::RightWallRun == MOVE_RightWallRun, "EParkourMode must match ECustomMovementMode");
+
+static FORCEINLINE LevelsParkour::FVec3 ToParkour(const FVector& V)
 {
+	return LevelsParkour::FVec3(V.X, V.Y, V.Z);
 }
 
-void ULevelsPlayerMovementComponent::WallMovementCheck()
+static FORCEINLINE FVector ToEngine(const LevelsParkour::FVec3& V)
 {
-	if (bWallRunEnabled)
+	return FVector(V.X, V.Y, V.Z);
+}
+
+static LevelsParkour::EBaseMovement ToBaseMovement(EMovementMode Mode)
+{
+	switch (Mode)
 	{
-		WallRunUpdate();
+	case MOVE_None:
+		return LevelsParkour::EBaseMovement::None;
+	case MOVE_Walking:
+	case MOVE_NavWalking:
+		return LevelsParkour::EBaseMovement::Walking;
+	case MOVE_Falling:
+		return LevelsParkour::EBaseMovement::Falling;
+	default:
+		return LevelsParkour::EBaseMovement::Other;
 	}
-	if (bWallClimbEnabled)
+}
+
+/** Times the game thread work of one entry point into the component's counters */
+struct FLevelsMovementCounterScope
+{
+	ULevelsPlayerMovementComponent& Movement;
+	const uint64 StartCycles;
+
+	explicit FLevelsMovementCounterScope(ULevelsPlayerMovementComponent& InMovement)
+		: Movement(InMovement)
+		, StartCycles(FPlatformTime::Cycles64())
 	{
-		WallClimbUpdate();
+		Movement.BeginCounterFrame();
 	}
-	if (bMantleCheckEnabled)
+
+	~FLevelsMovementCounterScope()
 	{
-		if (MantleCheck())
-		{
-			MantleStart();
-		}
+		Movement.AddCounterCycles(FPlatformTime::Cycles64() - StartCycles);
 	}
-	if (bMantleEnabled) {
-		MantleMovement();
-	}
-	if (bSprintEnabled) {
-		SprintUpdate();
-	}
-	if (bSlidingEnabled)
+};
+
+ULevelsPlayerMovementComponent::ULevelsPlayerMovementComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	LEVELS_LLM_SCOPE(Movement);
+
+	for (int32 Index = 0; Index < (int32)ELevelsParkourCooldown::Num; ++Index)
 	{
-		SlideUpdate();
+		CooldownStep[Index] = INDEX_NONE;
+		CooldownPeriod[Index] = 0;
 	}
 }
 
+void ULevelsPlayerMovementComponent::WallMovementCheck()
+{
+	FLevelsMovementCounterScope CounterScope(*this);
+	LEVELS_LLM_SCOPE(Movement);
+	FLevelsInputLatency::NoteParkourCheck(this);
+	//tuning can be changed from blueprints or the editor while playing
+	SyncParkourConfig();
+	ParkourSim.Update();
+	FLevelsInputLatency::NoteMovementUpdated(this);
+}
+
 void ULevelsPlayerMovementComponent::BeginPlay()
 {
+	LEVELS_LLM_SCOPE(Movement);
+
 	Super::BeginPlay();
 
-	GetWorld()->GetTimerManager().SetTimer(WallRunTimerHandle, this, &ULevelsPlayerMovementComponent::WallMovementCheck, 0.0167f, true);
+	//pooled characters are spawned dormant, they start polling once they are checked out
+	if (!bMovementChecksPaused)
+	{
+		StartMovementChecks();
+	}
+
+	//save default values so we can change them back
+	ParkourSim.Config.DefaultParams = ParkourAdapter.GetMovementParams();
+	SyncParkourConfig();
+
+	//the rewind history is allocated once up front, stepping and rewinding never allocate
+	if (bFixedStepSimulation)
+	{
+		SnapshotHistory.SetNum(SnapshotHistorySize);
+		InputHistory.SetNum(SnapshotHistorySize);
+	}
+
+
+
+}
+
+void ULevelsPlayerMovementComponent::SyncParkourConfig()
+{
+	LevelsParkour::FParkourConfig& Config = ParkourSim.Config;
+	Config.WallRunGravity = WallRunGravity;
+	Config.WallRunCooldown = WallRunCooldown;
+	Config.WallRunJumpCooldown = WallRunJumpCooldown;
+	Config.WallRunJumpHeight = WallRunJumpHeight;
+	Config.WallRunJumpForce = WallRunJumpForce;
+	Config.WallRunSpeedRequirement = WallRunSpeedRequirement;
+	Config.bWallRunGravity = WallRunGravityOn;
+	Config.WallClimbSpeed = WallClimbSpeed;
+	Config.MantleSpeed = MantleSpeed;
+	Config.QuickMantleSpeed = QuickMantleSpeed;
+	Config.MantleHeight = MantleHeight;
+	Config.LedgeGrabJumpForce = LedgeGrabJumpForce;
+	Config.LedgeGrabJumpHeight = LedgeGrabJumpHeight;
+	Config.SlideImpulseForce = SlideImpulseForce;
+	Config.SprintSpeed = SprintSpeed;
+	Config.JumpBufferTime = JumpBufferTime;
+	Config.SlideBufferTime = SlideBufferTime;
+	Config.SprintBufferTime = SprintBufferTime;
+}
+
+void ULevelsPlayerMovementComponent::StartMovementChecks()
+{
+	//fixed step mode runs the checks from TickComponent instead
+	if (!bFixedStepSimulation)
+	{
+		GetWorld()->GetTimerManager().SetTimer(WallRunTimerHandle, this, &ULevelsPlayerMovementComponent::WallMovementCheck, 0.0167f, true);
+	}
+
+	//nobody looks through a camera on a dedicated server
+	if (IsNetMode(NM_DedicatedServer))
+	{
+		return;
+	}
 
 	//sets a timer to check if the camera rotation should be changed based on the custom movement mode. Could just be called in wall movement check but its here for now
 	FTimerDelegate TimerDel;
 	TimerDel.BindUFunction(this, FName("MovementCamera"), MovementCameraRoll);
 	GetWorld()->GetTimerManager().SetTimer(CameraTimerHandle, TimerDel, 0.0167f, true);
+}
 
-	//save default values so we can change them back
-	DefaultGravity = GravityScale;
-	DefaultGroundFriction = GroundFriction;
-	DefaultBrakingDeceleration = BrakingDecelerationWalking;
-	DefaultWalkSpeed = MaxWalkSpeed;
-	DefaultCrouchSpeed = MaxWalkSpeedCrouched;
+void ULevelsPlayerMovementComponent::SetMovementChecksPaused(bool bPaused)
+{
+	bMovementChecksPaused = bPaused;
+
+	//timers can only be armed once the component has begun play, BeginPlay picks up the flag otherwise
+	if (!HasBegunPlay())
+	{
+		return;
+	}
+
+	if (bPaused)
+	{
+		GetWorld()->GetTimerManager().ClearTimer(WallRunTimerHandle);
+		GetWorld()->GetTimerManager().ClearTimer(CameraTimerHandle);
+	}
+	else
+	{
+		StartMovementChecks();
+	}
+}
+
+void ULevelsPlayerMovementComponent::ResetParkourState()
+{
+	for (int32 Index = 0; Index < (int32)ELevelsParkourCooldown::Num; ++Index)
+	{
+		ClearParkourCooldown((ELevelsParkourCooldown)Index);
+	}
+	GetWorld()->GetTimerManager().ClearTimer(SprintCooldownTimerHandle);
+
+	ParkourStepAccumulator = 0.f;
+	PendingInput = FLevelsParkourInput();
+	StepInput = FLevelsParkourInput();
+
+	ParkourSim.Reset();
 
+	if (IsCrouching())
+	{
+		UnCrouch(true);
+	}
 
+	StopMovementImmediately();
+	CustomMovementMode = MOVE_CustomNone;
 
+	//the defaults are only known once BeginPlay has saved them
+	if (HasBegunPlay())
+	{
+		ResetMovement();
+	}
+	else
+	{
+		SetPlaneConstraintEnabled(false);
+	}
 }
 
 void ULevelsPlayerMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction * ThisTickFunction)
 {
+	FLevelsMovementCounterScope CounterScope(*this);
+	LEVELS_LLM_SCOPE(Movement);
+
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	UE_LOG(LogTemp, Warning, TEXT("Test: %d"), CustomMovementMode);
-	UE_LOG(LogTemp, Warning, TEXT("Bool value is: %s"), bSlidingEnabled ? "e" : "f a l s e");
+	if (bFixedStepSimulation && !bMovementChecksPaused && HasBegunPlay())
+	{
+		//a long hitch only catches up a few steps, the rest is dropped rather than spiralling
+		const float StepSeconds = 1.f / FixedStepRate;
+		ParkourStepAccumulator = FMath::Min(ParkourStepAccumulator + DeltaTime, StepSeconds * 4.f);
+		while (ParkourStepAccumulator >= StepSeconds)
+		{
+			ParkourStepAccumulator -= StepSeconds;
+			PendingInput.MoveInput = GetLastInputVector();
+			PendingInput.ButtonAge = PendingInput.Buttons != 0 ? FMath::Max(0.f, (ParkourStep + 1) * StepSeconds - PendingPressTime) : 0.f;
+			SimulateParkourStep(PendingInput);
+			PendingInput.Buttons = 0;
+		}
+	}
+
+	FLevelsInputLatency::NoteMovementUpdated(this);
 }
 
 void ULevelsPlayerMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
@@ -81,172 +245,130 @@ void ULevelsPlayerMovementComponent::OnMovementModeChanged(EMovementMode Previou
 	//PreviousCustomMode = CustomMovementMode;
 	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
 
-	if (PreviousMovementMode == MOVE_Walking && IsFalling())
+	//a snapshot restore sets every parkour field itself afterwards
+	if (bRestoringSnapshot)
 	{
-		//EnableWallRun();
-		EnableWallClimb();
-		EnableSlide();
-		EnableSprint();
-		SprintJump();
-		if (PreviousCustomMode == MOVE_Sprint)
-			bWantsToSprint = true;
-		WallRunEnd(0.35f);
-		WallClimbEnd(0.0f);
-		SlideEnd(false);
+		return;
 	}
-	else if (PreviousMovementMode == MOVE_Falling && IsWalking())
+
+	//parkour mode changes are counted by the adapter as they happen
+	if (MovementMode != PreviousMovementMode)
 	{
-		//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Queued Movement!!"));
-		//CheckQueuedMovement();
+		CountModeTransition();
 	}
+
+	ParkourSim.OnMovementChanged(ToBaseMovement(PreviousMovementMode), (LevelsParkour::EParkourMode)PreviousCustomMode);
+}
+
+void ULevelsPlayerMovementComponent::CountModeTransition()
+{
+	BeginCounterFrame();
+	++CounterFrameModeTransitions;
+	++MovementCounters.ModeTransitions;
+	FLevelsHitchWatchdog::NoteModeTransition();
+	MovementCounters.MaxModeTransitionsPerFrame = FMath::Max(MovementCounters.MaxModeTransitionsPerFrame, CounterFrameModeTransitions);
+}
+
+void ULevelsPlayerMovementComponent::ResetMovementCounters()
+{
+	MovementCounters = FLevelsMovementCounters();
+	CounterFrame = 0;
+	CounterFrameCycles = 0;
+	CounterFrameSceneQueries = 0;
+	CounterFrameModeTransitions = 0;
+	CounterFrameCooldownsSet = 0;
+}
+
+void ULevelsPlayerMovementComponent::BeginCounterFrame()
+{
+	if (CounterFrame != GFrameCounter)
+	{
+		CounterFrame = GFrameCounter;
+		CounterFrameCycles = 0;
+		CounterFrameSceneQueries = 0;
+		CounterFrameModeTransitions = 0;
+		CounterFrameCooldownsSet = 0;
+		++MovementCounters.Frames;
+	}
+}
+
+void ULevelsPlayerMovementComponent::AddCounterCycles(uint64 Cycles)
+{
+	CounterFrameCycles += Cycles;
+	MovementCounters.TotalMicroseconds += FPlatformTime::ToMilliseconds64(Cycles) * 1000.0;
+	MovementCounters.MaxMicrosecondsPerFrame = FMath::Max(MovementCounters.MaxMicrosecondsPerFrame, FPlatformTime::ToMilliseconds64(CounterFrameCycles) * 1000.0);
+}
+
+void ULevelsPlayerMovementComponent::CountSceneQuery()
+{
+	BeginCounterFrame();
+	++CounterFrameSceneQueries;
+	++MovementCounters.SceneQueries;
+	FLevelsHitchWatchdog::NoteSceneQuery();
+	MovementCounters.MaxSceneQueriesPerFrame = FMath::Max(MovementCounters.MaxSceneQueriesPerFrame, CounterFrameSceneQueries);
 }
 
 void ULevelsPlayerMovementComponent::ProcessLanded(const FHitResult & Hit, float remainingTime, int32 Iterations)
 {
 	Super::ProcessLanded(Hit, remainingTime, Iterations);
-	DisableWallRun();
-	DisableWallClimb();
-	DisableSlide();
-	DisableSprint();
-	WallRunEnd(0.35f);
-	WallClimbEnd(0.0f);
-	SprintEnd();
-	SlideEnd(false);
-	CheckQueuedMovement();
-	//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Camera Shake!!"));
-	//GetWorld()->GetFirstPlayerController()->ClientStartCameraShake(JumpLandShake, 1, ECameraAnimPlaySpace::CameraLocal, FRotator(0, 0, 0));
-	GetWorld()->GetFirstPlayerController()->ClientStartCameraShake(JumpLandShake);
+	ParkourSim.OnLanded();
 }
 
 void ULevelsPlayerMovementComponent::OnJump()
 {
-;
-	if (CustomMovementMode == MOVE_CustomNone)
-	{
-		if (!IsFalling())
-		{
-			EnableWallRun();
-			EnableWallClimb();
-			EnableSprint();
-			EnableSlide();
-			GetWorld()->GetFirstPlayerController()->ClientStartCameraShake(JumpLandShake);
-		}
-	}
-	else
-	{
-		WallRunJump();
-		LedgeGrabJump();
-		SlideJump();
-		CrouchJump();
-		SprintJump();
-	}
-	//GetWorld()->GetFirstPlayerController()->ClientStartCameraShake(JumpLandShake);
-}
-
-//bool ULevelsPlayerMovementComponent::DoJump(bool bReplayingMoves)
-//{
-	//if (CustomMovementMode == MOVE_CustomNone && IsFalling())
-	//{
-	//	if (IsFalling())
-	//	{
-	//		EnableWallRun();
-	//		EnableWallClimb();
-	//		EnableSprint();
-	//		EnableSlide();
-	//		SlideJump();
-	//		CrouchJump();
-	//		SprintJump();
-	//	}
-	//}
+	ParkourSim.OnJump();
+}
+
+void ULevelsPlayerMovementComponent::CrouchSlideCheck()
+{
+	ParkourSim.CrouchSlideCheck();
+}
 
-	//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Camera Shake!!"));
-	//GetWorld()->GetFirstPlayerController()->ClientStartCameraShake(JumpLandShake);
-	//GetWorld()->GetFirstPlayerController()->ClientStartCameraShake(JumpLandShake);
-	//return Super::DoJump(bReplayingMoves);
-//}
+void ULevelsPlayerMovementComponent::SprintStart()
+{
+	ParkourSim.SprintStart();
+}
 
 bool ULevelsPlayerMovementComponent::SetCustomMovementMode(uint8 NewCustomMovementMode)
 {
-	if (CustomMovementMode == NewCustomMovementMode)
-	{
-		return false;
-	}
-	else
-	{
-		//if (NewCustomMovementMode == MOVE_RightWallRun || NewCustomMovementMode == MOVE_LeftWallRun || IsWallRunning())
-		//{
-		//	bChangeCamera = true;
-		//}
-		//	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Returning max movement speed to normal!!"));
-		//}
-		CustomMovementMode = NewCustomMovementMode;
-		ResetMovement();
-		return true;
-	}
+	return ParkourSim.SetCustomMode((LevelsParkour::EParkourMode)NewCustomMovementMode);
 }
 
 void ULevelsPlayerMovementComponent::ResetMovement()
 {
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, FString::Printf(TEXT("Resetting Movement")));
-	//if equal to null
+	ParkourSim.ResetMovement();
+}
 
+void ULevelsPlayerMovementComponent::EnableWallRun()
+{
+	ParkourSim.EnableWallRun();
+}
 
-	if (CustomMovementMode == MOVE_CustomNone || CustomMovementMode == MOVE_Crouch)
-	{
-		GravityScale = DefaultGravity;
-		GroundFriction= DefaultGroundFriction;
-		BrakingDecelerationWalking = DefaultBrakingDeceleration;
-		MaxWalkSpeed = DefaultWalkSpeed;
-		MaxWalkSpeedCrouched = DefaultCrouchSpeed;
+void ULevelsPlayerMovementComponent::EnableWallClimb()
+{
+	ParkourSim.EnableWallClimb();
+}
 
-		SetPlaneConstraintEnabled(false);
+void ULevelsPlayerMovementComponent::EnableMantleCheck()
+{
+	ParkourSim.EnableMantleCheck();
+}
 
-		switch (CustomMovementMode) {
-		case MOVE_CustomNone:
-			SetMovementMode(MOVE_Walking);
-			break;
-		case MOVE_Slide:
-			SetMovementMode(MOVE_Walking);
-			break;
-		case MOVE_LeftWallRun:
-			SetMovementMode(MOVE_Falling);
-			break;
-		case MOVE_RightWallRun:
-			SetMovementMode(MOVE_Falling);
-			break;
-		case MOVE_WallClimb:
-			SetMovementMode(MOVE_Falling);
-			break;
-		case MOVE_LedgeGrab:
-			SetMovementMode(MOVE_Falling);
-			break;
-		case MOVE_Mantle:
-			SetMovementMode(MOVE_Walking);
-			break;
-		case MOVE_Sprint:
-			SetMovementMode(MOVE_Walking);
-			break;
-		case MOVE_Crouch:
-			SetMovementMode(MOVE_Walking);
-			break;
-		}
-	}
+bool ULevelsPlayerMovementComponent::IsWallRunning()
+{
+	return ParkourSim.IsWallRunning();
 }
 
-void ULevelsPlayerMovementComponent::CheckQueuedMovement()
+bool ULevelsPlayerMovementComponent::IsSliding()
 {
-	if (bWantsToSlide)
-	{
-		SlideStart();
-	}
-	else if (bWantsToSprint)
-	{
-		SprintStart();
-	}
+	return ParkourSim.IsSliding();
 }
 
 void ULevelsPlayerMovementComponent::MovementCamera(float Roll)
 {
+	FLevelsMovementCounterScope CounterScope(*this);
+	LEVELS_LLM_SCOPE(Movement);
+
 	//if (bChangeCamera) {
 		//tilts camera in direction of wall run or slide
 		if (CustomMovementMode == MOVE_RightWallRun || IsSliding())
@@ -271,651 +393,673 @@ void ULevelsPlayerMovementComponent::MovementCamera(float Roll)
 
 void ULevelsPlayerMovementComponent::CameraTilt(float CameraRoll)
 {
+	//the tilt is purely for the player looking through this camera, servers and remote players skip it
+	APlayerController* PC = GetLocalPlayerController();
+	if (!PC)
+	{
+		return;
+	}
+	FLevelsInputLatency::NoteCameraUpdated(this);
+
 	//rotates the character's camera to the Camera Rotation
-	//tried to put GetWorld()->GetFirstPlayerController()->SetControlRotation (the current camera rotation) but created a bug (apparently we shouldnt get current rotation from a variable. Enjoy this long long line
-	GetWorld()->GetFirstPlayerController()->SetControlRotation(FMath::RInterpTo(GetWorld()->GetFirstPlayerController()->GetControlRotation(), 
-		FRotator(GetWorld()->GetFirstPlayerController()->GetControlRotation().Pitch, GetWorld()->GetFirstPlayerController()->GetControlRotation().Yaw, CameraRoll), GetWorld()->GetDeltaSeconds(), 10.f));
+	//tried to put the current camera rotation in a variable but created a bug (apparently we shouldnt get current rotation from a variable. Enjoy this long long line
+	PC->SetControlRotation(FMath::RInterpTo(PC->GetControlRotation(), 
+		FRotator(PC->GetControlRotation().Pitch, PC->GetControlRotation().Yaw, CameraRoll), GetWorld()->GetDeltaSeconds(), 10.f));
 }
 
-void ULevelsPlayerMovementComponent::PhysWalking(float deltaTime, int32 Iterations) 
+APlayerController* ULevelsPlayerMovementComponent::GetLocalPlayerController() const
 {
-	//Increases speed at the start of walking. Done by increasing acceleration when the character's velocity is below 500 (can be changed) units/s 
-	//makes the game feel faster :)
-	if (Velocity.Size2D() < 700.f)
+	APlayerController* PC = CharacterOwner ? Cast<APlayerController>(CharacterOwner->GetController()) : nullptr;
+	return PC && PC->IsLocalController() ? PC : nullptr;
+}
+
+void ULevelsPlayerMovementComponent::PlayCameraShake(ELevelsCosmeticEvent Event)
+{
+	APlayerController* PC = GetLocalPlayerController();
+	if (!PC)
 	{
-		//takes normal of the current accelleration vector and multiplies it by 2048
-		Acceleration = Acceleration.GetSafeNormal() * 2048.0f;
+		return;
+	}
+
+	//shakes stream in with the Client bundle, one that hasn't arrived yet is skipped
+	UClass* Shake = nullptr;
+	switch (Event)
+	{
+	case ELevelsCosmeticEvent::Jumped:
+	case ELevelsCosmeticEvent::Landed:
+		Shake = JumpLandShake.Get();
+		break;
+	case ELevelsCosmeticEvent::LedgeGrabbed:
+		Shake = LedgeGrabShake.Get();
+		break;
+	case ELevelsCosmeticEvent::Mantled:
+		Shake = MantleShake.Get();
+		break;
+	case ELevelsCosmeticEvent::QuickMantled:
+		Shake = QuickMantleShake.Get();
+		break;
+	default:
+		break;
+	}
+
+	if (Shake)
+	{
+		PC->ClientStartCameraShake(Shake);
 	}
-	Super::PhysWalking(deltaTime, Iterations);
 }
 
-bool ULevelsPlayerMovementComponent::ForwardInput()
+void ULevelsPlayerMovementComponent::GetBundleAssets(FName BundleName, TArray<FSoftObjectPath>& OutAssets) const
 {
-	return FVector::DotProduct(CharacterOwner->GetActorForwardVector(), GetLastInputVector()) > 0.f;
+	if (BundleName != ULevelsAssetManager::ClientBundle)
+	{
+		return;
+	}
+
+	const FSoftObjectPath Paths[] = {
+		LedgeGrabShake.ToSoftObjectPath(),
+		JumpLandShake.ToSoftObjectPath(),
+		MantleShake.ToSoftObjectPath(),
+		QuickMantleShake.ToSoftObjectPath()
+	};
+
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		if (Path.IsValid())
+		{
+			OutAssets.Add(Path);
+		}
+	}
+}
+
+void ULevelsPlayerMovementComponent::PublishCosmeticEvent(ELevelsCosmeticEvent Event)
+{
+	//replayed steps already showed their effects the first time round
+	if (bResimulating)
+	{
+		return;
+	}
+
+	ULevelsCosmeticEvents::Publish(GetWorld(), Event, Cast<ALevels_v0Character>(CharacterOwner), UpdatedComponent ? UpdatedComponent->GetComponentLocation() : FVector::ZeroVector);
 }
 
-bool ULevelsPlayerMovementComponent::MovingForward()
+void ULevelsPlayerMovementComponent::PhysWalking(float deltaTime, int32 Iterations) 
 {
-	return (FVector::DotProduct(CharacterOwner->GetActorForwardVector(), Velocity.GetSafeNormal())) > 0;
+	//Increases speed at the start of walking by increasing acceleration while the character is slow
+	Acceleration = ToEngine(LevelsParkour::BoostWalkingAcceleration(ParkourSim.Config, ToParkour(Acceleration), ToParkour(Velocity)));
+	Super::PhysWalking(deltaTime, Iterations);
 }
 
-void ULevelsPlayerMovementComponent::WallRunEndVectors()
+void ULevelsPlayerMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
 {
-	//get the character's current location
-	CurrentLocation = CharacterOwner->GetActorLocation();
-	
-	//get the right vector of the character with a length of 75 for ray casting when detecting a wall for wall running
-	RightDirection = CharacterOwner->GetActorRightVector()  * 75.f;
-	
-	//get the forward vector of the character with a length of -35 for ray casting when detecting a wall for wall running. This gives detection to the back of the character for leeway for aiming and stuff.
-	ForwardDirection = CharacterOwner->GetActorForwardVector() * -35.f;
-	
-	//add for right endpoint
-	RightEndpoint = CurrentLocation + RightDirection + ForwardDirection;
+	Super::PhysCustom(deltaTime, Iterations);
+}
 
-	//get the left vector of the character with a length of 75 for ray casting when detecting a wall for wall running
-	LeftDirection = CharacterOwner->GetActorRightVector()  * -75.f;
-	
-	//add for left endpoint
-	LeftEndpoint = CurrentLocation + LeftDirection + ForwardDirection;
 
+void ULevelsPlayerMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector & OldLocation, const FVector & OldVelocity)
+{
+	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
 }
 
-bool ULevelsPlayerMovementComponent::CanWallRun()
+bool ULevelsPlayerMovementComponent::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
 {
-	if (MovingForward() && CustomMovementMode == MOVE_CustomNone || IsWallRunning())
+	const bool bNeedsCorrection = Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientLoc, RelativeClientLocation, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+	if (bNeedsCorrection)
 	{
-		if (CustomMovementMode == MOVE_CustomNone || IsWallRunning())
-		{
-			return true;
-		}
+		ULevelsServerMetrics::NoteMovementCorrection();
 	}
-	return false;
+	return bNeedsCorrection;
 }
 
-void ULevelsPlayerMovementComponent::WallRunUpdate()
+void ULevelsPlayerMovementComponent::PressParkourButton(uint8 Button)
 {
-	if (CanWallRun()) 
+	//fixed steps pick presses up at the start of the next step so they are part of its recorded input
+	if (bFixedStepSimulation)
 	{
-		//for checking gravity scale
-		//FString GravString = FString::SanitizeFloat(GravityScale);
-
-		//get endpoints
-		WallRunEndVectors();
-
-		//boolean for whether if the velocity is fast enough for wall running
-		bool PassesSpeedRequirement = Velocity.Size2D() > WallRunSpeedRequirement;
-
-		//the character can wallrun on the right if wallrun isn't disabled, it is going fast enough, wasn't just wallrunning on the left side and has a wall detected to run on
-		if (PassesSpeedRequirement && !(CustomMovementMode == MOVE_LeftWallRun) && WallRunMovement(CharacterOwner, CurrentLocation, RightEndpoint, -1.0f))
-		{
-			//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Right side wall running!!"));
-			SetCustomMovementMode(MOVE_RightWallRun);
-			//change gravity to give the effect that the character falls downwards as it goes along the wall
-			GravityScale = FMath::FInterpTo(DefaultGravity, WallRunGravity, GetWorld()->GetDeltaSeconds(), 30.0);
-			//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Blue, *GravString); //Check what the gravity was changed to
-		}
-			//same but on the left
-		else if (PassesSpeedRequirement && !(CustomMovementMode == MOVE_RightWallRun) && WallRunMovement(CharacterOwner, CurrentLocation, LeftEndpoint, 1.0f))
-		{
-			//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Left side wall running!!"));
-			SetCustomMovementMode(MOVE_LeftWallRun);
-			GravityScale = FMath::FInterpTo(DefaultGravity, WallRunGravity, GetWorld()->GetDeltaSeconds(), 30.0);
-		}
-		else
+		//the press came during the frame that is about to be stepped through
+		if (PendingInput.Buttons == 0)
 		{
-			//check so we don't call WallRunEnd all the time
-			if (IsWallRunning())
-			{
-				//ends wallrunning
-				WallRunEnd(WallRunCooldown);
-				//test checks for gravity and WallRunSuppressed
-				//GravString = FString::SanitizeFloat(GravityScale);
-				//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("WallRunSuppressed: %s"), (bIsWallRunSuppressed ? TEXT("true") : TEXT("false"))));
-				//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Blue, *GravString);
-			}
+			PendingPressTime = GetParkourTime() + ParkourStepAccumulator + GetWorld()->GetDeltaSeconds();
 		}
+		PendingInput.Buttons |= Button;
+		return;
+	}
+
+	if (Button & ELevelsInputButton::Jump)
+	{
+		OnJump();
+		CharacterOwner->Jump();
+	}
+	if (Button & ELevelsInputButton::Crouch)
+	{
+		CrouchSlideCheck();
+	}
+	if (Button & ELevelsInputButton::Sprint)
+	{
+		SprintStart();
 	}
 }
 
+float ULevelsPlayerMovementComponent::GetParkourDeltaSeconds() const
+{
+	return bFixedStepSimulation ? 1.f / FixedStepRate : GetWorld()->GetDeltaSeconds();
+}
 
-bool ULevelsPlayerMovementComponent::WallRunMovement(ACharacter* Character, FVector Start, FVector End, float WallRunDirection)
+float ULevelsPlayerMovementComponent::GetParkourTime() const
 {
-	//hit result object for ray casting
-	FHitResult Hit(ForceInit);
-	//FCollisionQueryParams TraceParams;
-	//draws a line ingame that represent where this function is checking for wall running. Makes detection easier to understand when debugging
-	//DrawDebugLine(GetWorld(), Start, End, FColor::Green, false, 7.0f);
-	//if something was hit (gets hit result if hit)
-	if (GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility))
-	{
-		//store hit normal in a variable
-		WallRunHitNormal = Hit.Normal;
+	return bFixedStepSimulation ? (float)ParkourStep / FixedStepRate : GetWorld()->GetTimeSeconds();
+}
 
-		//For debugging. Stores the x and y of the normal vector from the wall hit.
-		FString HitX = FString::SanitizeFloat(WallRunHitNormal.X);
-		FString HitY = FString::SanitizeFloat(WallRunHitNormal.Y);
-		//FString HitZ = FString::SanitizeFloat(WallRunHitNormal.Z);
-		//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("WallRunSuppressed: %s"), (bIsWallRunSuppressed ? TEXT("true") : TEXT("false"))));
-		
-		//Fixes a bug that would happen when the player is wall running and the wall ends, if the wall had corner (another wall perpendicular to it) the detection would hit the perpendicular wall as the player is flying off the first wall and cause 
-		//the player to wall run on the perpendicular wall. This would cause the player to sometimes suddenly make a 90 degree turn and start wall running with the same velocity as before. The player might also just lose speed after a wall ends if the new wall run didn't continue.
-		//The fix is making a variable that holds the normal vector from the previous time this functionwas called while wall running. This is initialized as a vector with all components as 0 and resets on WallRunEnd. The if statement says if the Z value from PrevWallRunHitNormal
-		// is not zero (it will never be if we are wallrunning) and the difference of the current and previous hit normal is larger than the size of a vector with the components (0.5f, 0.5f, 0.5f) <- difference only made by making a 90 degree turn.  
-		//If the if statement is true we call WallRunEnd and return false. tbh pretty happy I could get this to work
-		if (PrevWallRunHitNormal.Z != 0 && (PrevWallRunHitNormal - WallRunHitNormal).Size2D() > FVector(0.5f, 0.5f, 0.5f).Size())
-		{
-			WallRunEnd(WallRunCooldown);
-			//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Wallrunning between corners BLOCKED :)")));
-			return false;
-		}
+void ULevelsPlayerMovementComponent::SetParkourCooldown(ELevelsParkourCooldown Cooldown, float Seconds, bool bLooping)
+{
+	BeginCounterFrame();
+	++CounterFrameCooldownsSet;
+	++MovementCounters.CooldownsSet;
+	MovementCounters.MaxCooldownsSetPerFrame = FMath::Max(MovementCounters.MaxCooldownsSetPerFrame, CounterFrameCooldownsSet);
 
-		//if the z component of WallRunHitNormal is between -.52 and .52 and the state is falling
-		if ((WallRunHitNormal.Z < .52f && WallRunHitNormal.Z > -.52f) && IsFalling())
-		{
-			//cling player to wall
-    		//Character->LaunchCharacter(PlayerToWallVector(WallRunHitNormal), false, false);
-			//move player forward on wall
-			FVector LaunchVector = FVector::CrossProduct(WallRunHitNormal, FVector(0.f, 0.f, 1.f));
-			//launch player along wall to make wall running
-			//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Blue, *HitX);
-			//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Blue, *HitY);
-			//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Blue, *HitZ);
-			Character->LaunchCharacter(LaunchVector * (WallRunDirection * Velocity.Size2D()), true, !WallRunGravityOn);
-			//bWallRunning = true;
-			PrevWallRunHitNormal = WallRunHitNormal;
-			return true;
-		}
-		//if we are no longer falling call WallRunEnd (bug fix)
-		//WallRunEnd(WallRunCooldown);
-		//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("WallRunSuppressed: %s"), (bIsWallRunSuppressed ? TEXT("true") : TEXT("false"))));
-		//return false;
+	if (bFixedStepSimulation)
+	{
+		//same rules as the timers: no delay means the cooldown never fires, looping repeats every period
+		const int32 Steps = FMath::CeilToInt(Seconds * FixedStepRate);
+		CooldownStep[(int32)Cooldown] = Steps > 0 ? ParkourStep + Steps : INDEX_NONE;
+		CooldownPeriod[(int32)Cooldown] = bLooping ? Steps : 0;
+		return;
+	}
+
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	switch (Cooldown)
+	{
+	case ELevelsParkourCooldown::WallRun:
+		TimerManager.SetTimer(WallRunCooldownTimerHandle, this, &ULevelsPlayerMovementComponent::EnableWallRun, Seconds, bLooping);
+		break;
+	case ELevelsParkourCooldown::WallClimb:
+		TimerManager.SetTimer(WallClimbCooldownTimerHandle, this, &ULevelsPlayerMovementComponent::EnableWallClimb, Seconds, bLooping);
+		break;
+	case ELevelsParkourCooldown::MantleCheck:
+		TimerManager.SetTimer(MantleCooldownTimerHandle, this, &ULevelsPlayerMovementComponent::EnableMantleCheck, Seconds, bLooping);
+		break;
+	default:
+		break;
 	}
-	return false;
 }
 
-void ULevelsPlayerMovementComponent::WallRunJump()
+void ULevelsPlayerMovementComponent::ClearParkourCooldown(ELevelsParkourCooldown Cooldown)
 {
-	if (IsWallRunning())
+	CooldownStep[(int32)Cooldown] = INDEX_NONE;
+	CooldownPeriod[(int32)Cooldown] = 0;
+
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	switch (Cooldown)
 	{
-		WallRunEnd(WallRunJumpCooldown);
-		//various algorithms for wall jumping
-		//CharacterOwner->LaunchCharacter(FVector(WallRunJumpForce * WallRunHitNormal.X, WallRunJumpForce * WallRunHitNormal.Y, WallRunJumpHeight), true, true);
-		//CharacterOwner->LaunchCharacter(FVector(WallRunJumpForce * Velocity.GetSafeNormal().X, WallRunJumpForce * Velocity.GetSafeNormal().Y, WallRunJumpHeight), true, true);
-		//CharacterOwner->LaunchCharacter(FVector(WallRunJumpForce * WallRunHitNormal.X, Velocity.Y * WallRunHitNormal.Y, WallRunJumpHeight), true, true);
-		CharacterOwner->LaunchCharacter(FVector(WallRunJumpForce * Velocity.X, WallRunJumpForce * Velocity.Y, WallRunJumpHeight), true, true);
+	case ELevelsParkourCooldown::WallRun:
+		TimerManager.ClearTimer(WallRunCooldownTimerHandle);
+		break;
+	case ELevelsParkourCooldown::WallClimb:
+		TimerManager.ClearTimer(WallClimbCooldownTimerHandle);
+		break;
+	case ELevelsParkourCooldown::MantleCheck:
+		TimerManager.ClearTimer(MantleCooldownTimerHandle);
+		break;
+	default:
+		break;
 	}
 }
 
-bool ULevelsPlayerMovementComponent::IsWallRunning()
+bool ULevelsPlayerMovementComponent::IsParkourCooldownActive(ELevelsParkourCooldown Cooldown) const
 {
-	if (CustomMovementMode == MOVE_RightWallRun || CustomMovementMode == MOVE_LeftWallRun)
+	if (bFixedStepSimulation)
 	{
-		return true;
+		return CooldownStep[(int32)Cooldown] != INDEX_NONE;
 	}
+
+	const FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	switch (Cooldown)
+	{
+	case ELevelsParkourCooldown::WallRun:
+		return TimerManager.IsTimerActive(WallRunCooldownTimerHandle);
+	case ELevelsParkourCooldown::WallClimb:
+		return TimerManager.IsTimerActive(WallClimbCooldownTimerHandle);
+	case ELevelsParkourCooldown::MantleCheck:
+		return TimerManager.IsTimerActive(MantleCooldownTimerHandle);
+	default:
 		return false;
+	}
 }
 
-void ULevelsPlayerMovementComponent::EnableWallRun()
+int32 ULevelsPlayerMovementComponent::GetNumLiveTimers() const
 {
-	bWallRunEnabled = true;
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("bWallRunEnabled: %s"), (bWallRunEnabled ? TEXT("true") : TEXT("false"))));
-	GetWorld()->GetTimerManager().ClearTimer(WallRunCooldownTimerHandle);
+	int32 NumLive = 0;
+	for (int32 Index = 0; Index < (int32)ELevelsParkourCooldown::Num; ++Index)
+	{
+		NumLive += IsParkourCooldownActive((ELevelsParkourCooldown)Index) ? 1 : 0;
+	}
 
+	const FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	NumLive += TimerManager.IsTimerActive(WallRunTimerHandle) ? 1 : 0;
+	NumLive += TimerManager.IsTimerActive(CameraTimerHandle) ? 1 : 0;
+	NumLive += TimerManager.IsTimerActive(SprintCooldownTimerHandle) ? 1 : 0;
+	return NumLive;
 }
 
-void ULevelsPlayerMovementComponent::DisableWallRun()
+void ULevelsPlayerMovementComponent::FireParkourCooldown(ELevelsParkourCooldown Cooldown)
 {
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Disabled Wall Run")));
-	bWallRunEnabled = false;
+	ParkourSim.FireCooldown(Cooldown);
 }
 
-void ULevelsPlayerMovementComponent::WallRunEnd(float Cooldown)
+void ULevelsPlayerMovementComponent::SimulateParkourStep(const FLevelsParkourInput& Input)
 {
-	SetCustomMovementMode(MOVE_CustomNone);
-	//fix gravity
-	PrevWallRunHitNormal = FVector::ZeroVector;
-	GravityScale = DefaultGravity;
-	//Set a cooldown on wallrunning
-	DisableWallRun();
-	GetWorld()->GetTimerManager().SetTimer(WallRunCooldownTimerHandle, this, &ULevelsPlayerMovementComponent::EnableWallRun, Cooldown, true);
-	GetWorld()->GetTimerManager().SetTimer(QueueTimerHandle, this, &ULevelsPlayerMovementComponent::CheckQueuedMovement, Cooldown, true);
+	++ParkourStep;
+	StepInput = Input;
+
+	if (Input.Buttons & ELevelsInputButton::Jump)
+	{
+		ParkourSim.OnJump(Input.ButtonAge);
+		//the engine's own jump runs on the next movement update, after parkour has seen the press
+		CharacterOwner->Jump();
+	}
+	if (Input.Buttons & ELevelsInputButton::Crouch)
+	{
+		ParkourSim.CrouchSlideCheck(Input.ButtonAge);
+	}
+	if (Input.Buttons & ELevelsInputButton::Sprint)
+	{
+		ParkourSim.SprintStart(Input.ButtonAge);
+	}
+
+	//cooldowns that are due fire in a fixed order, before the checks just like the timers did
+	for (int32 Index = 0; Index < (int32)ELevelsParkourCooldown::Num; ++Index)
+	{
+		if (CooldownStep[Index] != INDEX_NONE && ParkourStep >= CooldownStep[Index])
+		{
+			CooldownStep[Index] = CooldownPeriod[Index] > 0 ? CooldownStep[Index] + CooldownPeriod[Index] : INDEX_NONE;
+			FireParkourCooldown((ELevelsParkourCooldown)Index);
+		}
+	}
+
+	WallMovementCheck();
+
+	if (SnapshotHistory.Num() > 0)
+	{
+		const int32 Slot = ParkourStep % SnapshotHistory.Num();
+		InputHistory[Slot] = Input;
+		SaveParkourSnapshot(SnapshotHistory[Slot]);
+	}
 }
 
-void ULevelsPlayerMovementComponent::WallClimbUpdate()
+void ULevelsPlayerMovementComponent::SaveParkourSnapshot(FLevelsParkourSnapshot& Out) const
 {
-	if (CanWallClimb())
+	Out.Step = ParkourStep;
+
+	Out.Location = UpdatedComponent ? UpdatedComponent->GetComponentLocation() : FVector::ZeroVector;
+	Out.Rotation = UpdatedComponent ? UpdatedComponent->GetComponentQuat() : FQuat::Identity;
+	Out.Velocity = Velocity;
+	Out.PendingLaunchVelocity = PendingLaunchVelocity;
+
+	Out.PlaneConstraintNormal = GetPlaneConstraintNormal();
+
+	Out.GravityScale = GravityScale;
+	Out.GroundFriction = GroundFriction;
+	Out.BrakingDecelerationWalking = BrakingDecelerationWalking;
+	Out.MaxWalkSpeed = MaxWalkSpeed;
+
+	for (int32 Index = 0; Index < (int32)ELevelsParkourCooldown::Num; ++Index)
 	{
-		FHitResult Hit(ForceInit);
-		MantleVectors();
+		Out.CooldownStep[Index] = CooldownStep[Index];
+		Out.CooldownPeriod[Index] = CooldownPeriod[Index];
+	}
+
+	Out.Parkour = ParkourSim.State;
+
+	Out.MovementMode = MovementMode;
+	Out.CustomMovementMode = CustomMovementMode;
+	Out.bCrouched = CharacterOwner && CharacterOwner->bIsCrouched;
+	Out.bPlaneConstraintEnabled = bConstrainToPlane;
+	Out.bPressedJump = CharacterOwner && CharacterOwner->bPressedJump;
+}
+
+void ULevelsPlayerMovementComponent::RestoreParkourSnapshot(const FLevelsParkourSnapshot& Snapshot)
+{
+	//the mode change callbacks would start cooldowns and end wall runs, everything is set by hand below instead
+	TGuardValue<bool> RestoreGuard(bRestoringSnapshot, true);
 
-		//EDrawDebugTrace:: for debug lines
-		if (UKismetSystemLibrary::CapsuleTraceSingle(GetWorld(), MantleEyeLevel, MantleFeetLevel, 20.f, 10.f, UEngineTypes::ConvertToTraceType(ECC_Visibility), false, ActorArray, EDrawDebugTrace::None, Hit, true, FLinearColor::Green, FLinearColor::Red, 7.0f))
+	if (CharacterOwner && Snapshot.bCrouched != CharacterOwner->bIsCrouched)
+	{
+		if (Snapshot.bCrouched)
 		{
-			MantleTraceDistance = Hit.Distance;
-			if (IsWalkable(Hit))
-			{
-				MantlePosition = Hit.ImpactPoint + FVector(0.f, 0.f, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
-				DisableWallClimb();
-				if (SetCustomMovementMode(MOVE_LedgeGrab))
-				{
-					DisableMovement();
-					//DisableMovement() sets the CustomMovementMode to 0, we have to change the movement mode back to LedgeGrab
-					CustomMovementMode = MOVE_LedgeGrab;
-					//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Is this a ledge grab?")));
-					StopMovementImmediately();
-					GravityScale = 0.f;
-					GetWorld()->GetFirstPlayerController()->ClientStartCameraShake(LedgeGrabShake);
-					//UE_LOG(LogTemp, Warning, TEXT("MantleTraceDistance: %f"), MantleTraceDistance);
-					//UE_LOG(LogTemp, Warning, TEXT("CapsuleHalfHeight: %f"), CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
-					//check if the player can quick mantle
-					if (QuickMantle())
-					{
-						EnableMantleCheck();
-					}
-					else
-					{
-						GetWorld()->GetTimerManager().SetTimer(MantleCooldownTimerHandle, this, &ULevelsPlayerMovementComponent::EnableMantleCheck, .25f, true);
-					}
-					//GetWorld()->GetTimerManager().SetTimer(MantleCooldownTimerHandle, this, &ULevelsPlayerMovementComponent::EnableMantle, 0.25f, true);
-					//DisableMantle();
-				}
-			}
-			else
-			{
-				WallClimbMovement();
-			}
+			Crouch(true);
 		}
 		else
 		{
-			WallClimbMovement();
+			UnCrouch(true);
 		}
 	}
-	else
+
+	SetMovementMode((EMovementMode)Snapshot.MovementMode);
+	//parkour keeps its own sub state in CustomMovementMode alongside walking and falling
+	CustomMovementMode = Snapshot.CustomMovementMode;
+
+	if (UpdatedComponent)
 	{
-		WallClimbEnd(.35f);
+		UpdatedComponent->SetWorldLocationAndRotation(Snapshot.Location, Snapshot.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
 	}
-	
-}
+	Velocity = Snapshot.Velocity;
+	PendingLaunchVelocity = Snapshot.PendingLaunchVelocity;
 
-bool ULevelsPlayerMovementComponent::WallClimbMovement()
-{
-	FHitResult Hit(ForceInit);
-	//DrawDebugLine(GetWorld(), MantleEyeLevel, CharacterOwner->GetActorForwardVector() * 50 + MantleFeetLevel, FColor::Green, false, 7.0f);
-	if (ForwardInput() && GetWorld()->LineTraceSingleByChannel(Hit, MantleEyeLevel, CharacterOwner->GetActorForwardVector() * 50 + MantleFeetLevel, ECC_Visibility))
-	{
-		WallClimbHitNormal = Hit.Normal;
-		SetCustomMovementMode(MOVE_WallClimb);
+	SetPlaneConstraintNormal(Snapshot.PlaneConstraintNormal);
+	SetPlaneConstraintEnabled(Snapshot.bPlaneConstraintEnabled);
 
-		CharacterOwner->LaunchCharacter(FVector(WallClimbHitNormal.X * -600.f, WallClimbHitNormal.Y * -600.f, WallClimbSpeed), true, true);
-		
-		return true;
+	GravityScale = Snapshot.GravityScale;
+	GroundFriction = Snapshot.GroundFriction;
+	BrakingDecelerationWalking = Snapshot.BrakingDecelerationWalking;
+	MaxWalkSpeed = Snapshot.MaxWalkSpeed;
+
+	for (int32 Index = 0; Index < (int32)ELevelsParkourCooldown::Num; ++Index)
+	{
+		CooldownStep[Index] = Snapshot.CooldownStep[Index];
+		CooldownPeriod[Index] = Snapshot.CooldownPeriod[Index];
 	}
-	else 
+
+	ParkourSim.State = Snapshot.Parkour;
+
+	if (CharacterOwner)
 	{
-		WallClimbEnd(.35f);
-		return false;
+		CharacterOwner->bPressedJump = Snapshot.bPressedJump;
 	}
+
+	ParkourStep = Snapshot.Step;
 }
 
-bool ULevelsPlayerMovementComponent::CanWallClimb()
+const FLevelsParkourSnapshot* ULevelsPlayerMovementComponent::FindParkourSnapshot(int32 Step) const
 {
-	if(ForwardInput() && IsFalling() && (CustomMovementMode == MOVE_CustomNone || CustomMovementMode == MOVE_WallClimb || IsWallRunning()))
+	if (SnapshotHistory.Num() == 0 || Step < 0)
 	{
-		//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Can Wall Climb")));
-		return true;
+		return nullptr;
 	}
-	return false;
-}
 
-void ULevelsPlayerMovementComponent::EnableWallClimb()
-{
-	bWallClimbEnabled = true;
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("bWallClimbEnabled: %s"), (bWallClimbEnabled ? TEXT("true") : TEXT("false"))));
+	const FLevelsParkourSnapshot& Snapshot = SnapshotHistory[Step % SnapshotHistory.Num()];
+	return Snapshot.Step == Step ? &Snapshot : nullptr;
 }
 
-void ULevelsPlayerMovementComponent::DisableWallClimb()
+bool ULevelsPlayerMovementComponent::ResimulateFrom(const FLevelsParkourSnapshot& Snapshot)
 {
-	bWallClimbEnabled = false;
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("bWallClimbEnabled: %s"), (bWallClimbEnabled ? TEXT("true") : TEXT("false"))));
-	DisableMantle();
-	//GetWorld()->GetTimerManager().SetTimer(WallClimbCooldownTimerHandle, this, &ULevelsPlayerMovementComponent::EnableWallClimb, Cooldown, true);
-}
+	const int32 TargetStep = ParkourStep;
+	const int32 HistorySize = InputHistory.Num();
+	if (!bFixedStepSimulation || !CharacterOwner || HistorySize == 0 || Snapshot.Step > TargetStep || TargetStep - Snapshot.Step >= HistorySize)
+	{
+		return false;
+	}
 
-void ULevelsPlayerMovementComponent::WallClimbEnd(float Cooldown)
-{
-	if (CustomMovementMode == MOVE_LedgeGrab || CustomMovementMode == MOVE_WallClimb || CustomMovementMode == MOVE_Mantle)
+	TGuardValue<bool> ResimulateGuard(bResimulating, true);
+	RestoreParkourSnapshot(Snapshot);
+
+	//same order as TickComponent, the capsule moves first and parkour steps after it. The capsule is moved at the
+	//step rate too, so the replay matches live play when the game runs at the same fixed rate
+	const float StepSeconds = 1.f / FixedStepRate;
+	while (ParkourStep < TargetStep)
 	{
-		if (SetCustomMovementMode(MOVE_CustomNone)) 
-		{
-			DisableWallClimb();
-			DisableMantleCheck();
-			MantleTraceDistance = 0.f;
-			GetWorld()->GetTimerManager().SetTimer(WallClimbCooldownTimerHandle, this, &ULevelsPlayerMovementComponent::EnableWallClimb, Cooldown, false);
-			GetWorld()->GetTimerManager().SetTimer(QueueTimerHandle, this, &ULevelsPlayerMovementComponent::CheckQueuedMovement, Cooldown, true);
-		}
-			
+		const FLevelsParkourInput Input = InputHistory[(ParkourStep + 1) % HistorySize];
+
+		//what ControlledCharacterMove does, without sending the move to the server
+		CharacterOwner->CheckJumpInput(StepSeconds);
+		Acceleration = ScaleInputAcceleration(ConstrainInputAcceleration(Input.MoveInput));
+		PerformMovement(StepSeconds);
+		CharacterOwner->ClearJumpInput(StepSeconds);
+
+		SimulateParkourStep(Input);
 	}
+
+	return true;
 }
 
-bool ULevelsPlayerMovementComponent::MantleCheck()
+//Parkour core adapter
+
+LevelsParkour::FVec3 FLevelsParkourAdapter::GetLocation() const
 {
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Quick Mantle Bool %s"), (QuickMantle() ? TEXT("true") : TEXT("false"))));
-	if (ForwardInput() && (CustomMovementMode == MOVE_LedgeGrab || QuickMantle()))
-	{
-		//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Mantle Check passed")));
-		return true;
-	}
-	return false;
+	return ToParkour(Movement->CharacterOwner->GetActorLocation());
 }
 
-bool ULevelsPlayerMovementComponent::QuickMantle()
+LevelsParkour::FVec3 FLevelsParkourAdapter::GetForward() const
 {
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Did a quick mantle%s"), (MantleTraceDistance > CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() ? TEXT("true") : TEXT("false"))));
-	return MantleTraceDistance > CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	return ToParkour(Movement->CharacterOwner->GetActorForwardVector());
 }
 
-void ULevelsPlayerMovementComponent::MantleMovement()
+LevelsParkour::FVec3 FLevelsParkourAdapter::GetRight() const
 {
-	GetWorld()->GetFirstPlayerController()->SetControlRotation(FMath::RInterpTo(GetWorld()->GetFirstPlayerController()->GetControlRotation(),
-		UKismetMathLibrary::FindLookAtRotation(FVector(CharacterOwner->GetActorLocation().X, CharacterOwner->GetActorLocation().Y, 0.f), FVector(MantlePosition.X, MantlePosition.Y, 0.f)), GetWorld()->GetDeltaSeconds(), 7.f));
-	
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("MantleMovement()")));
-	CharacterOwner->SetActorLocation(FMath::VInterpTo(CharacterOwner->GetActorLocation(), MantlePosition, GetWorld()->GetDeltaSeconds(), (QuickMantle() ? QuickMantleSpeed : MantleSpeed)));
+	return ToParkour(Movement->CharacterOwner->GetActorRightVector());
+}
 
-	if (FVector::Distance(CharacterOwner->GetActorLocation(), MantlePosition) < 8.f)
-	{
-		WallClimbEnd(0.5f);
-	}
+LevelsParkour::FVec3 FLevelsParkourAdapter::GetUp() const
+{
+	return ToParkour(Movement->CharacterOwner->GetActorUpVector());
 }
 
-void ULevelsPlayerMovementComponent::MantleStart()
+LevelsParkour::FVec3 FLevelsParkourAdapter::GetEyeLocation() const
 {
-	if (SetCustomMovementMode(MOVE_Mantle))
+	//the owner's own camera, the first player controller is somebody else entirely on a server. A player
+	//controller's view point is its camera, which mantle heights were tuned against, bots fall back to their eyes
+	FVector EyeLocation;
+	FRotator EyeRotation;
+	if (const AController* Controller = Movement->CharacterOwner->GetController())
+	{
+		Controller->GetActorEyesViewPoint(EyeLocation, EyeRotation);
+	}
+	else
 	{
-		//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("MantleStart()"), (QuickMantle() ? TEXT("true") : TEXT("false"))));
-		GetWorld()->GetFirstPlayerController()->ClientStartCameraShake(QuickMantle() ? QuickMantleShake : MantleShake);
-		DisableMantleCheck();
-		EnableMantle();
+		Movement->CharacterOwner->GetActorEyesViewPoint(EyeLocation, EyeRotation);
 	}
+	return ToParkour(EyeLocation);
 }
 
-void ULevelsPlayerMovementComponent::MantleVectors()
+LevelsParkour::FVec3 FLevelsParkourAdapter::GetVelocity() const
 {
-	GetWorld()->GetFirstPlayerController()->GetActorEyesViewPoint(MantleEyeLevel, CurrentRotation);
-	MantleEyeLevel = (MantleEyeLevel + FVector(0.f, 0.f, 50.f)) + (CharacterOwner->GetActorForwardVector() * 50.f);
-	MantleFeetLevel = (CharacterOwner->GetActorLocation() - (FVector(0.f, 0.f, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() - MantleHeight))) + (CharacterOwner->GetActorForwardVector() * 50.f);
+	return ToParkour(Movement->Velocity);
 }
 
-void ULevelsPlayerMovementComponent::EnableMantle()
+float FLevelsParkourAdapter::GetCapsuleHalfHeight() const
 {
-	bMantleEnabled = true;
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("bMantleEnabled: %s"), (bMantleEnabled ? TEXT("true") : TEXT("false"))));
+	return Movement->CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 }
 
-void ULevelsPlayerMovementComponent::DisableMantle()
+LevelsParkour::FVec3 FLevelsParkourAdapter::GetMoveInput() const
 {
-	bMantleEnabled = false;
-	//GetWorld()->GetTimerManager().SetTimer(MantleCooldownTimerHandle, this, &ULevelsPlayerMovementComponent::EnableMantle, Cooldown, true);
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("bMantleEnabled: %s"), (bMantleEnabled ? TEXT("true") : TEXT("false"))));
+	//fixed steps only read their own input so a replay sees exactly what the original step saw
+	return ToParkour(Movement->bFixedStepSimulation ? Movement->StepInput.MoveInput : Movement->GetLastInputVector());
 }
 
-void ULevelsPlayerMovementComponent::EnableMantleCheck()
+float FLevelsParkourAdapter::GetDeltaSeconds() const
 {
-	bMantleCheckEnabled = true;
+	return Movement->GetParkourDeltaSeconds();
 }
 
-void ULevelsPlayerMovementComponent::DisableMantleCheck()
+float FLevelsParkourAdapter::GetTime() const
 {
-	bMantleCheckEnabled = false;
+	return Movement->GetParkourTime();
 }
 
-void ULevelsPlayerMovementComponent::LedgeGrabJump()
+LevelsParkour::EBaseMovement FLevelsParkourAdapter::GetMovement() const
 {
-	if (CustomMovementMode == MOVE_LedgeGrab || CustomMovementMode == MOVE_WallClimb || CustomMovementMode == MOVE_Mantle)
-	{
-		//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Ledge grab jump")));
-		WallClimbEnd(0.35f);
-		CharacterOwner->LaunchCharacter(FVector(WallClimbHitNormal.X * LedgeGrabJumpForce, WallClimbHitNormal.Y * LedgeGrabJumpForce, LedgeGrabJumpHeight), false, true);
-	}
+	return ToBaseMovement(Movement->MovementMode);
 }
 
-bool ULevelsPlayerMovementComponent::IsSliding()
+void FLevelsParkourAdapter::SetMovement(LevelsParkour::EBaseMovement NewMovement)
 {
-	if (CustomMovementMode == MOVE_Slide)
+	switch (NewMovement)
 	{
-		return true;
+	case LevelsParkour::EBaseMovement::None:
+		Movement->SetMovementMode(MOVE_None);
+		break;
+	case LevelsParkour::EBaseMovement::Walking:
+		Movement->SetMovementMode(MOVE_Walking);
+		break;
+	case LevelsParkour::EBaseMovement::Falling:
+		Movement->SetMovementMode(MOVE_Falling);
+		break;
+	default:
+		break;
 	}
-	return false;
 }
 
-void ULevelsPlayerMovementComponent::SlideUpdate()
+LevelsParkour::EParkourMode FLevelsParkourAdapter::GetMode() const
 {
-	if (CustomMovementMode == MOVE_Slide)
-	{
-		if (Velocity.Size() <= 350.f)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Slide Update")));
-			SlideEnd(true);
-		}
-	}
+	return (LevelsParkour::EParkourMode)Movement->CustomMovementMode;
 }
 
-void ULevelsPlayerMovementComponent::SlideJump()
+void FLevelsParkourAdapter::SetMode(LevelsParkour::EParkourMode Mode)
 {
-	if (CustomMovementMode == MOVE_Slide)
+	//parkour keeps its own sub state in CustomMovementMode alongside walking and falling
+	if (Movement->CustomMovementMode != (uint8)Mode && !Movement->bRestoringSnapshot)
 	{
-		SlideEnd(false);
-
+		Movement->CountModeTransition();
 	}
+	Movement->CustomMovementMode = (uint8)Mode;
 }
 
-void ULevelsPlayerMovementComponent::EnableSlide()
+LevelsParkour::FMovementParams FLevelsParkourAdapter::GetMovementParams() const
 {
-	bSlidingEnabled = true;
+	LevelsParkour::FMovementParams Params;
+	Params.GravityScale = Movement->GravityScale;
+	Params.GroundFriction = Movement->GroundFriction;
+	Params.BrakingDecelerationWalking = Movement->BrakingDecelerationWalking;
+	Params.MaxWalkSpeed = Movement->MaxWalkSpeed;
+	Params.MaxWalkSpeedCrouched = Movement->MaxWalkSpeedCrouched;
+	return Params;
 }
 
-void ULevelsPlayerMovementComponent::DisableSlide()
+void FLevelsParkourAdapter::SetMovementParams(const LevelsParkour::FMovementParams& Params)
 {
-	bSlidingEnabled = false;
+	Movement->GravityScale = Params.GravityScale;
+	Movement->GroundFriction = Params.GroundFriction;
+	Movement->BrakingDecelerationWalking = Params.BrakingDecelerationWalking;
+	Movement->MaxWalkSpeed = Params.MaxWalkSpeed;
+	Movement->MaxWalkSpeedCrouched = Params.MaxWalkSpeedCrouched;
 }
 
-bool ULevelsPlayerMovementComponent::CanSlide()
+void FLevelsParkourAdapter::SetLocation(const LevelsParkour::FVec3& Location)
 {
-	if ((CustomMovementMode == MOVE_Sprint || bWantsToSprint) && MovingForward())
-	{
-		return true;
-	}
-	return false;
+	Movement->CharacterOwner->SetActorLocation(ToEngine(Location));
 }
 
-void ULevelsPlayerMovementComponent::SlideStart()
+void FLevelsParkourAdapter::Jump()
 {
-	if (CanSlide() && IsWalking())
-	{
-		SprintEnd();
-		SetCustomMovementMode(MOVE_Slide);
-		Crouch(true);
-		GroundFriction = 0.f;
-		BrakingDecelerationWalking = 1400.f;
-		MaxWalkSpeed = 0.f;
-		SetPlaneConstraintFromVectors(Velocity.GetSafeNormal(), CharacterOwner->GetActorUpVector());
-		SetPlaneConstraintEnabled(true);
-		FHitResult Hit(ForceInit);
-		FVector SlideVector;
-		DrawDebugLine(GetWorld(), CharacterOwner->GetActorLocation(), (CharacterOwner->GetActorUpVector() * -200) + CharacterOwner->GetActorLocation(), FColor::Green, false, 7.0f);
-		GetWorld()->LineTraceSingleByChannel(Hit, CharacterOwner->GetActorLocation(), (CharacterOwner->GetActorUpVector() * -200) + CharacterOwner->GetActorLocation(), ECC_Visibility);
-		SlideVector = FVector::CrossProduct(CharacterOwner->GetActorRightVector(), Hit.ImpactNormal) * -1.0f;
-		
-		//FString GravString = FString::SanitizeFloat(GravityScale);
-
-		if (SlideVector.Z <= .02f)
-		{
-			FString SlideString = SlideVector.ToString();
-			GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, *SlideString);
-			AddImpulse(SlideImpulseForce * SlideVector, true);
-		}
-		EnableSlide();
-		bWantsToSlide = false;
-		bWantsToSprint = false;
-	}
+	Movement->CharacterOwner->Jump();
 }
 
-void ULevelsPlayerMovementComponent::SlideEnd(bool CrouchAfter)
+void FLevelsParkourAdapter::Launch(const LevelsParkour::FVec3& LaunchVelocity, bool bXYOverride, bool bZOverride)
 {
-	if (CustomMovementMode == MOVE_Slide)
-	{
-		if (CrouchAfter)
-		{
-			Crouch(true);
-			GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Orange, TEXT("Crouch"));
-			//SetCustomMovementMode(MOVE_Crouch);
-			SprintStart();
-			//MaxWalkSpeed = 300.f;
-			
-		}
-		else
-		{
-			SetCustomMovementMode(MOVE_CustomNone);
-			UnCrouch();
-		}
-		DisableSlide();
-	}
+	Movement->CharacterOwner->LaunchCharacter(ToEngine(LaunchVelocity), bXYOverride, bZOverride);
 }
 
-void ULevelsPlayerMovementComponent::CrouchSlideCheck()
+void FLevelsParkourAdapter::AddImpulse(const LevelsParkour::FVec3& Impulse)
 {
-	if (CustomMovementMode == MOVE_LedgeGrab || CustomMovementMode == MOVE_WallClimb || CustomMovementMode == MOVE_Mantle)
-	{
-		//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Ledge grab jump")));
-		WallClimbEnd(0.5f);
-	}
-	else if (IsWallRunning())
-	{
-		WallRunEnd(0.5f);
-	}
-	else if (!CanSlide())
-	{
-		if (CustomMovementMode == MOVE_CustomNone)
-		{
-			CrouchStart();
-		}
-		else if (CustomMovementMode == MOVE_Crouch)
-		{
-			CrouchEnd();
-		}
-	}
-	else if (IsWalking())
-	{
-		SlideStart();
-	}
-
-	bWantsToSlide = true;
+	Movement->AddImpulse(ToEngine(Impulse), true);
 }
 
-void ULevelsPlayerMovementComponent::CrouchJump()
+void FLevelsParkourAdapter::StopMovement()
 {
-	if (CustomMovementMode == MOVE_Crouch)
-	{
-		CrouchEnd();
-	}
+	Movement->StopMovementImmediately();
 }
 
-void ULevelsPlayerMovementComponent::CrouchStart()
+void FLevelsParkourAdapter::DisableMovement()
 {
-	if (CustomMovementMode == MOVE_CustomNone && IsWalking())
-	{
-		Crouch(true);
-		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Orange, TEXT("Crouch"));
-		SetCustomMovementMode(MOVE_Crouch);
-		MaxWalkSpeed = 300.f;
-		bWantsToSlide = false;
-		bWantsToSprint = false;
-	}
-
+	Movement->DisableMovement();
 }
 
-void ULevelsPlayerMovementComponent::CrouchEnd()
+void FLevelsParkourAdapter::Crouch(bool bClientSimulation)
 {
-	if (CustomMovementMode == MOVE_Crouch)
-	{
-		UnCrouch(true);
-		SetCustomMovementMode(MOVE_CustomNone);
-		bWantsToSlide = false;
-		bWantsToSprint = false;
-	}
+	Movement->Crouch(bClientSimulation);
+}
 
+void FLevelsParkourAdapter::UnCrouch(bool bClientSimulation)
+{
+	Movement->UnCrouch(bClientSimulation);
 }
 
-void ULevelsPlayerMovementComponent::SprintUpdate()
+void FLevelsParkourAdapter::ConstrainToPlane(const LevelsParkour::FVec3& Forward, const LevelsParkour::FVec3& Up)
 {
-	if (!(CustomMovementMode == MOVE_Sprint && ForwardInput()))
-	{
-		//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Sprint Update (END)"));
-		SprintEnd();
-	}
+	Movement->SetPlaneConstraintFromVectors(ToEngine(Forward), ToEngine(Up));
+	Movement->SetPlaneConstraintEnabled(true);
 }
 
-void ULevelsPlayerMovementComponent::EnableSprint()
+void FLevelsParkourAdapter::ReleasePlaneConstraint()
 {
-	bSprintEnabled = true;
+	Movement->SetPlaneConstraintEnabled(false);
 }
 
-void ULevelsPlayerMovementComponent::DisableSprint()
+void FLevelsParkourAdapter::SetCooldown(LevelsParkour::ECooldown Cooldown, float Seconds, bool bLooping)
 {
-	bSprintEnabled = false;
+	Movement->SetParkourCooldown(Cooldown, Seconds, bLooping);
 }
 
-void ULevelsPlayerMovementComponent::SprintStart()
+void FLevelsParkourAdapter::ClearCooldown(LevelsParkour::ECooldown Cooldown)
 {
-	//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Sprint Start"));
-	CrouchEnd();
-	SlideEnd(false);
-	if (CustomMovementMode == MOVE_CustomNone && IsWalking()) 
-	{
-		//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Sprint Start2"));
-		if (SetCustomMovementMode(MOVE_Sprint))
-		{
-			//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Sprint Start3"));
-			MaxWalkSpeed = SprintSpeed;
-			EnableSprint();
-			bWantsToSlide = false;
-			bWantsToSprint = false;
-		}
-	}
+	Movement->ClearParkourCooldown(Cooldown);
 }
 
-void ULevelsPlayerMovementComponent::SprintEnd()
+void FLevelsParkourAdapter::TurnTowards(const LevelsParkour::FVec3& Target, float DeltaSeconds, float InterpSpeed)
 {
-	if (CustomMovementMode == MOVE_Sprint)
+	//turn the local player towards the ledge, the server gets the new rotation from the client's moves
+	APlayerController* PC = Movement->GetLocalPlayerController();
+	if (!PC)
 	{
-		if (SetCustomMovementMode(MOVE_CustomNone))
-		{
-		//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Sprint End!!"));
-		//MaxWalkSpeed /= SprintSpeedMultiplier;
-		DisableSprint();
-		//GetWorld()->GetTimerManager().SetTimer(SprintCooldownTimerHandle, this, &ULevelsPlayerMovementComponent::EnableSprint, .1f, false);
-		}
+		return;
 	}
+
+	const FVector Location = Movement->CharacterOwner->GetActorLocation();
+	PC->SetControlRotation(FMath::RInterpTo(PC->GetControlRotation(),
+		UKismetMathLibrary::FindLookAtRotation(FVector(Location.X, Location.Y, 0.f), FVector(Target.X, Target.Y, 0.f)), DeltaSeconds, InterpSpeed));
 }
 
-void ULevelsPlayerMovementComponent::SprintJump()
+void FLevelsParkourAdapter::OnParkourEvent(LevelsParkour::EParkourEvent Event)
 {
-	if (CustomMovementMode == MOVE_Sprint)
+	switch (Event)
 	{
-		//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Sprint Jump"));
-		SprintEnd();
-		bWantsToSprint = true;
+	case LevelsParkour::EParkourEvent::Jumped:
+		Movement->PublishCosmeticEvent(ELevelsCosmeticEvent::Jumped);
+		break;
+	case LevelsParkour::EParkourEvent::Landed:
+		Movement->PublishCosmeticEvent(ELevelsCosmeticEvent::Landed);
+		break;
+	case LevelsParkour::EParkourEvent::LedgeGrabbed:
+		Movement->PublishCosmeticEvent(ELevelsCosmeticEvent::LedgeGrabbed);
+		break;
+	case LevelsParkour::EParkourEvent::Mantled:
+		Movement->PublishCosmeticEvent(ELevelsCosmeticEvent::Mantled);
+		break;
+	case LevelsParkour::EParkourEvent::QuickMantled:
+		Movement->PublishCosmeticEvent(ELevelsCosmeticEvent::QuickMantled);
+		break;
+	case LevelsParkour::EParkourEvent::SlideStarted:
+		Movement->PublishCosmeticEvent(ELevelsCosmeticEvent::SlideStarted);
+		break;
+	default:
+		break;
 	}
 }
 
-void ULevelsPlayerMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
+static void ToParkourHit(const FHitResult& Hit, bool bWalkable, LevelsParkour::FTraceHit& Out)
 {
-	Super::PhysCustom(deltaTime, Iterations);
+	Out.ImpactPoint = ToParkour(Hit.ImpactPoint);
+	Out.Normal = ToParkour(Hit.Normal);
+	Out.ImpactNormal = ToParkour(Hit.ImpactNormal);
+	Out.Distance = Hit.Distance;
+	Out.bWalkable = bWalkable;
 }
 
+bool FLevelsParkourAdapter::LineTrace(const LevelsParkour::FVec3& Start, const LevelsParkour::FVec3& End, LevelsParkour::FTraceHit& Hit) const
+{
+	Movement->CountSceneQuery();
+	FHitResult EngineHit(ForceInit);
+	const bool bHit = Movement->GetWorld()->LineTraceSingleByChannel(EngineHit, ToEngine(Start), ToEngine(End), ECC_Visibility);
+	ToParkourHit(EngineHit, bHit && Movement->IsWalkable(EngineHit), Hit);
+	return bHit;
+}
 
-void ULevelsPlayerMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector & OldLocation, const FVector & OldVelocity)
+bool FLevelsParkourAdapter::CapsuleTrace(const LevelsParkour::FVec3& Start, const LevelsParkour::FVec3& End, float Radius, float HalfHeight, LevelsParkour::FTraceHit& Hit) const
 {
-	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
-}
\ No newline at end of file
+	Movement->CountSceneQuery();
+	FHitResult EngineHit(ForceInit);
+	const TArray<AActor*> ActorsToIgnore;
+	//EDrawDebugTrace:: for debug lines
+	const bool bHit = UKismetSystemLibrary::CapsuleTraceSingle(Movement->GetWorld(), ToEngine(Start), ToEngine(End), Radius, HalfHeight, UEngineTypes::ConvertToTraceType(ECC_Visibility), false, ActorsToIgnore, EDrawDebugTrace::None, EngineHit, true, FLinearColor::Green, FLinearColor::Red, 7.0f);
+	ToParkourHit(EngineHit, bHit && Movement->IsWalkable(EngineHit), Hit);
+	return bHit;
+}
@@ -4,10 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Parkour/ParkourSim.h"
 #include "LevelsPlayerMovementComponent.generated.h"
 
 class ALevels_v0Character;
+class ULevelsPlayerMovementComponent;
 class UMatineeCameraShake;
+class APlayerController;
+enum class ELevelsCosmeticEvent : uint8;
 
 /**
  * 
@@ -27,12 +31,126 @@ enum ECustomMovementMode
 	MOVE_Crouch = 8
 };
 
+/** Parkour cooldowns. Timers in the default mode, step counts in fixed step mode */
+typedef LevelsParkour::ECooldown ELevelsParkourCooldown;
+
+/** Input for one fixed parkour step */
+struct FLevelsParkourInput
+{
+	FVector MoveInput = FVector::ZeroVector;
+
+	//ELevelsInputButton bits pressed since the previous step
+	uint8 Buttons = 0;
+
+	//how long before the step the earliest of those presses came, buffered presses expire from then
+	float ButtonAge = 0.f;
+};
+
+/**
+ * Everything a fixed parkour step reads or writes, kept flat so saving and restoring is a copy.
+ * Restoring one and replaying the inputs after it reproduces the same transitions and launches.
+ */
+struct FLevelsParkourSnapshot
+{
+	int32 Step = INDEX_NONE;
+
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector Velocity = FVector::ZeroVector;
+	FVector PendingLaunchVelocity = FVector::ZeroVector;
+	FVector PlaneConstraintNormal = FVector::ZeroVector;
+
+	float GravityScale = 1.f;
+	float GroundFriction = 0.f;
+	float BrakingDecelerationWalking = 0.f;
+	float MaxWalkSpeed = 0.f;
+
+	//step each cooldown fires on (INDEX_NONE when idle) and its repeat period, 0 for one shot
+	int32 CooldownStep[(int32)ELevelsParkourCooldown::Num];
+	int32 CooldownPeriod[(int32)ELevelsParkourCooldown::Num];
+
+	LevelsParkour::FParkourState Parkour;
+
+	uint8 MovementMode = 0;
+	uint8 CustomMovementMode = 0;
+	bool bCrouched = false;
+	bool bPlaneConstraintEnabled = false;
+	//a jump pressed on this step, taken off on the next movement update
+	bool bPressedJump = false;
+};
+
+/** Work a movement component has done since its counters were last reset, checked against budgets by the automation tests */
+struct FLevelsMovementCounters
+{
+	//frames the component ticked or ran a parkour check in
+	int32 Frames = 0;
+	int32 SceneQueries = 0;
+	int32 MaxSceneQueriesPerFrame = 0;
+	//movement mode and custom movement mode changes
+	int32 ModeTransitions = 0;
+	int32 MaxModeTransitionsPerFrame = 0;
+	//parkour cooldowns started or restarted
+	int32 CooldownsSet = 0;
+	int32 MaxCooldownsSetPerFrame = 0;
+	//game thread time spent in TickComponent and the parkour timers
+	double TotalMicroseconds = 0.0;
+	double MaxMicrosecondsPerFrame = 0.0;
+};
+
+/** Lets the parkour core drive the movement component and trace against the world */
+class FLevelsParkourAdapter final : public LevelsParkour::IParkourBody, public LevelsParkour::ISceneQuery
+{
+public:
+	explicit FLevelsParkourAdapter(ULevelsPlayerMovementComponent* InMovement) : Movement(InMovement) {}
+
+	//IParkourBody
+	virtual LevelsParkour::FVec3 GetLocation() const override;
+	virtual LevelsParkour::FVec3 GetForward() const override;
+	virtual LevelsParkour::FVec3 GetRight() const override;
+	virtual LevelsParkour::FVec3 GetUp() const override;
+	virtual LevelsParkour::FVec3 GetEyeLocation() const override;
+	virtual LevelsParkour::FVec3 GetVelocity() const override;
+	virtual float GetCapsuleHalfHeight() const override;
+	virtual LevelsParkour::FVec3 GetMoveInput() const override;
+	virtual float GetDeltaSeconds() const override;
+	virtual float GetTime() const override;
+	virtual LevelsParkour::EBaseMovement GetMovement() const override;
+	virtual void SetMovement(LevelsParkour::EBaseMovement NewMovement) override;
+	virtual LevelsParkour::EParkourMode GetMode() const override;
+	virtual void SetMode(LevelsParkour::EParkourMode Mode) override;
+	virtual LevelsParkour::FMovementParams GetMovementParams() const override;
+	virtual void SetMovementParams(const LevelsParkour::FMovementParams& Params) override;
+	virtual void SetLocation(const LevelsParkour::FVec3& Location) override;
+	virtual void Jump() override;
+	virtual void Launch(const LevelsParkour::FVec3& LaunchVelocity, bool bXYOverride, bool bZOverride) override;
+	virtual void AddImpulse(const LevelsParkour::FVec3& Impulse) override;
+	virtual void StopMovement() override;
+	virtual void DisableMovement() override;
+	virtual void Crouch(bool bClientSimulation) override;
+	virtual void UnCrouch(bool bClientSimulation) override;
+	virtual void ConstrainToPlane(const LevelsParkour::FVec3& Forward, const LevelsParkour::FVec3& Up) override;
+	virtual void ReleasePlaneConstraint() override;
+	virtual void SetCooldown(LevelsParkour::ECooldown Cooldown, float Seconds, bool bLooping) override;
+	virtual void ClearCooldown(LevelsParkour::ECooldown Cooldown) override;
+	virtual void TurnTowards(const LevelsParkour::FVec3& Target, float DeltaSeconds, float InterpSpeed) override;
+	virtual void OnParkourEvent(LevelsParkour::EParkourEvent Event) override;
+
+	//ISceneQuery
+	virtual bool LineTrace(const LevelsParkour::FVec3& Start, const LevelsParkour::FVec3& End, LevelsParkour::FTraceHit& Hit) const override;
+	virtual bool CapsuleTrace(const LevelsParkour::FVec3& Start, const LevelsParkour::FVec3& End, float Radius, float HalfHeight, LevelsParkour::FTraceHit& Hit) const override;
+
+private:
+	ULevelsPlayerMovementComponent* Movement;
+};
+
 UCLASS()
 class LEVELS_V0_API ULevelsPlayerMovementComponent : public UCharacterMovementComponent
 {
 
 	GENERATED_BODY()
 
+	friend class FLevelsParkourAdapter;
+
 public:
 
 	//Overrides
@@ -51,6 +169,8 @@ public:
 
 	virtual void ProcessLanded(const FHitResult& Hit, float remainingTime, int32 Iterations) override;
 
+	virtual bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+
 	//virtual bool DoJump(bool bReplayingMoves) override;
 
 
@@ -66,35 +186,11 @@ public:
 
 protected:
 
-	//for wall running
-	FVector RightDirection;
-	FVector LeftDirection;
-	FVector CurrentLocation;
-	FVector ForwardDirection;
-	FVector RightEndpoint;
-	FVector LeftEndpoint;
-	FVector WallRunHitNormal;
-	FVector WallClimbHitNormal;
-	FVector PrevWallRunHitNormal;
-
-	//for mantling
-	FVector MantleEyeLevel;
-	FVector MantleFeetLevel;
-	FVector MantleHitNormal;
-	FVector MantlePosition;
-	float MantleTraceDistance;
-	
-	//booleans for states (movement modes)
-	bool bWallRunEnabled = false;
-	bool bWallClimbEnabled = false;
-	bool bMantleEnabled = false;
-	bool bMantleCheckEnabled = false;
-	bool bSprintEnabled = false;
-	bool bCrouchEnabled = false;
-	bool bChangeCamera = false;
-	bool bWantsToSprint = false;
-	bool bWantsToSlide = false;
-	bool bSlidingEnabled = false;
+	//the parkour rules live in the engine independent core, this component feeds it and applies what it asks for
+	FLevelsParkourAdapter ParkourAdapter{ this };
+	LevelsParkour::FParkourSim ParkourSim{ ParkourAdapter, ParkourAdapter };
+
+	bool bMovementChecksPaused = false;
 
 	//timer handles
 	FTimerHandle WallRunCooldownTimerHandle;
@@ -103,18 +199,50 @@ protected:
 	FTimerHandle WallClimbCooldownTimerHandle;
 	FTimerHandle MantleCooldownTimerHandle;
 	FTimerHandle SprintCooldownTimerHandle;
-	FTimerHandle QueueTimerHandle;
-	FRotator CurrentRotation;
-	TArray<AActor*, FDefaultAllocator> ActorArray;
-
-	//set default gravity scale value to a variable
-	float DefaultGravity;
-	float DefaultGroundFriction;
-	float DefaultBrakingDeceleration;
-	float DefaultWalkSpeed;
-	float DefaultCrouchSpeed;
 
-#pragma endregion
+	/** Copies the editable tuning into the parkour core, before every update so changes made while playing take effect */
+	void SyncParkourConfig();
+
+	/** Starts a cooldown that calls its enable function after Seconds, repeating if bLooping */
+	void SetParkourCooldown(ELevelsParkourCooldown Cooldown, float Seconds, bool bLooping);
+	void ClearParkourCooldown(ELevelsParkourCooldown Cooldown);
+	void FireParkourCooldown(ELevelsParkourCooldown Cooldown);
+
+	//fixed step state
+	int32 ParkourStep = 0;
+	int32 CooldownStep[(int32)ELevelsParkourCooldown::Num];
+	int32 CooldownPeriod[(int32)ELevelsParkourCooldown::Num];
+	float ParkourStepAccumulator = 0.f;
+	FLevelsParkourInput PendingInput;
+	//parkour time of the earliest press in PendingInput
+	float PendingPressTime = 0.f;
+	FLevelsParkourInput StepInput;
+	TArray<FLevelsParkourSnapshot> SnapshotHistory;
+	TArray<FLevelsParkourInput> InputHistory;
+	bool bResimulating = false;
+	bool bRestoringSnapshot = false;
+
+	//budget counters
+	FLevelsMovementCounters MovementCounters;
+	uint64 CounterFrame = 0;
+	uint64 CounterFrameCycles = 0;
+	int32 CounterFrameSceneQueries = 0;
+	int32 CounterFrameModeTransitions = 0;
+	int32 CounterFrameCooldownsSet = 0;
+
+	/** Starts a new per frame total the first time the component does work in a frame */
+	void BeginCounterFrame();
+
+	/** Adds game thread time to the counters */
+	void AddCounterCycles(uint64 Cycles);
+
+	/** Counts one trace the parkour core asked for */
+	void CountSceneQuery();
+
+	/** Counts a movement mode or parkour mode change, parkour modes change without going through SetMovementMode */
+	void CountModeTransition();
+
+	friend struct FLevelsMovementCounterScope;
 
 public:
 
@@ -129,9 +257,73 @@ public:
 	UFUNCTION()
 		void ResetMovement();
 
-	/** Resets movement state based on the current movement state */
-	UFUNCTION()
-		void CheckQueuedMovement();
+	/** Arms the looping timers that poll for wall movement and camera tilt */
+	void StartMovementChecks();
+
+	/** Stops or restarts the polling timers, used while a character sits dormant in the pool */
+	void SetMovementChecksPaused(bool bPaused);
+
+	/** Clears every parkour flag, cooldown and custom mode so a pooled character starts fresh */
+	void ResetParkourState();
+
+	/** Jump, crouch and sprint presses. Handled right away normally, on the next step in fixed step mode */
+	void PressParkourButton(uint8 Button);
+
+	/** The parkour state machine, for tools that want to look inside */
+	const LevelsParkour::FParkourSim& GetParkourSim() const { return ParkourSim; }
+
+	/** Scene queries, mode changes and game thread time since the last reset */
+	const FLevelsMovementCounters& GetMovementCounters() const { return MovementCounters; }
+
+	void ResetMovementCounters();
+
+	/** Whether a parkour cooldown is waiting to fire, as a timer or in fixed step mode */
+	bool IsParkourCooldownActive(ELevelsParkourCooldown Cooldown) const;
+
+	/** Parkour cooldowns and polling timers currently running */
+	int32 GetNumLiveTimers() const;
+
+	//Fixed step simulation
+
+	/**
+	 * Runs parkour at a fixed rate off the component tick instead of the 60Hz timers. Cooldowns count steps,
+	 * interpolation uses the step length and transitions only read the step input, so every transition and
+	 * launch depends on (state, input, step) alone and can be rewound and replayed.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Fixed Step")
+		bool bFixedStepSimulation = false;
+
+	/** Parkour steps per second in fixed step mode */
+	UPROPERTY(EditAnywhere, Category = "Fixed Step", meta = (ClampMin = "10", EditCondition = "bFixedStepSimulation"))
+		int32 FixedStepRate = 60;
+
+	/** Number of past steps kept for rewinding */
+	UPROPERTY(EditAnywhere, Category = "Fixed Step", meta = (ClampMin = "2", EditCondition = "bFixedStepSimulation"))
+		int32 SnapshotHistorySize = 64;
+
+	/** Advances parkour by exactly one fixed step and records a snapshot of the result */
+	void SimulateParkourStep(const FLevelsParkourInput& Input);
+
+	/** Copies the parkour state into Out, no allocations */
+	void SaveParkourSnapshot(FLevelsParkourSnapshot& Out) const;
+
+	/** Puts the parkour state back the way it was when the snapshot was taken */
+	void RestoreParkourSnapshot(const FLevelsParkourSnapshot& Snapshot);
+
+	/** Returns the recorded snapshot for a past step, or null if it fell out of the history */
+	const FLevelsParkourSnapshot* FindParkourSnapshot(int32 Step) const;
+
+	/** Restores a (corrected) snapshot and replays the recorded inputs up to the current step, moving the character as it goes */
+	bool ResimulateFrom(const FLevelsParkourSnapshot& Snapshot);
+
+	/** Current fixed step number */
+	int32 GetParkourStep() const { return ParkourStep; }
+
+	/** Length of a parkour update, the fixed step or the frame delta */
+	float GetParkourDeltaSeconds() const;
+
+	/** Clock buffered presses are stamped with, fixed steps count their own time so replays see the same */
+	float GetParkourTime() const;
 
 	//the roll of the camera when wall jumping
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Wall Run")
@@ -145,41 +337,18 @@ public:
 	UFUNCTION()
 		void CameraTilt(float CameraRoll);
 
-	//Listens and checks for when to change movement modes and calls the movement mode functions
-	UFUNCTION()
-		void WallMovementCheck();
+	/** Returns the owner's player controller if it is controlled on this machine, nothing on servers and for remote players */
+	APlayerController* GetLocalPlayerController() const;
 
-	//gets if the player is inputting forward
-	UFUNCTION()
-		bool ForwardInput();
-
-	//Returns if the player's forward velocity is positive
-	UFUNCTION()
-		bool MovingForward();
-
-	/** Get endpoints for character in prep for a raycast when checking if there is a wall to wall run on */
-	UFUNCTION()
-		void WallRunEndVectors();
-
-	/** Check for and perform wallruns */
-	UFUNCTION()
-		void WallRunUpdate();
+	/** Starts the camera shake that goes with a movement event, for the local player only */
+	void PlayCameraShake(ELevelsCosmeticEvent Event);
 
-	/** Additional checks for if the player should be able to wall run */
-	UFUNCTION()
-		bool CanWallRun();
+	/** Queues a cosmetic event for the owning character, see ULevelsCosmeticEvents */
+	void PublishCosmeticEvent(ELevelsCosmeticEvent Event);
 
-	/** Does a raycast and performs the required movement to wall run */
-	UFUNCTION()
-		bool WallRunMovement(ACharacter* Character, FVector Start, FVector End, float WallRunDirection);
-
-	/** Wall jump */
-	UFUNCTION()
-		void WallRunJump();
-
-	/** End wall run state */
+	//Listens and checks for when to change movement modes and calls the movement mode functions
 	UFUNCTION()
-		void WallRunEnd(float Cooldown);
+		void WallMovementCheck();
 
 	//the gravity of the player when wall running
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Wall Run")
@@ -209,10 +378,6 @@ public:
 	UFUNCTION()
 		void EnableWallRun();
 
-	/** Disables wall run */
-	UFUNCTION()
-		void DisableWallRun();
-
 	/** If true use Gravity on walls */
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Wall Run")
 		bool WallRunGravityOn = false;
@@ -221,18 +386,6 @@ public:
 	UFUNCTION()
 		bool IsWallRunning();
 
-	/** Check for and perform wall climbing */
-	UFUNCTION()
-		void WallClimbUpdate();
-
-	/** Does a raycast and gets required movement to wall climb */
-	UFUNCTION()
-		bool WallClimbMovement();
-
-	/** Check if player can perform a wall Climb */
-	UFUNCTION()
-		bool CanWallClimb();
-
 	//speed the player climbs walls
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Wall Climb")
 		float WallClimbSpeed = 400.f;
@@ -241,22 +394,6 @@ public:
 	UFUNCTION()
 		void EnableWallClimb();
 
-	/** Disables wall climb */
-	UFUNCTION()
-		void DisableWallClimb();
-
-	/** End wall climb state */
-	UFUNCTION()
-		void WallClimbEnd(float Cooldown);
-
-	/** Check if player can mantle */
-	UFUNCTION()
-		bool MantleCheck();
-
-	/** Check for is player can do a quick mantle */
-	UFUNCTION()
-		bool QuickMantle();
-
 	//speed the player mantles
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Mantle")
 		float MantleSpeed = 10.f;
@@ -265,42 +402,14 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Mantle")
 		float QuickMantleSpeed = 20.f;
 
-	/** Performs the movement for a mantle */
-	UFUNCTION()
-		void MantleMovement();
-
-	/** Check for and enable mantling */
-	UFUNCTION()
-		void MantleStart();
-
-	/** Gets the vectors needed for checking for mantling */
-	UFUNCTION()
-		void MantleVectors();
-
 	//how tall something must be to mantle onto it
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Mantle")
 	float MantleHeight = 40.f;
 
-	/** Enables mantle  */
-	UFUNCTION()
-		void EnableMantle();
-
-	/** Disables mantle */
-	UFUNCTION()
-		void DisableMantle();
-
 	/** Enables mantle check  */
 	UFUNCTION()
 		void EnableMantleCheck();
 
-	/** Disables mantle check */
-	UFUNCTION()
-		void DisableMantleCheck();
-
-	/** Jumps of a wall while grabbing on a ledge */
-	UFUNCTION()
-		void LedgeGrabJump();
-
 	//The force of the jump off a ledge
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Wall Climb")
 		float LedgeGrabJumpForce = 300.f;
@@ -313,99 +422,54 @@ public:
 	UFUNCTION()
 		bool IsSliding();
 
-	/** Checks if the player is going fast enough to slide while sliding, if not it puts the player in a crouch */
-	UFUNCTION()
-		void SlideUpdate();
-
-	/** Jump in sliding state */
-	UFUNCTION()
-		void SlideJump();
-	
-	/** Enable slide check */
-	UFUNCTION()
-		void EnableSlide();
-
-	/** Disable slide check */
-	UFUNCTION()
-		void DisableSlide();
-
-	/** Start slide state */
-	UFUNCTION()
-		void SlideStart();
-
-	/** End slide state */
-	UFUNCTION()
-		void SlideEnd(bool Crouch);
-
 	/** Start crouch state */
 	UFUNCTION()
 		void CrouchSlideCheck();
 
-	/** Jump in crouching state */
-	UFUNCTION()
-		void CrouchJump();
-
-	/** Start crouch state */
-	UFUNCTION()
-		void CrouchStart();
-
-	/** End crouch state */
-	UFUNCTION()
-		void CrouchEnd();
-
-	/** Checks if player can slide */
-		UFUNCTION()
-		bool CanSlide();
-
 	//The amount of impule the player recieves while sliding
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Slide")
 		float SlideImpulseForce = 600.f;
 
-	/** Checks if the player is pressing W while sprinting, if not stop sprinting */
-	UFUNCTION()
-		void SprintUpdate();
-
-	/** Disable sprint update */
-	UFUNCTION()
-		void EnableSprint();
-
-	/** Disable sprint update */
-	UFUNCTION()
-		void DisableSprint();
-
 	/** Start sprint state */
 	UFUNCTION()
 		void SprintStart();
 
-	/** End sprint state */
-	UFUNCTION()
-		void SprintEnd();
-
-	/** Handles if the player will continue sprinting after a jump and land */
-	UFUNCTION()
-		void SprintJump();
-
 	/** Gets called whenever the player presses space */
 	UFUNCTION()
 		void OnJump();
 
 
-	//Camera shakes
+	//Camera shakes, soft so dedicated servers never load them
+
+	/** Adds the camera shakes to the character's Client bundle */
+	void GetBundleAssets(FName BundleName, TArray<FSoftObjectPath>& OutAssets) const;
 
-	UPROPERTY(EditAnywhere, Category = "Camera Shakes")
-		TSubclassOf<UMatineeCameraShake> LedgeGrabShake;
+	UPROPERTY(EditAnywhere, Category = "Camera Shakes", meta = (AssetBundles = "Client"))
+		TSoftClassPtr<UMatineeCameraShake> LedgeGrabShake;
 
-	UPROPERTY(EditAnywhere, Category = "Camera Shakes")
-		TSubclassOf<UMatineeCameraShake> JumpLandShake;
+	UPROPERTY(EditAnywhere, Category = "Camera Shakes", meta = (AssetBundles = "Client"))
+		TSoftClassPtr<UMatineeCameraShake> JumpLandShake;
 
-	UPROPERTY(EditAnywhere, Category = "Camera Shakes")
-		TSubclassOf<UMatineeCameraShake> MantleShake;
+	UPROPERTY(EditAnywhere, Category = "Camera Shakes", meta = (AssetBundles = "Client"))
+		TSoftClassPtr<UMatineeCameraShake> MantleShake;
 
-	UPROPERTY(EditAnywhere, Category = "Camera Shakes")
-		TSubclassOf<UMatineeCameraShake> QuickMantleShake;
+	UPROPERTY(EditAnywhere, Category = "Camera Shakes", meta = (AssetBundles = "Client"))
+		TSoftClassPtr<UMatineeCameraShake> QuickMantleShake;
  
 	//Sprinting speed
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Sprint")
 		float SprintSpeed = 1500.f;
+
+	//How long a jump pressed just before landing is kept for the landing
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Input Buffer")
+		float JumpBufferTime = .15f;
+
+	//How long a crouch pressed in the air is kept to slide on landing
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Input Buffer")
+		float SlideBufferTime = .4f;
+
+	//How long a sprint is carried through jumps and wall runs, or kept when pressed in the air
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Input Buffer")
+		float SprintBufferTime = 1.5f;
 };
 
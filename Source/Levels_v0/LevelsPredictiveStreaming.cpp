@@ -0,0 +1,245 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsPredictiveStreaming.h"
+#include "Levels_v0.h"
+#include "Levels_v0Character.h"
+#include "LevelsPlayerMovementComponent.h"
+#include "Engine/World.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/LevelStreamingVolume.h"
+#include "GameFramework/PlayerController.h"
+#include "EngineUtils.h"
+
+DEFINE_LOG_CATEGORY(LogLevelsStreaming);
+
+DECLARE_CYCLE_STAT(TEXT("Predictive Streaming"), STAT_LevelsPredictiveStreaming, STATGROUP_Levels);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Blocking Level Loads"), STAT_LevelsBlockingLoads, STATGROUP_Levels);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Predicted Level Requests"), STAT_LevelsPredictedRequests, STATGROUP_Levels);
+
+bool ULevelsPredictiveStreaming::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void ULevelsPredictiveStreaming::Deinitialize()
+{
+	Regions.Reset();
+	bRegionsGathered = false;
+
+	Super::Deinitialize();
+}
+
+ETickableTickType ULevelsPredictiveStreaming::GetTickableTickType() const
+{
+	//the CDO is a tickable object too, keep it out of the tick list
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool ULevelsPredictiveStreaming::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return World && World->HasBegunPlay();
+}
+
+TStatId ULevelsPredictiveStreaming::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULevelsPredictiveStreaming, STATGROUP_Tickables);
+}
+
+UWorld* ULevelsPredictiveStreaming::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void ULevelsPredictiveStreaming::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LevelsPredictiveStreaming);
+
+	UWorld* World = GetWorld();
+
+	if (!bRegionsGathered)
+	{
+		GatherRegions();
+	}
+	if (Regions.Num() == 0)
+	{
+		return;
+	}
+
+	for (FStreamingRegion& Region : Regions)
+	{
+		Region.ArrivalTime = -1.f;
+		Region.bOccupied = false;
+	}
+
+	//local players only, remote players stream on their own machines. The server streams for everyone
+	const bool bAllPlayers = World->GetNetMode() == NM_DedicatedServer;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController == nullptr || (!bAllPlayers && !PlayerController->IsLocalController()))
+		{
+			continue;
+		}
+
+		const ALevels_v0Character* Character = Cast<ALevels_v0Character>(PlayerController->GetPawn());
+		if (Character == nullptr)
+		{
+			continue;
+		}
+
+		PredictPath(Character, PathSamples);
+
+		for (FStreamingRegion& Region : Regions)
+		{
+			const FBox ExpandedBounds = Region.Bounds.ExpandBy(RegionMargin);
+			if (Region.Bounds.IsInside(PathSamples[0]))
+			{
+				Region.bOccupied = true;
+			}
+			for (int32 SampleIndex = 0; SampleIndex < PathSamples.Num(); ++SampleIndex)
+			{
+				if (ExpandedBounds.IsInside(PathSamples[SampleIndex]))
+				{
+					const float Arrival = SampleIndex * PredictionStep;
+					if (Region.ArrivalTime < 0.f || Arrival < Region.ArrivalTime)
+					{
+						Region.ArrivalTime = Arrival;
+					}
+					break;
+				}
+			}
+		}
+	}
+
+	const float Now = World->GetTimeSeconds();
+	for (FStreamingRegion& Region : Regions)
+	{
+		UpdateRegionLevels(Region, Now);
+	}
+}
+
+void ULevelsPredictiveStreaming::GatherRegions()
+{
+	bRegionsGathered = true;
+	Regions.Reset();
+
+	UWorld* World = GetWorld();
+	for (TActorIterator<ALevelStreamingVolume> It(World); It; ++It)
+	{
+		const ALevelStreamingVolume* Volume = *It;
+		if (!Volume->bDisabled || Volume->StreamingLevelNames.Num() == 0)
+		{
+			continue;
+		}
+
+		FStreamingRegion Region;
+		Region.Bounds = Volume->GetComponentsBoundingBox(true);
+
+		for (ULevelStreaming* LevelStreaming : World->GetStreamingLevels())
+		{
+			if (LevelStreaming && Volume->StreamingLevelNames.Contains(LevelStreaming->GetWorldAssetPackageFName()))
+			{
+				Region.Levels.Add(LevelStreaming);
+			}
+		}
+
+		if (Region.Levels.Num() > 0)
+		{
+			Regions.Add(MoveTemp(Region));
+		}
+	}
+
+	UE_LOG(LogLevelsStreaming, Log, TEXT("Predictive streaming controls %d regions in %s"), Regions.Num(), *World->GetName());
+}
+
+void ULevelsPredictiveStreaming::PredictPath(const ALevels_v0Character* Character, TArray<FVector>& OutSamples) const
+{
+	const int32 NumSamples = FMath::Max(1, FMath::CeilToInt(PredictionHorizon / PredictionStep)) + 1;
+	OutSamples.Reset(NumSamples);
+
+	const FVector Start = Character->GetActorLocation();
+	FVector Velocity = Character->GetVelocity();
+	float GravityZ = 0.f;
+
+	if (const ULevelsPlayerMovementComponent* Movement = Cast<ULevelsPlayerMovementComponent>(Character->GetCharacterMovement()))
+	{
+		//sprinting accelerates towards sprint speed, so predict with where the speed is heading rather than where it is
+		if (Movement->CustomMovementMode == MOVE_Sprint && Velocity.Size2D() < Movement->SprintSpeed)
+		{
+			const FVector Direction = Velocity.GetSafeNormal2D();
+			if (!Direction.IsNearlyZero())
+			{
+				Velocity = Direction * Movement->SprintSpeed + FVector(0.f, 0.f, Velocity.Z);
+			}
+		}
+
+		//wall running keeps height on the wall and then falls away, walking stays on the ground
+		if (Movement->IsFalling())
+		{
+			GravityZ = Movement->GetGravityZ();
+		}
+		else
+		{
+			Velocity.Z = 0.f;
+		}
+	}
+
+	for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+	{
+		const float Time = SampleIndex * PredictionStep;
+		OutSamples.Add(Start + Velocity * Time + FVector(0.f, 0.f, 0.5f * GravityZ * Time * Time));
+	}
+}
+
+void ULevelsPredictiveStreaming::UpdateRegionLevels(FStreamingRegion& Region, float Now)
+{
+	const bool bWanted = Region.bOccupied || Region.ArrivalTime >= 0.f;
+	if (bWanted)
+	{
+		Region.LastWantedTime = Now;
+	}
+	const bool bKeepLoaded = bWanted || (Now - Region.LastWantedTime) < KeepAliveTime;
+	const bool bMakeVisible = Region.bOccupied || (Region.ArrivalTime >= 0.f && Region.ArrivalTime <= VisibleLeadTime);
+
+	for (const TWeakObjectPtr<ULevelStreaming>& LevelPtr : Region.Levels)
+	{
+		ULevelStreaming* LevelStreaming = LevelPtr.Get();
+		if (LevelStreaming == nullptr)
+		{
+			continue;
+		}
+
+		if (Region.bOccupied && !LevelStreaming->IsLevelVisible())
+		{
+			//the prediction missed, the character is standing in a level that isn't there yet
+			if (!LevelStreaming->bShouldBlockOnLoad)
+			{
+				LevelStreaming->bShouldBlockOnLoad = true;
+				++NumBlockingLoads;
+				INC_DWORD_STAT(STAT_LevelsBlockingLoads);
+				UE_LOG(LogLevelsStreaming, Warning, TEXT("Blocking load of %s, predicted arrival came too late"), *LevelStreaming->GetWorldAssetPackageName());
+			}
+		}
+		else if (LevelStreaming->bShouldBlockOnLoad && LevelStreaming->IsLevelVisible())
+		{
+			LevelStreaming->bShouldBlockOnLoad = false;
+		}
+
+		if (bWanted)
+		{
+			//sooner arrivals stream first
+			const float Arrival = Region.bOccupied ? 0.f : Region.ArrivalTime;
+			LevelStreaming->SetPriority(FMath::RoundToInt((PredictionHorizon - Arrival) * 100.f));
+			if (!LevelStreaming->ShouldBeLoaded())
+			{
+				INC_DWORD_STAT(STAT_LevelsPredictedRequests);
+			}
+		}
+
+		//once visible a level stays visible for as long as some prediction still needs it
+		LevelStreaming->SetShouldBeLoaded(bKeepLoaded);
+		LevelStreaming->SetShouldBeVisible(bMakeVisible || (bWanted && LevelStreaming->ShouldBeVisible()));
+	}
+}
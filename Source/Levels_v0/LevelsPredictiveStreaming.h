@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LevelsPredictiveStreaming.generated.h"
+
+class ULevelStreaming;
+class ALevels_v0Character;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLevelsStreaming, Log, All);
+
+/**
+ * Streams sublevels in ahead of fast parkour traversal. Distance based streaming assumes the
+ * player moves at walking pace; with sprinting, slides and wall run jumps they cross a boundary
+ * before the level has finished loading. Each frame this projects every local character along
+ * its velocity (with the gravity of its current parkour mode) over the next few seconds and
+ * requests the levels on that path, prioritised by how soon the character will arrive.
+ *
+ * Regions are taken from level streaming volumes that are marked bDisabled, which hands their
+ * levels over from the engine's volume streaming to this subsystem. Entering a region whose
+ * level isn't visible yet forces a blocking load and is counted in "stat Levels".
+ */
+UCLASS(config = Game)
+class LEVELS_V0_API ULevelsPredictiveStreaming : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	// End of FTickableGameObject
+
+	/** Number of times a character reached a region before its level was visible */
+	int32 GetNumBlockingLoads() const { return NumBlockingLoads; }
+
+	//how far ahead to predict, in seconds
+	UPROPERTY(Config)
+		float PredictionHorizon = 4.f;
+
+	//spacing between predicted samples, in seconds
+	UPROPERTY(Config)
+		float PredictionStep = 0.2f;
+
+	//levels predicted to be reached within this many seconds are made visible, not just loaded
+	UPROPERTY(Config)
+		float VisibleLeadTime = 0.75f;
+
+	//extra room around each region so a character skimming its edge still counts
+	UPROPERTY(Config)
+		float RegionMargin = 300.f;
+
+	//a level stays loaded this long after the last prediction that needed it
+	UPROPERTY(Config)
+		float KeepAliveTime = 5.f;
+
+private:
+
+	struct FStreamingRegion
+	{
+		FBox Bounds;
+		TArray<TWeakObjectPtr<ULevelStreaming>> Levels;
+
+		//seconds until arrival for this frame, negative if not on any predicted path
+		float ArrivalTime = -1.f;
+		float LastWantedTime = -BIG_NUMBER;
+		bool bOccupied = false;
+	};
+
+	/** Collects the regions from the world's disabled streaming volumes */
+	void GatherRegions();
+
+	/** Projects a character's position over the prediction horizon */
+	void PredictPath(const ALevels_v0Character* Character, TArray<FVector>& OutSamples) const;
+
+	/** Applies the frame's arrival times to the streaming levels */
+	void UpdateRegionLevels(FStreamingRegion& Region, float Now);
+
+	TArray<FStreamingRegion> Regions;
+	TArray<FVector> PathSamples;
+	bool bRegionsGathered = false;
+	int32 NumBlockingLoads = 0;
+};
@@ -0,0 +1,230 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsReplicationGraph.h"
+#include "Levels_v0Character.h"
+#include "Levels_v0Projectile.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/Pawn.h"
+#include "UObject/UObjectIterator.h"
+
+void ULevelsReplicationGraph::InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool bSpatialize) const
+{
+	const AActor* CDO = Class->GetDefaultObject<AActor>();
+	if (bSpatialize)
+	{
+		Info.SetCullDistanceSquared(CDO->NetCullDistanceSquared);
+	}
+
+	Info.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(CDO->NetUpdateFrequency);
+}
+
+ELevelsClassRepNodeMapping ULevelsReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	if (const ELevelsClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class))
+	{
+		return *Policy;
+	}
+
+	const AActor* CDO = Class->GetDefaultObject<AActor>();
+	if (!CDO || !CDO->GetIsReplicated())
+	{
+		return ELevelsClassRepNodeMapping::NotRouted;
+	}
+
+	if (CDO->bAlwaysRelevant)
+	{
+		return ELevelsClassRepNodeMapping::RelevantAllConnections;
+	}
+
+	if (CDO->bOnlyRelevantToOwner)
+	{
+		return ELevelsClassRepNodeMapping::OwnerOnly;
+	}
+
+	//anything that never replicates movement and starts dormant can be flushed on demand instead of polled
+	if (!CDO->IsReplicatingMovement() && CDO->NetDormancy >= DORM_DormantAll)
+	{
+		return ELevelsClassRepNodeMapping::Spatialize_Dormancy;
+	}
+
+	return ELevelsClassRepNodeMapping::Spatialize_Dynamic;
+}
+
+void ULevelsReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	//explicit rules, everything else is worked out from the class defaults in GetMappingPolicy
+	ClassRepNodePolicies.Set(ALevels_v0Character::StaticClass(), ELevelsClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(ALevels_v0Projectile::StaticClass(), ELevelsClassRepNodeMapping::Spatialize_Dynamic);
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		const AActor* CDO = Cast<AActor>(Class->GetDefaultObject(false));
+		if (!CDO || !CDO->GetIsReplicated() || Class->HasAnyClassFlags(CLASS_Abstract))
+		{
+			continue;
+		}
+
+		//skip blueprint compile leftovers
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		const ELevelsClassRepNodeMapping Mapping = GetMappingPolicy(Class);
+		ClassRepNodePolicies.Set(Class, Mapping);
+
+		const bool bSpatialize = Mapping == ELevelsClassRepNodeMapping::Spatialize_Dynamic || Mapping == ELevelsClassRepNodeMapping::Spatialize_Dormancy;
+
+		FClassReplicationInfo ClassInfo;
+		InitClassReplicationInfo(ClassInfo, Class, bSpatialize);
+
+		if (Class->IsChildOf(ALevels_v0Character::StaticClass()))
+		{
+			ClassInfo.SetCullDistanceSquared(FMath::Square(CharacterCullDistance));
+		}
+		else if (Class->IsChildOf(ALevels_v0Projectile::StaticClass()))
+		{
+			ClassInfo.SetCullDistanceSquared(FMath::Square(ProjectileCullDistance));
+		}
+
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void ULevelsReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = SpatialBias;
+
+	if (bDistanceFrequencyBuckets)
+	{
+		//each cell sorts its moving actors per connection by distance and view angle and spreads their updates out accordingly
+		GridNode->CreateCellNodeOverride = [](UReplicationGraphNode_GridSpatialization2D* Parent)
+		{
+			UReplicationGraphNode_GridCell* Cell = Parent->CreateChildNode<UReplicationGraphNode_GridCell>();
+			Cell->CreateDynamicNodeOverride = [](UReplicationGraphNode_GridCell* CellParent) -> UReplicationGraphNode*
+			{
+				return CellParent->CreateChildNode<UReplicationGraphNode_DynamicSpatialFrequency>();
+			};
+			return Cell;
+		};
+	}
+
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void ULevelsReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	//the connection's own controller, pawn and view target plus its owner only actors
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* Node = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	RepGraphConnection->OnClientVisibleLevelNameAdd.AddUObject(Node, &UReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityAdd);
+	RepGraphConnection->OnClientVisibleLevelNameRemove.AddUObject(Node, &UReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove);
+
+	AddConnectionGraphNode(Node, RepGraphConnection);
+	AlwaysRelevantForConnectionNodes.Add(RepGraphConnection->NetConnection, Node);
+}
+
+void ULevelsReplicationGraph::RemoveClientConnection(UNetConnection* NetConnection)
+{
+	AlwaysRelevantForConnectionNodes.Remove(NetConnection);
+
+	Super::RemoveClientConnection(NetConnection);
+}
+
+UReplicationGraphNode_AlwaysRelevant_ForConnection* ULevelsReplicationGraph::GetAlwaysRelevantNodeForConnection(UNetConnection* Connection)
+{
+	UReplicationGraphNode_AlwaysRelevant_ForConnection** Node = Connection ? AlwaysRelevantForConnectionNodes.Find(Connection) : nullptr;
+	return Node ? *Node : nullptr;
+}
+
+void ULevelsReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case ELevelsClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+
+	case ELevelsClassRepNodeMapping::OwnerOnly:
+		//the owning connection usually isn't set yet when the actor is spawned, ServerReplicateActors routes it later
+		ActorsWithoutNetConnection.Add(ActorInfo.Actor);
+		break;
+
+	case ELevelsClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+
+	case ELevelsClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void ULevelsReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case ELevelsClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		SetActorDestructionInfoToIgnoreDistanceCulling(ActorInfo.GetActor());
+		break;
+
+	case ELevelsClassRepNodeMapping::OwnerOnly:
+		if (UReplicationGraphNode_AlwaysRelevant_ForConnection* Node = GetAlwaysRelevantNodeForConnection(ActorInfo.Actor->GetNetConnection()))
+		{
+			Node->NotifyRemoveNetworkActor(ActorInfo);
+		}
+		ActorsWithoutNetConnection.Remove(ActorInfo.Actor);
+		break;
+
+	case ELevelsClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+
+	case ELevelsClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+
+	default:
+		break;
+	}
+}
+
+int32 ULevelsReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	//route owner only actors once they have been given to a connection
+	for (int32 Index = ActorsWithoutNetConnection.Num() - 1; Index >= 0; --Index)
+	{
+		AActor* Actor = ActorsWithoutNetConnection[Index];
+		bool bRouted = Actor == nullptr;
+
+		if (Actor)
+		{
+			if (UReplicationGraphNode_AlwaysRelevant_ForConnection* Node = GetAlwaysRelevantNodeForConnection(Actor->GetNetConnection()))
+			{
+				Node->NotifyAddNetworkActor(FNewReplicatedActorInfo(Actor));
+				bRouted = true;
+			}
+		}
+
+		if (bRouted)
+		{
+			ActorsWithoutNetConnection.RemoveAtSwap(Index, 1, false);
+		}
+	}
+
+	return Super::ServerReplicateActors(DeltaSeconds);
+}
@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "LevelsReplicationGraph.generated.h"
+
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_ActorList;
+class UReplicationGraphNode_AlwaysRelevant_ForConnection;
+
+/** How an actor class is routed into the graph */
+enum class ELevelsClassRepNodeMapping : uint8
+{
+	NotRouted,				//not replicated through a global node
+	RelevantAllConnections,	//game state and other bAlwaysRelevant actors
+	OwnerOnly,				//bOnlyRelevantToOwner actors, replicated to the owning connection only
+	Spatialize_Dynamic,		//moving actors (characters, projectiles), re-bucketed into the grid every frame
+	Spatialize_Dormancy,	//actors that sit dormant most of the time, treated as static while dormant
+};
+
+/**
+ * Replication graph for the Levels server. Characters and projectiles live in a 2D spatial grid so each
+ * connection only gathers the cells around its viewer instead of testing every actor, game state sits in
+ * an always relevant node and owner only actors (controllers, player states of the owner) go to a per
+ * connection node. Within a grid cell, moving actors are put into distance/view based frequency buckets
+ * per connection, so far away players update less often than the ones right next to you.
+ *
+ * Enabled with ReplicationDriverClassName in DefaultEngine.ini.
+ */
+UCLASS(transient, config=Engine)
+class LEVELS_V0_API ULevelsReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void InitGlobalActorClassSettings() override;
+
+	virtual void InitGlobalGraphNodes() override;
+
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+
+	virtual void RemoveClientConnection(UNetConnection* NetConnection) override;
+
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+
+	/** Size of a grid cell in uu */
+	UPROPERTY(Config)
+		float GridCellSize = 10000.f;
+
+	/** Offset applied to the grid so the whole map lands in positive cell coordinates */
+	UPROPERTY(Config)
+		FVector2D SpatialBias = FVector2D(-200000.f, -200000.f);
+
+	/** Cull distance used for player characters */
+	UPROPERTY(Config)
+		float CharacterCullDistance = 15000.f;
+
+	/** Cull distance used for projectiles */
+	UPROPERTY(Config)
+		float ProjectileCullDistance = 8000.f;
+
+	/** Use per connection distance/view frequency buckets inside grid cells, otherwise every relevant actor updates at its own rate */
+	UPROPERTY(Config)
+		bool bDistanceFrequencyBuckets = true;
+
+private:
+
+	/** Fills in cull distance and update period for a class from its defaults */
+	void InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool bSpatialize) const;
+
+	/** Decides how a replicated class is routed */
+	ELevelsClassRepNodeMapping GetMappingPolicy(UClass* Class);
+
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* GetAlwaysRelevantNodeForConnection(UNetConnection* Connection);
+
+	UPROPERTY()
+		UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+		UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	UPROPERTY()
+		TMap<UNetConnection*, UReplicationGraphNode_AlwaysRelevant_ForConnection*> AlwaysRelevantForConnectionNodes;
+
+	/** Owner only actors that were added before they had a connection to route to */
+	UPROPERTY()
+		TArray<AActor*> ActorsWithoutNetConnection;
+
+	TClassMap<ELevelsClassRepNodeMapping> ClassRepNodePolicies;
+};
@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsSceneExportCommandlet.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerStart.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogLevelsSceneExport, Log, All);
+
+ULevelsSceneExportCommandlet::ULevelsSceneExportCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+/** Appends one box line */
+static void AddBoxLine(FString& Text, const FBox& Box)
+{
+	Text += FString::Printf(TEXT("%.1f %.1f %.1f %.1f %.1f %.1f\n"), Box.Min.X, Box.Min.Y, Box.Min.Z, Box.Max.X, Box.Max.Y, Box.Max.Z);
+}
+
+/** World bounds of every simple collision shape of a component, false if it has none */
+static bool AddCollisionBoxes(FString& Text, const UPrimitiveComponent* Component, int32& OutNumBoxes)
+{
+	const UBodySetup* BodySetup = Component->GetBodySetup();
+	if (BodySetup == nullptr || BodySetup->AggGeom.GetElementCount() == 0)
+	{
+		return false;
+	}
+
+	const FTransform ComponentTransform = Component->GetComponentTransform();
+	const FKAggregateGeom& Geometry = BodySetup->AggGeom;
+
+	for (const FKBoxElem& Box : Geometry.BoxElems)
+	{
+		const FVector HalfExtent(Box.X * 0.5f, Box.Y * 0.5f, Box.Z * 0.5f);
+		AddBoxLine(Text, FBox(-HalfExtent, HalfExtent).TransformBy(Box.GetTransform() * ComponentTransform));
+		++OutNumBoxes;
+	}
+	for (const FKSphereElem& Sphere : Geometry.SphereElems)
+	{
+		AddBoxLine(Text, FBox::BuildAABB(Sphere.Center, FVector(Sphere.Radius)).TransformBy(ComponentTransform));
+		++OutNumBoxes;
+	}
+	for (const FKSphylElem& Sphyl : Geometry.SphylElems)
+	{
+		const FVector HalfExtent(Sphyl.Radius, Sphyl.Radius, Sphyl.Radius + Sphyl.Length * 0.5f);
+		AddBoxLine(Text, FBox(-HalfExtent, HalfExtent).TransformBy(Sphyl.GetTransform() * ComponentTransform));
+		++OutNumBoxes;
+	}
+	for (const FKConvexElem& Convex : Geometry.ConvexElems)
+	{
+		AddBoxLine(Text, Convex.ElemBox.TransformBy(Convex.GetTransform() * ComponentTransform));
+		++OutNumBoxes;
+	}
+	return true;
+}
+
+int32 ULevelsSceneExportCommandlet::Main(const FString& Params)
+{
+	FString MapName;
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogLevelsSceneExport, Error, TEXT("Usage: -run=LevelsSceneExport -Map=/Game/Path/To/Map [-Out=file.boxes]"));
+		return 1;
+	}
+
+	FString OutputFile = FPaths::Combine(TEXT("Parkour"), FPackageName::GetShortName(MapName) + TEXT(".boxes"));
+	FParse::Value(*Params, TEXT("Out="), OutputFile);
+	if (FPaths::IsRelative(OutputFile))
+	{
+		OutputFile = FPaths::ProjectSavedDir() / OutputFile;
+	}
+
+	UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (World == nullptr)
+	{
+		UE_LOG(LogLevelsSceneExport, Error, TEXT("Could not load map %s"), *MapName);
+		return 1;
+	}
+
+	//components only have their world transforms once registered
+	World->AddToRoot();
+	World->WorldType = EWorldType::Editor;
+	World->InitWorld(UWorld::InitializationValues()
+		.AllowAudioPlayback(false)
+		.CreatePhysicsScene(false)
+		.RequiresHitProxies(false)
+		.CreateNavigation(false)
+		.CreateAISystem(false)
+		.ShouldSimulatePhysics(false)
+		.SetTransactional(false));
+	World->UpdateWorldComponents(true, false);
+
+	FString Text = FString::Printf(TEXT("# %s, minx miny minz maxx maxy maxz per line\n"), *MapName);
+	int32 NumBoxes = 0;
+	int32 NumBoundsOnly = 0;
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		AActor* Actor = *It;
+
+		if (const APlayerStart* PlayerStart = Cast<APlayerStart>(Actor))
+		{
+			const FVector Location = PlayerStart->GetActorLocation();
+			Text += FString::Printf(TEXT("# start %.1f %.1f %.1f %.1f\n"), Location.X, Location.Y, Location.Z, PlayerStart->GetActorRotation().Yaw);
+			continue;
+		}
+
+		//characters and other pawns aren't part of the course
+		if (Actor->IsA<APawn>())
+		{
+			continue;
+		}
+
+		TInlineComponentArray<UPrimitiveComponent*> Components;
+		Actor->GetComponents(Components);
+		for (const UPrimitiveComponent* Component : Components)
+		{
+			if (!Component->IsRegistered() || !Component->IsCollisionEnabled() || Component->GetCollisionResponseToChannel(ECC_Pawn) != ECR_Block)
+			{
+				continue;
+			}
+
+			//shapes without simple collision (BSP, complex as simple) fall back to their bounds
+			if (!AddCollisionBoxes(Text, Component, NumBoxes))
+			{
+				AddBoxLine(Text, Component->Bounds.GetBox());
+				++NumBoxes;
+				++NumBoundsOnly;
+			}
+		}
+	}
+
+	World->CleanupWorld();
+	World->RemoveFromRoot();
+
+	if (!FFileHelper::SaveStringToFile(Text, *OutputFile))
+	{
+		UE_LOG(LogLevelsSceneExport, Error, TEXT("Could not write %s"), *OutputFile);
+		return 1;
+	}
+
+	UE_LOG(LogLevelsSceneExport, Display, TEXT("Wrote %d boxes (%d from component bounds) to %s"), NumBoxes, NumBoundsOnly, *OutputFile);
+	return 0;
+}
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LevelsSceneExportCommandlet.generated.h"
+
+/**
+ * Writes a map's walkable and runnable geometry as a box file for the offline parkour tools in
+ * Tools/ParkourCore (route analyzer, parameter sweep). Every blocking collision shape becomes its
+ * world space bounding box, so rotated shapes come out bigger than they are. Player starts are
+ * written as "# start x y z yaw" comments.
+ *
+ *   UE4Editor-Cmd Levels_v0.uproject -run=LevelsSceneExport -Map=/Game/PolygonPrototype/Maps/Demonstration
+ *       [-Out=Parkour/Demonstration.boxes]
+ *
+ * Relative output paths are under Saved, the default is Saved/Parkour/<map name>.boxes.
+ */
+UCLASS()
+class LEVELS_V0_API ULevelsSceneExportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	ULevelsSceneExportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
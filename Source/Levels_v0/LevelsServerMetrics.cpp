@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsServerMetrics.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogLevelsMetrics, Log, All);
+
+int32 ULevelsServerMetrics::NumCorrections = 0;
+
+bool ULevelsServerMetrics::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	FString File;
+	return World && World->IsGameWorld() && FParse::Value(FCommandLine::Get(), TEXT("LevelsMetrics="), File) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void ULevelsServerMetrics::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FParse::Value(FCommandLine::Get(), TEXT("LevelsMetrics="), OutputFile);
+	FParse::Value(FCommandLine::Get(), TEXT("LevelsMetricsInterval="), SampleInterval);
+	if (FPaths::IsRelative(OutputFile))
+	{
+		OutputFile = FPaths::ProjectSavedDir() / OutputFile;
+	}
+
+	const FString Header = TEXT("time,players,frame_work_ms_avg,frame_work_ms_max,out_bytes_per_sec_per_conn,in_bytes_per_sec_per_conn,corrections_per_sec,used_physical_mb\n");
+	FFileHelper::SaveStringToFile(Header, *OutputFile);
+	UE_LOG(LogLevelsMetrics, Display, TEXT("Writing server metrics to %s"), *OutputFile);
+}
+
+void ULevelsServerMetrics::Deinitialize()
+{
+	NumCorrections = 0;
+
+	Super::Deinitialize();
+}
+
+ETickableTickType ULevelsServerMetrics::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool ULevelsServerMetrics::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return World && World->HasBegunPlay();
+}
+
+TStatId ULevelsServerMetrics::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULevelsServerMetrics, STATGROUP_Tickables);
+}
+
+UWorld* ULevelsServerMetrics::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void ULevelsServerMetrics::NoteMovementCorrection()
+{
+	++NumCorrections;
+}
+
+void ULevelsServerMetrics::Tick(float DeltaTime)
+{
+	//the server sleeps to hold its tick rate, only the time it spent working counts
+	const double WorkSeconds = FMath::Max(0.0, FApp::GetDeltaTime() - FApp::GetIdleTime());
+	WorkSecondsTotal += WorkSeconds;
+	WorkSecondsMax = FMath::Max(WorkSecondsMax, WorkSeconds);
+	++NumFrames;
+
+	const float Now = GetWorld()->GetRealTimeSeconds();
+	if (Now - IntervalStart >= SampleInterval)
+	{
+		WriteSample(Now);
+	}
+}
+
+void ULevelsServerMetrics::WriteSample(float Now)
+{
+	const UWorld* World = GetWorld();
+	const float Elapsed = FMath::Max(Now - IntervalStart, KINDA_SMALL_NUMBER);
+
+	int64 OutBytes = 0;
+	int64 InBytes = 0;
+	int32 NumConnections = 0;
+	if (const UNetDriver* NetDriver = World->GetNetDriver())
+	{
+		for (const UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			if (Connection)
+			{
+				OutBytes += Connection->OutBytesPerSecond;
+				InBytes += Connection->InBytesPerSecond;
+				++NumConnections;
+			}
+		}
+	}
+
+	const int32 NumPlayers = World->GetGameState() ? World->GetGameState()->PlayerArray.Num() : NumConnections;
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+	const FString Row = FString::Printf(TEXT("%.1f,%d,%.3f,%.3f,%lld,%lld,%.2f,%.1f\n"),
+		Now,
+		NumPlayers,
+		NumFrames > 0 ? (WorkSecondsTotal / NumFrames) * 1000.0 : 0.0,
+		WorkSecondsMax * 1000.0,
+		NumConnections > 0 ? OutBytes / NumConnections : 0,
+		NumConnections > 0 ? InBytes / NumConnections : 0,
+		NumCorrections / Elapsed,
+		MemoryStats.UsedPhysical / (1024.0 * 1024.0));
+
+	FFileHelper::SaveStringToFile(Row, *OutputFile, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+	IntervalStart = Now;
+	NumFrames = 0;
+	WorkSecondsTotal = 0.0;
+	WorkSecondsMax = 0.0;
+	NumCorrections = 0;
+}
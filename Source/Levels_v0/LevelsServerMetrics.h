@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LevelsServerMetrics.generated.h"
+
+/**
+ * Records server load for the localhost load harness (Scripts/LoadHarness). Enabled with
+ * -LevelsMetrics=<csv file>. Once per interval it appends a row with the player count, game
+ * thread work per frame (idle time excluded), bandwidth per connection, movement corrections
+ * sent to clients and resident memory.
+ */
+UCLASS()
+class LEVELS_V0_API ULevelsServerMetrics : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	// End of FTickableGameObject
+
+	/** Called by the movement component whenever the server corrects a client's move */
+	static void NoteMovementCorrection();
+
+private:
+
+	/** Appends one row to the CSV and resets the interval */
+	void WriteSample(float Now);
+
+	FString OutputFile;
+	float SampleInterval = 1.f;
+	float IntervalStart = 0.f;
+
+	//accumulated over the interval
+	int32 NumFrames = 0;
+	double WorkSecondsTotal = 0.0;
+	double WorkSecondsMax = 0.0;
+
+	static int32 NumCorrections;
+};
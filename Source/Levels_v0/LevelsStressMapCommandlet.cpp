@@ -0,0 +1,380 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LevelsStressMapCommandlet.h"
+#include "Levels_v0Character.h"
+#include "Levels_v0GameMode.h"
+#include "LevelsPlayerMovementComponent.h"
+#include "Parkour/ParkourTypes.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/DirectionalLight.h"
+#include "Engine/LevelStreamingDynamic.h"
+#include "Engine/LevelStreamingVolume.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerStart.h"
+#include "GameMapsSettings.h"
+#include "Math/RandomStream.h"
+#include "Misc/PackageName.h"
+#include "Misc/Parse.h"
+#include "UObject/Package.h"
+#if WITH_EDITOR
+#include "ActorFactories/ActorFactory.h"
+#include "Builders/CubeBuilder.h"
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogLevelsStressMap, Log, All);
+
+ULevelsStressMapCommandlet::ULevelsStressMapCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+#if WITH_EDITOR
+
+namespace
+{
+	/** Heights and limits the features are built around */
+	struct FStressMapLimits
+	{
+		float CapsuleHalfHeight = 96.f;
+		float MantleHeight = 40.f;
+		//top of the mantle probe above the feet, ledges above this can only be reached by climbing
+		float MantleProbeTop = 210.f;
+		float WallRunNormalZLimit = .52f;
+	};
+
+	/** One world being filled, the persistent level or a streaming tile */
+	struct FStressMapTarget
+	{
+		UWorld* World = nullptr;
+		FString PackageName;
+		FBox Bounds = FBox(ForceInit);
+	};
+
+	/** How many of each feature were built */
+	struct FStressMapCounts
+	{
+		int32 Walls = 0;
+		int32 NearLimitWalls = 0;
+		int32 Corners = 0;
+		int32 QuickMantleLedges = 0;
+		int32 LedgeGrabLedges = 0;
+		int32 ClimbLedges = 0;
+		int32 Ramps = 0;
+	};
+}
+
+/** Adds an engine cube scaled to Size, rotated around its middle */
+static void AddSlab(FStressMapTarget& Target, UStaticMesh* Cube, const FVector& Center, const FVector& Size, const FRotator& Rotation)
+{
+	AStaticMeshActor* Slab = Target.World->SpawnActor<AStaticMeshActor>(Center, Rotation);
+	Slab->SetMobility(EComponentMobility::Static);
+	Slab->GetStaticMeshComponent()->SetStaticMesh(Cube);
+	//the engine cube is 100 units across around its middle
+	Slab->SetActorScale3D(Size / 100.f);
+	Target.Bounds += Slab->GetComponentsBoundingBox();
+}
+
+/** A wall Length long along Yaw whose faces have a normal Z of NormalZ, standing on the floor at Base */
+static void AddTiltedWall(FStressMapTarget& Target, UStaticMesh* Cube, const FVector& Base, float Yaw, float Length, float Height, float NormalZ)
+{
+	const float Thickness = 40.f;
+	//rolling the wall tips its side faces up or down by the same angle
+	const float Roll = FMath::RadiansToDegrees(FMath::Asin(NormalZ));
+	const FVector Center = Base + FVector(0.f, 0.f, Height * 0.5f * FMath::Cos(FMath::DegreesToRadians(Roll)) - Thickness);
+	AddSlab(Target, Cube, Center, FVector(Length, Thickness, Height), FRotator(0.f, Yaw, Roll));
+}
+
+static void AddWall(FStressMapTarget& Target, UStaticMesh* Cube, FRandomStream& Random, const FStressMapLimits& Limits, const FVector& Base, FStressMapCounts& Counts)
+{
+	const float Sign = Random.FRand() < 0.5f ? -1.f : 1.f;
+	float NormalZ;
+	if (Random.FRand() < 0.5f)
+	{
+		//just runnable and just not, either side of the limit
+		NormalZ = Sign * (Limits.WallRunNormalZLimit + Random.FRandRange(-0.04f, 0.04f));
+		++Counts.NearLimitWalls;
+	}
+	else
+	{
+		NormalZ = Sign * Random.FRandRange(0.f, Limits.WallRunNormalZLimit - 0.04f);
+	}
+
+	AddTiltedWall(Target, Cube, Base, Random.FRandRange(0.f, 360.f), Random.FRandRange(600.f, 1600.f), Random.FRandRange(300.f, 700.f), NormalZ);
+	++Counts.Walls;
+}
+
+static void AddCorner(FStressMapTarget& Target, UStaticMesh* Cube, FRandomStream& Random, const FVector& Base, FStressMapCounts& Counts)
+{
+	//the corner rejection only looks at walls whose normal isn't flat, so these lean a little
+	const float NormalZ = Random.FRandRange(0.02f, 0.3f);
+	//walls closer than about 129 degrees turn the normal far enough to be rejected
+	const float Angle = Random.FRandRange(95.f, 160.f);
+	const float Yaw = Random.FRandRange(0.f, 360.f);
+	const float Length = Random.FRandRange(700.f, 1200.f);
+	const float Height = Random.FRandRange(400.f, 700.f);
+
+	const FVector First = FRotator(0.f, Yaw, 0.f).Vector();
+	const FVector Second = FRotator(0.f, Yaw + Angle, 0.f).Vector();
+	AddTiltedWall(Target, Cube, Base + First * Length * 0.5f, Yaw, Length, Height, NormalZ);
+	AddTiltedWall(Target, Cube, Base + Second * Length * 0.5f, Yaw + Angle, Length, Height, NormalZ);
+	++Counts.Corners;
+}
+
+static void AddLedge(FStressMapTarget& Target, UStaticMesh* Cube, FRandomStream& Random, const FStressMapLimits& Limits, const FVector& Base, FStressMapCounts& Counts)
+{
+	//a ledge more than a capsule half height below the top of the probe is quick mantled
+	const float QuickMantleTop = Limits.MantleProbeTop - Limits.CapsuleHalfHeight;
+
+	float Min;
+	float Max;
+	const float Band = Random.FRand();
+	if (Band < 0.4f)
+	{
+		Min = Limits.MantleHeight;
+		Max = QuickMantleTop;
+		++Counts.QuickMantleLedges;
+	}
+	else if (Band < 0.8f)
+	{
+		Min = QuickMantleTop;
+		Max = Limits.MantleProbeTop;
+		++Counts.LedgeGrabLedges;
+	}
+	else
+	{
+		Min = Limits.MantleProbeTop;
+		Max = Limits.MantleProbeTop + 400.f;
+		++Counts.ClimbLedges;
+	}
+
+	//a third sit right on an edge of their band
+	float Top;
+	if (Random.FRand() < 0.33f)
+	{
+		Top = (Random.FRand() < 0.5f ? Min : Max) + Random.FRandRange(-4.f, 4.f);
+	}
+	else
+	{
+		Top = Random.FRandRange(Min, Max);
+	}
+
+	const FVector Size(Random.FRandRange(200.f, 600.f), Random.FRandRange(200.f, 600.f), Top + 50.f);
+	AddSlab(Target, Cube, Base + FVector(0.f, 0.f, Top - Size.Z * 0.5f), Size, FRotator(0.f, Random.FRandRange(0.f, 360.f), 0.f));
+}
+
+static void AddRamp(FStressMapTarget& Target, UStaticMesh* Cube, FRandomStream& Random, const FVector& Base, FStressMapCounts& Counts)
+{
+	const float Thickness = 40.f;
+	const float Pitch = Random.FRandRange(6.f, 25.f);
+	const float Length = Random.FRandRange(1000.f, 1600.f);
+	const FVector Center = Base + FVector(0.f, 0.f, FMath::Sin(FMath::DegreesToRadians(Pitch)) * Length * 0.5f - Thickness * 0.5f);
+	AddSlab(Target, Cube, Center, FVector(Length, 400.f, Thickness), FRotator(Pitch, Random.FRandRange(0.f, 360.f), 0.f));
+	++Counts.Ramps;
+}
+
+/** A new, empty map world in its own package */
+static UWorld* CreateMapWorld(const FString& PackageName)
+{
+	UPackage* Package = CreatePackage(*PackageName);
+	Package->SetPackageFlags(PKG_ContainsMap);
+	UWorld* World = UWorld::CreateWorld(EWorldType::Inactive, false, FName(*FPackageName::GetShortName(PackageName)), Package);
+	World->SetFlags(RF_Public | RF_Standalone);
+	return World;
+}
+
+static bool SaveMapWorld(UWorld* World, const FString& PackageName)
+{
+	UPackage* Package = World->GetOutermost();
+	Package->MarkPackageDirty();
+	const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetMapPackageExtension());
+	if (!UPackage::SavePackage(Package, World, RF_Standalone, *Filename, GError, nullptr, false, true, SAVE_NoError))
+	{
+		UE_LOG(LogLevelsStressMap, Error, TEXT("Could not save %s"), *Filename);
+		return false;
+	}
+	return true;
+}
+
+/** Defaults of the character the game actually plays as, the blueprint pawn with its own capsule and movement tuning */
+static const ALevels_v0Character* GetGamePawnDefaults()
+{
+	UClass* GameModeClass = LoadClass<AGameModeBase>(nullptr, *UGameMapsSettings::GetGlobalDefaultGameMode());
+	const AGameModeBase* GameMode = GameModeClass ? GameModeClass->GetDefaultObject<AGameModeBase>() : nullptr;
+	if (GameMode == nullptr)
+	{
+		return nullptr;
+	}
+
+	const ALevels_v0GameMode* LevelsGameMode = Cast<ALevels_v0GameMode>(GameMode);
+	UClass* PawnClass = LevelsGameMode ? LevelsGameMode->ResolveDefaultPawnClass() : GameMode->DefaultPawnClass;
+	return PawnClass && PawnClass->IsChildOf(ALevels_v0Character::StaticClass()) ? PawnClass->GetDefaultObject<ALevels_v0Character>() : nullptr;
+}
+
+#endif
+
+int32 ULevelsStressMapCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	int32 Seed = 0;
+	int32 NumFeatures = 4000;
+	float Spacing = 1200.f;
+	int32 NumTiles = 1;
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Features="), NumFeatures);
+	FParse::Value(*Params, TEXT("Spacing="), Spacing);
+	FParse::Value(*Params, TEXT("Tiles="), NumTiles);
+	NumFeatures = FMath::Max(NumFeatures, 1);
+	NumTiles = FMath::Max(NumTiles, 1);
+
+	FString PackageName = FString::Printf(TEXT("/Game/Generated/Stress_%d"), Seed);
+	FParse::Value(*Params, TEXT("Out="), PackageName);
+	if (!FPackageName::IsValidLongPackageName(PackageName))
+	{
+		UE_LOG(LogLevelsStressMap, Error, TEXT("Usage: -run=LevelsStressMap [-Seed=0] [-Features=4000] [-Spacing=1200] [-Tiles=1] [-Out=/Game/Generated/Stress_0]"));
+		return 1;
+	}
+
+	UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (Cube == nullptr)
+	{
+		UE_LOG(LogLevelsStressMap, Error, TEXT("Could not load the engine cube"));
+		return 1;
+	}
+
+	//build around the tuning the game ships with
+	FStressMapLimits Limits;
+	const LevelsParkour::FParkourConfig ParkourDefaults;
+	Limits.WallRunNormalZLimit = ParkourDefaults.WallRunNormalZLimit;
+	float EyeHeight = 64.f;
+	if (const ALevels_v0Character* Character = GetGamePawnDefaults())
+	{
+		Limits.CapsuleHalfHeight = Character->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+		EyeHeight = Character->BaseEyeHeight;
+		//CharacterMovement is only cached once components initialize, the CDO has just the subobject
+		if (const ULevelsPlayerMovementComponent* Movement = Cast<ULevelsPlayerMovementComponent>(Character->GetCharacterMovement()))
+		{
+			Limits.MantleHeight = Movement->MantleHeight;
+		}
+	}
+	else
+	{
+		UE_LOG(LogLevelsStressMap, Warning, TEXT("The default game mode doesn't play as a Levels_v0 character, using built-in limits"));
+	}
+	Limits.MantleProbeTop = Limits.CapsuleHalfHeight + EyeHeight + ParkourDefaults.MantleProbeRise;
+
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt((float)NumFeatures));
+	NumTiles = FMath::Min(NumTiles, GridSize);
+
+	FStressMapTarget Persistent;
+	Persistent.PackageName = PackageName;
+	Persistent.World = CreateMapWorld(PackageName);
+
+	TArray<FStressMapTarget> Tiles;
+	Tiles.SetNum(NumTiles * NumTiles);
+	for (int32 TileIndex = 0; TileIndex < Tiles.Num(); ++TileIndex)
+	{
+		if (NumTiles == 1)
+		{
+			Tiles[TileIndex] = Persistent;
+			continue;
+		}
+		Tiles[TileIndex].PackageName = FString::Printf(TEXT("%s_Tile_%d_%d"), *PackageName, TileIndex % NumTiles, TileIndex / NumTiles);
+		Tiles[TileIndex].World = CreateMapWorld(Tiles[TileIndex].PackageName);
+	}
+
+	//one feature per cell, pushed around a little so the grid doesn't line everything up
+	FRandomStream Random(Seed);
+	FStressMapCounts Counts;
+	for (int32 FeatureIndex = 0; FeatureIndex < NumFeatures; ++FeatureIndex)
+	{
+		const int32 CellX = FeatureIndex % GridSize;
+		const int32 CellY = FeatureIndex / GridSize;
+		const FVector Base((CellX + 0.5f) * Spacing + Random.FRandRange(-0.15f, 0.15f) * Spacing, (CellY + 0.5f) * Spacing + Random.FRandRange(-0.15f, 0.15f) * Spacing, 0.f);
+		FStressMapTarget& Target = Tiles[(CellY * NumTiles / GridSize) * NumTiles + CellX * NumTiles / GridSize];
+
+		const float Pick = Random.FRand();
+		if (Pick < 0.45f)
+		{
+			AddWall(Target, Cube, Random, Limits, Base, Counts);
+		}
+		else if (Pick < 0.65f)
+		{
+			AddCorner(Target, Cube, Random, Base, Counts);
+		}
+		else if (Pick < 0.9f)
+		{
+			AddLedge(Target, Cube, Random, Limits, Base, Counts);
+		}
+		else
+		{
+			AddRamp(Target, Cube, Random, Base, Counts);
+		}
+	}
+	if (NumTiles == 1)
+	{
+		Persistent = Tiles[0];
+	}
+
+	//the floor reaches a cell past the grid on every side, top at Z 0
+	const float FloorSize = (GridSize + 2) * Spacing;
+	AddSlab(Persistent, Cube, FVector(GridSize * Spacing * 0.5f, GridSize * Spacing * 0.5f, -50.f), FVector(FloorSize, FloorSize, 100.f), FRotator::ZeroRotator);
+
+	APlayerStart* PlayerStart = Persistent.World->SpawnActor<APlayerStart>(FVector(-Spacing * 0.5f, -Spacing * 0.5f, Limits.CapsuleHalfHeight + 10.f), FRotator(0.f, 45.f, 0.f));
+	Persistent.World->SpawnActor<ADirectionalLight>(FVector(0.f, 0.f, 1000.f), FRotator(-50.f, 30.f, 0.f));
+	if (PlayerStart == nullptr)
+	{
+		UE_LOG(LogLevelsStressMap, Error, TEXT("Could not spawn the player start"));
+		return 1;
+	}
+
+	bool bSaved = true;
+	if (NumTiles > 1)
+	{
+		for (FStressMapTarget& Tile : Tiles)
+		{
+			bSaved &= SaveMapWorld(Tile.World, Tile.PackageName);
+
+			ULevelStreamingDynamic* Streaming = NewObject<ULevelStreamingDynamic>(Persistent.World, NAME_None, RF_NoFlags);
+			Streaming->SetWorldAssetByPackageName(FName(*Tile.PackageName));
+			Persistent.World->AddStreamingLevel(Streaming);
+
+			//disabled volumes hand their level to ULevelsPredictiveStreaming
+			const FVector Center = Tile.Bounds.GetCenter();
+			const FVector Size = Tile.Bounds.GetSize() + FVector(Spacing, Spacing, 400.f);
+			ALevelStreamingVolume* Volume = Persistent.World->SpawnActor<ALevelStreamingVolume>(Center, FRotator::ZeroRotator);
+			UCubeBuilder* Builder = NewObject<UCubeBuilder>();
+			Builder->X = Size.X;
+			Builder->Y = Size.Y;
+			Builder->Z = Size.Z;
+			UActorFactory::CreateBrushForVolumeActor(Volume, Builder);
+			Volume->bDisabled = true;
+			Volume->StreamingLevelNames.Add(FName(*Tile.PackageName));
+
+			Tile.World->DestroyWorld(false);
+		}
+	}
+	bSaved &= SaveMapWorld(Persistent.World, PackageName);
+	Persistent.World->DestroyWorld(false);
+
+	if (!bSaved)
+	{
+		return 1;
+	}
+
+	UE_LOG(LogLevelsStressMap, Display, TEXT("Wrote %s with %d features in %d tiles: %d walls (%d near the normal limit), %d corners, %d quick mantle / %d ledge grab / %d climb ledges, %d ramps"),
+		*PackageName, NumFeatures, Tiles.Num(), Counts.Walls, Counts.NearLimitWalls, Counts.Corners,
+		Counts.QuickMantleLedges, Counts.LedgeGrabLedges, Counts.ClimbLedges, Counts.Ramps);
+	UE_LOG(LogLevelsStressMap, Display, TEXT("Mantle height %.0f, quick mantle below %.0f, ledge grab below %.0f, wall run normal Z limit %.2f"),
+		Limits.MantleHeight, Limits.MantleProbeTop - Limits.CapsuleHalfHeight, Limits.MantleProbeTop, Limits.WallRunNormalZLimit);
+	return 0;
+#else
+	UE_LOG(LogLevelsStressMap, Error, TEXT("LevelsStressMap saves map packages and needs an editor build"));
+	return 1;
+#endif
+}
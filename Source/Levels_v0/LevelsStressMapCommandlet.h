@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LevelsStressMapCommandlet.generated.h"
+
+/**
+ * Builds a parkour stress map from a seed. Every cell of a square grid gets one feature:
+ *
+ *   walls    tilted at random, half of them within a few hundredths of the wall run normal Z limit either side
+ *   corners  two slightly tilted walls meeting at 95 to 160 degrees, either side of the corner rejection
+ *   ledges   tops in the quick mantle band, the ledge grab band or above it (reached by climbing), some on the edges
+ *   ramps    slide ramps from 6 to 25 degrees
+ *
+ * Heights come from the character's capsule and eye height, its movement component's MantleHeight and the
+ * parkour probe defaults, so the map follows the tuning it was built with. The same parameters always give
+ * the same map.
+ *
+ *   UE4Editor-Cmd Levels_v0.uproject -run=LevelsStressMap [-Seed=0] [-Features=4000] [-Spacing=1200] [-Tiles=1]
+ *       [-Out=/Game/Generated/Stress_<seed>]
+ *
+ * With -Tiles=N the features go into NxN streaming sublevels, each with a disabled level streaming volume
+ * for ULevelsPredictiveStreaming; the floor, the player start and the light stay in the persistent level.
+ */
+UCLASS()
+class LEVELS_V0_API ULevelsStressMapCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	ULevelsStressMapCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
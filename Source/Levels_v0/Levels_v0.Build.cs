@@ -9,5 +9,12 @@ public class Levels_v0 : ModuleRules
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay", "UMG", "Slate", "SlateCore" });
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "AssetRegistry", "ReplicationGraph", "AnimationBudgetAllocator", "EngineSettings" });
+
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("UnrealEd");
+		}
 	}
 }
@@ -1,7 +1,31 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Levels_v0.h"
+#include "LevelsHitchWatchdog.h"
+#include "LevelsMemoryTags.h"
+#include "LevelsInputLatency.h"
+#include "LevelsAnimationBudget.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Levels_v0, "Levels_v0" );
- 
\ No newline at end of file
+class FLevels_v0Module : public FDefaultGameModuleImpl
+{
+public:
+
+	virtual void StartupModule() override
+	{
+		FLevelsMemoryTags::Startup();
+		FLevelsHitchWatchdog::Startup();
+		FLevelsInputLatency::Startup();
+		FLevelsAnimationBudget::Startup();
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FLevelsAnimationBudget::Shutdown();
+		FLevelsInputLatency::Shutdown();
+		FLevelsHitchWatchdog::Shutdown();
+		FLevelsMemoryTags::Shutdown();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FLevels_v0Module, Levels_v0, "Levels_v0" );
@@ -3,3 +3,6 @@
 #pragma once
 
 #include "CoreMinimal.h"
+
+// stat group for everything this module measures, view with "stat Levels"
+DECLARE_STATS_GROUP(TEXT("Levels"), STATGROUP_Levels, STATCAT_Advanced);
@@ -11,10 +11,24 @@
 #include "Kismet/GameplayStatics.h"
 //#include "Kismet/KismetMathLibrary.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "HAL/IConsoleManager.h"
 #include "MotionControllerComponent.h"
 #include "XRMotionControllerBase.h" // for FXRMotionControllerBase::RightHandSourceId
 #include "GameFramework/CharacterMovementComponent.h"
 #include "LevelsPlayerMovementComponent.h"
+#include "LevelsAssetManager.h"
+#include "LevelsInputScript.h"
+#include "LevelsCosmeticEvents.h"
+#include "LevelsCosmeticMeshComponent.h"
+#include "LevelsHitchWatchdog.h"
+#include "LevelsMemoryTags.h"
+#include "LevelsInputLatency.h"
+#include "LevelsAnimationBudget.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "Particles/ParticleSystem.h"
+#include "Sound/SoundBase.h"
+#include "Animation/AnimMontage.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogFPChar, Warning, All);
 
@@ -22,8 +36,16 @@ DEFINE_LOG_CATEGORY_STATIC(LogFPChar, Warning, All);
 // ALevels_v0Character
 
 ALevels_v0Character::ALevels_v0Character(const FObjectInitializer& ObjectInitializer)
-	: Super(ObjectInitializer.SetDefaultSubobjectClass<ULevelsPlayerMovementComponent>(ACharacter::CharacterMovementComponentName))
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<ULevelsPlayerMovementComponent>(ACharacter::CharacterMovementComponentName)
+		.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName))
 {
+	LEVELS_LLM_SCOPE(CharacterComponents);
+
+	//the third person mesh is registered with the animation budget in BeginPlay, pooled characters wait until they wake
+	if (USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh()))
+	{
+		BudgetedMesh->SetAutoRegisterWithBudgetAllocator(false);
+	}
 
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(55.f, 96.0f);
@@ -39,7 +61,7 @@ ALevels_v0Character::ALevels_v0Character(const FObjectInitializer& ObjectInitial
 	FirstPersonCameraComponent->bUsePawnControlRotation = true;
 
 	// Create a mesh component that will be used when being viewed from a '1st person' view (when controlling this pawn)
-	Mesh1P = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("CharacterMesh1P"));
+	Mesh1P = CreateDefaultSubobject<ULevelsCosmeticMeshComponent>(TEXT("CharacterMesh1P"));
 	Mesh1P->SetOnlyOwnerSee(true);
 	Mesh1P->SetupAttachment(FirstPersonCameraComponent);
 	Mesh1P->bCastDynamicShadow = false;
@@ -48,7 +70,7 @@ ALevels_v0Character::ALevels_v0Character(const FObjectInitializer& ObjectInitial
 	Mesh1P->SetRelativeLocation(FVector(-0.5f, -4.4f, -155.7f));
 
 	// Create a gun mesh component
-	FP_Gun = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("FP_Gun"));
+	FP_Gun = CreateDefaultSubobject<ULevelsCosmeticMeshComponent>(TEXT("FP_Gun"));
 	FP_Gun->SetOnlyOwnerSee(false);			// otherwise won't be visible in the multiplayer
 	FP_Gun->bCastDynamicShadow = false;
 	FP_Gun->CastShadow = false;
@@ -62,60 +84,277 @@ ALevels_v0Character::ALevels_v0Character(const FObjectInitializer& ObjectInitial
 	// Default offset from the character location for projectiles to spawn
 	GunOffset = FVector(100.0f, 0.0f, 10.0f);
 
-	// Note: The ProjectileClass and the skeletal mesh/anim blueprints for Mesh1P, FP_Gun, and VR_Gun 
+	// Note: The ProjectileClass and the skeletal mesh/anim blueprints for Mesh1P and FP_Gun, and VRGunMesh,
 	// are set in the derived blueprint asset named MyCharacter to avoid direct content references in C++.
 
+	// The VR controllers and gun are only created in BeginPlay for the VR configuration, see CreateVRComponents.
+	R_MotionController = nullptr;
+	L_MotionController = nullptr;
+	VR_Gun = nullptr;
+	VR_MuzzleLocation = nullptr;
+
+	// Uncomment the following line to turn motion controllers on by default:
+	//bUsingMotionControllers = true;
+	isZoomedIn = false; // default boolean for Zoom
+
+	if (!HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+	{
+		SpawnStartCycles = FPlatformTime::Cycles64();
+	}
+}
+
+/** Characters that have begun play in one configuration, for Levels.CharacterComposition */
+struct FLevelsCompositionStats
+{
+	int32 Characters = 0;
+	int32 Components = 0;
+	double SpawnMs = 0.0;
+};
+
+static FLevelsCompositionStats CompositionStats[(int32)ELevelsCharacterConfig::Num];
+
+static FAutoConsoleCommand CharacterCompositionCommand(
+	TEXT("Levels.CharacterComposition"),
+	TEXT("Prints the components and spawn time of characters in each configuration and the components left out of them"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		static const TCHAR* ConfigNames[(int32)ELevelsCharacterConfig::Num] = { TEXT("Desktop"), TEXT("VR"), TEXT("ServerBot") };
+		GLog->Logf(TEXT("%-10s %10s %12s %12s %10s"), TEXT("Config"), TEXT("Characters"), TEXT("Components"), TEXT("Spawn ms"), TEXT("Skipped"));
+		int32 Skipped = 0;
+		for (int32 Index = 0; Index < (int32)ELevelsCharacterConfig::Num; ++Index)
+		{
+			const FLevelsCompositionStats& Stats = CompositionStats[Index];
+			const int32 SkippedEach = Index == (int32)ELevelsCharacterConfig::VR ? 0 : ALevels_v0Character::VRComponentCount;
+			Skipped += SkippedEach * Stats.Characters;
+			if (Stats.Characters > 0)
+			{
+				GLog->Logf(TEXT("%-10s %10d %12.1f %12.3f %10d"), ConfigNames[Index], Stats.Characters,
+					(float)Stats.Components / Stats.Characters, Stats.SpawnMs / Stats.Characters, SkippedEach);
+			}
+		}
+		GLog->Logf(TEXT("%d components never created"), Skipped);
+	}));
+
+void ALevels_v0Character::BeginPlay()
+{
+	const uint64 BeginPlayStartCycles = FPlatformTime::Cycles64();
+
+	// Call the base class  
+	Super::BeginPlay();
+
+	FullHealth = 1000.0f;
+	Health = FullHealth;
+	HealthPercentage = 1.0f;
+	//bCanBeDamaged = true;
+
+	// normally streamed in at startup already, this only picks up classes spawned without going through the game mode
+	ULevelsAssetManager::Get().LoadCharacterBundle(GetClass(), ULevelsAssetManager::GameBundle);
+	ULevelsAssetManager::Get().LoadCharacterBundle(GetClass(), ULevelsAssetManager::ClientBundle);
+
+	if (!bPoolDormant)
+	{
+		FLevelsAnimationBudget::Register(GetMesh());
+	}
+
+	//Attach gun mesh component to Skeleton, doing it here because the skeleton is not yet created in the constructor
+	//the view meshes are cosmetic and don't exist on a dedicated server
+	if (FP_Gun && Mesh1P)
+	{
+		FP_Gun->AttachToComponent(Mesh1P, FAttachmentTransformRules(EAttachmentRule::SnapToTarget, true), TEXT("GripPoint"));
+	}
+
+	// Only the VR configuration has a VR gun, it shows in place of the arms
+	const ELevelsCharacterConfig Config = GetComponentConfig();
+	if (Config == ELevelsCharacterConfig::VR && VR_Gun == nullptr)
+	{
+		CreateVRComponents();
+	}
+	if (Mesh1P)
+	{
+		//the arms stay up when there is no gun model to show instead
+		Mesh1P->SetHiddenInGame(VR_Gun != nullptr && !VRGunMesh.IsNull(), true);
+	}
+
+	if (ConstructionMs >= 0.0)
+	{
+		FLevelsCompositionStats& Stats = CompositionStats[(int32)Config];
+		++Stats.Characters;
+		Stats.Components += GetComponents().Num();
+		Stats.SpawnMs += ConstructionMs + FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - BeginPlayStartCycles);
+		ConstructionMs = -1.0;
+	}
+}
+
+ELevelsCharacterConfig ALevels_v0Character::GetComponentConfig() const
+{
+	if (IsRunningDedicatedServer() || ULevelsScriptedInputComponent::IsBotCommandLine())
+	{
+		return ELevelsCharacterConfig::ServerBot;
+	}
+	return bUsingMotionControllers ? ELevelsCharacterConfig::VR : ELevelsCharacterConfig::Desktop;
+}
+
+void ALevels_v0Character::CreateVRComponents()
+{
+	LEVELS_LLM_SCOPE(CharacterComponents);
+
 	// Create VR Controllers.
-	R_MotionController = CreateDefaultSubobject<UMotionControllerComponent>(TEXT("R_MotionController"));
+	R_MotionController = NewObject<UMotionControllerComponent>(this, TEXT("R_MotionController"));
 	R_MotionController->MotionSource = FXRMotionControllerBase::RightHandSourceId;
 	R_MotionController->SetupAttachment(RootComponent);
-	L_MotionController = CreateDefaultSubobject<UMotionControllerComponent>(TEXT("L_MotionController"));
+	L_MotionController = NewObject<UMotionControllerComponent>(this, TEXT("L_MotionController"));
 	L_MotionController->SetupAttachment(RootComponent);
 
 	// Create a gun and attach it to the right-hand VR controller.
-	// Create a gun mesh component
-	VR_Gun = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("VR_Gun"));
+	VR_Gun = NewObject<ULevelsCosmeticMeshComponent>(this, TEXT("VR_Gun"));
 	VR_Gun->SetOnlyOwnerSee(false);			// otherwise won't be visible in the multiplayer
 	VR_Gun->bCastDynamicShadow = false;
 	VR_Gun->CastShadow = false;
 	VR_Gun->SetupAttachment(R_MotionController);
 	VR_Gun->SetRelativeRotation(FRotator(0.0f, -90.0f, 0.0f));
+	//the Client bundle load BeginPlay started may still be in flight, the mesh is set once it lands
+	if (VRGunMesh.IsNull())
+	{
+		UE_LOG(LogFPChar, Warning, TEXT("%s has no VRGunMesh set, the VR gun will be invisible"), *GetClass()->GetName());
+	}
+	else if (VRGunMesh.IsValid())
+	{
+		VR_Gun->SetSkeletalMesh(VRGunMesh.Get());
+	}
+	else
+	{
+		ULevelsAssetManager::Get().GetStreamableManager().RequestAsyncLoad(VRGunMesh.ToSoftObjectPath(), FStreamableDelegate::CreateWeakLambda(this, [this]()
+		{
+			if (VR_Gun)
+			{
+				VR_Gun->SetSkeletalMesh(VRGunMesh.Get());
+			}
+		}));
+	}
 
-	VR_MuzzleLocation = CreateDefaultSubobject<USceneComponent>(TEXT("VR_MuzzleLocation"));
+	VR_MuzzleLocation = NewObject<USceneComponent>(this, TEXT("VR_MuzzleLocation"));
 	VR_MuzzleLocation->SetupAttachment(VR_Gun);
 	VR_MuzzleLocation->SetRelativeLocation(FVector(0.000004, 53.999992, 10.000000));
 	VR_MuzzleLocation->SetRelativeRotation(FRotator(0.0f, 90.0f, 0.0f));		// Counteract the rotation of the VR gun model.
 
-	// Uncomment the following line to turn motion controllers on by default:
-	//bUsingMotionControllers = true;
-	isZoomedIn = false; // default boolean for Zoom
+	//parents first so each attaches to a registered component
+	R_MotionController->RegisterComponent();
+	L_MotionController->RegisterComponent();
+	VR_Gun->RegisterComponent();
+	VR_MuzzleLocation->RegisterComponent();
 }
 
-void ALevels_v0Character::BeginPlay()
+void ALevels_v0Character::PostInitializeComponents()
 {
-	// Call the base class  
-	Super::BeginPlay();
-
-	FullHealth = 1000.0f;
-	Health = FullHealth;
-	HealthPercentage = 1.0f;
-	//bCanBeDamaged = true;
+	Super::PostInitializeComponents();
 
+	//grabbed here rather than in BeginPlay so pooled characters can be reset before they begin play
 	CharacterMovement = Cast<ULevelsPlayerMovementComponent>(GetCharacterMovement());
 
-	//Attach gun mesh component to Skeleton, doing it here because the skeleton is not yet created in the constructor
-	FP_Gun->AttachToComponent(Mesh1P, FAttachmentTransformRules(EAttachmentRule::SnapToTarget, true), TEXT("GripPoint"));
+	if (SpawnStartCycles != 0)
+	{
+		ConstructionMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - SpawnStartCycles);
+		SpawnStartCycles = 0;
+	}
+}
 
-	// Show or hide the two versions of the gun based on whether or not we're using motion controllers.
-	if (bUsingMotionControllers)
+void ALevels_v0Character::GetBundleAssets(FName BundleName, TArray<FSoftObjectPath>& OutAssets) const
+{
+	//Game holds what the simulation needs, Client holds presentation that dedicated servers never load
+	TArray<FSoftObjectPath, TInlineAllocator<8>> Paths;
+	if (BundleName == ULevelsAssetManager::GameBundle)
 	{
-		VR_Gun->SetHiddenInGame(false, true);
-		Mesh1P->SetHiddenInGame(true, true);
+		Paths.Add(ProjectileClass.ToSoftObjectPath());
 	}
-	else
+	else if (BundleName == ULevelsAssetManager::ClientBundle)
+	{
+		Paths.Add(FireSound.ToSoftObjectPath());
+		Paths.Add(FireAnimation.ToSoftObjectPath());
+		Paths.Add(MuzzleParticles.ToSoftObjectPath());
+		Paths.Add(ImpactParticles.ToSoftObjectPath());
+		Paths.Add(VRGunMesh.ToSoftObjectPath());
+	}
+
+	for (const FSoftObjectPath& Path : Paths)
 	{
-		VR_Gun->SetHiddenInGame(true, true);
-		Mesh1P->SetHiddenInGame(false, true);
+		if (Path.IsValid())
+		{
+			OutAssets.Add(Path);
+		}
+	}
+
+	//CharacterMovement is only cached once components are initialized, class defaults never get there
+	if (const ULevelsPlayerMovementComponent* Movement = Cast<ULevelsPlayerMovementComponent>(GetCharacterMovement()))
+	{
+		Movement->GetBundleAssets(BundleName, OutAssets);
+	}
+}
+
+FPrimaryAssetId ALevels_v0Character::GetPrimaryAssetId() const
+{
+	// same as UPrimaryDataAsset: only the default object of a blueprint subclass is a primary asset, named after its package
+	if (HasAnyFlags(RF_ClassDefaultObject) && !GetClass()->HasAnyClassFlags(CLASS_Native | CLASS_Intrinsic))
+	{
+		return FPrimaryAssetId(ULevelsAssetManager::CharacterType, FPackageName::GetShortFName(GetOutermost()->GetFName()));
+	}
+	return Super::GetPrimaryAssetId();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Pooling
+
+void ALevels_v0Character::EnterPoolDormancy()
+{
+	bPoolDormant = true;
+
+	bFiring = false;
+	GetWorldTimerManager().ClearTimer(TimerHandle_HandleRefire);
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	FLevelsAnimationBudget::Unregister(GetMesh());
+
+	//nothing to send while parked, the replication graph skips dormant actors entirely
+	SetNetDormancy(DORM_DormantAll);
+
+	if (CharacterMovement)
+	{
+		CharacterMovement->SetMovementChecksPaused(true);
+		CharacterMovement->ResetParkourState();
+		CharacterMovement->DisableMovement();
+		CharacterMovement->SetComponentTickEnabled(false);
+	}
+}
+
+void ALevels_v0Character::LeavePoolDormancy(const FTransform& SpawnTransform)
+{
+	bPoolDormant = false;
+
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+
+	SetNetDormancy(DORM_Awake);
+
+	//health only has a valid maximum once BeginPlay has run, BeginPlay fills it in otherwise
+	if (HasActorBegunPlay())
+	{
+		Health = FullHealth;
+		HealthPercentage = 1.0f;
+		FLevelsAnimationBudget::Register(GetMesh());
+	}
+
+	AimOut();
+
+	if (CharacterMovement)
+	{
+		CharacterMovement->SetComponentTickEnabled(true);
+		CharacterMovement->ResetParkourState();
+		CharacterMovement->SetDefaultMovementMode();
+		CharacterMovement->SetMovementChecksPaused(false);
 	}
 }
 
@@ -162,6 +401,74 @@ void ALevels_v0Character::SetupPlayerInputComponent(class UInputComponent* Playe
 	PlayerInputComponent->BindAction("Sprint", EInputEvent::IE_Pressed, this, &ALevels_v0Character::SprintPressed);
 	PlayerInputComponent->BindAction("Sprint", EInputEvent::IE_Released, this, &ALevels_v0Character::SprintReleased);
 
+	// on a networked client the pawn is usually possessed after BeginPlay, this runs whenever a local player takes it
+	CreateScriptedInput();
+}
+
+void ALevels_v0Character::CreateScriptedInput()
+{
+	// headless bot clients for the load harness drive their character with scripted input
+	if (!ULevelsScriptedInputComponent::IsBotCommandLine() || FindComponentByClass<ULevelsScriptedInputComponent>() != nullptr)
+	{
+		return;
+	}
+
+	LEVELS_LLM_SCOPE(CharacterComponents);
+	ULevelsScriptedInputComponent* ScriptedInput = NewObject<ULevelsScriptedInputComponent>(this, TEXT("ScriptedInput"));
+	ScriptedInput->RegisterComponent();
+}
+
+void ALevels_v0Character::ApplyInputFrame(const FLevelsInputFrame& Frame, const FLevelsInputFrame& Previous)
+{
+	MoveForward(Frame.Forward);
+	MoveRight(Frame.Right);
+
+	// yaw is in degrees so it means the same thing for player and AI controllers
+	if (Frame.Yaw != 0.f && Controller)
+	{
+		FRotator ControlRotation = Controller->GetControlRotation();
+		ControlRotation.Yaw += Frame.Yaw;
+		Controller->SetControlRotation(ControlRotation);
+	}
+
+	const uint8 Pressed = Frame.Buttons & ~Previous.Buttons;
+	const uint8 Released = Previous.Buttons & ~Frame.Buttons;
+
+	if (Pressed & ELevelsInputButton::Jump)
+	{
+		JumpPressed();
+	}
+	else if (Released & ELevelsInputButton::Jump)
+	{
+		StopJumping();
+	}
+
+	if (Pressed & ELevelsInputButton::Crouch)
+	{
+		CrouchStart();
+	}
+	else if (Released & ELevelsInputButton::Crouch)
+	{
+		CrouchEnd();
+	}
+
+	if (Pressed & ELevelsInputButton::Sprint)
+	{
+		SprintPressed();
+	}
+	else if (Released & ELevelsInputButton::Sprint)
+	{
+		SprintReleased();
+	}
+
+	if (Pressed & ELevelsInputButton::Fire)
+	{
+		StartFire();
+	}
+	else if (Released & ELevelsInputButton::Fire)
+	{
+		EndFire();
+	}
 }
 
 void ALevels_v0Character::Fire()
@@ -175,32 +482,56 @@ void ALevels_v0Character::Fire()
 	FCollisionQueryParams QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(WeaponTrace), false, this);
 
 
+	FLevelsHitchWatchdog::NoteSceneQuery();
 	if (GetWorld()->LineTraceSingleByChannel(Hit, StartTrace, EndTrace, ECC_Visibility, QueryParams)) {
-		if (ImpactParticles) {
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, FTransform(Hit.ImpactNormal.Rotation(), Hit.ImpactPoint));
-
-		}
+		ULevelsCosmeticEvents::Publish(GetWorld(), ELevelsCosmeticEvent::ShotImpact, this, Hit.ImpactPoint, Hit.ImpactNormal);
 	}
 
-	if (MuzzleParticles) {
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleParticles, FP_Gun->GetSocketTransform(FName("Muzzle")));
-	}
+	ULevelsCosmeticEvents::Publish(GetWorld(), ELevelsCosmeticEvent::ShotFired, this, StartTrace, FirstPersonCameraComponent->GetForwardVector());
+}
 
-	// try and play the sound if specified
-	if (FireSound != nullptr)
-	{
-		UGameplayStatics::PlaySoundAtLocation(this, FireSound, GetActorLocation());
-	}
+void ALevels_v0Character::PlayCosmeticEvent(const FLevelsCosmeticEvent& Event)
+{
+	LEVELS_LLM_SCOPE(WeaponFX);
 
-	// try and play a firing animation if specified
-	if (FireAnimation != nullptr)
+	//the effects are soft references streamed in by the asset manager, anything still in flight is skipped rather than loaded mid-fight
+	switch (Event.Type)
 	{
-		// Get the animation object for the arms mesh
-		UAnimInstance* AnimInstance = Mesh1P->GetAnimInstance();
-		if (AnimInstance != nullptr)
+	case ELevelsCosmeticEvent::ShotImpact:
+		if (UParticleSystem* Impact = ImpactParticles.Get()) {
+			FLevelsHitchWatchdog::TrackEmitter(UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), Impact, FTransform(Event.Normal.Rotation(), Event.Location)));
+		}
+		break;
+
+	case ELevelsCosmeticEvent::ShotFired:
+		if (UParticleSystem* Muzzle = FP_Gun ? MuzzleParticles.Get() : nullptr) {
+			FLevelsHitchWatchdog::TrackEmitter(UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), Muzzle, FP_Gun->GetSocketTransform(FName("Muzzle"))));
+		}
+
+		// try and play the sound if specified
+		if (USoundBase* Sound = FireSound.Get())
+		{
+			UGameplayStatics::PlaySoundAtLocation(this, Sound, GetActorLocation());
+		}
+
+		// try and play a firing animation if specified
+		if (UAnimMontage* Montage = FireAnimation.Get())
 		{
-			AnimInstance->Montage_Play(FireAnimation, 1.f);
+			// Get the animation object for the arms mesh
+			UAnimInstance* AnimInstance = Mesh1P ? Mesh1P->GetAnimInstance() : nullptr;
+			if (AnimInstance != nullptr)
+			{
+				AnimInstance->Montage_Play(Montage, 1.f);
+			}
 		}
+		break;
+
+	default:
+		if (CharacterMovement)
+		{
+			CharacterMovement->PlayCameraShake(Event.Type);
+		}
+		break;
 	}
 }
 
@@ -326,7 +657,13 @@ float ALevels_v0Character::GetHealth()
 /** Get's the current percentage of speed for the UI's speed meter */
 float ALevels_v0Character::GetSpeed()
 {
-	SpeedPercentage = GetVelocity().Size() / CharacterMovement->MaxWalkSpeed;
+	//sliding sets the walk speed cap to 0, measure against the normal running speed then
+	float MaxSpeed = CharacterMovement->MaxWalkSpeed;
+	if (MaxSpeed <= KINDA_SMALL_NUMBER)
+	{
+		MaxSpeed = CharacterMovement->GetParkourSim().Config.DefaultParams.MaxWalkSpeed;
+	}
+	SpeedPercentage = MaxSpeed > KINDA_SMALL_NUMBER ? GetVelocity().Size() / MaxSpeed : 0.f;
 	return SpeedPercentage;
 }
 
@@ -382,29 +719,33 @@ void ALevels_v0Character::AimOut() {
 }
 
 void ALevels_v0Character::EndFire() {
+	bFiring = false;
 	GetWorldTimerManager().ClearTimer(TimerHandle_HandleRefire);
 }
 
 void ALevels_v0Character::StartFire() {
+	bFiring = true;
 	Fire();
 	GetWorldTimerManager().SetTimer(TimerHandle_HandleRefire, this, &ALevels_v0Character::Fire, TimeBetweenShots, true);
 }
 
 void ALevels_v0Character::CrouchStart()
 {
-	CharacterMovement->CrouchSlideCheck();
+	FLevelsInputLatency::NoteAction(this, ELevelsInputButton::Crouch);
+	CharacterMovement->PressParkourButton(ELevelsInputButton::Crouch);
 }
 
 void ALevels_v0Character::CrouchEnd()
 {
 	//CharacterMovement->CrouchEnd();
-	CharacterMovement->CrouchSlideCheck();
+	CharacterMovement->PressParkourButton(ELevelsInputButton::Crouch);
 }
 
 void ALevels_v0Character::JumpPressed()
 {
-	CharacterMovement->OnJump();
-	Super::Jump();
+	FLevelsInputLatency::NoteAction(this, ELevelsInputButton::Jump);
+	//the movement component jumps once parkour has seen the press, on the next step in fixed step mode so replays jump too
+	CharacterMovement->PressParkourButton(ELevelsInputButton::Jump);
 }
 
 void ALevels_v0Character::JumpReleased()
@@ -414,7 +755,8 @@ void ALevels_v0Character::JumpReleased()
 
 void ALevels_v0Character::SprintPressed()
 {
-	CharacterMovement->SprintStart();
+	FLevelsInputLatency::NoteAction(this, ELevelsInputButton::Sprint);
+	CharacterMovement->PressParkourButton(ELevelsInputButton::Sprint);
 }
 
 void ALevels_v0Character::SprintReleased()
@@ -14,18 +14,34 @@ class UCameraComponent;
 class UMotionControllerComponent;
 class UAnimMontage;
 class USoundBase;
+class USkeletalMesh;
 class ULevelsPlayerMovementComponent;
+struct FLevelsInputFrame;
+struct FLevelsCosmeticEvent;
+
+/** The set of optional components a character builds for itself when it begins play */
+UENUM()
+enum class ELevelsCharacterConfig : uint8
+{
+	//first person arms and gun only
+	Desktop,
+	//motion controllers and the VR gun in place of the arms
+	VR,
+	//dedicated servers and headless bot clients, nothing only a viewer would use
+	ServerBot,
+	Num UMETA(Hidden)
+};
 
 UCLASS(config = Game)
 class ALevels_v0Character : public ACharacter
 {
 	GENERATED_BODY()
 
-		/** Pawn mesh: 1st person view (arms; seen only by self) */
+		/** Pawn mesh: 1st person view (arms; seen only by self). Not loaded on dedicated servers */
 		UPROPERTY(VisibleDefaultsOnly, Category = Mesh)
 		USkeletalMeshComponent* Mesh1P;
 
-	/** Gun mesh: 1st person view (seen only by self) */
+	/** Gun mesh: 1st person view (seen only by self). Not loaded on dedicated servers */
 	UPROPERTY(VisibleDefaultsOnly, Category = Mesh)
 		USkeletalMeshComponent* FP_Gun;
 
@@ -33,24 +49,24 @@ class ALevels_v0Character : public ACharacter
 	UPROPERTY(VisibleDefaultsOnly, Category = Mesh)
 		USceneComponent* FP_MuzzleLocation;
 
-	/** Gun mesh: VR view (attached to the VR controller directly, no arm, just the actual gun) */
-	UPROPERTY(VisibleDefaultsOnly, Category = Mesh)
+	/** Gun mesh: VR view (attached to the VR controller directly, no arm, just the actual gun). Only created in the VR configuration */
+	UPROPERTY(Transient, VisibleInstanceOnly, Category = Mesh)
 		USkeletalMeshComponent* VR_Gun;
 
-	/** Location on VR gun mesh where projectiles should spawn. */
-	UPROPERTY(VisibleDefaultsOnly, Category = Mesh)
+	/** Location on VR gun mesh where projectiles should spawn. Only created in the VR configuration */
+	UPROPERTY(Transient, VisibleInstanceOnly, Category = Mesh)
 		USceneComponent* VR_MuzzleLocation;
 
 	/** First person camera */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 		UCameraComponent* FirstPersonCameraComponent;
 
-	/** Motion controller (right hand) */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
+	/** Motion controller (right hand). Only created in the VR configuration */
+	UPROPERTY(Transient, VisibleInstanceOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
 		UMotionControllerComponent* R_MotionController;
 
-	/** Motion controller (left hand) */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
+	/** Motion controller (left hand). Only created in the VR configuration */
+	UPROPERTY(Transient, VisibleInstanceOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
 		UMotionControllerComponent* L_MotionController;
 
 
@@ -64,6 +80,53 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void PostInitializeComponents() override;
+
+public:
+
+	/** Puts the character to sleep so it can wait in the character pool without ticking, colliding or rendering */
+	void EnterPoolDormancy();
+
+	/** Wakes a pooled character at the given transform and resets its health and movement state */
+	void LeavePoolDormancy(const FTransform& SpawnTransform);
+
+	/** Returns true while the character is parked in the character pool */
+	bool IsPoolDormant() const { return bPoolDormant; }
+
+	/** Feeds one frame of scripted input through the same handlers the input bindings use. Buttons fire on their edges against Previous */
+	void ApplyInputFrame(const FLevelsInputFrame& Frame, const FLevelsInputFrame& Previous);
+
+	/** Plays the shakes, emitters, sounds and montages for an event this character published. Only called where there is a local viewer */
+	void PlayCosmeticEvent(const FLevelsCosmeticEvent& Event);
+
+	/** Returns true while the trigger is held */
+	bool IsFiring() const { return bFiring; }
+
+	/** Which optional components this character builds, decided by the process and bUsingMotionControllers */
+	ELevelsCharacterConfig GetComponentConfig() const;
+
+	/** Components the VR configuration adds, the ones every other configuration goes without */
+	static const int32 VRComponentCount = 4;
+
+private:
+
+	/** Creates and registers the motion controllers, VR gun and its muzzle */
+	void CreateVRComponents();
+
+	/** Adds the scripted input component that drives -LevelsBot clients, once the character is under local control */
+	void CreateScriptedInput();
+
+	//when construction started, for the spawn times Levels.CharacterComposition reports
+	uint64 SpawnStartCycles = 0;
+
+	//construction up to initialized components. Pooled characters begin play only after the map has loaded, so the
+	//time in between is left out and BeginPlay adds only its own part. Negative once reported or if never timed
+	double ConstructionMs = -1.0;
+
+	bool bPoolDormant = false;
+
+	bool bFiring = false;
+
 public:
 	// Called every frame
 	//virtual void Tick(float DeltaTime) override;
@@ -94,33 +157,43 @@ public:
 		FVector GunOffset;
 
 	/** Projectile class to spawn */
-	UPROPERTY(EditDefaultsOnly, Category = Projectile)
-		TSubclassOf<class ALevels_v0Projectile> ProjectileClass;
+	UPROPERTY(EditDefaultsOnly, Category = Projectile, meta = (AssetBundles = "Game"))
+		TSoftClassPtr<class ALevels_v0Projectile> ProjectileClass;
 
 	/** Sound to play each time we fire */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
-		USoundBase* FireSound;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay, meta = (AssetBundles = "Client"))
+		TSoftObjectPtr<USoundBase> FireSound;
 
 	/** AnimMontage to play each time we fire */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
-		UAnimMontage* FireAnimation;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay, meta = (AssetBundles = "Client"))
+		TSoftObjectPtr<UAnimMontage> FireAnimation;
 
 	// time to wait (in seconds) between shots
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
 		float TimeBetweenShots;
 
 	// muzzle flash for shooting gun
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
-		class UParticleSystem* MuzzleParticles;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay, meta = (AssetBundles = "Client"))
+		TSoftObjectPtr<class UParticleSystem> MuzzleParticles;
 
 	// impact particles for shooting gun
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
-		class UParticleSystem* ImpactParticles;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay, meta = (AssetBundles = "Client"))
+		TSoftObjectPtr<class UParticleSystem> ImpactParticles;
 
-	/** Whether to use motion controller location for aiming. */
+	/** Adds the soft references belonging to an asset bundle, used by the asset manager to stream them */
+	virtual void GetBundleAssets(FName BundleName, TArray<FSoftObjectPath>& OutAssets) const;
+
+	/** Character blueprints are primary assets so the asset manager can find, stream and chunk them */
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+
+	/** Whether to use motion controller location for aiming. Has to be set before BeginPlay, the VR components are built then */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
 		uint8 bUsingMotionControllers : 1;
 
+	/** Gun model for the VR configuration */
+	UPROPERTY(EditDefaultsOnly, Category = Mesh, meta = (AssetBundles = "Client"))
+		TSoftObjectPtr<USkeletalMesh> VRGunMesh;
+
 	// Kenny - ADS FUNCTION TO BE USED FOR ANIMATION, TO CHECK STATES 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
 		bool isZoomedIn;
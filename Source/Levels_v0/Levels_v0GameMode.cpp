@@ -3,10 +3,10 @@
 #include "Levels_v0GameMode.h"
 #include "Levels_v0HUD.h"
 #include "Levels_v0Character.h"
-#include "UObject/ConstructorHelpers.h"
+#include "LevelsCharacterPool.h"
+#include "GameFramework/Controller.h"
+#include "LevelsAssetManager.h"
 #include "Kismet/GameplayStatics.h"
-#include "UObject/ConstructorHelpers.h"
-#include "Blueprint/UserWidget.h"
 
 
 ALevels_v0GameMode::ALevels_v0GameMode()
@@ -15,36 +15,74 @@ ALevels_v0GameMode::ALevels_v0GameMode()
 
 	PrimaryActorTick.bCanEverTick = true;
 
-	// set default pawn class to our Blueprinted character
-	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnClassFinder(TEXT("/Game/FirstPersonCPP/Blueprints/FirstPersonCharacter"));
-	DefaultPawnClass = PlayerPawnClassFinder.Class;
+	// set default pawn class to our Blueprinted character. Only a path here, the asset manager streams it in and InitGame resolves it
+	DefaultPawnSoftClass = TSoftClassPtr<APawn>(FSoftObjectPath(TEXT("/Game/FirstPersonCPP/Blueprints/FirstPersonCharacter.FirstPersonCharacter_C")));
 
-	// Sets the healthbar and speed meter as UI
-	static ConstructorHelpers::FClassFinder<UUserWidget> HealthBar(TEXT("/Game/FirstPerson/UI/Health_UI"));
-	HUDWidgetClass = HealthBar.Class;
+	// use our custom HUD class. The HUD owns the health and speed widget, the game mode runs on the CDO and the server where there is nothing to draw
+	HUDClass = ALevels_v0HUD::StaticClass();
+}
+
+void ALevels_v0GameMode::BeginPlay()
+{
+	Super::BeginPlay();
+
+	SetCurrentState(EGamePlayState::EPlaying);
+
+	MyCharacter = Cast<ALevels_v0Character>(UGameplayStatics::GetPlayerPawn(this, 0));
+}
+
+void ALevels_v0GameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
 
-	// use our custom HUD class
-	HUDClass = ALevels_v0GameMode::StaticClass();
+	DefaultPawnClass = ResolveDefaultPawnClass();
 
-	// add Health Bar UI to viewport
-	if (HUDWidgetClass != nullptr)
+	//spawn the dormant characters now while the map is loading so respawns don't hitch later
+	if (ULevelsCharacterPool* Pool = GetWorld()->GetSubsystem<ULevelsCharacterPool>())
 	{
-		CurrentWidget = CreateWidget<UUserWidget>(GetWorld(), HUDWidgetClass);
+		Pool->Prewarm(DefaultPawnClass, CharacterPoolSize);
+	}
+}
 
-		if (CurrentWidget)
+UClass* ALevels_v0GameMode::ResolveDefaultPawnClass() const
+{
+	//a blueprint game mode that picked its own DefaultPawnClass keeps it, unless it also picked a soft class
+	const ALevels_v0GameMode* NativeDefaults = GetDefault<ALevels_v0GameMode>();
+	const bool bPawnClassOverridden = DefaultPawnClass != NativeDefaults->DefaultPawnClass;
+	const bool bSoftClassOverridden = DefaultPawnSoftClass != NativeDefaults->DefaultPawnSoftClass;
+	if (!DefaultPawnSoftClass.IsNull() && DefaultPawnSoftClass.Get() != DefaultPawnClass && (bSoftClassOverridden || !bPawnClassOverridden))
+	{
+		if (UClass* PawnClass = ULevelsAssetManager::ResolveClass(DefaultPawnSoftClass))
 		{
-			CurrentWidget->AddToViewport();
+			return PawnClass;
 		}
 	}
+	return DefaultPawnClass;
 }
 
-void ALevels_v0GameMode::BeginPlay()
+APawn* ALevels_v0GameMode::SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform)
 {
-	Super::BeginPlay();
+	UClass* PawnClass = GetDefaultPawnClassForController(NewPlayer);
+	if (PawnClass && PawnClass->IsChildOf(ALevels_v0Character::StaticClass()))
+	{
+		if (ULevelsCharacterPool* Pool = GetWorld()->GetSubsystem<ULevelsCharacterPool>())
+		{
+			if (ALevels_v0Character* Character = Pool->Acquire(PawnClass, SpawnTransform))
+			{
+				return Character;
+			}
+		}
+	}
 
-	SetCurrentState(EGamePlayState::EPlaying);
+	return Super::SpawnDefaultPawnAtTransform_Implementation(NewPlayer, SpawnTransform);
+}
 
-	MyCharacter = Cast<ALevels_v0Character>(UGameplayStatics::GetPlayerPawn(this, 0));
+void ALevels_v0GameMode::GetStartupAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	if (!DefaultPawnSoftClass.IsNull())
+	{
+		OutAssets.Add(DefaultPawnSoftClass.ToSoftObjectPath());
+	}
 }
 
 void ALevels_v0GameMode::Tick(float DeltaTime)
@@ -83,7 +121,14 @@ void ALevels_v0GameMode::HandleNewState(EGamePlayState NewState)
 	// Unknown/default state
 	case EGamePlayState::EGameOver:
 	{
-		UGameplayStatics::OpenLevel(this, FName(*GetWorld()->GetName()), false);
+		if (bRespawnFromPool)
+		{
+			RespawnFromPool();
+		}
+		else
+		{
+			UGameplayStatics::OpenLevel(this, FName(*GetWorld()->GetName()), false);
+		}
 	}
 	break;
 	// Unknown/default state
@@ -97,6 +142,34 @@ void ALevels_v0GameMode::HandleNewState(EGamePlayState NewState)
 }
 
 
+void ALevels_v0GameMode::RespawnFromPool()
+{
+	ULevelsCharacterPool* Pool = GetWorld()->GetSubsystem<ULevelsCharacterPool>();
+	if (MyCharacter == nullptr || Pool == nullptr)
+	{
+		return;
+	}
+
+	AController* Controller = MyCharacter->GetController();
+	if (Controller)
+	{
+		Controller->UnPossess();
+	}
+
+	Pool->Release(MyCharacter);
+	MyCharacter = nullptr;
+
+	if (Controller)
+	{
+		//RestartPlayer ends up in SpawnDefaultPawnAtTransform which checks a fresh character out of the pool
+		RestartPlayer(Controller);
+		MyCharacter = Cast<ALevels_v0Character>(Controller->GetPawn());
+	}
+
+	SetCurrentState(EGamePlayState::EPlaying);
+}
+
+
 //test of overriding the startplay method. 
 //BeginPlay is an event that gets called at the beginning of a level being opened. Start Play is a function you can call with GameModes
 void ALevels_v0GameMode::StartPlay()
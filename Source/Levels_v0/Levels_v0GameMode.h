@@ -30,6 +30,10 @@ public:
 
 	virtual void Tick(float DeltaTime) override;
 
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	virtual APawn* SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform) override;
+
 	ALevels_v0Character* MyCharacter;
 
 	/** Returns the current playing state */
@@ -39,11 +43,23 @@ public:
 	/** Sets a new playing state */
 	void SetCurrentState(EGamePlayState NewState);
 
-	UPROPERTY(EditAnywhere, Category = "Health")
-		TSubclassOf<class UUserWidget> HUDWidgetClass;
+	/** Character blueprint to play as. Resolved into DefaultPawnClass in InitGame, streamed in by the asset manager at startup */
+	UPROPERTY(EditDefaultsOnly, Category = "Classes")
+		TSoftClassPtr<APawn> DefaultPawnSoftClass;
+
+	/** The pawn class this game mode plays as once DefaultPawnSoftClass is taken into account, also valid on the CDO */
+	UClass* ResolveDefaultPawnClass() const;
 
-	UPROPERTY(EditAnywhere, Category = "Health")
-		class UUserWidget* CurrentWidget;
+	/** Adds the assets the asset manager should stream in before the first map loads */
+	void GetStartupAssets(TArray<FSoftObjectPath>& OutAssets) const;
+
+	/** How many dormant characters to spawn while the map loads */
+	UPROPERTY(EditDefaultsOnly, Category = "Pool")
+		int32 CharacterPoolSize = 4;
+
+	/** If true a dead player is recycled through the character pool instead of reloading the level */
+	UPROPERTY(EditDefaultsOnly, Category = "Pool")
+		bool bRespawnFromPool = true;
 
 private:
 	/**Keeps track of the current playing state */
@@ -52,5 +68,8 @@ private:
 	/**Handle any function calls that rely upon changing the playing state of our game */
 	void HandleNewState(EGamePlayState NewState);
 
+	/** Returns the dead character to the pool and restarts its controller with a fresh one */
+	void RespawnFromPool();
+
 	virtual void StartPlay() override;
 };
\ No newline at end of file
@@ -5,18 +5,40 @@
 #include "Engine/Texture2D.h"
 #include "TextureResource.h"
 #include "CanvasItem.h"
-#include "UObject/ConstructorHelpers.h"
+#include "LevelsAssetManager.h"
 #include "Blueprint/UserWidget.h"
+#include "Levels_v0Character.h"
+#include "LevelsHUDViewModel.h"
+#include "LevelsHealthWidget.h"
+#include "LevelsMemoryTags.h"
 
 ALevels_v0HUD::ALevels_v0HUD()
 {
-	// Set the crosshair texture
-	static ConstructorHelpers::FObjectFinder<UTexture2D> CrosshairTexObj(TEXT("/Game/FirstPerson/Textures/FirstPersonCrosshair"));
-	CrosshairTex = CrosshairTexObj.Object;
+	// the view model is sampled once per frame here instead of the widget polling the character through bindings
+	PrimaryActorTick.bCanEverTick = true;
+
+	// Set the crosshair texture. Soft references only, the asset manager streams them in at startup
+	CrosshairTexture = TSoftObjectPtr<UTexture2D>(FSoftObjectPath(TEXT("/Game/FirstPerson/Textures/FirstPersonCrosshair.FirstPersonCrosshair")));
 
 	// Sets the UI for healthbar and speed meter
-	static ConstructorHelpers::FClassFinder<UUserWidget> HealthBarObj(TEXT("/Game/FirstPerson/UI/Health_UI"));
-	HUDWidgetClass = HealthBarObj.Class;
+	HUDWidgetClass = TSoftClassPtr<UUserWidget>(FSoftObjectPath(TEXT("/Game/FirstPerson/UI/Health_UI.Health_UI_C")));
+}
+
+void ALevels_v0HUD::GetStartupAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	// the server never draws a HUD
+	if (IsRunningDedicatedServer())
+	{
+		return;
+	}
+	if (!CrosshairTexture.IsNull())
+	{
+		OutAssets.Add(CrosshairTexture.ToSoftObjectPath());
+	}
+	if (!HUDWidgetClass.IsNull())
+	{
+		OutAssets.Add(HUDWidgetClass.ToSoftObjectPath());
+	}
 }
 
 
@@ -33,6 +55,11 @@ void ALevels_v0HUD::DrawHUD()
 	const FVector2D CrosshairDrawPosition( (Center.X),
 										   (Center.Y + 20.0f));
 
+	if (CrosshairTex == nullptr)
+	{
+		return;
+	}
+
 	// draw the crosshair
 	FCanvasTileItem TileItem( CrosshairDrawPosition, CrosshairTex->Resource, FLinearColor::White);
 	TileItem.BlendMode = SE_BLEND_Translucent;
@@ -41,15 +68,40 @@ void ALevels_v0HUD::DrawHUD()
 
 void ALevels_v0HUD::BeginPlay()
 {
+	LEVELS_LLM_SCOPE(HUD);
+
 	Super::BeginPlay();
 
-	if (HUDWidgetClass != nullptr)
+	ViewModel = NewObject<ULevelsHUDViewModel>(this);
+
+	CrosshairTex = ULevelsAssetManager::ResolveObject(CrosshairTexture);
+
+	// the HUD is the only owner of the health and speed widget
+	UClass* WidgetClass = ULevelsAssetManager::ResolveClass(HUDWidgetClass);
+	if (WidgetClass != nullptr && CurrentWidget == nullptr)
 	{
-		CurrentWidget = CreateWidget<UUserWidget>(GetWorld(), HUDWidgetClass);
+		CurrentWidget = CreateWidget<UUserWidget>(GetOwningPlayerController(), WidgetClass);
 
 		if (CurrentWidget) 
 		{
+			if (ULevelsHealthWidget* HealthWidget = Cast<ULevelsHealthWidget>(CurrentWidget))
+			{
+				HealthWidget->SetViewModel(ViewModel);
+			}
 			CurrentWidget->AddToViewport();
 		}
 	}
 }
+
+void ALevels_v0HUD::Tick(float DeltaSeconds)
+{
+	LEVELS_LLM_SCOPE(HUD);
+
+	Super::Tick(DeltaSeconds);
+
+	if (ViewModel)
+	{
+		// the pawn changes when a character is recycled through the pool, Refresh does a full push when it does
+		ViewModel->Refresh(Cast<ALevels_v0Character>(GetOwningPawn()));
+	}
+}
@@ -19,16 +19,33 @@ public:
 
 	virtual void BeginPlay() override;
 
+	virtual void Tick(float DeltaSeconds) override;
+
+	/** Adds the assets the asset manager should stream in before the first map loads */
+	void GetStartupAssets(TArray<FSoftObjectPath>& OutAssets) const;
+
+	/** Returns the view model driving the health and speed widget */
+	class ULevelsHUDViewModel* GetViewModel() const { return ViewModel; }
+
 private:
-	/** Crosshair asset pointer */
-	class UTexture2D* CrosshairTex;
+	/** Crosshair asset */
+	UPROPERTY(EditAnywhere, Category = "HUD")
+		TSoftObjectPtr<class UTexture2D> CrosshairTexture;
+
+	/** Crosshair asset pointer, resolved from CrosshairTexture in BeginPlay */
+	UPROPERTY(Transient)
+		class UTexture2D* CrosshairTex;
 
 	UPROPERTY(EditAnywhere, Category = "Health")
-		TSubclassOf<class UUserWidget> HUDWidgetClass;
+		TSoftClassPtr<class UUserWidget> HUDWidgetClass;
 	
 	UPROPERTY(EditAnywhere, Category = "Health")
 		class UUserWidget* CurrentWidget;
 
+	/** Caches the displayed values and pushes them to the widget only when they change */
+	UPROPERTY(Transient)
+		class ULevelsHUDViewModel* ViewModel;
+
 
 };
 
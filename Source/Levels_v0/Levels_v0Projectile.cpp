@@ -3,9 +3,12 @@
 #include "Levels_v0Projectile.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
+#include "LevelsMemoryTags.h"
 
 ALevels_v0Projectile::ALevels_v0Projectile() 
 {
+	LEVELS_LLM_SCOPE(Projectiles);
+
 	// Use a sphere as a simple collision representation
 	CollisionComp = CreateDefaultSubobject<USphereComponent>(TEXT("SphereComp"));
 	CollisionComp->InitSphereRadius(5.0f);
@@ -29,6 +32,10 @@ ALevels_v0Projectile::ALevels_v0Projectile()
 
 	// Die after 3 seconds by default
 	InitialLifeSpan = 3.0f;
+
+	// Replicate server spawned projectiles, the replication graph keeps them in its spatial grid
+	bReplicates = true;
+	SetReplicatingMovement(true);
 }
 
 void ALevels_v0Projectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "ParkourTypes.h"
+
+namespace LevelsParkour
+{
+	/** Collision queries the sim needs from whatever world it runs in */
+	class ISceneQuery
+	{
+	public:
+		virtual ~ISceneQuery() {}
+
+		/** Visibility line trace, fills Hit and returns true on a blocking hit */
+		virtual bool LineTrace(const FVec3& Start, const FVec3& End, FTraceHit& Hit) const = 0;
+
+		/** Visibility capsule sweep, fills Hit and returns true on a blocking hit */
+		virtual bool CapsuleTrace(const FVec3& Start, const FVec3& End, float Radius, float HalfHeight, FTraceHit& Hit) const = 0;
+	};
+
+	/**
+	 * The character the sim drives. In the game this is the character movement component, headless it is a
+	 * simple kinematic capsule. Changing the base movement clears the parkour mode and reports the change back
+	 * through FParkourSim::OnMovementChanged, the same as the engine's SetMovementMode.
+	 */
+	class IParkourBody
+	{
+	public:
+		virtual ~IParkourBody() {}
+
+		virtual FVec3 GetLocation() const = 0;
+		virtual FVec3 GetForward() const = 0;
+		virtual FVec3 GetRight() const = 0;
+		virtual FVec3 GetUp() const = 0;
+		virtual FVec3 GetEyeLocation() const = 0;
+		virtual FVec3 GetVelocity() const = 0;
+		virtual float GetCapsuleHalfHeight() const = 0;
+
+		/** Movement input for this update, only its direction matters */
+		virtual FVec3 GetMoveInput() const = 0;
+
+		/** Length of this parkour update */
+		virtual float GetDeltaSeconds() const = 0;
+
+		/** Simulation time in seconds, what buffered presses are stamped with */
+		virtual float GetTime() const = 0;
+
+		virtual EBaseMovement GetMovement() const = 0;
+		virtual void SetMovement(EBaseMovement Movement) = 0;
+
+		virtual EParkourMode GetMode() const = 0;
+		virtual void SetMode(EParkourMode Mode) = 0;
+
+		virtual FMovementParams GetMovementParams() const = 0;
+		virtual void SetMovementParams(const FMovementParams& Params) = 0;
+
+		virtual void SetLocation(const FVec3& Location) = 0;
+
+		/** Starts the body's own jump, for a jump press that was buffered until landing */
+		virtual void Jump() = 0;
+
+		/** Adds to or replaces the velocity on the next movement update, like ACharacter::LaunchCharacter */
+		virtual void Launch(const FVec3& LaunchVelocity, bool bXYOverride, bool bZOverride) = 0;
+
+		/** Instant velocity change */
+		virtual void AddImpulse(const FVec3& Impulse) = 0;
+
+		virtual void StopMovement() = 0;
+
+		/** Stops all movement updates until the base movement is set again */
+		virtual void DisableMovement() = 0;
+
+		virtual void Crouch(bool bClientSimulation) = 0;
+		virtual void UnCrouch(bool bClientSimulation) = 0;
+
+		/** Keeps movement on the plane spanned by Forward and Up */
+		virtual void ConstrainToPlane(const FVec3& Forward, const FVec3& Up) = 0;
+		virtual void ReleasePlaneConstraint() = 0;
+
+		/** Calls FParkourSim::FireCooldown after Seconds, repeating if bLooping. Zero or less never fires */
+		virtual void SetCooldown(ECooldown Cooldown, float Seconds, bool bLooping) = 0;
+		virtual void ClearCooldown(ECooldown Cooldown) = 0;
+
+		/** Turns the view towards Target, only matters for a locally controlled player */
+		virtual void TurnTowards(const FVec3& Target, float DeltaSeconds, float InterpSpeed) {}
+
+		virtual void OnParkourEvent(EParkourEvent Event) {}
+	};
+}
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cmath>
+
+/**
+ * Engine independent vector math for the parkour core. Mirrors the handful of FVector and FMath
+ * operations the movement code used so results match what the component computed before.
+ */
+namespace LevelsParkour
+{
+	struct FVec3
+	{
+		float X = 0.f;
+		float Y = 0.f;
+		float Z = 0.f;
+
+		FVec3() {}
+		FVec3(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ) {}
+
+		FVec3 operator+(const FVec3& V) const { return FVec3(X + V.X, Y + V.Y, Z + V.Z); }
+		FVec3 operator-(const FVec3& V) const { return FVec3(X - V.X, Y - V.Y, Z - V.Z); }
+		FVec3 operator*(float Scale) const { return FVec3(X * Scale, Y * Scale, Z * Scale); }
+		FVec3 operator-() const { return FVec3(-X, -Y, -Z); }
+		FVec3& operator+=(const FVec3& V) { X += V.X; Y += V.Y; Z += V.Z; return *this; }
+		FVec3& operator-=(const FVec3& V) { X -= V.X; Y -= V.Y; Z -= V.Z; return *this; }
+		bool operator==(const FVec3& V) const { return X == V.X && Y == V.Y && Z == V.Z; }
+		bool operator!=(const FVec3& V) const { return !(*this == V); }
+	};
+
+	inline float Dot(const FVec3& A, const FVec3& B)
+	{
+		return A.X * B.X + A.Y * B.Y + A.Z * B.Z;
+	}
+
+	inline FVec3 Cross(const FVec3& A, const FVec3& B)
+	{
+		return FVec3(A.Y * B.Z - A.Z * B.Y, A.Z * B.X - A.X * B.Z, A.X * B.Y - A.Y * B.X);
+	}
+
+	inline float SizeSquared(const FVec3& V)
+	{
+		return V.X * V.X + V.Y * V.Y + V.Z * V.Z;
+	}
+
+	inline float Size(const FVec3& V)
+	{
+		return std::sqrt(SizeSquared(V));
+	}
+
+	inline float Size2D(const FVec3& V)
+	{
+		return std::sqrt(V.X * V.X + V.Y * V.Y);
+	}
+
+	inline float Distance(const FVec3& A, const FVec3& B)
+	{
+		return Size(A - B);
+	}
+
+	/** Unit vector, or zero for vectors too short to normalize */
+	inline FVec3 SafeNormal(const FVec3& V)
+	{
+		const float SquareSum = SizeSquared(V);
+		if (SquareSum == 1.f)
+		{
+			return V;
+		}
+		if (SquareSum < 1.e-8f)
+		{
+			return FVec3();
+		}
+		return V * (1.f / std::sqrt(SquareSum));
+	}
+
+	inline float Clamp01(float Value)
+	{
+		return Value < 0.f ? 0.f : (Value < 1.f ? Value : 1.f);
+	}
+
+	/** Same as FMath::FInterpTo */
+	inline float FInterpTo(float Current, float Target, float DeltaTime, float InterpSpeed)
+	{
+		if (InterpSpeed <= 0.f)
+		{
+			return Target;
+		}
+
+		const float Dist = Target - Current;
+		if (Dist * Dist < 1.e-8f)
+		{
+			return Target;
+		}
+
+		return Current + Dist * Clamp01(DeltaTime * InterpSpeed);
+	}
+
+	/** Same as FMath::VInterpTo */
+	inline FVec3 VInterpTo(const FVec3& Current, const FVec3& Target, float DeltaTime, float InterpSpeed)
+	{
+		if (InterpSpeed <= 0.f)
+		{
+			return Target;
+		}
+
+		const FVec3 Dist = Target - Current;
+		if (SizeSquared(Dist) < 1.e-4f)
+		{
+			return Target;
+		}
+
+		return Current + Dist * Clamp01(DeltaTime * InterpSpeed);
+	}
+}
@@ -0,0 +1,729 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ParkourSim.h"
+
+namespace LevelsParkour
+{
+	FWallRunProbe ComputeWallRunProbe(const FParkourConfig& Config, const FVec3& Location, const FVec3& Forward, const FVec3& Right)
+	{
+		//the probes lean back a little so there's leeway for looking around while running along a wall
+		const FVec3 Back = Forward * -Config.WallRunProbeBack;
+
+		FWallRunProbe Probe;
+		Probe.Start = Location;
+		Probe.RightEnd = Location + Right * Config.WallRunProbeLength + Back;
+		Probe.LeftEnd = Location + Right * -Config.WallRunProbeLength + Back;
+		return Probe;
+	}
+
+	FMantleProbe ComputeMantleProbe(const FParkourConfig& Config, const FVec3& EyeLocation, const FVec3& Location, const FVec3& Forward, float CapsuleHalfHeight)
+	{
+		const FVec3 Reach = Forward * Config.MantleProbeReach;
+
+		FMantleProbe Probe;
+		Probe.Eye = (EyeLocation + FVec3(0.f, 0.f, Config.MantleProbeRise)) + Reach;
+		Probe.Feet = (Location - FVec3(0.f, 0.f, CapsuleHalfHeight - Config.MantleHeight)) + Reach;
+		return Probe;
+	}
+
+	bool IsWallRunnableNormal(const FParkourConfig& Config, const FVec3& Normal)
+	{
+		return Normal.Z < Config.WallRunNormalZLimit && Normal.Z > -Config.WallRunNormalZLimit;
+	}
+
+	bool IsCornerTransition(const FVec3& PrevNormal, const FVec3& Normal)
+	{
+		//only a turn of about 90 degrees makes the normals differ by more than this
+		return PrevNormal.Z != 0.f && Size2D(PrevNormal - Normal) > Size(FVec3(0.5f, 0.5f, 0.5f));
+	}
+
+	bool ShouldEndSlide(const FParkourConfig& Config, const FVec3& Velocity)
+	{
+		return Size(Velocity) <= Config.SlideEndSpeed;
+	}
+
+	FVec3 BoostWalkingAcceleration(const FParkourConfig& Config, const FVec3& Acceleration, const FVec3& Velocity)
+	{
+		//makes the game feel faster :)
+		if (Size2D(Velocity) < Config.StartBoostSpeed)
+		{
+			return SafeNormal(Acceleration) * Config.StartBoostAcceleration;
+		}
+		return Acceleration;
+	}
+
+	void FParkourSim::Update()
+	{
+		ConsumeIntents();
+
+		if (State.bWallRunEnabled)
+		{
+			WallRunUpdate();
+		}
+		if (State.bWallClimbEnabled)
+		{
+			WallClimbUpdate();
+		}
+		if (State.bMantleCheckEnabled && MantleCheck())
+		{
+			MantleStart();
+		}
+		if (State.bMantleEnabled)
+		{
+			MantleMovement();
+		}
+		if (State.bSprintEnabled)
+		{
+			SprintUpdate();
+		}
+		if (State.bSlidingEnabled)
+		{
+			SlideUpdate();
+		}
+	}
+
+	void FParkourSim::OnJump(float AgeSeconds)
+	{
+		//a press on the way down is kept for the landing, one on the way up is the body's own jump taking off
+		if (!ApplyJump() && IsFalling() && Body.GetVelocity().Z <= 0.f)
+		{
+			BufferIntent(EIntent::Jump, AgeSeconds);
+		}
+	}
+
+	bool FParkourSim::ApplyJump()
+	{
+		if (Body.GetMode() == EParkourMode::None)
+		{
+			if (IsFalling())
+			{
+				return false;
+			}
+			EnableWallRun();
+			EnableWallClimb();
+			State.bSprintEnabled = true;
+			State.bSlidingEnabled = true;
+			Body.OnParkourEvent(EParkourEvent::Jumped);
+		}
+		else
+		{
+			WallRunJump();
+			LedgeGrabJump();
+			SlideJump();
+			CrouchJump();
+			SprintJump();
+		}
+		return true;
+	}
+
+	bool FParkourSim::HasIntent(EIntent Intent) const
+	{
+		for (int Index = 0; Index < State.IntentCount; ++Index)
+		{
+			if (State.Intents[(State.IntentHead + Index) % IntentCapacity] == Intent)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void FParkourSim::BufferIntent(EIntent Intent, float AgeSeconds)
+	{
+		RemoveIntent(Intent);
+		if (State.IntentCount == IntentCapacity)
+		{
+			State.IntentHead = (State.IntentHead + 1) % IntentCapacity;
+			--State.IntentCount;
+		}
+
+		const int Slot = (State.IntentHead + State.IntentCount) % IntentCapacity;
+		State.Intents[Slot] = Intent;
+		State.IntentTimes[Slot] = Body.GetTime() - (AgeSeconds > 0.f ? AgeSeconds : 0.f);
+		++State.IntentCount;
+	}
+
+	void FParkourSim::RemoveIntent(EIntent Intent)
+	{
+		//closes the gap so the rest stay in press order
+		int Kept = 0;
+		for (int Index = 0; Index < State.IntentCount; ++Index)
+		{
+			const int From = (State.IntentHead + Index) % IntentCapacity;
+			if (State.Intents[From] != Intent)
+			{
+				const int To = (State.IntentHead + Kept++) % IntentCapacity;
+				State.Intents[To] = State.Intents[From];
+				State.IntentTimes[To] = State.IntentTimes[From];
+			}
+		}
+		State.IntentCount = (uint8_t)Kept;
+	}
+
+	float FParkourSim::GetIntentWindow(EIntent Intent) const
+	{
+		switch (Intent)
+		{
+		case EIntent::Jump:
+			return Config.JumpBufferTime;
+		case EIntent::Slide:
+			return Config.SlideBufferTime;
+		case EIntent::Sprint:
+			return Config.SprintBufferTime;
+		default:
+			return 0.f;
+		}
+	}
+
+	void FParkourSim::ConsumeIntents()
+	{
+		if (State.IntentCount == 0)
+		{
+			return;
+		}
+
+		const float Now = Body.GetTime();
+		for (int Intent = 0; Intent < (int)EIntent::Num; ++Intent)
+		{
+			for (int Index = 0; Index < State.IntentCount; ++Index)
+			{
+				const int Slot = (State.IntentHead + Index) % IntentCapacity;
+				if (State.Intents[Slot] == (EIntent)Intent && Now - State.IntentTimes[Slot] > GetIntentWindow((EIntent)Intent))
+				{
+					RemoveIntent((EIntent)Intent);
+					break;
+				}
+			}
+		}
+
+		//a fixed order rather than press order, a slide needs the sprint that a sprint start would use up
+		const EParkourMode Mode = Body.GetMode();
+		if (HasIntent(EIntent::Jump) && IsWalking() && (Mode == EParkourMode::None || Mode == EParkourMode::Sprint || Mode == EParkourMode::Crouch))
+		{
+			RemoveIntent(EIntent::Jump);
+			ApplyJump();
+			Body.Jump();
+		}
+		if (HasIntent(EIntent::Slide) && CanSlide() && IsWalking())
+		{
+			SlideStart();
+		}
+		if (HasIntent(EIntent::Sprint) && Body.GetMode() == EParkourMode::None && IsWalking())
+		{
+			TrySprint();
+		}
+	}
+
+	void FParkourSim::OnMovementChanged(EBaseMovement PreviousMovement, EParkourMode PreviousMode)
+	{
+		if (PreviousMovement == EBaseMovement::Walking && IsFalling())
+		{
+			EnableWallClimb();
+			State.bSlidingEnabled = true;
+			State.bSprintEnabled = true;
+			SprintJump();
+			if (PreviousMode == EParkourMode::Sprint)
+			{
+				BufferIntent(EIntent::Sprint, 0.f);
+			}
+			WallRunEnd(0.35f);
+			WallClimbEnd(0.0f);
+			SlideEnd(false);
+		}
+	}
+
+	void FParkourSim::OnLanded()
+	{
+		DisableWallRun();
+		DisableWallClimb();
+		State.bSlidingEnabled = false;
+		State.bSprintEnabled = false;
+		WallRunEnd(0.35f);
+		WallClimbEnd(0.0f);
+		SprintEnd();
+		SlideEnd(false);
+		Body.OnParkourEvent(EParkourEvent::Landed);
+	}
+
+	void FParkourSim::FireCooldown(ECooldown Cooldown)
+	{
+		switch (Cooldown)
+		{
+		case ECooldown::WallRun:
+			EnableWallRun();
+			break;
+		case ECooldown::WallClimb:
+			EnableWallClimb();
+			break;
+		case ECooldown::MantleCheck:
+			EnableMantleCheck();
+			break;
+		default:
+			break;
+		}
+	}
+
+	bool FParkourSim::SetCustomMode(EParkourMode NewMode)
+	{
+		if (Body.GetMode() == NewMode)
+		{
+			return false;
+		}
+
+		Body.SetMode(NewMode);
+		ResetMovement();
+		return true;
+	}
+
+	void FParkourSim::ResetMovement()
+	{
+		const EParkourMode Mode = Body.GetMode();
+		if (Mode == EParkourMode::None || Mode == EParkourMode::Crouch)
+		{
+			Body.SetMovementParams(Config.DefaultParams);
+			Body.ReleasePlaneConstraint();
+			Body.SetMovement(EBaseMovement::Walking);
+		}
+	}
+
+	bool FParkourSim::IsWallRunning() const
+	{
+		const EParkourMode Mode = Body.GetMode();
+		return Mode == EParkourMode::RightWallRun || Mode == EParkourMode::LeftWallRun;
+	}
+
+	bool FParkourSim::IsClimbing() const
+	{
+		const EParkourMode Mode = Body.GetMode();
+		return Mode == EParkourMode::LedgeGrab || Mode == EParkourMode::WallClimb || Mode == EParkourMode::Mantle;
+	}
+
+	bool FParkourSim::ForwardInput() const
+	{
+		return Dot(Body.GetForward(), Body.GetMoveInput()) > 0.f;
+	}
+
+	bool FParkourSim::MovingForward() const
+	{
+		return Dot(Body.GetForward(), SafeNormal(Body.GetVelocity())) > 0.f;
+	}
+
+	void FParkourSim::SetGravityScale(float GravityScale)
+	{
+		FMovementParams Params = Body.GetMovementParams();
+		Params.GravityScale = GravityScale;
+		Body.SetMovementParams(Params);
+	}
+
+	void FParkourSim::SetMaxWalkSpeed(float MaxWalkSpeed)
+	{
+		FMovementParams Params = Body.GetMovementParams();
+		Params.MaxWalkSpeed = MaxWalkSpeed;
+		Body.SetMovementParams(Params);
+	}
+
+	//Wall run
+
+	bool FParkourSim::CanWallRun() const
+	{
+		return (MovingForward() && Body.GetMode() == EParkourMode::None) || IsWallRunning();
+	}
+
+	void FParkourSim::WallRunUpdate()
+	{
+		if (!CanWallRun())
+		{
+			return;
+		}
+
+		const FWallRunProbe Probe = ComputeWallRunProbe(Config, Body.GetLocation(), Body.GetForward(), Body.GetRight());
+		const bool bPassesSpeedRequirement = Size2D(Body.GetVelocity()) > Config.WallRunSpeedRequirement;
+
+		//a wall run can't switch sides without ending first. The mode is read again for the left side, hitting a corner on the right ends the run
+		if (bPassesSpeedRequirement && Body.GetMode() != EParkourMode::LeftWallRun && WallRunMovement(Probe.Start, Probe.RightEnd, -1.0f))
+		{
+			SetCustomMode(EParkourMode::RightWallRun);
+			//change gravity to give the effect that the character falls downwards as it goes along the wall
+			SetGravityScale(FInterpTo(Config.DefaultParams.GravityScale, Config.WallRunGravity, Body.GetDeltaSeconds(), Config.WallRunGravityInterpSpeed));
+		}
+		else if (bPassesSpeedRequirement && Body.GetMode() != EParkourMode::RightWallRun && WallRunMovement(Probe.Start, Probe.LeftEnd, 1.0f))
+		{
+			SetCustomMode(EParkourMode::LeftWallRun);
+			SetGravityScale(FInterpTo(Config.DefaultParams.GravityScale, Config.WallRunGravity, Body.GetDeltaSeconds(), Config.WallRunGravityInterpSpeed));
+		}
+		else if (IsWallRunning())
+		{
+			WallRunEnd(Config.WallRunCooldown);
+		}
+	}
+
+	bool FParkourSim::WallRunMovement(const FVec3& Start, const FVec3& End, float WallRunDirection)
+	{
+		FTraceHit Hit;
+		if (!Scene.LineTrace(Start, End, Hit))
+		{
+			return false;
+		}
+
+		State.WallRunHitNormal = Hit.Normal;
+
+		if (IsCornerTransition(State.PrevWallRunHitNormal, State.WallRunHitNormal))
+		{
+			WallRunEnd(Config.WallRunCooldown);
+			return false;
+		}
+
+		if (IsWallRunnableNormal(Config, State.WallRunHitNormal) && IsFalling())
+		{
+			//launch the character along the wall
+			const FVec3 LaunchVector = Cross(State.WallRunHitNormal, FVec3(0.f, 0.f, 1.f));
+			Body.Launch(LaunchVector * (WallRunDirection * Size2D(Body.GetVelocity())), true, !Config.bWallRunGravity);
+			State.PrevWallRunHitNormal = State.WallRunHitNormal;
+			return true;
+		}
+		return false;
+	}
+
+	void FParkourSim::WallRunJump()
+	{
+		if (IsWallRunning())
+		{
+			WallRunEnd(Config.WallRunJumpCooldown);
+			const FVec3 Velocity = Body.GetVelocity();
+			Body.Launch(FVec3(Config.WallRunJumpForce * Velocity.X, Config.WallRunJumpForce * Velocity.Y, Config.WallRunJumpHeight), true, true);
+		}
+	}
+
+	void FParkourSim::EnableWallRun()
+	{
+		State.bWallRunEnabled = true;
+		Body.ClearCooldown(ECooldown::WallRun);
+	}
+
+	void FParkourSim::WallRunEnd(float Cooldown)
+	{
+		SetCustomMode(EParkourMode::None);
+		State.PrevWallRunHitNormal = FVec3();
+		SetGravityScale(Config.DefaultParams.GravityScale);
+		DisableWallRun();
+		Body.SetCooldown(ECooldown::WallRun, Cooldown, true);
+	}
+
+	//Wall climb, ledge grab and mantle
+
+	bool FParkourSim::CanWallClimb() const
+	{
+		const EParkourMode Mode = Body.GetMode();
+		return ForwardInput() && IsFalling() && (Mode == EParkourMode::None || Mode == EParkourMode::WallClimb || IsWallRunning());
+	}
+
+	void FParkourSim::WallClimbUpdate()
+	{
+		if (!CanWallClimb())
+		{
+			WallClimbEnd(.35f);
+			return;
+		}
+
+		const FMantleProbe Probe = ComputeMantleProbe(Config, Body.GetEyeLocation(), Body.GetLocation(), Body.GetForward(), Body.GetCapsuleHalfHeight());
+
+		FTraceHit Hit;
+		if (Scene.CapsuleTrace(Probe.Eye, Probe.Feet, Config.MantleProbeRadius, Config.MantleProbeHalfHeight, Hit))
+		{
+			State.MantleTraceDistance = Hit.Distance;
+			if (Hit.bWalkable)
+			{
+				State.MantlePosition = Hit.ImpactPoint + FVec3(0.f, 0.f, Body.GetCapsuleHalfHeight());
+				DisableWallClimb();
+				if (SetCustomMode(EParkourMode::LedgeGrab))
+				{
+					Body.DisableMovement();
+					//disabling movement clears the mode, put the ledge grab back
+					Body.SetMode(EParkourMode::LedgeGrab);
+					Body.StopMovement();
+					SetGravityScale(0.f);
+					Body.OnParkourEvent(EParkourEvent::LedgeGrabbed);
+					//a ledge far enough below the eyes is mantled straight away
+					if (QuickMantle())
+					{
+						EnableMantleCheck();
+					}
+					else
+					{
+						Body.SetCooldown(ECooldown::MantleCheck, .25f, true);
+					}
+				}
+				return;
+			}
+		}
+
+		WallClimbMovement(Probe);
+	}
+
+	bool FParkourSim::WallClimbMovement(const FMantleProbe& Probe)
+	{
+		FTraceHit Hit;
+		if (ForwardInput() && Scene.LineTrace(Probe.Eye, Body.GetForward() * Config.MantleProbeReach + Probe.Feet, Hit))
+		{
+			State.WallClimbHitNormal = Hit.Normal;
+			SetCustomMode(EParkourMode::WallClimb);
+			Body.Launch(FVec3(State.WallClimbHitNormal.X * -Config.WallClimbPull, State.WallClimbHitNormal.Y * -Config.WallClimbPull, Config.WallClimbSpeed), true, true);
+			return true;
+		}
+
+		WallClimbEnd(.35f);
+		return false;
+	}
+
+	void FParkourSim::EnableWallClimb()
+	{
+		State.bWallClimbEnabled = true;
+	}
+
+	void FParkourSim::DisableWallClimb()
+	{
+		State.bWallClimbEnabled = false;
+		State.bMantleEnabled = false;
+	}
+
+	void FParkourSim::WallClimbEnd(float Cooldown)
+	{
+		if (IsClimbing() && SetCustomMode(EParkourMode::None))
+		{
+			DisableWallClimb();
+			DisableMantleCheck();
+			State.MantleTraceDistance = 0.f;
+			Body.SetCooldown(ECooldown::WallClimb, Cooldown, false);
+		}
+	}
+
+	bool FParkourSim::MantleCheck() const
+	{
+		return ForwardInput() && (Body.GetMode() == EParkourMode::LedgeGrab || QuickMantle());
+	}
+
+	bool FParkourSim::QuickMantle() const
+	{
+		return State.MantleTraceDistance > Body.GetCapsuleHalfHeight();
+	}
+
+	void FParkourSim::MantleStart()
+	{
+		if (SetCustomMode(EParkourMode::Mantle))
+		{
+			Body.OnParkourEvent(QuickMantle() ? EParkourEvent::QuickMantled : EParkourEvent::Mantled);
+			DisableMantleCheck();
+			State.bMantleEnabled = true;
+		}
+	}
+
+	void FParkourSim::MantleMovement()
+	{
+		const float DeltaSeconds = Body.GetDeltaSeconds();
+		Body.TurnTowards(State.MantlePosition, DeltaSeconds, Config.MantleTurnSpeed);
+		Body.SetLocation(VInterpTo(Body.GetLocation(), State.MantlePosition, DeltaSeconds, QuickMantle() ? Config.QuickMantleSpeed : Config.MantleSpeed));
+
+		if (Distance(Body.GetLocation(), State.MantlePosition) < Config.MantleArriveDistance)
+		{
+			WallClimbEnd(0.5f);
+		}
+	}
+
+	void FParkourSim::LedgeGrabJump()
+	{
+		if (IsClimbing())
+		{
+			WallClimbEnd(0.35f);
+			Body.Launch(FVec3(State.WallClimbHitNormal.X * Config.LedgeGrabJumpForce, State.WallClimbHitNormal.Y * Config.LedgeGrabJumpForce, Config.LedgeGrabJumpHeight), false, true);
+		}
+	}
+
+	//Slide and crouch
+
+	bool FParkourSim::CanSlide() const
+	{
+		return (Body.GetMode() == EParkourMode::Sprint || HasIntent(EIntent::Sprint)) && MovingForward();
+	}
+
+	void FParkourSim::SlideUpdate()
+	{
+		if (Body.GetMode() == EParkourMode::Slide && ShouldEndSlide(Config, Body.GetVelocity()))
+		{
+			SlideEnd(true);
+		}
+	}
+
+	void FParkourSim::SlideStart()
+	{
+		if (!(CanSlide() && IsWalking()))
+		{
+			return;
+		}
+
+		SprintEnd();
+		SetCustomMode(EParkourMode::Slide);
+		Body.Crouch(true);
+
+		FMovementParams Params = Body.GetMovementParams();
+		Params.GroundFriction = 0.f;
+		Params.BrakingDecelerationWalking = Config.SlideBrakingDeceleration;
+		Params.MaxWalkSpeed = 0.f;
+		Body.SetMovementParams(Params);
+		Body.ConstrainToPlane(SafeNormal(Body.GetVelocity()), Body.GetUp());
+
+		//push along the floor, a miss leaves the normal zero and the push with it
+		const FVec3 Location = Body.GetLocation();
+		FTraceHit Hit;
+		Scene.LineTrace(Location, Body.GetUp() * -Config.SlideProbeLength + Location, Hit);
+		const FVec3 SlideVector = Cross(Body.GetRight(), Hit.ImpactNormal) * -1.0f;
+		if (SlideVector.Z <= Config.SlideMaxImpulseZ)
+		{
+			Body.AddImpulse(SlideVector * Config.SlideImpulseForce);
+		}
+
+		State.bSlidingEnabled = true;
+		RemoveIntent(EIntent::Slide);
+		RemoveIntent(EIntent::Sprint);
+		Body.OnParkourEvent(EParkourEvent::SlideStarted);
+	}
+
+	void FParkourSim::SlideEnd(bool bCrouchAfter)
+	{
+		if (Body.GetMode() != EParkourMode::Slide)
+		{
+			return;
+		}
+
+		if (bCrouchAfter)
+		{
+			Body.Crouch(true);
+			TrySprint();
+		}
+		else
+		{
+			SetCustomMode(EParkourMode::None);
+			Body.UnCrouch(false);
+		}
+		State.bSlidingEnabled = false;
+	}
+
+	void FParkourSim::SlideJump()
+	{
+		if (Body.GetMode() == EParkourMode::Slide)
+		{
+			SlideEnd(false);
+		}
+	}
+
+	void FParkourSim::CrouchSlideCheck(float AgeSeconds)
+	{
+		//off the ground a press becomes a slide for the landing
+		const bool bAirborne = !IsWalking();
+
+		if (IsClimbing())
+		{
+			WallClimbEnd(0.5f);
+		}
+		else if (IsWallRunning())
+		{
+			WallRunEnd(0.5f);
+		}
+		else if (!CanSlide())
+		{
+			if (Body.GetMode() == EParkourMode::None)
+			{
+				CrouchStart();
+			}
+			else if (Body.GetMode() == EParkourMode::Crouch)
+			{
+				CrouchEnd();
+			}
+		}
+		else if (IsWalking())
+		{
+			SlideStart();
+		}
+
+		if (bAirborne)
+		{
+			BufferIntent(EIntent::Slide, AgeSeconds);
+		}
+	}
+
+	void FParkourSim::CrouchStart()
+	{
+		if (Body.GetMode() == EParkourMode::None && IsWalking())
+		{
+			Body.Crouch(true);
+			SetCustomMode(EParkourMode::Crouch);
+			SetMaxWalkSpeed(Config.CrouchSpeed);
+			RemoveIntent(EIntent::Slide);
+			RemoveIntent(EIntent::Sprint);
+		}
+	}
+
+	void FParkourSim::CrouchEnd()
+	{
+		if (Body.GetMode() == EParkourMode::Crouch)
+		{
+			Body.UnCrouch(true);
+			SetCustomMode(EParkourMode::None);
+			RemoveIntent(EIntent::Slide);
+			RemoveIntent(EIntent::Sprint);
+		}
+	}
+
+	void FParkourSim::CrouchJump()
+	{
+		CrouchEnd();
+	}
+
+	//Sprint
+
+	void FParkourSim::SprintUpdate()
+	{
+		if (!(Body.GetMode() == EParkourMode::Sprint && ForwardInput()))
+		{
+			SprintEnd();
+		}
+	}
+
+	void FParkourSim::SprintStart(float AgeSeconds)
+	{
+		if (!TrySprint())
+		{
+			BufferIntent(EIntent::Sprint, AgeSeconds);
+		}
+	}
+
+	bool FParkourSim::TrySprint()
+	{
+		CrouchEnd();
+		SlideEnd(false);
+		if (Body.GetMode() == EParkourMode::None && IsWalking() && SetCustomMode(EParkourMode::Sprint))
+		{
+			SetMaxWalkSpeed(Config.SprintSpeed);
+			State.bSprintEnabled = true;
+			RemoveIntent(EIntent::Slide);
+			RemoveIntent(EIntent::Sprint);
+		}
+		return Body.GetMode() == EParkourMode::Sprint;
+	}
+
+	void FParkourSim::SprintEnd()
+	{
+		if (Body.GetMode() == EParkourMode::Sprint && SetCustomMode(EParkourMode::None))
+		{
+			State.bSprintEnabled = false;
+		}
+	}
+
+	void FParkourSim::SprintJump()
+	{
+		if (Body.GetMode() == EParkourMode::Sprint)
+		{
+			SprintEnd();
+			BufferIntent(EIntent::Sprint, 0.f);
+		}
+	}
+}
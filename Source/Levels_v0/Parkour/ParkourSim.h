@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "ParkourInterfaces.h"
+
+namespace LevelsParkour
+{
+	/** Side trace endpoints for a character at Location facing Forward */
+	FWallRunProbe ComputeWallRunProbe(const FParkourConfig& Config, const FVec3& Location, const FVec3& Forward, const FVec3& Right);
+
+	/** Ledge sweep from above the eyes down to just over the feet, in front of the character */
+	FMantleProbe ComputeMantleProbe(const FParkourConfig& Config, const FVec3& EyeLocation, const FVec3& Location, const FVec3& Forward, float CapsuleHalfHeight);
+
+	/** Whether a wall with this normal is upright enough to run on */
+	bool IsWallRunnableNormal(const FParkourConfig& Config, const FVec3& Normal);
+
+	/**
+	 * Whether going from the previous wall normal to this one is a turn around a corner rather than a curve in
+	 * the same wall. Without it flying off the end of a wall into a perpendicular one starts a second wall run.
+	 * A previous normal with no Z never counts, it is zero when not wall running.
+	 */
+	bool IsCornerTransition(const FVec3& PrevNormal, const FVec3& Normal);
+
+	/** Whether a slide at this speed should turn into a crouch */
+	bool ShouldEndSlide(const FParkourConfig& Config, const FVec3& Velocity);
+
+	/** Walking acceleration with the start boost applied below StartBoostSpeed */
+	FVec3 BoostWalkingAcceleration(const FParkourConfig& Config, const FVec3& Acceleration, const FVec3& Velocity);
+
+	/**
+	 * The parkour state machine: wall running, wall climbing, ledge grabs, mantling, sliding, crouching and
+	 * sprinting. Knows nothing about the engine, everything goes through IParkourBody and ISceneQuery.
+	 */
+	class FParkourSim
+	{
+	public:
+		FParkourSim(IParkourBody& InBody, const ISceneQuery& InScene) : Body(InBody), Scene(InScene) {}
+
+		FParkourConfig Config;
+		FParkourState State;
+
+		/** One parkour update, what the old 60Hz wall movement timer ran. Buffered presses are acted on first */
+		void Update();
+
+		/**
+		 * Jump pressed, AgeSeconds before now. Presses that can't act yet are buffered for their window in
+		 * FParkourConfig, the same goes for the other two.
+		 */
+		void OnJump(float AgeSeconds = 0.f);
+
+		/** Crouch pressed or released */
+		void CrouchSlideCheck(float AgeSeconds = 0.f);
+
+		/** Sprint pressed */
+		void SprintStart(float AgeSeconds = 0.f);
+
+		/** The body's base movement changed, PreviousMode is the parkour mode from before the change */
+		void OnMovementChanged(EBaseMovement PreviousMovement, EParkourMode PreviousMode);
+
+		/** The body touched down */
+		void OnLanded();
+
+		/** A cooldown set through IParkourBody::SetCooldown went off */
+		void FireCooldown(ECooldown Cooldown);
+
+		/** Changes the parkour mode and resets movement for it, false if already in it */
+		bool SetCustomMode(EParkourMode NewMode);
+
+		/** Puts movement settings back for modes that don't change them */
+		void ResetMovement();
+
+		/** Clears every flag and normal */
+		void Reset() { State = FParkourState(); }
+
+		bool IsWallRunning() const;
+		bool IsSliding() const { return Body.GetMode() == EParkourMode::Slide; }
+		bool ForwardInput() const;
+		bool MovingForward() const;
+		bool CanWallRun() const;
+		bool CanWallClimb() const;
+		bool CanSlide() const;
+		bool QuickMantle() const;
+		bool HasIntent(EIntent Intent) const;
+
+		void EnableWallRun();
+		void EnableWallClimb();
+		void EnableMantleCheck() { State.bMantleCheckEnabled = true; }
+
+	private:
+		IParkourBody& Body;
+		const ISceneQuery& Scene;
+
+		bool IsFalling() const { return Body.GetMovement() == EBaseMovement::Falling; }
+		bool IsWalking() const { return Body.GetMovement() == EBaseMovement::Walking; }
+		bool IsClimbing() const;
+		void SetGravityScale(float GravityScale);
+		void SetMaxWalkSpeed(float MaxWalkSpeed);
+
+		/** Adds a press to the ring, replacing an older one of the same intent */
+		void BufferIntent(EIntent Intent, float AgeSeconds);
+		void RemoveIntent(EIntent Intent);
+		float GetIntentWindow(EIntent Intent) const;
+		/** Drops expired presses and acts on the rest that can, jump then slide then sprint */
+		void ConsumeIntents();
+
+		/** Parkour's part of a jump, false if it had nothing to do */
+		bool ApplyJump();
+
+		void WallRunUpdate();
+		bool WallRunMovement(const FVec3& Start, const FVec3& End, float WallRunDirection);
+		void WallRunJump();
+		void WallRunEnd(float Cooldown);
+		void DisableWallRun() { State.bWallRunEnabled = false; }
+
+		void WallClimbUpdate();
+		bool WallClimbMovement(const FMantleProbe& Probe);
+		void WallClimbEnd(float Cooldown);
+		void DisableWallClimb();
+
+		bool MantleCheck() const;
+		void MantleStart();
+		void MantleMovement();
+		void DisableMantleCheck() { State.bMantleCheckEnabled = false; }
+		void LedgeGrabJump();
+
+		void SlideUpdate();
+		void SlideStart();
+		void SlideEnd(bool bCrouchAfter);
+		void SlideJump();
+
+		void CrouchStart();
+		void CrouchEnd();
+		void CrouchJump();
+
+		void SprintUpdate();
+		bool TrySprint();
+		void SprintEnd();
+		void SprintJump();
+	};
+}
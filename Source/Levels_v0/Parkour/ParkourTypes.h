@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "ParkourMath.h"
+#include <cstdint>
+
+namespace LevelsParkour
+{
+	/** Parkour sub state, same values as ECustomMovementMode */
+	enum class EParkourMode : uint8_t
+	{
+		None = 0,
+		Slide = 1,
+		LeftWallRun = 2,
+		RightWallRun = 3,
+		WallClimb = 4,
+		LedgeGrab = 5,
+		Mantle = 6,
+		Sprint = 7,
+		Crouch = 8
+	};
+
+	/** The part of the character movement mode parkour cares about */
+	enum class EBaseMovement : uint8_t
+	{
+		None,
+		Walking,
+		Falling,
+		Other
+	};
+
+	/** Parkour cooldowns, each one calls back into the sim when it fires */
+	enum class ECooldown : uint8_t
+	{
+		WallRun,
+		WallClimb,
+		MantleCheck,
+		Num
+	};
+
+	/** Presses that are kept for a while when they can't act straight away */
+	enum class EIntent : uint8_t
+	{
+		Jump,
+		Slide,
+		Sprint,
+		Num
+	};
+
+	/** Things worth a sound, shake or particle. The sim reports them, it never plays anything */
+	enum class EParkourEvent : uint8_t
+	{
+		Jumped,
+		Landed,
+		LedgeGrabbed,
+		Mantled,
+		QuickMantled,
+		SlideStarted
+	};
+
+	/** Result of a scene query */
+	struct FTraceHit
+	{
+		FVec3 ImpactPoint;
+		FVec3 Normal;
+		FVec3 ImpactNormal;
+		float Distance = 0.f;
+
+		//whether a character could stand on the surface that was hit
+		bool bWalkable = false;
+	};
+
+	/** Movement settings parkour changes while in a mode and puts back afterwards */
+	struct FMovementParams
+	{
+		float GravityScale = 1.f;
+		float GroundFriction = 8.f;
+		float BrakingDecelerationWalking = 2048.f;
+		float MaxWalkSpeed = 600.f;
+		float MaxWalkSpeedCrouched = 300.f;
+	};
+
+	/** Tuning. The first block mirrors the component's editable properties, the rest were constants in the old code */
+	struct FParkourConfig
+	{
+		float WallRunGravity = .10f;
+		float WallRunCooldown = .75f;
+		float WallRunJumpCooldown = .25f;
+		float WallRunJumpHeight = 400.f;
+		float WallRunJumpForce = 1.1f;
+		float WallRunSpeedRequirement = 0.f;
+		bool bWallRunGravity = false;
+		float WallClimbSpeed = 400.f;
+		float MantleSpeed = 10.f;
+		float QuickMantleSpeed = 20.f;
+		float MantleHeight = 40.f;
+		float LedgeGrabJumpForce = 300.f;
+		float LedgeGrabJumpHeight = 400.f;
+		float SlideImpulseForce = 600.f;
+		float SprintSpeed = 1500.f;
+		//how long a press waits for the moment it can act. A sprint is also carried through jumps and wall runs this long
+		float JumpBufferTime = .15f;
+		float SlideBufferTime = .4f;
+		float SprintBufferTime = 1.5f;
+
+		//movement settings ResetMovement goes back to
+		FMovementParams DefaultParams;
+
+		//wall run probes reach this far to the side and this far behind the character
+		float WallRunProbeLength = 75.f;
+		float WallRunProbeBack = 35.f;
+		//walls whose normal leans further than this up or down can't be run on
+		float WallRunNormalZLimit = .52f;
+		float WallRunGravityInterpSpeed = 30.f;
+
+		//mantle probe starts this far above the eyes and reaches this far forward
+		float MantleProbeRise = 50.f;
+		float MantleProbeReach = 50.f;
+		float MantleProbeRadius = 20.f;
+		float MantleProbeHalfHeight = 10.f;
+		float MantleArriveDistance = 8.f;
+		float MantleTurnSpeed = 7.f;
+		//how hard a wall climb pulls the character into the wall
+		float WallClimbPull = 600.f;
+
+		//slides stop below this speed
+		float SlideEndSpeed = 350.f;
+		float SlideProbeLength = 200.f;
+		//slopes steeper than this going up get no slide impulse
+		float SlideMaxImpulseZ = .02f;
+		float SlideBrakingDeceleration = 1400.f;
+		float CrouchSpeed = 300.f;
+
+		//walking starts with extra acceleration below this speed
+		float StartBoostSpeed = 700.f;
+		float StartBoostAcceleration = 2048.f;
+	};
+
+	/** Room for buffered presses, there is at most one per intent */
+	const int IntentCapacity = 4;
+
+	/** Everything the sim owns. Plain data so a snapshot is a copy */
+	struct FParkourState
+	{
+		FVec3 WallRunHitNormal;
+		FVec3 PrevWallRunHitNormal;
+		FVec3 WallClimbHitNormal;
+		FVec3 MantlePosition;
+		float MantleTraceDistance = 0.f;
+
+		bool bWallRunEnabled = false;
+		bool bWallClimbEnabled = false;
+		bool bMantleEnabled = false;
+		bool bMantleCheckEnabled = false;
+		bool bSprintEnabled = false;
+		bool bSlidingEnabled = false;
+
+		//buffered presses, a ring of IntentCount entries from IntentHead stamped with IParkourBody::GetTime
+		float IntentTimes[IntentCapacity] = {};
+		EIntent Intents[IntentCapacity] = {};
+		uint8_t IntentHead = 0;
+		uint8_t IntentCount = 0;
+	};
+
+	/** Side traces used to look for a wall to run on */
+	struct FWallRunProbe
+	{
+		FVec3 Start;
+		FVec3 RightEnd;
+		FVec3 LeftEnd;
+	};
+
+	/** Capsule sweep used to look for a ledge in front of the character */
+	struct FMantleProbe
+	{
+		FVec3 Eye;
+		FVec3 Feet;
+	};
+}
@@ -0,0 +1,893 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Levels_v0Character.h"
+#include "Levels_v0GameMode.h"
+#include "LevelsCharacterPool.h"
+#include "LevelsCosmeticEvents.h"
+#include "LevelsInputScript.h"
+#include "LevelsMemoryTags.h"
+#include "LevelsPlayerMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Math/RandomStream.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "MotionControllerComponent.h"
+
+//Movement, weapon and respawn scenarios, each checked against a budget as well as for what it does, so a
+//performance regression fails the run the same way a broken move does. Every test builds its own small
+//game world out of boxes, so they need no map and run headless:
+//
+//  UE4Editor-Cmd Levels_v0.uproject -nullrhi -unattended -nosound -ExecCmds="Automation RunTests Levels; Quit"
+//
+//Time budgets are for a Development build, -LevelsBudgetScale=<n> scales them for slower builds and machines.
+//Levels.Memory.Budgets checks the per tag memory budgets and needs -LLM, without it the test only notes that.
+
+static const int32 LevelsTestFlags = EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter;
+
+/** Most work a scenario may do */
+struct FLevelsTestBudget
+{
+	//traces the parkour core makes in any one frame, per character
+	int32 MaxSceneQueriesPerFrame;
+	//movement mode changes over the whole scenario, all characters
+	int32 MaxModeTransitions;
+	//game thread time of the slowest world tick
+	double MaxTickMicroseconds;
+};
+
+/** A game world with a Levels_v0 game mode and nothing in it, stepped by hand at 60Hz */
+class FLevelsTestWorld
+{
+public:
+
+	FLevelsTestWorld();
+	~FLevelsTestWorld();
+
+	bool IsValid() const { return World != nullptr && World->GetAuthGameMode<ALevels_v0GameMode>() != nullptr; }
+
+	UWorld* GetWorld() const { return World; }
+
+	/** Adds a block of collision filling Min to Max */
+	AStaticMeshActor* AddBox(const FVector& Min, const FVector& Max);
+
+	/** A floor big enough for every scenario, top at Z 0 */
+	void AddFloor() { AddBox(FVector(-5000.f, -5000.f, -100.f), FVector(5000.f, 5000.f, 0.f)); }
+
+	/** Checks a character out of the pool standing at Location facing +X, with an AI controller */
+	ALevels_v0Character* SpawnCharacter(const FVector& Location);
+
+	/** The setup every scenario shares: a floor and a landed character with clean counters. Fails Test and returns null if either is missing */
+	ALevels_v0Character* Start(FAutomationTestBase& Test, const FVector& Location);
+
+	/** Applies one frame of input to the character and ticks the world once */
+	void Step(const FLevelsInputFrame& Frame);
+
+	void Run(const FLevelsInputFrame& Frame, int32 Steps);
+
+	/** Steps until Predicate is true, returns false if it wasn't within MaxSteps */
+	template <typename PredicateType>
+	bool StepUntil(const FLevelsInputFrame& Frame, int32 MaxSteps, PredicateType Predicate)
+	{
+		for (int32 Index = 0; Index < MaxSteps; ++Index)
+		{
+			Step(Frame);
+			if (Predicate())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Clears the counters of every character and the tick timing, so the budget covers what comes after */
+	void ResetCounters();
+
+	/** Fails the test for everything over budget */
+	void CheckBudget(FAutomationTestBase& Test, const FLevelsTestBudget& Budget) const;
+
+	/** Cosmetic events of a type published so far */
+	int32 GetEventCount(ELevelsCosmeticEvent Type) const { return EventCounts[(int32)Type]; }
+
+	const TArray<FLevelsCosmeticEvent>& GetEvents() const { return Events; }
+
+	/** Game thread time of the last world tick */
+	double GetLastTickMicroseconds() const { return LastTickMicroseconds; }
+
+	static const float StepSeconds;
+
+private:
+
+	UGameInstance* GameInstance = nullptr;
+	UWorld* World = nullptr;
+	UWorld* PreviousWorld = nullptr;
+	ALevels_v0Character* Character = nullptr;
+	FLevelsInputFrame Previous;
+
+	double MaxTickMicroseconds = 0.0;
+	double LastTickMicroseconds = 0.0;
+	int32 EventCounts[(int32)ELevelsCosmeticEvent::ShotImpact + 1] = {};
+	TArray<FLevelsCosmeticEvent> Events;
+};
+
+const float FLevelsTestWorld::StepSeconds = 1.f / 60.f;
+
+FLevelsTestWorld::FLevelsTestWorld()
+{
+	GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+	GameInstance->InitializeStandalone(TEXT("LevelsAutomationTest"));
+
+	//a game world of our own in place of the placeholder the game instance starts with
+	FWorldContext* Context = GameInstance->GetWorldContext();
+	UWorld* PlaceholderWorld = Context->World();
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("LevelsAutomationTestWorld"));
+	Context->SetCurrentWorld(World);
+	PlaceholderWorld->DestroyWorld(false);
+	World->SetGameInstance(GameInstance);
+
+	PreviousWorld = GWorld;
+	GWorld = World;
+
+	FURL URL;
+	URL.AddOption(*FString::Printf(TEXT("game=%s"), *ALevels_v0GameMode::StaticClass()->GetPathName()));
+	if (!World->SetGameMode(URL))
+	{
+		return;
+	}
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	if (ULevelsCosmeticEvents* CosmeticEvents = World->GetSubsystem<ULevelsCosmeticEvents>())
+	{
+		CosmeticEvents->OnCosmeticEvent.AddLambda([this](const FLevelsCosmeticEvent& Event)
+		{
+			++EventCounts[(int32)Event.Type];
+			Events.Add(Event);
+		});
+	}
+}
+
+FLevelsTestWorld::~FLevelsTestWorld()
+{
+	World->DestroyWorld(false);
+	GameInstance->Shutdown();
+	GEngine->DestroyWorldContext(World);
+	GameInstance->RemoveFromRoot();
+	GWorld = PreviousWorld;
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+AStaticMeshActor* FLevelsTestWorld::AddBox(const FVector& Min, const FVector& Max)
+{
+	//the engine cube is 100 units across around its middle
+	UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+
+	AStaticMeshActor* Box = World->SpawnActor<AStaticMeshActor>((Min + Max) * 0.5f, FRotator::ZeroRotator);
+	Box->SetMobility(EComponentMobility::Movable);
+	Box->GetStaticMeshComponent()->SetStaticMesh(Cube);
+	Box->SetActorScale3D((Max - Min) / 100.f);
+	return Box;
+}
+
+ALevels_v0Character* FLevelsTestWorld::SpawnCharacter(const FVector& Location)
+{
+	UClass* PawnClass = World->GetAuthGameMode<ALevels_v0GameMode>()->DefaultPawnClass;
+	ULevelsCharacterPool* Pool = World->GetSubsystem<ULevelsCharacterPool>();
+	if (Pool == nullptr)
+	{
+		return nullptr;
+	}
+
+	Character = Pool->Acquire(PawnClass, FTransform(Location));
+	if (Character)
+	{
+		Character->SpawnDefaultController();
+		Previous = FLevelsInputFrame();
+
+		//land before the scenario starts
+		Run(FLevelsInputFrame(), 30);
+	}
+	return Character;
+}
+
+ALevels_v0Character* FLevelsTestWorld::Start(FAutomationTestBase& Test, const FVector& Location)
+{
+	if (!IsValid())
+	{
+		Test.AddError(TEXT("Could not start a world with the Levels_v0 game mode"));
+		return nullptr;
+	}
+	AddFloor();
+
+	ALevels_v0Character* Spawned = SpawnCharacter(Location);
+	if (Spawned == nullptr)
+	{
+		Test.AddError(TEXT("Could not spawn a Levels_v0 character"));
+		return nullptr;
+	}
+	ResetCounters();
+	return Spawned;
+}
+
+void FLevelsTestWorld::Step(const FLevelsInputFrame& Frame)
+{
+	if (Character && !Character->IsPoolDormant())
+	{
+		Character->ApplyInputFrame(Frame, Previous);
+	}
+	Previous = Frame;
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	//drains the cosmetic event queue too, it is a tickable bound to this world
+	World->Tick(LEVELTICK_All, StepSeconds);
+	LastTickMicroseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0;
+	MaxTickMicroseconds = FMath::Max(MaxTickMicroseconds, LastTickMicroseconds);
+
+	//timers only run once per frame number
+	++GFrameCounter;
+}
+
+void FLevelsTestWorld::Run(const FLevelsInputFrame& Frame, int32 Steps)
+{
+	for (int32 Index = 0; Index < Steps; ++Index)
+	{
+		Step(Frame);
+	}
+}
+
+void FLevelsTestWorld::ResetCounters()
+{
+	for (TActorIterator<ALevels_v0Character> It(World); It; ++It)
+	{
+		if (It->CharacterMovement)
+		{
+			It->CharacterMovement->ResetMovementCounters();
+		}
+	}
+	MaxTickMicroseconds = 0.0;
+}
+
+void FLevelsTestWorld::CheckBudget(FAutomationTestBase& Test, const FLevelsTestBudget& Budget) const
+{
+	float TimeScale = 1.f;
+	FParse::Value(FCommandLine::Get(), TEXT("LevelsBudgetScale="), TimeScale);
+
+	int32 MaxSceneQueries = 0;
+	int32 ModeTransitions = 0;
+	for (TActorIterator<ALevels_v0Character> It(World); It; ++It)
+	{
+		if (It->CharacterMovement == nullptr)
+		{
+			continue;
+		}
+		const FLevelsMovementCounters& Counters = It->CharacterMovement->GetMovementCounters();
+		MaxSceneQueries = FMath::Max(MaxSceneQueries, Counters.MaxSceneQueriesPerFrame);
+		ModeTransitions += Counters.ModeTransitions;
+	}
+
+	if (MaxSceneQueries > Budget.MaxSceneQueriesPerFrame)
+	{
+		Test.AddError(FString::Printf(TEXT("Over budget: %d scene queries in one frame, budget is %d"), MaxSceneQueries, Budget.MaxSceneQueriesPerFrame));
+	}
+	if (ModeTransitions > Budget.MaxModeTransitions)
+	{
+		Test.AddError(FString::Printf(TEXT("Over budget: %d mode transitions, budget is %d"), ModeTransitions, Budget.MaxModeTransitions));
+	}
+	if (MaxTickMicroseconds > Budget.MaxTickMicroseconds * TimeScale)
+	{
+		Test.AddError(FString::Printf(TEXT("Over budget: %.0fus world tick, budget is %.0fus"), MaxTickMicroseconds, Budget.MaxTickMicroseconds * TimeScale));
+	}
+	Test.AddInfo(FString::Printf(TEXT("%d scene queries per frame, %d mode transitions, %.0fus slowest tick"), MaxSceneQueries, ModeTransitions, MaxTickMicroseconds));
+}
+
+static FLevelsInputFrame Forward(uint8 Buttons = 0)
+{
+	FLevelsInputFrame Frame;
+	Frame.Forward = 1.f;
+	Frame.Buttons = Buttons;
+	return Frame;
+}
+
+static bool IsInMode(const ALevels_v0Character* Character, ECustomMovementMode Mode)
+{
+	const ULevelsPlayerMovementComponent* Movement = Character->CharacterMovement;
+	//parkour modes ride on walking or falling, the project never uses MOVE_Custom
+	return Movement->CustomMovementMode == Mode;
+}
+
+static bool IsWallRunning(const ALevels_v0Character* Character)
+{
+	return IsInMode(Character, MOVE_LeftWallRun) || IsInMode(Character, MOVE_RightWallRun);
+}
+
+/** Builds the world and a character for a test, or fails it */
+#define LEVELS_TEST_WORLD(TestWorld, Character, Location) \
+	FLevelsTestWorld TestWorld; \
+	ALevels_v0Character* Character = TestWorld.Start(*this, Location); \
+	if (Character == nullptr) \
+	{ \
+		return false; \
+	}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLevelsSprintSlideCrouchTest, "Levels.Movement.SprintSlideCrouch", LevelsTestFlags)
+
+bool FLevelsSprintSlideCrouchTest::RunTest(const FString& Parameters)
+{
+	LEVELS_TEST_WORLD(TestWorld, Character, FVector(-4000.f, 0.f, 120.f));
+
+	TestTrue(TEXT("Sprint starts"), TestWorld.StepUntil(Forward(ELevelsInputButton::Sprint), 10, [Character]() { return IsInMode(Character, MOVE_Sprint); }));
+	TestWorld.Run(Forward(ELevelsInputButton::Sprint), 90);
+	TestTrue(TEXT("Sprinting picks up speed"), Character->GetVelocity().Size2D() > 1000.f);
+
+	//crouch is pressed for one frame, the slide carries on by itself
+	TestWorld.Step(Forward(ELevelsInputButton::Sprint | ELevelsInputButton::Crouch));
+	TestTrue(TEXT("Crouching while sprinting slides"), IsInMode(Character, MOVE_Slide));
+	TestTrue(TEXT("Sliding crouches"), Character->bIsCrouched);
+	TestEqual(TEXT("One slide started"), TestWorld.GetEventCount(ELevelsCosmeticEvent::SlideStarted), 1);
+
+	TestTrue(TEXT("The slide bleeds off speed and ends"), TestWorld.StepUntil(Forward(ELevelsInputButton::Sprint), 600, [Character]() { return !IsInMode(Character, MOVE_Slide); }));
+	TestTrue(TEXT("A slide hands back to a sprint"), IsInMode(Character, MOVE_Sprint));
+
+	//stop, then crouch on the spot
+	TestWorld.Run(FLevelsInputFrame(), 120);
+	FLevelsInputFrame Crouch;
+	Crouch.Buttons = ELevelsInputButton::Crouch;
+	TestWorld.Step(Crouch);
+	TestTrue(TEXT("Crouching without speed crouches"), IsInMode(Character, MOVE_Crouch) && Character->bIsCrouched);
+	TestWorld.Step(FLevelsInputFrame());
+	TestFalse(TEXT("Letting go of crouch stands up"), IsInMode(Character, MOVE_Crouch));
+
+	TestWorld.CheckBudget(*this, { 8, 12, 2000.0 });
+	return true;
+}
+
+/** Runs along a wall on one side and off its end */
+static void RunWallRunScenario(FAutomationTestBase& Test, bool bRightSide)
+{
+	const float Side = bRightSide ? 1.f : -1.f;
+	const ECustomMovementMode ExpectedMode = bRightSide ? MOVE_RightWallRun : MOVE_LeftWallRun;
+
+	FLevelsTestWorld TestWorld;
+	ALevels_v0Character* Character = TestWorld.Start(Test, FVector(0.f, 30.f * Side, 120.f));
+	if (Character == nullptr)
+	{
+		return;
+	}
+	TestWorld.AddBox(FVector(200.f, bRightSide ? 100.f : -150.f, 0.f), FVector(3000.f, bRightSide ? 150.f : -100.f, 600.f));
+
+	TestWorld.Run(Forward(), 30);
+	TestWorld.Step(Forward(ELevelsInputButton::Jump));
+
+	Test.TestTrue(TEXT("Jumping along a wall starts a wall run on that side"), TestWorld.StepUntil(Forward(), 60, [Character, ExpectedMode]() { return IsInMode(Character, ExpectedMode); }));
+	Test.TestTrue(TEXT("Wall running keeps the character off the floor"), Character->CharacterMovement->IsFalling());
+
+	TestWorld.StepUntil(Forward(), 600, [Character]() { return Character->GetActorLocation().X > 3100.f; });
+	Test.TestFalse(TEXT("The run ends with the wall"), IsWallRunning(Character));
+
+	TestWorld.CheckBudget(Test, { 8, 8, 2000.0 });
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLevelsWallRunRightTest, "Levels.Movement.WallRunRight", LevelsTestFlags)
+
+bool FLevelsWallRunRightTest::RunTest(const FString& Parameters)
+{
+	RunWallRunScenario(*this, true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLevelsWallRunLeftTest, "Levels.Movement.WallRunLeft", LevelsTestFlags)
+
+bool FLevelsWallRunLeftTest::RunTest(const FString& Parameters)
+{
+	RunWallRunScenario(*this, false);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLevelsWallRunCornerTest, "Levels.Movement.WallRunCorner", LevelsTestFlags)
+
+bool FLevelsWallRunCornerTest::RunTest(const FString& Parameters)
+{
+	LEVELS_TEST_WORLD(TestWorld, Character, FVector(0.f, 30.f, 120.f));
+
+	//a wall on the right that runs into one across the path
+	TestWorld.AddBox(FVector(200.f, 100.f, 0.f), FVector(1500.f, 150.f, 600.f));
+	TestWorld.AddBox(FVector(1500.f, -600.f, 0.f), FVector(1550.f, 150.f, 600.f));
+
+	TestWorld.Run(Forward(), 30);
+	TestWorld.Step(Forward(ELevelsInputButton::Jump));
+	TestTrue(TEXT("The wall run starts"), TestWorld.StepUntil(Forward(), 60, [Character]() { return IsInMode(Character, MOVE_RightWallRun); }));
+
+	//the run must never carry on around the corner onto the wall ahead
+	bool bTurnedTheCorner = false;
+	for (int32 Index = 0; Index < 180; ++Index)
+	{
+		TestWorld.Step(Forward());
+		const LevelsParkour::FVec3& Normal = Character->CharacterMovement->GetParkourSim().State.WallRunHitNormal;
+		bTurnedTheCorner |= IsWallRunning(Character) && FMath::Abs(Normal.X) > 0.5f;
+	}
+	TestFalse(TEXT("Wall runs don't turn right angled corners"), bTurnedTheCorner);
+	TestFalse(TEXT("The wall run ends at the corner"), IsWallRunning(Character));
+
+	TestWorld.CheckBudget(*this, { 8, 10, 2000.0 });
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLevelsWallJumpTest, "Levels.Movement.WallJump", LevelsTestFlags)
+
+bool FLevelsWallJumpTest::RunTest(const FString& Parameters)
+{
+	LEVELS_TEST_WORLD(TestWorld, Character, FVector(0.f, 30.f, 120.f));
+	TestWorld.AddBox(FVector(200.f, 100.f, 0.f), FVector(3000.f, 150.f, 600.f));
+
+	TestWorld.Run(Forward(), 30);
+	TestWorld.Step(Forward(ELevelsInputButton::Jump));
+	if (!TestWorld.StepUntil(Forward(), 60, [Character]() { return IsInMode(Character, MOVE_RightWallRun); }))
+	{
+		AddError(TEXT("The wall run didn't start"));
+		return false;
+	}
+	TestWorld.Run(Forward(), 10);
+
+	TestWorld.Step(Forward(ELevelsInputButton::Jump));
+	TestWorld.Step(Forward());
+	TestFalse(TEXT("Jumping ends the wall run"), IsWallRunning(Character));
+	TestTrue(TEXT("Wall jumps push away from the wall"), Character->GetVelocity().Y < -100.f);
+	TestTrue(TEXT("Wall jumps go up"), Character->GetVelocity().Z > 0.f);
+
+	TestWorld.CheckBudget(*this, { 8, 10, 2000.0 });
+	return true;
+}
+
+/** Runs at a block of the given height, jumps and holds forward until the character is standing on it */
+static void RunMantleScenario(FAutomationTestBase& Test, float Height, bool bExpectClimb)
+{
+	FLevelsTestWorld TestWorld;
+	ALevels_v0Character* Character = TestWorld.Start(Test, FVector(0.f, 0.f, 120.f));
+	if (Character == nullptr)
+	{
+		return;
+	}
+	TestWorld.AddBox(FVector(200.f, -500.f, 0.f), FVector(600.f, 500.f, Height));
+
+	TestWorld.Run(Forward(), 20);
+	TestWorld.Step(Forward(ELevelsInputButton::Jump));
+
+	bool bClimbed = false;
+	for (int32 Index = 0; Index < 300; ++Index)
+	{
+		TestWorld.Step(Forward());
+		bClimbed |= IsInMode(Character, MOVE_WallClimb);
+
+		const int32 Mantles = TestWorld.GetEventCount(ELevelsCosmeticEvent::Mantled) + TestWorld.GetEventCount(ELevelsCosmeticEvent::QuickMantled);
+		if (Mantles > 0 && Character->CharacterMovement->IsMovingOnGround())
+		{
+			break;
+		}
+	}
+
+	if (bExpectClimb)
+	{
+		Test.TestTrue(TEXT("A wall above the jump is climbed"), bClimbed);
+	}
+	Test.TestTrue(TEXT("The ledge is grabbed"), TestWorld.GetEventCount(ELevelsCosmeticEvent::LedgeGrabbed) >= 1);
+	Test.TestTrue(TEXT("The ledge is mantled"), TestWorld.GetEventCount(ELevelsCosmeticEvent::Mantled) + TestWorld.GetEventCount(ELevelsCosmeticEvent::QuickMantled) >= 1);
+	Test.TestTrue(TEXT("Standing on top"), Character->CharacterMovement->IsMovingOnGround()
+		&& FMath::IsNearlyEqual(Character->GetActorLocation().Z, Height + Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight(), 5.f));
+
+	TestWorld.CheckBudget(Test, { 10, 10, 2000.0 });
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLevelsClimbMantleTest, "Levels.Movement.ClimbLedgeGrabMantle", LevelsTestFlags)
+
+bool FLevelsClimbMantleTest::RunTest(const FString& Parameters)
+{
+	RunMantleScenario(*this, 260.f, true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLevelsQuickMantleTest, "Levels.Movement.LedgeGrabQuickMantle", LevelsTestFlags)
+
+bool FLevelsQuickMantleTest::RunTest(const FString& Parameters)
+{
+	RunMantleScenario(*this, 150.f, false);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLevelsFireTest, "Levels.Weapon.Fire", LevelsTestFlags)
+
+bool FLevelsFireTest::RunTest(const FString& Parameters)
+{
+	LEVELS_TEST_WORLD(TestWorld, Character, FVector(0.f, 0.f, 120.f));
+	TestWorld.AddBox(FVector(1000.f, -1000.f, 0.f), FVector(1100.f, 1000.f, 1000.f));
+
+	FLevelsInputFrame Fire;
+	Fire.Buttons = ELevelsInputButton::Fire;
+	TestWorld.Run(Fire, 60);
+
+	const int32 Shots = TestWorld.GetEventCount(ELevelsCosmeticEvent::ShotFired);
+	const int32 ExpectedShots = Character->TimeBetweenShots > 0.f ? 1 + FMath::FloorToInt(1.f / Character->TimeBetweenShots) : 1;
+	TestTrue(TEXT("Holding fire fires"), Shots >= 1);
+	TestTrue(TEXT("Holding fire refires at the weapon's rate"), FMath::Abs(Shots - ExpectedShots) <= 1);
+
+	bool bHitTheWall = TestWorld.GetEventCount(ELevelsCosmeticEvent::ShotImpact) > 0;
+	for (const FLevelsCosmeticEvent& Event : TestWorld.GetEvents())
+	{
+		if (Event.Type == ELevelsCosmeticEvent::ShotImpact)
+		{
+			bHitTheWall &= FMath::IsNearlyEqual(Event.Location.X, 1000.f, 1.f);
+		}
+	}
+	TestTrue(TEXT("Shots hit the wall in front"), bHitTheWall);
+
+	TestWorld.Run(FLevelsInputFrame(), 60);
+	TestEqual(TEXT("Letting go stops firing"), TestWorld.GetEventCount(ELevelsCosmeticEvent::ShotFired), Shots);
+
+	TestWorld.CheckBudget(*this, { 8, 2, 2000.0 });
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLevelsDeathResetTest, "Levels.GameMode.DeathAndRespawn", LevelsTestFlags)
+
+bool FLevelsDeathResetTest::RunTest(const FString& Parameters)
+{
+	LEVELS_TEST_WORLD(TestWorld, Character, FVector(0.f, 0.f, 120.f));
+
+	ALevels_v0GameMode* GameMode = TestWorld.GetWorld()->GetAuthGameMode<ALevels_v0GameMode>();
+	AController* Controller = Character->GetController();
+	GameMode->MyCharacter = Character;
+
+	Character->UpdateHealth(-Character->FullHealth);
+	TestWorld.Run(FLevelsInputFrame(), 5);
+
+	ALevels_v0Character* Respawned = Cast<ALevels_v0Character>(Controller->GetPawn());
+	TestTrue(TEXT("The dead character goes back to the pool"), Character->IsPoolDormant());
+	TestTrue(TEXT("The controller gets a fresh character"), Respawned != nullptr && Respawned != Character);
+	if (Respawned)
+	{
+		TestEqual(TEXT("The fresh character has full health"), Respawned->GetHealth(), Respawned->FullHealth);
+		TestTrue(TEXT("The game mode follows the fresh character"), GameMode->MyCharacter == Respawned);
+	}
+	TestTrue(TEXT("Play carries on"), GameMode->GetCurrentState() == EGamePlayState::EPlaying);
+
+	TestWorld.CheckBudget(*this, { 8, 4, 4000.0 });
+	return true;
+}
+
+//Input fuzzing. Seeded random input on a small course, checked every frame against limits no input should
+//be able to push the movement past. It lives outside Levels. so a normal run stays a pass/fail gate:
+//
+//  UE4Editor-Cmd ... -ExecCmds="Automation RunTests LevelsFuzz; Quit" [-LevelsFuzzSeeds=64] [-LevelsFuzzFirstSeed=0] [-LevelsFuzzSeconds=20]
+//
+//A seed that breaks a limit saves its input up to that frame to Saved/Fuzz/Seed<n>.csv. -LevelsFuzzRepro=<file>
+//runs only that file through the same course, and the file also replays in game with -LevelsInputTrace.
+
+/** What no input may make the movement of one character do */
+struct FLevelsFuzzInvariants
+{
+	//the two polling timers plus at most three cooldowns at once
+	int32 MaxLiveTimers = 5;
+	//the longest cooldown is under a second, one that stays armed longer keeps looping
+	float MaxCooldownLiveSeconds = 3.f;
+	//movement and parkour mode changes together. The busiest honest frame is a landing that resumes a buffered
+	//sprint and turns it straight into a buffered slide, anything past that is modes flipping back and forth
+	int32 MaxModeTransitionsPerFrame = 3;
+	int32 MaxCooldownsSetPerFrame = 4;
+	int32 MaxSceneQueriesPerFrame = 12;
+	double MaxTickMicroseconds = 4000.0;
+};
+
+/**
+ * Random input a person could produce: the sticks move towards a target instead of jumping there, the view
+ * turns at most two turns a second and buttons are held for a while, except the one being mashed.
+ */
+class FLevelsInputFuzzer
+{
+public:
+
+	explicit FLevelsInputFuzzer(int32 Seed) : Random(Seed) {}
+
+	FLevelsInputFrame Next(float DeltaSeconds)
+	{
+		Clock += DeltaSeconds;
+
+		if (Clock >= PhaseEndTime)
+		{
+			TargetForward = Random.FRand() < 0.75f ? Random.FRandRange(0.3f, 1.f) : Random.FRandRange(-1.f, 0.3f);
+			TargetRight = Random.FRand() < 0.4f ? Random.FRandRange(-1.f, 1.f) : 0.f;
+			TurnRate = Random.FRand() < 0.15f ? Random.FRandRange(-720.f, 720.f) : Random.FRandRange(-120.f, 120.f);
+
+			HeldButtons = 0;
+			HeldButtons |= Random.FRand() < 0.5f ? ELevelsInputButton::Sprint : 0;
+			HeldButtons |= Random.FRand() < 0.3f ? ELevelsInputButton::Fire : 0;
+			HeldButtons |= Random.FRand() < 0.15f ? ELevelsInputButton::Crouch : 0;
+			HeldButtons |= Random.FRand() < 0.1f ? ELevelsInputButton::Jump : 0;
+
+			//mashing crouch, jump or both at 5 to 15 presses a second
+			MashedButtons = 0;
+			const float Mash = Random.FRand();
+			if (Mash < 0.15f)
+			{
+				MashedButtons = ELevelsInputButton::Crouch;
+			}
+			else if (Mash < 0.25f)
+			{
+				MashedButtons = ELevelsInputButton::Jump;
+			}
+			else if (Mash < 0.35f)
+			{
+				MashedButtons = ELevelsInputButton::Crouch | ELevelsInputButton::Jump;
+			}
+			MashInterval = 1.f / Random.FRandRange(10.f, 30.f);
+			HeldButtons &= ~MashedButtons;
+
+			PhaseEndTime = Clock + Random.FRandRange(0.2f, 2.f);
+		}
+
+		Current.Time = Clock;
+		Current.Forward = FMath::FInterpConstantTo(Current.Forward, TargetForward, DeltaSeconds, 8.f);
+		Current.Right = FMath::FInterpConstantTo(Current.Right, TargetRight, DeltaSeconds, 8.f);
+		Current.Yaw = TurnRate * DeltaSeconds;
+
+		uint8 Mashed = 0;
+		if (MashedButtons != 0)
+		{
+			MashClock += DeltaSeconds;
+			if (MashClock >= MashInterval)
+			{
+				MashClock = 0.f;
+				bMashDown = !bMashDown;
+			}
+			Mashed = bMashDown ? MashedButtons : 0;
+		}
+		Current.Buttons = HeldButtons | Mashed;
+		return Current;
+	}
+
+private:
+
+	FRandomStream Random;
+	float Clock = 0.f;
+	float PhaseEndTime = 0.f;
+	float TargetForward = 0.f;
+	float TargetRight = 0.f;
+	float TurnRate = 0.f;
+	uint8 HeldButtons = 0;
+	uint8 MashedButtons = 0;
+	float MashInterval = 0.1f;
+	float MashClock = 0.f;
+	bool bMashDown = false;
+	FLevelsInputFrame Current;
+};
+
+/** Walls to run along, a corner, ledges at both mantle heights and a fence so nobody runs off the floor */
+static void AddFuzzCourse(FLevelsTestWorld& TestWorld)
+{
+	TestWorld.AddBox(FVector(300.f, 200.f, 0.f), FVector(2500.f, 250.f, 600.f));
+	TestWorld.AddBox(FVector(300.f, -650.f, 0.f), FVector(2500.f, -600.f, 600.f));
+	TestWorld.AddBox(FVector(2500.f, -650.f, 0.f), FVector(2550.f, 800.f, 600.f));
+	TestWorld.AddBox(FVector(-1500.f, 600.f, 0.f), FVector(-1000.f, 1200.f, 150.f));
+	TestWorld.AddBox(FVector(-1500.f, -1200.f, 0.f), FVector(-1000.f, -600.f, 260.f));
+
+	const float Fence = 4000.f;
+	TestWorld.AddBox(FVector(-Fence, -Fence - 100.f, 0.f), FVector(Fence, -Fence, 1000.f));
+	TestWorld.AddBox(FVector(-Fence, Fence, 0.f), FVector(Fence, Fence + 100.f, 1000.f));
+	TestWorld.AddBox(FVector(-Fence - 100.f, -Fence, 0.f), FVector(-Fence, Fence, 1000.f));
+	TestWorld.AddBox(FVector(Fence, -Fence, 0.f), FVector(Fence + 100.f, Fence, 1000.f));
+}
+
+/** The first invariant the character breaks, empty if none */
+static FString CheckFuzzInvariants(const FLevelsFuzzInvariants& Invariants, const FLevelsTestWorld& TestWorld, const ALevels_v0Character* Character, float* CooldownLiveSeconds)
+{
+	const ULevelsPlayerMovementComponent* Movement = Character->CharacterMovement;
+	const FLevelsMovementCounters& Counters = Movement->GetMovementCounters();
+
+	if (Movement->GetNumLiveTimers() > Invariants.MaxLiveTimers)
+	{
+		return FString::Printf(TEXT("%d timers live, limit is %d"), Movement->GetNumLiveTimers(), Invariants.MaxLiveTimers);
+	}
+	for (int32 Index = 0; Index < (int32)ELevelsParkourCooldown::Num; ++Index)
+	{
+		CooldownLiveSeconds[Index] = Movement->IsParkourCooldownActive((ELevelsParkourCooldown)Index) ? CooldownLiveSeconds[Index] + FLevelsTestWorld::StepSeconds : 0.f;
+		if (CooldownLiveSeconds[Index] > Invariants.MaxCooldownLiveSeconds)
+		{
+			return FString::Printf(TEXT("cooldown %d has been armed for %.1fs, limit is %.1fs"), Index, CooldownLiveSeconds[Index], Invariants.MaxCooldownLiveSeconds);
+		}
+	}
+	if (Counters.MaxModeTransitionsPerFrame > Invariants.MaxModeTransitionsPerFrame)
+	{
+		return FString::Printf(TEXT("%d mode transitions in one frame, limit is %d, ended in %s %s"), Counters.MaxModeTransitionsPerFrame, Invariants.MaxModeTransitionsPerFrame,
+			*StaticEnum<EMovementMode>()->GetNameStringByValue(Movement->MovementMode), *StaticEnum<ECustomMovementMode>()->GetNameStringByValue(Movement->CustomMovementMode));
+	}
+	if (Counters.MaxCooldownsSetPerFrame > Invariants.MaxCooldownsSetPerFrame)
+	{
+		return FString::Printf(TEXT("%d cooldowns set in one frame, limit is %d"), Counters.MaxCooldownsSetPerFrame, Invariants.MaxCooldownsSetPerFrame);
+	}
+	if (Counters.MaxSceneQueriesPerFrame > Invariants.MaxSceneQueriesPerFrame)
+	{
+		return FString::Printf(TEXT("%d scene queries in one frame, limit is %d"), Counters.MaxSceneQueriesPerFrame, Invariants.MaxSceneQueriesPerFrame);
+	}
+	if (TestWorld.GetLastTickMicroseconds() > Invariants.MaxTickMicroseconds)
+	{
+		return FString::Printf(TEXT("%.0fus world tick, limit is %.0fus"), TestWorld.GetLastTickMicroseconds(), Invariants.MaxTickMicroseconds);
+	}
+	return FString();
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FLevelsInputFuzzTest, "LevelsFuzz.Input", LevelsTestFlags)
+
+void FLevelsInputFuzzTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	FString Repro;
+	if (FParse::Value(FCommandLine::Get(), TEXT("LevelsFuzzRepro="), Repro))
+	{
+		OutBeautifiedNames.Add(FPaths::GetBaseFilename(Repro));
+		OutTestCommands.Add(Repro);
+		return;
+	}
+
+	int32 NumSeeds = 16;
+	int32 FirstSeed = 0;
+	FParse::Value(FCommandLine::Get(), TEXT("LevelsFuzzSeeds="), NumSeeds);
+	FParse::Value(FCommandLine::Get(), TEXT("LevelsFuzzFirstSeed="), FirstSeed);
+	for (int32 Seed = FirstSeed; Seed < FirstSeed + NumSeeds; ++Seed)
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("Seed%d"), Seed));
+		OutTestCommands.Add(FString::FromInt(Seed));
+	}
+}
+
+bool FLevelsInputFuzzTest::RunTest(const FString& Parameters)
+{
+	LEVELS_TEST_WORLD(TestWorld, Character, FVector(0.f, 0.f, 120.f));
+	AddFuzzCourse(TestWorld);
+
+	//a seed makes its input here, anything else is a saved repro
+	TArray<FLevelsInputFrame> Frames;
+	const bool bRepro = !Parameters.IsNumeric();
+	if (bRepro)
+	{
+		if (!FLevelsInputFrame::LoadTrace(Parameters, Frames))
+		{
+			AddError(FString::Printf(TEXT("Could not load %s"), *Parameters));
+			return false;
+		}
+	}
+	else
+	{
+		float Seconds = 20.f;
+		FParse::Value(FCommandLine::Get(), TEXT("LevelsFuzzSeconds="), Seconds);
+		FLevelsInputFuzzer Fuzzer(FCString::Atoi(*Parameters));
+		const int32 NumFrames = FMath::CeilToInt(Seconds / FLevelsTestWorld::StepSeconds);
+		for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+		{
+			Frames.Add(Fuzzer.Next(FLevelsTestWorld::StepSeconds));
+		}
+	}
+
+	float TimeScale = 1.f;
+	FParse::Value(FCommandLine::Get(), TEXT("LevelsBudgetScale="), TimeScale);
+	FLevelsFuzzInvariants Invariants;
+	Invariants.MaxTickMicroseconds *= TimeScale;
+
+	float CooldownLiveSeconds[(int32)ELevelsParkourCooldown::Num] = {};
+	FString Violation;
+	//frames stepped, the last one is where a limit broke
+	int32 NumStepped = 0;
+	while (NumStepped < Frames.Num() && Violation.IsEmpty())
+	{
+		TestWorld.Step(Frames[NumStepped++]);
+		Violation = Character->IsPoolDormant() ? FString(TEXT("the character died")) : CheckFuzzInvariants(Invariants, TestWorld, Character, CooldownLiveSeconds);
+	}
+
+	const FLevelsMovementCounters& Counters = Character->CharacterMovement->GetMovementCounters();
+	AddInfo(FString::Printf(TEXT("%d frames, %d mode transitions, %d cooldowns set, %d scene queries"), NumStepped, Counters.ModeTransitions, Counters.CooldownsSet, Counters.SceneQueries));
+
+	if (!Violation.IsEmpty())
+	{
+		FString Message = FString::Printf(TEXT("Frame %d (%.2fs): %s"), NumStepped, NumStepped * FLevelsTestWorld::StepSeconds, *Violation);
+		if (!bRepro)
+		{
+			Frames.SetNum(NumStepped);
+			const FString ReproFile = FPaths::ProjectSavedDir() / TEXT("Fuzz") / FString::Printf(TEXT("Seed%s.csv"), *Parameters);
+			if (FLevelsInputFrame::SaveTrace(ReproFile, Frames))
+			{
+				Message += FString::Printf(TEXT(", repro saved to %s"), *FPaths::ConvertRelativePathToFull(ReproFile));
+			}
+		}
+		AddError(Message);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLevelsMemoryBudgetTest, "Levels.Memory.Budgets", LevelsTestFlags)
+
+bool FLevelsMemoryBudgetTest::RunTest(const FString& Parameters)
+{
+	LEVELS_TEST_WORLD(TestWorld, Character, FVector(0.f, 0.f, 120.f));
+	AddFuzzCourse(TestWorld);
+
+	if (!FLevelsMemoryTags::IsTracking())
+	{
+		AddInfo(TEXT("LLM isn't running, run with -LLM to check the memory budgets"));
+		return true;
+	}
+
+	//parkour and firing for a while, the peaks cover only this scenario
+	FLevelsMemoryTags::ResetPeaks();
+	FLevelsInputFuzzer Fuzzer(0);
+	for (int32 FrameIndex = 0; FrameIndex < 600; ++FrameIndex)
+	{
+		TestWorld.Step(Fuzzer.Next(FLevelsTestWorld::StepSeconds));
+		FLevelsMemoryTags::SamplePeaks();
+	}
+
+	for (const FLevelsMemoryTagReport& Line : FLevelsMemoryTags::GetReport())
+	{
+		AddInfo(FString::Printf(TEXT("%s: peak %.1fKB, budget %s, %d objects"), *Line.Name, Line.PeakBytes / 1024.0,
+			Line.BudgetBytes > 0 ? *FString::Printf(TEXT("%.0fKB"), Line.BudgetBytes / 1024.0) : TEXT("none"), Line.Objects));
+		if (Line.IsOverBudget())
+		{
+			AddError(FString::Printf(TEXT("%s peaked at %.1fKB, over its %.0fKB budget"), *Line.Name, Line.PeakBytes / 1024.0, Line.BudgetBytes / 1024.0));
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLevelsCharacterCompositionTest, "Levels.Character.Composition", LevelsTestFlags)
+
+bool FLevelsCharacterCompositionTest::RunTest(const FString& Parameters)
+{
+	LEVELS_TEST_WORLD(TestWorld, Character, FVector(0.f, 0.f, 120.f));
+
+	//both configurations spawned fresh from the pool's class, so components its blueprint adds are on both sides
+	UClass* CharacterClass = Character->GetClass();
+	auto SpawnConfigured = [&TestWorld, CharacterClass](const FVector& Location, bool bVR)
+	{
+		const FTransform Transform(Location);
+		ALevels_v0Character* Spawned = TestWorld.GetWorld()->SpawnActorDeferred<ALevels_v0Character>(CharacterClass, Transform);
+		if (Spawned)
+		{
+			Spawned->bUsingMotionControllers = bVR;
+			Spawned->FinishSpawning(Transform);
+		}
+		return Spawned;
+	};
+
+	ALevels_v0Character* DesktopCharacter = SpawnConfigured(FVector(-500.f, 0.f, 120.f), false);
+	ALevels_v0Character* VRCharacter = SpawnConfigured(FVector(500.f, 0.f, 120.f), true);
+	if (DesktopCharacter == nullptr || VRCharacter == nullptr)
+	{
+		AddError(TEXT("Could not spawn the desktop and VR characters"));
+		return false;
+	}
+
+	//the VR parts must never have been made for a desktop character
+	TArray<UMotionControllerComponent*> MotionControllers;
+	DesktopCharacter->GetComponents(MotionControllers);
+	TestEqual(TEXT("Desktop motion controllers"), MotionControllers.Num(), 0);
+	const int32 DesktopComponents = DesktopCharacter->GetComponents().Num();
+
+	if (VRCharacter->GetComponentConfig() != ELevelsCharacterConfig::VR)
+	{
+		AddInfo(TEXT("Running as a server or bot, there is no VR configuration to compare against"));
+		return true;
+	}
+	VRCharacter->GetComponents(MotionControllers);
+	TestEqual(TEXT("VR motion controllers"), MotionControllers.Num(), 2);
+	TestEqual(TEXT("Components the VR configuration adds"), VRCharacter->GetComponents().Num() - DesktopComponents, ALevels_v0Character::VRComponentCount);
+	return true;
+}
+
+#endif
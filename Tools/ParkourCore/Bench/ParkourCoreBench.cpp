@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ParkourSim.h"
+#include "BoxScene.h"
+#include "HeadlessCharacter.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace LevelsParkour;
+
+//Microbenchmarks for the parkour core. Each one prints nanoseconds per call, run a release build by hand for
+//numbers worth comparing: ParkourCoreBench [--iterations N]
+
+//keeps the optimizer from throwing away results nobody reads
+static volatile float Sink = 0.f;
+
+typedef std::chrono::steady_clock FClock;
+
+static void Report(const char* Name, FClock::time_point Start, int Iterations)
+{
+	const double Nanoseconds = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(FClock::now() - Start).count();
+	std::printf("%-28s %10.1f ns/op  (%d iterations)\n", Name, Nanoseconds / Iterations, Iterations);
+}
+
+static FBoxScene MakeCourse()
+{
+	FBoxScene Scene;
+	Scene.AddBox(FBox(FVec3(-50000.f, -5000.f, -100.f), FVec3(50000.f, 5000.f, 0.f)));
+
+	//alternating walls to run along and ledges to mantle, repeated down the course
+	for (int Index = 0; Index < 40; ++Index)
+	{
+		const float X = Index * 2000.f;
+		Scene.AddBox(FBox(FVec3(X + 200.f, 100.f, 0.f), FVec3(X + 1200.f, 150.f, 600.f)));
+		Scene.AddBox(FBox(FVec3(X + 1500.f, -500.f, 0.f), FVec3(X + 1700.f, 500.f, 150.f)));
+	}
+	return Scene;
+}
+
+static void BenchWallRunProbe(int Iterations)
+{
+	FParkourConfig Config;
+	FVec3 Location(0.f, 0.f, 100.f);
+
+	const FClock::time_point Start = FClock::now();
+	for (int Index = 0; Index < Iterations; ++Index)
+	{
+		Location.X += 1.f;
+		const FWallRunProbe Probe = ComputeWallRunProbe(Config, Location, FVec3(1.f, 0.f, 0.f), FVec3(0.f, 1.f, 0.f));
+		Sink = Sink + Probe.RightEnd.Y;
+	}
+	Report("ComputeWallRunProbe", Start, Iterations);
+}
+
+static void BenchCornerTransition(int Iterations)
+{
+	FVec3 Normal(0.f, -0.999f, 0.04f);
+
+	const FClock::time_point Start = FClock::now();
+	for (int Index = 0; Index < Iterations; ++Index)
+	{
+		Normal.X = (Index & 1) ? -0.999f : 0.f;
+		Sink = Sink + (IsCornerTransition(FVec3(0.f, -0.999f, 0.04f), Normal) ? 1.f : 0.f);
+	}
+	Report("IsCornerTransition", Start, Iterations);
+}
+
+static void BenchSceneTrace(int Iterations)
+{
+	const FBoxScene Scene = MakeCourse();
+	FTraceHit Hit;
+
+	const FClock::time_point Start = FClock::now();
+	for (int Index = 0; Index < Iterations; ++Index)
+	{
+		const FVec3 From((float)(Index % 80000), 30.f, 100.f);
+		Scene.LineTrace(From, From + FVec3(-35.f, 75.f, 0.f), Hit);
+		Sink = Sink + Hit.Distance;
+	}
+	Report("FBoxScene::LineTrace (81)", Start, Iterations);
+}
+
+static void BenchHeadlessStep(int Iterations)
+{
+	const FBoxScene Scene = MakeCourse();
+	FHeadlessCharacter Character(Scene);
+	Character.Location = FVec3(0.f, 30.f, 200.f);
+	Character.PlaceOnFloor();
+
+	FHeadlessInput Input;
+	Input.MoveInput = FVec3(1.f, 0.f, 0.f);
+
+	const FClock::time_point Start = FClock::now();
+	for (int Index = 0; Index < Iterations; ++Index)
+	{
+		//jump every second, sprint every few, and start over before running off the end of the course
+		Input.Buttons = (Index % 60 == 20) ? EHeadlessButton::Jump : ((Index % 240 == 0) ? EHeadlessButton::Sprint : 0);
+		if (Character.Location.X > 75000.f)
+		{
+			Character.Location = FVec3(0.f, 30.f, 200.f);
+			Character.Velocity = FVec3();
+			Character.PlaceOnFloor();
+		}
+		Character.Step(Input);
+	}
+	Sink = Sink + Character.Location.X;
+	Report("FHeadlessCharacter::Step", Start, Iterations);
+}
+
+int main(int argc, char** argv)
+{
+	int Iterations = 1000000;
+	for (int Index = 1; Index + 1 < argc; ++Index)
+	{
+		if (std::strcmp(argv[Index], "--iterations") == 0)
+		{
+			Iterations = std::atoi(argv[Index + 1]);
+		}
+	}
+
+	if (Iterations <= 0)
+	{
+		std::printf("usage: ParkourCoreBench [--iterations N]\n");
+		return 1;
+	}
+
+	BenchWallRunProbe(Iterations);
+	BenchCornerTransition(Iterations);
+	BenchSceneTrace(Iterations);
+	//a step is a few dozen traces, run fewer so the whole thing stays quick
+	BenchHeadlessStep(Iterations / 10 > 0 ? Iterations / 10 : 1);
+	return 0;
+}
@@ -0,0 +1,257 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoxScene.h"
+#include <cstdio>
+#include <fstream>
+
+namespace LevelsParkour
+{
+	static float Axis(const FVec3& V, int Index)
+	{
+		return Index == 0 ? V.X : (Index == 1 ? V.Y : V.Z);
+	}
+
+	static void SetAxis(FVec3& V, int Index, float Value)
+	{
+		if (Index == 0)
+		{
+			V.X = Value;
+		}
+		else if (Index == 1)
+		{
+			V.Y = Value;
+		}
+		else
+		{
+			V.Z = Value;
+		}
+	}
+
+	static float ClampTo(float Value, float Min, float Max)
+	{
+		return Value < Min ? Min : (Value > Max ? Max : Value);
+	}
+
+	bool FBoxScene::LoadBoxes(const std::string& Filename)
+	{
+		std::ifstream File(Filename);
+		if (!File)
+		{
+			return false;
+		}
+
+		std::string Line;
+		int LineNumber = 0;
+		while (std::getline(File, Line))
+		{
+			++LineNumber;
+			const size_t First = Line.find_first_not_of(" \t\r");
+			if (First == std::string::npos || Line[First] == '#')
+			{
+				continue;
+			}
+
+			FBox Box;
+			if (std::sscanf(Line.c_str(), "%f %f %f %f %f %f", &Box.Min.X, &Box.Min.Y, &Box.Min.Z, &Box.Max.X, &Box.Max.Y, &Box.Max.Z) != 6)
+			{
+				std::fprintf(stderr, "%s:%d is not a minx miny minz maxx maxy maxz line\n", Filename.c_str(), LineNumber);
+				return false;
+			}
+			AddBox(Box);
+		}
+		return true;
+	}
+
+	bool FBoxScene::LineTrace(const FVec3& Start, const FVec3& End, FTraceHit& Hit) const
+	{
+		return Sweep(Start, End, 0.f, Hit);
+	}
+
+	bool FBoxScene::CapsuleTrace(const FVec3& Start, const FVec3& End, float Radius, float HalfHeight, FTraceHit& Hit) const
+	{
+		//swept as a sphere around the capsule center, see the class comment
+		return Sweep(Start, End, Radius, Hit);
+	}
+
+	void FBoxScene::AddBox(const FBox& Box)
+	{
+		Boxes.push_back(Box);
+		GridCellSize = 0.f;
+		GridCells.clear();
+	}
+
+	void FBoxScene::BuildGrid(float CellSize)
+	{
+		GridCells.clear();
+		GridCellSize = 0.f;
+		if (Boxes.empty() || CellSize <= 0.f)
+		{
+			return;
+		}
+
+		float MinX = Boxes[0].Min.X;
+		float MinY = Boxes[0].Min.Y;
+		float MaxX = Boxes[0].Max.X;
+		float MaxY = Boxes[0].Max.Y;
+		for (const FBox& Box : Boxes)
+		{
+			MinX = Box.Min.X < MinX ? Box.Min.X : MinX;
+			MinY = Box.Min.Y < MinY ? Box.Min.Y : MinY;
+			MaxX = Box.Max.X > MaxX ? Box.Max.X : MaxX;
+			MaxY = Box.Max.Y > MaxY ? Box.Max.Y : MaxY;
+		}
+
+		//huge scenes get bigger cells rather than millions of them
+		const float MaxCells = 256.f;
+		const float Extent = (MaxX - MinX) > (MaxY - MinY) ? (MaxX - MinX) : (MaxY - MinY);
+		if (Extent / CellSize > MaxCells)
+		{
+			CellSize = Extent / MaxCells;
+		}
+
+		GridCellSize = CellSize;
+		GridOriginX = MinX;
+		GridOriginY = MinY;
+		GridSizeX = (int)((MaxX - MinX) / CellSize) + 1;
+		GridSizeY = (int)((MaxY - MinY) / CellSize) + 1;
+		GridCells.resize((size_t)GridSizeX * GridSizeY);
+
+		for (int BoxIndex = 0; BoxIndex < (int)Boxes.size(); ++BoxIndex)
+		{
+			const FBox& Box = Boxes[BoxIndex];
+			const int FirstX = (int)((Box.Min.X - GridOriginX) / CellSize);
+			const int FirstY = (int)((Box.Min.Y - GridOriginY) / CellSize);
+			const int LastX = (int)((Box.Max.X - GridOriginX) / CellSize);
+			const int LastY = (int)((Box.Max.Y - GridOriginY) / CellSize);
+			for (int CellY = FirstY; CellY <= LastY && CellY < GridSizeY; ++CellY)
+			{
+				for (int CellX = FirstX; CellX <= LastX && CellX < GridSizeX; ++CellX)
+				{
+					GridCells[(size_t)CellY * GridSizeX + CellX].push_back(BoxIndex);
+				}
+			}
+		}
+	}
+
+	/** Slab test of the segment against a box grown by Radius, keeps the earliest hit */
+	static void SweepBox(const FBox& Box, const FVec3& Start, const FVec3& Delta, float Radius, float& BestTime, const FBox*& BestBox, int& BestAxis)
+	{
+		const FVec3 Grow(Radius, Radius, Radius);
+		const FVec3 Min = Box.Min - Grow;
+		const FVec3 Max = Box.Max + Grow;
+
+		float EnterTime = 0.f;
+		float ExitTime = 1.f;
+		int EnterAxis = -1;
+
+		for (int Index = 0; Index < 3; ++Index)
+		{
+			const float From = Axis(Start, Index);
+			const float Step = Axis(Delta, Index);
+			const float Low = Axis(Min, Index);
+			const float High = Axis(Max, Index);
+
+			if (Step == 0.f)
+			{
+				if (From < Low || From > High)
+				{
+					return;
+				}
+				continue;
+			}
+
+			float Near = (Low - From) / Step;
+			float Far = (High - From) / Step;
+			if (Near > Far)
+			{
+				const float Swap = Near;
+				Near = Far;
+				Far = Swap;
+			}
+
+			if (Near > EnterTime)
+			{
+				EnterTime = Near;
+				EnterAxis = Index;
+			}
+			if (Far < ExitTime)
+			{
+				ExitTime = Far;
+			}
+			if (EnterTime > ExitTime)
+			{
+				return;
+			}
+		}
+
+		//starting inside a box never hits it, same as traces that begin inside a wall
+		if (EnterAxis < 0 || EnterTime >= BestTime)
+		{
+			return;
+		}
+
+		BestTime = EnterTime;
+		BestBox = &Box;
+		BestAxis = EnterAxis;
+	}
+
+	bool FBoxScene::Sweep(const FVec3& Start, const FVec3& End, float Radius, FTraceHit& Hit) const
+	{
+		const FVec3 Delta = End - Start;
+		const float Length = Size(Delta);
+
+		float BestTime = 2.f;
+		const FBox* BestBox = nullptr;
+		int BestAxis = 0;
+
+		if (GridCellSize > 0.f)
+		{
+			//only the cells the swept bounds touch, a box in several of them is just tested more than once
+			const float LowX = (Start.X < End.X ? Start.X : End.X) - Radius - GridOriginX;
+			const float LowY = (Start.Y < End.Y ? Start.Y : End.Y) - Radius - GridOriginY;
+			const float HighX = (Start.X > End.X ? Start.X : End.X) + Radius - GridOriginX;
+			const float HighY = (Start.Y > End.Y ? Start.Y : End.Y) + Radius - GridOriginY;
+			const int FirstX = LowX < 0.f ? 0 : (int)(LowX / GridCellSize);
+			const int FirstY = LowY < 0.f ? 0 : (int)(LowY / GridCellSize);
+			const int LastX = HighX < 0.f ? -1 : (int)(HighX / GridCellSize);
+			const int LastY = HighY < 0.f ? -1 : (int)(HighY / GridCellSize);
+
+			for (int CellY = FirstY; CellY <= LastY && CellY < GridSizeY; ++CellY)
+			{
+				for (int CellX = FirstX; CellX <= LastX && CellX < GridSizeX; ++CellX)
+				{
+					for (int BoxIndex : GridCells[(size_t)CellY * GridSizeX + CellX])
+					{
+						SweepBox(Boxes[BoxIndex], Start, Delta, Radius, BestTime, BestBox, BestAxis);
+					}
+				}
+			}
+		}
+		else
+		{
+			for (const FBox& Box : Boxes)
+			{
+				SweepBox(Box, Start, Delta, Radius, BestTime, BestBox, BestAxis);
+			}
+		}
+
+		if (!BestBox)
+		{
+			Hit = FTraceHit();
+			return false;
+		}
+
+		FVec3 Normal;
+		SetAxis(Normal, BestAxis, Axis(Delta, BestAxis) > 0.f ? -1.f : 1.f);
+
+		const FVec3 Center = Start + Delta * BestTime;
+		const FVec3 Contact = Center - Normal * Radius;
+
+		Hit.Normal = Normal;
+		Hit.ImpactNormal = Normal;
+		Hit.ImpactPoint = FVec3(ClampTo(Contact.X, BestBox->Min.X, BestBox->Max.X), ClampTo(Contact.Y, BestBox->Min.Y, BestBox->Max.Y), ClampTo(Contact.Z, BestBox->Min.Z, BestBox->Max.Z));
+		Hit.Distance = BestTime * Length;
+		Hit.bWalkable = Normal.Z >= WalkableFloorZ;
+		return true;
+	}
+}
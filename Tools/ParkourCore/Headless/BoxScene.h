@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "ParkourInterfaces.h"
+#include <string>
+#include <vector>
+
+namespace LevelsParkour
+{
+	/** Axis aligned box, the only shape the headless scene knows */
+	struct FBox
+	{
+		FVec3 Min;
+		FVec3 Max;
+
+		FBox() {}
+		FBox(const FVec3& InMin, const FVec3& InMax) : Min(InMin), Max(InMax) {}
+
+		static FBox FromCenter(const FVec3& Center, const FVec3& Extent) { return FBox(Center - Extent, Center + Extent); }
+	};
+
+	/**
+	 * A world made of boxes for running the parkour core without the engine. Capsule sweeps are treated as
+	 * sphere sweeps against the boxes grown by the radius, close enough for the short probes parkour uses.
+	 */
+	class FBoxScene : public ISceneQuery
+	{
+	public:
+		std::vector<FBox> Boxes;
+
+		//surfaces whose normal points at least this far up can be stood on, the engine's default walkable slope
+		float WalkableFloorZ = 0.71f;
+
+		/** Adds a box, drops the grid until BuildGrid is called again */
+		void AddBox(const FBox& Box);
+
+		/** Adds the boxes of a text file, one "minx miny minz maxx maxy maxz" per line and # for comments */
+		bool LoadBoxes(const std::string& Filename);
+
+		/**
+		 * Buckets the boxes into a 2D grid so traces only test nearby boxes. Optional, without it every trace
+		 * tests every box, which is fine for a handful of boxes and slow for a course.
+		 */
+		void BuildGrid(float CellSize = 1000.f);
+
+		virtual bool LineTrace(const FVec3& Start, const FVec3& End, FTraceHit& Hit) const override;
+		virtual bool CapsuleTrace(const FVec3& Start, const FVec3& End, float Radius, float HalfHeight, FTraceHit& Hit) const override;
+
+	private:
+		bool Sweep(const FVec3& Start, const FVec3& End, float Radius, FTraceHit& Hit) const;
+
+		//cell size zero means there's no grid
+		float GridCellSize = 0.f;
+		float GridOriginX = 0.f;
+		float GridOriginY = 0.f;
+		int GridSizeX = 0;
+		int GridSizeY = 0;
+		std::vector<std::vector<int>> GridCells;
+	};
+}
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CachedSceneQuery.h"
+#include <cstring>
+
+namespace LevelsParkour
+{
+	bool FCachedSceneQuery::FKey::operator==(const FKey& Other) const
+	{
+		for (int Index = 0; Index < 8; ++Index)
+		{
+			if (Values[Index] != Other.Values[Index])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	size_t FCachedSceneQuery::FKeyHash::operator()(const FKey& Key) const
+	{
+		//FNV-1a over the key
+		uint64_t Hash = 14695981039346656037ull;
+		for (int Index = 0; Index < 8; ++Index)
+		{
+			Hash = (Hash ^ Key.Values[Index]) * 1099511628211ull;
+		}
+		return (size_t)Hash;
+	}
+
+	bool FCachedSceneQuery::LineTrace(const FVec3& Start, const FVec3& End, FTraceHit& Hit) const
+	{
+		return Trace(Start, End, 0.f, 0.f, false, Hit);
+	}
+
+	bool FCachedSceneQuery::CapsuleTrace(const FVec3& Start, const FVec3& End, float Radius, float HalfHeight, FTraceHit& Hit) const
+	{
+		return Trace(Start, End, Radius, HalfHeight, true, Hit);
+	}
+
+	bool FCachedSceneQuery::Trace(const FVec3& Start, const FVec3& End, float Radius, float HalfHeight, bool bCapsule, FTraceHit& Hit) const
+	{
+		//float bits, so -0 and 0 are different keys, which only costs a miss
+		const float Inputs[8] = { Start.X, Start.Y, Start.Z, End.X, End.Y, End.Z, bCapsule ? Radius : -1.f, bCapsule ? HalfHeight : -1.f };
+		FKey Key;
+		std::memcpy(Key.Values, Inputs, sizeof(Key.Values));
+
+		//high bits pick the shard, the map inside uses the low ones
+		FShard& Shard = Shards[(FKeyHash()(Key) >> 24) % NumShards];
+		{
+			std::lock_guard<std::mutex> Lock(Shard.Mutex);
+			const auto Found = Shard.Entries.find(Key);
+			if (Found != Shard.Entries.end())
+			{
+				++Hits;
+				Hit = Found->second.Hit;
+				return Found->second.bHit;
+			}
+		}
+
+		//traced outside the lock, two threads missing the same key just do the same work twice
+		++Misses;
+		FEntry Entry;
+		Entry.bHit = bCapsule ? Inner.CapsuleTrace(Start, End, Radius, HalfHeight, Entry.Hit) : Inner.LineTrace(Start, End, Entry.Hit);
+
+		{
+			std::lock_guard<std::mutex> Lock(Shard.Mutex);
+			if (Shard.Entries.size() >= MaxShardEntries)
+			{
+				Shard.Entries.clear();
+			}
+			Shard.Entries.emplace(Key, Entry);
+		}
+
+		Hit = Entry.Hit;
+		return Entry.bHit;
+	}
+}
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "ParkourInterfaces.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace LevelsParkour
+{
+	/**
+	 * Memoizes another scene's traces, keyed on the exact inputs so a cached result is the one the inner scene
+	 * would give and sharing the cache between threads can't change an outcome. Searches branch many moves off
+	 * the same state, which repeat the same probes, and that's where this pays off. Snapping inputs to a grid
+	 * would hit more often but lets capsules creep into walls, so it doesn't.
+	 */
+	class FCachedSceneQuery : public ISceneQuery
+	{
+	public:
+		explicit FCachedSceneQuery(const ISceneQuery& InInner) : Inner(InInner) {}
+
+		virtual bool LineTrace(const FVec3& Start, const FVec3& End, FTraceHit& Hit) const override;
+		virtual bool CapsuleTrace(const FVec3& Start, const FVec3& End, float Radius, float HalfHeight, FTraceHit& Hit) const override;
+
+		uint64_t GetHits() const { return Hits; }
+		uint64_t GetMisses() const { return Misses; }
+
+	private:
+		struct FKey
+		{
+			uint32_t Values[8];
+
+			bool operator==(const FKey& Other) const;
+		};
+
+		struct FKeyHash
+		{
+			size_t operator()(const FKey& Key) const;
+		};
+
+		struct FEntry
+		{
+			FTraceHit Hit;
+			bool bHit = false;
+		};
+
+		//shards keep threads from queueing on one lock
+		static const int NumShards = 64;
+		//a full shard is emptied rather than growing without bound
+		static const size_t MaxShardEntries = 1 << 14;
+
+		struct FShard
+		{
+			std::mutex Mutex;
+			std::unordered_map<FKey, FEntry, FKeyHash> Entries;
+		};
+
+		const ISceneQuery& Inner;
+		mutable FShard Shards[NumShards];
+		mutable std::atomic<uint64_t> Hits{ 0 };
+		mutable std::atomic<uint64_t> Misses{ 0 };
+
+		bool Trace(const FVec3& Start, const FVec3& End, float Radius, float HalfHeight, bool bCapsule, FTraceHit& Hit) const;
+	};
+}
@@ -0,0 +1,371 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HeadlessCharacter.h"
+
+namespace LevelsParkour
+{
+	static const float DegreesToRadians = 3.14159265358979f / 180.f;
+
+	//how far below the feet still counts as standing on the floor
+	static const float FloorSnapDistance = 10.f;
+
+	FHeadlessCharacter::FHeadlessCharacter(const ISceneQuery& InScene, int InStepRate)
+		: Sim(*this, InScene)
+		, StepRate(InStepRate)
+		, Scene(InScene)
+	{
+		for (int Index = 0; Index < (int)ECooldown::Num; ++Index)
+		{
+			CooldownStep[Index] = -1;
+			CooldownPeriod[Index] = 0;
+		}
+		Sim.Config.DefaultParams = Params;
+	}
+
+	FVec3 FHeadlessCharacter::GetForward() const
+	{
+		return FVec3(std::cos(Yaw * DegreesToRadians), std::sin(Yaw * DegreesToRadians), 0.f);
+	}
+
+	FVec3 FHeadlessCharacter::GetRight() const
+	{
+		return FVec3(-std::sin(Yaw * DegreesToRadians), std::cos(Yaw * DegreesToRadians), 0.f);
+	}
+
+	void FHeadlessCharacter::PlaceOnFloor()
+	{
+		FTraceHit Hit;
+		if (Scene.LineTrace(Location, Location - FVec3(0.f, 0.f, 100000.f), Hit))
+		{
+			Location.Z = Hit.ImpactPoint.Z + GetCapsuleHalfHeight();
+			Movement = EBaseMovement::Walking;
+			Velocity.Z = 0.f;
+		}
+	}
+
+	void FHeadlessCharacter::Step(const FHeadlessInput& Input)
+	{
+		++StepIndex;
+		Yaw += Input.YawDelta;
+		CurrentInput = Input;
+
+		if (Input.Buttons & EHeadlessButton::Jump)
+		{
+			Sim.OnJump(Input.ButtonAge);
+			//the engine's own jump runs on the next movement update, after parkour has seen the press
+			Jump();
+		}
+		if (Input.Buttons & EHeadlessButton::Crouch)
+		{
+			Sim.CrouchSlideCheck(Input.ButtonAge);
+		}
+		if (Input.Buttons & EHeadlessButton::Sprint)
+		{
+			Sim.SprintStart(Input.ButtonAge);
+		}
+
+		for (int Index = 0; Index < (int)ECooldown::Num; ++Index)
+		{
+			if (CooldownStep[Index] >= 0 && StepIndex >= CooldownStep[Index])
+			{
+				CooldownStep[Index] = CooldownPeriod[Index] > 0 ? CooldownStep[Index] + CooldownPeriod[Index] : -1;
+				Sim.FireCooldown((ECooldown)Index);
+			}
+		}
+
+		Sim.Update();
+		Integrate(GetDeltaSeconds());
+	}
+
+	void FHeadlessCharacter::Jump()
+	{
+		if (Movement == EBaseMovement::Walking && !bCrouched)
+		{
+			Velocity.Z = Velocity.Z > JumpZVelocity ? Velocity.Z : JumpZVelocity;
+			SetMovement(EBaseMovement::Falling);
+		}
+	}
+
+	void FHeadlessCharacter::Save(FHeadlessSnapshot& OutSnapshot) const
+	{
+		OutSnapshot.Location = Location;
+		OutSnapshot.Velocity = Velocity;
+		OutSnapshot.PendingLaunchVelocity = PendingLaunchVelocity;
+		OutSnapshot.PlaneNormal = PlaneNormal;
+		OutSnapshot.Yaw = Yaw;
+		OutSnapshot.Params = Params;
+		OutSnapshot.StepIndex = StepIndex;
+		for (int Index = 0; Index < (int)ECooldown::Num; ++Index)
+		{
+			OutSnapshot.CooldownStep[Index] = CooldownStep[Index];
+			OutSnapshot.CooldownPeriod[Index] = CooldownPeriod[Index];
+		}
+		OutSnapshot.Parkour = Sim.State;
+		OutSnapshot.Movement = Movement;
+		OutSnapshot.Mode = Mode;
+		OutSnapshot.bCrouched = bCrouched;
+		OutSnapshot.bPlaneConstrained = bPlaneConstrained;
+		OutSnapshot.bPendingLaunch = bPendingLaunch;
+	}
+
+	void FHeadlessCharacter::Restore(const FHeadlessSnapshot& Snapshot)
+	{
+		Location = Snapshot.Location;
+		Velocity = Snapshot.Velocity;
+		PendingLaunchVelocity = Snapshot.PendingLaunchVelocity;
+		PlaneNormal = Snapshot.PlaneNormal;
+		Yaw = Snapshot.Yaw;
+		Params = Snapshot.Params;
+		StepIndex = Snapshot.StepIndex;
+		for (int Index = 0; Index < (int)ECooldown::Num; ++Index)
+		{
+			CooldownStep[Index] = Snapshot.CooldownStep[Index];
+			CooldownPeriod[Index] = Snapshot.CooldownPeriod[Index];
+		}
+		Sim.State = Snapshot.Parkour;
+		Movement = Snapshot.Movement;
+		Mode = Snapshot.Mode;
+		bCrouched = Snapshot.bCrouched;
+		bPlaneConstrained = Snapshot.bPlaneConstrained;
+		bPendingLaunch = Snapshot.bPendingLaunch;
+	}
+
+	void FHeadlessCharacter::SetMovement(EBaseMovement NewMovement)
+	{
+		if (NewMovement == Movement)
+		{
+			return;
+		}
+
+		//same side effects as the engine: the parkour mode is cleared, walking drops vertical speed, none stops everything
+		const EBaseMovement PreviousMovement = Movement;
+		const EParkourMode PreviousMode = Mode;
+		Movement = NewMovement;
+		Mode = EParkourMode::None;
+
+		if (NewMovement == EBaseMovement::Walking)
+		{
+			Velocity.Z = 0.f;
+		}
+		else if (NewMovement == EBaseMovement::None)
+		{
+			Velocity = FVec3();
+			bPendingLaunch = false;
+		}
+
+		Sim.OnMovementChanged(PreviousMovement, PreviousMode);
+	}
+
+	void FHeadlessCharacter::Launch(const FVec3& LaunchVelocity, bool bXYOverride, bool bZOverride)
+	{
+		FVec3 FinalVelocity = LaunchVelocity;
+		if (!bXYOverride)
+		{
+			FinalVelocity.X += Velocity.X;
+			FinalVelocity.Y += Velocity.Y;
+		}
+		if (!bZOverride)
+		{
+			FinalVelocity.Z += Velocity.Z;
+		}
+		PendingLaunchVelocity = FinalVelocity;
+		bPendingLaunch = true;
+	}
+
+	void FHeadlessCharacter::Crouch(bool bClientSimulation)
+	{
+		if (bCrouched)
+		{
+			return;
+		}
+
+		bCrouched = true;
+		//on the ground crouching keeps the feet where they are
+		if (Movement == EBaseMovement::Walking)
+		{
+			Location.Z -= StandingHalfHeight - CrouchedHalfHeight;
+		}
+	}
+
+	void FHeadlessCharacter::UnCrouch(bool bClientSimulation)
+	{
+		if (!bCrouched)
+		{
+			return;
+		}
+
+		bCrouched = false;
+		if (Movement == EBaseMovement::Walking)
+		{
+			Location.Z += StandingHalfHeight - CrouchedHalfHeight;
+		}
+	}
+
+	void FHeadlessCharacter::ConstrainToPlane(const FVec3& Forward, const FVec3& Up)
+	{
+		PlaneNormal = SafeNormal(Cross(Up, Forward));
+		bPlaneConstrained = true;
+	}
+
+	void FHeadlessCharacter::SetCooldown(ECooldown Cooldown, float Seconds, bool bLooping)
+	{
+		const int Steps = (int)std::ceil(Seconds * StepRate);
+		CooldownStep[(int)Cooldown] = Steps > 0 ? StepIndex + Steps : -1;
+		CooldownPeriod[(int)Cooldown] = bLooping ? Steps : 0;
+	}
+
+	void FHeadlessCharacter::ClearCooldown(ECooldown Cooldown)
+	{
+		CooldownStep[(int)Cooldown] = -1;
+		CooldownPeriod[(int)Cooldown] = 0;
+	}
+
+	void FHeadlessCharacter::Integrate(float DeltaSeconds)
+	{
+		if (Movement == EBaseMovement::None)
+		{
+			return;
+		}
+
+		if (bPendingLaunch)
+		{
+			Velocity = PendingLaunchVelocity;
+			bPendingLaunch = false;
+			SetMovement(EBaseMovement::Falling);
+		}
+
+		if (bPlaneConstrained)
+		{
+			Velocity -= PlaneNormal * Dot(Velocity, PlaneNormal);
+		}
+
+		if (Movement == EBaseMovement::Walking)
+		{
+			MoveWalking(DeltaSeconds);
+		}
+		else if (Movement == EBaseMovement::Falling)
+		{
+			MoveFalling(DeltaSeconds);
+		}
+	}
+
+	void FHeadlessCharacter::MoveWalking(float DeltaSeconds)
+	{
+		FVec3 Acceleration = SafeNormal(FVec3(CurrentInput.MoveInput.X, CurrentInput.MoveInput.Y, 0.f)) * MaxAcceleration;
+		Acceleration = BoostWalkingAcceleration(Sim.Config, Acceleration, Velocity);
+
+		const bool bAccelerating = SizeSquared(Acceleration) > 0.f;
+		const float MaxSpeed = bCrouched ? Params.MaxWalkSpeedCrouched : Params.MaxWalkSpeed;
+		FVec3 Horizontal(Velocity.X, Velocity.Y, 0.f);
+
+		//brake when there's no input or when going faster than allowed, but never below the limit while accelerating
+		const float Speed = Size(Horizontal);
+		if (!bAccelerating || Speed > MaxSpeed * 1.01f)
+		{
+			float NewSpeed = Speed - (Params.GroundFriction * Speed + Params.BrakingDecelerationWalking) * DeltaSeconds;
+			if (bAccelerating && NewSpeed < MaxSpeed)
+			{
+				NewSpeed = MaxSpeed;
+			}
+			Horizontal = SafeNormal(Horizontal) * (NewSpeed > 0.f ? NewSpeed : 0.f);
+		}
+
+		if (bAccelerating)
+		{
+			const float CurrentSpeed = Size(Horizontal);
+			const float Limit = CurrentSpeed > MaxSpeed ? CurrentSpeed : MaxSpeed;
+			//friction turns the velocity towards the input
+			Horizontal -= (Horizontal - SafeNormal(Acceleration) * CurrentSpeed) * Clamp01(DeltaSeconds * Params.GroundFriction);
+			Horizontal += Acceleration * DeltaSeconds;
+			if (Size(Horizontal) > Limit)
+			{
+				Horizontal = SafeNormal(Horizontal) * Limit;
+			}
+		}
+
+		if (bPlaneConstrained)
+		{
+			Horizontal -= PlaneNormal * Dot(Horizontal, PlaneNormal);
+		}
+
+		Velocity = Horizontal;
+		MoveAlongWalls(Horizontal * DeltaSeconds);
+
+		float FloorZ = 0.f;
+		if (FindFloor(FloorZ))
+		{
+			Location.Z = FloorZ + GetCapsuleHalfHeight();
+		}
+		else
+		{
+			SetMovement(EBaseMovement::Falling);
+		}
+	}
+
+	void FHeadlessCharacter::MoveFalling(float DeltaSeconds)
+	{
+		Velocity.Z += GravityZ * Params.GravityScale * DeltaSeconds;
+		const FVec3 Delta = Velocity * DeltaSeconds;
+
+		MoveAlongWalls(FVec3(Delta.X, Delta.Y, 0.f));
+
+		const float HalfHeight = GetCapsuleHalfHeight();
+		FTraceHit Hit;
+		if (Delta.Z <= 0.f)
+		{
+			if (Scene.LineTrace(Location, Location - FVec3(0.f, 0.f, HalfHeight - Delta.Z + 1.f), Hit) && Hit.bWalkable)
+			{
+				Location.Z = Hit.ImpactPoint.Z + HalfHeight;
+				SetMovement(EBaseMovement::Walking);
+				Sim.OnLanded();
+				return;
+			}
+		}
+		else if (Scene.LineTrace(Location, Location + FVec3(0.f, 0.f, HalfHeight + Delta.Z), Hit))
+		{
+			//bumped a ceiling
+			Location.Z = Hit.ImpactPoint.Z - HalfHeight;
+			Velocity.Z = 0.f;
+			return;
+		}
+
+		Location.Z += Delta.Z;
+	}
+
+	void FHeadlessCharacter::MoveAlongWalls(const FVec3& Delta)
+	{
+		FVec3 Remaining = Delta;
+		for (int Iteration = 0; Iteration < 3 && SizeSquared(Remaining) > 1.e-6f; ++Iteration)
+		{
+			FTraceHit Hit;
+			if (!Scene.CapsuleTrace(Location, Location + Remaining, CapsuleRadius, GetCapsuleHalfHeight(), Hit))
+			{
+				Location += Remaining;
+				break;
+			}
+
+			//stop just short of the wall and slide the rest of the way along it
+			const float Length = Size(Remaining);
+			const float Travel = Hit.Distance > 0.1f ? Hit.Distance - 0.1f : 0.f;
+			Location += Remaining * (Travel / Length);
+			Remaining = Remaining * (1.f - Travel / Length);
+			Remaining -= Hit.Normal * Dot(Remaining, Hit.Normal);
+			const float IntoWall = Dot(Velocity, Hit.Normal);
+			if (IntoWall < 0.f)
+			{
+				Velocity -= Hit.Normal * IntoWall;
+			}
+		}
+	}
+
+	bool FHeadlessCharacter::FindFloor(float& OutFloorZ) const
+	{
+		FTraceHit Hit;
+		if (Scene.LineTrace(Location, Location - FVec3(0.f, 0.f, GetCapsuleHalfHeight() + FloorSnapDistance), Hit) && Hit.bWalkable)
+		{
+			OutFloorZ = Hit.ImpactPoint.Z;
+			return true;
+		}
+		return false;
+	}
+}
@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "ParkourSim.h"
+
+namespace LevelsParkour
+{
+	/** Same bits as ELevelsInputButton */
+	namespace EHeadlessButton
+	{
+		enum Type : uint8_t
+		{
+			Jump = 1 << 0,
+			Crouch = 1 << 1,
+			Sprint = 1 << 2
+		};
+	}
+
+	/** Input for one headless step */
+	struct FHeadlessInput
+	{
+		//world space movement direction, zero for none
+		FVec3 MoveInput;
+
+		//EHeadlessButton bits pressed this step
+		uint8_t Buttons = 0;
+
+		//how long before the step they were pressed
+		float ButtonAge = 0.f;
+
+		//turns the character before the step, degrees
+		float YawDelta = 0.f;
+	};
+
+	/** Everything a headless step reads and writes, the FLevelsParkourSnapshot of the headless character */
+	struct FHeadlessSnapshot
+	{
+		FVec3 Location;
+		FVec3 Velocity;
+		FVec3 PendingLaunchVelocity;
+		FVec3 PlaneNormal;
+		float Yaw = 0.f;
+		FMovementParams Params;
+		int StepIndex = 0;
+		int CooldownStep[(int)ECooldown::Num];
+		int CooldownPeriod[(int)ECooldown::Num];
+		FParkourState Parkour;
+		EBaseMovement Movement = EBaseMovement::Walking;
+		EParkourMode Mode = EParkourMode::None;
+		bool bCrouched = false;
+		bool bPlaneConstrained = false;
+		bool bPendingLaunch = false;
+	};
+
+	/**
+	 * A capsule with just enough character movement to exercise the parkour core: walking with braking,
+	 * falling under gravity, launches, crouching, landing and sliding along walls. Steps at a fixed rate the way
+	 * the component's fixed step mode does, cooldowns count steps. Not the engine's movement, don't tune against it.
+	 */
+	class FHeadlessCharacter final : public IParkourBody
+	{
+	public:
+		FHeadlessCharacter(const ISceneQuery& InScene, int InStepRate = 60);
+
+		FParkourSim Sim;
+
+		//body state, public so tests can set up and inspect scenarios
+		FVec3 Location;
+		FVec3 Velocity;
+		float Yaw = 0.f;
+		EBaseMovement Movement = EBaseMovement::Walking;
+		EParkourMode Mode = EParkourMode::None;
+		FMovementParams Params;
+		bool bCrouched = false;
+		bool bPlaneConstrained = false;
+		FVec3 PlaneNormal;
+
+		//capsule and movement settings, the template character's values
+		float CapsuleRadius = 55.f;
+		float StandingHalfHeight = 96.f;
+		float CrouchedHalfHeight = 40.f;
+		float EyeHeight = 64.f;
+		float MaxAcceleration = 2048.f;
+		float JumpZVelocity = 420.f;
+		float GravityZ = -980.f;
+
+		int StepRate;
+		int StepIndex = 0;
+
+		//number of each event seen, indexed by EParkourEvent
+		int EventCounts[6] = {};
+
+		/** Snaps the capsule onto whatever is below Location */
+		void PlaceOnFloor();
+
+		/** Runs one fixed step: buttons, due cooldowns, the parkour update, then movement */
+		void Step(const FHeadlessInput& Input);
+
+		//IParkourBody
+		virtual FVec3 GetLocation() const override { return Location; }
+		virtual FVec3 GetForward() const override;
+		virtual FVec3 GetRight() const override;
+		virtual FVec3 GetUp() const override { return FVec3(0.f, 0.f, 1.f); }
+		virtual FVec3 GetEyeLocation() const override { return Location + FVec3(0.f, 0.f, EyeHeight); }
+		virtual FVec3 GetVelocity() const override { return Velocity; }
+		virtual float GetCapsuleHalfHeight() const override { return bCrouched ? CrouchedHalfHeight : StandingHalfHeight; }
+		virtual FVec3 GetMoveInput() const override { return CurrentInput.MoveInput; }
+		virtual float GetDeltaSeconds() const override { return 1.f / StepRate; }
+		virtual float GetTime() const override { return (float)StepIndex / StepRate; }
+		virtual EBaseMovement GetMovement() const override { return Movement; }
+		virtual void SetMovement(EBaseMovement NewMovement) override;
+		virtual EParkourMode GetMode() const override { return Mode; }
+		virtual void SetMode(EParkourMode NewMode) override { Mode = NewMode; }
+		virtual FMovementParams GetMovementParams() const override { return Params; }
+		virtual void SetMovementParams(const FMovementParams& NewParams) override { Params = NewParams; }
+		virtual void SetLocation(const FVec3& NewLocation) override { Location = NewLocation; }
+		virtual void Jump() override;
+		virtual void Launch(const FVec3& LaunchVelocity, bool bXYOverride, bool bZOverride) override;
+		virtual void AddImpulse(const FVec3& Impulse) override { Velocity += Impulse; }
+		virtual void StopMovement() override { Velocity = FVec3(); }
+		virtual void DisableMovement() override { SetMovement(EBaseMovement::None); }
+		virtual void Crouch(bool bClientSimulation) override;
+		virtual void UnCrouch(bool bClientSimulation) override;
+		virtual void ConstrainToPlane(const FVec3& Forward, const FVec3& Up) override;
+		virtual void ReleasePlaneConstraint() override { bPlaneConstrained = false; }
+		virtual void SetCooldown(ECooldown Cooldown, float Seconds, bool bLooping) override;
+		virtual void ClearCooldown(ECooldown Cooldown) override;
+		virtual void OnParkourEvent(EParkourEvent Event) override { ++EventCounts[(int)Event]; }
+
+		/** Copies out the simulation state, event counts aren't part of it */
+		void Save(FHeadlessSnapshot& OutSnapshot) const;
+
+		/** Puts back a saved state */
+		void Restore(const FHeadlessSnapshot& Snapshot);
+
+		/** Whether a cooldown is waiting to fire */
+		bool IsCooldownActive(ECooldown Cooldown) const { return CooldownStep[(int)Cooldown] >= 0; }
+
+	private:
+		const ISceneQuery& Scene;
+		FHeadlessInput CurrentInput;
+		FVec3 PendingLaunchVelocity;
+		bool bPendingLaunch = false;
+		int CooldownStep[(int)ECooldown::Num];
+		int CooldownPeriod[(int)ECooldown::Num];
+
+		void Integrate(float DeltaSeconds);
+		void MoveWalking(float DeltaSeconds);
+		void MoveFalling(float DeltaSeconds);
+		void MoveAlongWalls(const FVec3& Delta);
+		bool FindFloor(float& OutFloorZ) const;
+	};
+}
@@ -0,0 +1,179 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "InputTrace.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace LevelsParkour
+{
+	//ELevelsInputButton bits, the headless buttons only cover the first three
+	static const uint8_t JumpButton = 1 << 0;
+	static const uint8_t CrouchButton = 1 << 1;
+	static const uint8_t SprintButton = 1 << 2;
+
+	static const float DegreesToRadians = 3.14159265358979f / 180.f;
+
+	/** Small deterministic generator so scripted traces are the same on every platform */
+	class FTraceRandom
+	{
+	public:
+		explicit FTraceRandom(uint32_t Seed) : State(Seed * 2654435761u + 1u) {}
+
+		float FRand()
+		{
+			State = State * 1664525u + 1013904223u;
+			return (State >> 8) * (1.f / 16777216.f);
+		}
+
+		float FRandRange(float Min, float Max) { return Min + (Max - Min) * FRand(); }
+
+		//inclusive, like FRandomStream::RandRange
+		int RandRange(int Min, int Max)
+		{
+			const int Value = Min + (int)(FRand() * (Max - Min + 1));
+			return Value > Max ? Max : Value;
+		}
+
+	private:
+		uint32_t State;
+	};
+
+	bool FInputTrace::Load(const std::string& Filename)
+	{
+		std::ifstream File(Filename);
+		if (!File)
+		{
+			return false;
+		}
+
+		Name = Filename;
+		Frames.clear();
+
+		std::string Line;
+		//first line is the header
+		std::getline(File, Line);
+		int LineNumber = 1;
+		while (std::getline(File, Line))
+		{
+			++LineNumber;
+			if (Line.empty() || Line == "\r")
+			{
+				continue;
+			}
+
+			FInputFrame Frame;
+			int Buttons = 0;
+			if (std::sscanf(Line.c_str(), "%f,%f,%f,%f,%d", &Frame.Time, &Frame.Forward, &Frame.Right, &Frame.Yaw, &Buttons) != 5)
+			{
+				std::fprintf(stderr, "%s:%d is not a time,forward,right,yaw,buttons line\n", Filename.c_str(), LineNumber);
+				return false;
+			}
+			Frame.Buttons = (uint8_t)Buttons;
+			Frames.push_back(Frame);
+		}
+		return !Frames.empty();
+	}
+
+	FInputTrace FInputTrace::MakeScripted(uint32_t Seed, float Seconds, int StepRate)
+	{
+		FInputTrace Trace;
+		Trace.Name = "scripted:" + std::to_string(Seed);
+
+		FTraceRandom Random(Seed);
+		float Clock = 0.f;
+		while (Clock < Seconds)
+		{
+			//pick the next move of the loop, each one held for a short random time
+			FInputFrame Phase;
+			Phase.Time = Clock;
+			Phase.Forward = 1.f;
+			switch (Random.RandRange(0, 5))
+			{
+			case 0:
+				//plain run with a turn
+				Phase.Yaw = Random.FRandRange(-1.5f, 1.5f);
+				break;
+			case 1:
+				Phase.Buttons = SprintButton;
+				break;
+			case 2:
+				//sprint into a slide
+				Phase.Buttons = SprintButton | CrouchButton;
+				break;
+			case 3:
+				//jump while strafing, which is how wall runs start
+				Phase.Buttons = SprintButton | JumpButton;
+				Phase.Right = Random.FRandRange(-1.f, 1.f);
+				break;
+			case 4:
+				//the bots fire here, headless there's nothing to shoot so it's a slight turn
+				Phase.Yaw = Random.FRandRange(-0.5f, 0.5f);
+				break;
+			default:
+				//back off and strafe so bots don't pin themselves against one wall
+				Phase.Forward = -1.f;
+				Phase.Right = Random.FRandRange(-1.f, 1.f);
+				break;
+			}
+			Trace.Frames.push_back(Phase);
+
+			//phases line up with steps so the trace plays back the same at any step rate that divides it
+			const float Length = Random.FRandRange(0.3f, 1.5f);
+			Clock += (float)(int)(Length * StepRate + 0.5f) / StepRate;
+		}
+
+		//the last phase runs to the end
+		FInputFrame End = Trace.Frames.back();
+		End.Time = Seconds;
+		Trace.Frames.push_back(End);
+		return Trace;
+	}
+
+	FHeadlessInput FInputTracePlayer::Next(const FHeadlessCharacter& Character)
+	{
+		Clock += Character.GetDeltaSeconds();
+
+		const std::vector<FInputFrame>& Frames = Trace.Frames;
+		while (FrameIndex + 1 < Frames.size() && Frames[FrameIndex + 1].Time <= Clock)
+		{
+			++FrameIndex;
+		}
+
+		FHeadlessInput Input;
+		if (Frames.empty())
+		{
+			return Input;
+		}
+
+		const FInputFrame& Frame = Frames[FrameIndex];
+
+		//the yaw turns the character before it moves, same as the control rotation
+		Input.YawDelta = Frame.Yaw;
+		const float Yaw = (Character.Yaw + Frame.Yaw) * DegreesToRadians;
+		const FVec3 Forward(std::cos(Yaw), std::sin(Yaw), 0.f);
+		const FVec3 Right(-std::sin(Yaw), std::cos(Yaw), 0.f);
+		Input.MoveInput = Forward * Frame.Forward + Right * Frame.Right;
+
+		const uint8_t Pressed = Frame.Buttons & ~PreviousButtons;
+		const uint8_t Released = PreviousButtons & ~Frame.Buttons;
+		PreviousButtons = Frame.Buttons;
+
+		if (Pressed & JumpButton)
+		{
+			Input.Buttons |= EHeadlessButton::Jump;
+		}
+		//crouch is checked both ways, see ALevels_v0Character::CrouchEnd
+		if ((Pressed | Released) & CrouchButton)
+		{
+			Input.Buttons |= EHeadlessButton::Crouch;
+		}
+		if (Pressed & SprintButton)
+		{
+			Input.Buttons |= EHeadlessButton::Sprint;
+		}
+		//the frame's time puts the press inside the step, not at its start
+		Input.ButtonAge = Input.Buttons != 0 ? Clock - Frame.Time : 0.f;
+		return Input;
+	}
+}
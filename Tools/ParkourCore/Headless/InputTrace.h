@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HeadlessCharacter.h"
+#include <string>
+#include <vector>
+
+namespace LevelsParkour
+{
+	/** One line of an input trace, same fields and meaning as FLevelsInputFrame */
+	struct FInputFrame
+	{
+		float Time = 0.f;
+		float Forward = 0.f;
+		float Right = 0.f;
+		//degrees added to the yaw every frame
+		float Yaw = 0.f;
+		//held buttons, ELevelsInputButton bits
+		uint8_t Buttons = 0;
+	};
+
+	/** A recorded or generated input trace */
+	struct FInputTrace
+	{
+		std::string Name;
+		std::vector<FInputFrame> Frames;
+
+		float GetDuration() const { return Frames.empty() ? 0.f : Frames.back().Time; }
+
+		/** Loads a "time,forward,right,yaw,buttons" CSV written by FLevelsInputFrame::SaveTrace */
+		bool Load(const std::string& Filename);
+
+		/** The built-in bot script of ULevelsScriptedInputComponent, seeded, without firing */
+		static FInputTrace MakeScripted(uint32_t Seed, float Seconds, int StepRate);
+	};
+
+	/**
+	 * Feeds a trace to a headless character the way ALevels_v0Character::ApplyInputFrame does: axes are
+	 * relative to the character's yaw and buttons act on press, crouch also on release.
+	 */
+	class FInputTracePlayer
+	{
+	public:
+		explicit FInputTracePlayer(const FInputTrace& InTrace) : Trace(InTrace) {}
+
+		/** Input for the next step of Character, doesn't loop */
+		FHeadlessInput Next(const FHeadlessCharacter& Character);
+
+		bool IsFinished() const { return Clock > Trace.GetDuration(); }
+
+	private:
+		const FInputTrace& Trace;
+		size_t FrameIndex = 0;
+		float Clock = 0.f;
+		uint8_t PreviousButtons = 0;
+	};
+}
@@ -0,0 +1,517 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ParkourRoute.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <queue>
+#include <thread>
+#include <unordered_set>
+
+namespace LevelsParkour
+{
+	const std::vector<FRouteAction>& GetRouteActions()
+	{
+		//a quarter second per move keeps the branching manageable and still lets a jump pick its wall
+		static const std::vector<FRouteAction> Actions = {
+			{ "run", 0.f, 0, 15 },
+			{ "run left", -20.f, 0, 15 },
+			{ "run right", 20.f, 0, 15 },
+			{ "turn left", -45.f, 0, 15 },
+			{ "turn right", 45.f, 0, 15 },
+			{ "hard left", -90.f, 0, 15 },
+			{ "hard right", 90.f, 0, 15 },
+			{ "jump", 0.f, EHeadlessButton::Jump, 15 },
+			{ "jump left", -20.f, EHeadlessButton::Jump, 15 },
+			{ "jump right", 20.f, EHeadlessButton::Jump, 15 },
+			{ "jump turn left", -45.f, EHeadlessButton::Jump, 15 },
+			{ "jump turn right", 45.f, EHeadlessButton::Jump, 15 },
+			{ "sprint", 0.f, EHeadlessButton::Sprint, 15 },
+			{ "crouch", 0.f, EHeadlessButton::Crouch, 15 },
+			//long enough for a climb or a mantle to play out
+			{ "hold", 0.f, 0, 30 },
+		};
+		return Actions;
+	}
+
+	const char* GetRoutePrimitiveName(int Bit)
+	{
+		static const char* Names[ERoutePrimitive::Num] = {
+			"run", "sprint", "slide", "left wall run", "right wall run", "wall jump", "wall climb", "ledge grab", "mantle", "quick mantle"
+		};
+		return Bit >= 0 && Bit < ERoutePrimitive::Num ? Names[Bit] : "";
+	}
+
+	std::string DescribeRoutePrimitives(int Primitives)
+	{
+		std::string Text;
+		for (int Bit = 0; Bit < ERoutePrimitive::Num; ++Bit)
+		{
+			if (Primitives & (1 << Bit))
+			{
+				Text += Text.empty() ? "" : ", ";
+				Text += GetRoutePrimitiveName(Bit);
+			}
+		}
+		return Text;
+	}
+
+	int FRoute::GetPrimitives() const
+	{
+		int Primitives = 0;
+		for (const FRouteSegment& Segment : Segments)
+		{
+			Primitives |= Segment.Primitives;
+		}
+		return Primitives;
+	}
+
+	bool FRoute::WriteInputTrace(const std::string& Filename) const
+	{
+		FILE* File = std::fopen(Filename.c_str(), "w");
+		if (!File)
+		{
+			return false;
+		}
+
+		//buttons in a trace are held, presses are edges. Jump and sprint are held for a single frame, crouch
+		//acts on release too so it's toggled instead, see FInputTracePlayer
+		std::fprintf(File, "time,forward,right,yaw,buttons\n");
+		bool bCrouchHeld = false;
+		for (size_t Index = 0; Index < Steps.size(); ++Index)
+		{
+			const FHeadlessInput& Input = Steps[Index].Input;
+			bCrouchHeld = bCrouchHeld != ((Input.Buttons & EHeadlessButton::Crouch) != 0);
+
+			int Buttons = bCrouchHeld ? EHeadlessButton::Crouch : 0;
+			Buttons |= Input.Buttons & (EHeadlessButton::Jump | EHeadlessButton::Sprint);
+
+			//players advance their clock before picking a frame, stamping mid step keeps frame N on step N
+			std::fprintf(File, "%.4f,%.3f,%.3f,%.3f,%d\n", (Index + 0.5f) / StepRate, 1.f, 0.f, Input.YawDelta, Buttons);
+		}
+		std::fclose(File);
+		return true;
+	}
+
+	bool FRoute::WriteSpline(const std::string& Filename, float Interval) const
+	{
+		FILE* File = std::fopen(Filename.c_str(), "w");
+		if (!File)
+		{
+			return false;
+		}
+
+		std::fprintf(File, "time,x,y,z,mode\n");
+		const int Every = std::max(1, (int)(Interval * StepRate + 0.5f));
+		for (size_t Index = 0; Index < Steps.size(); ++Index)
+		{
+			if (Index % Every == 0 || Index + 1 == Steps.size())
+			{
+				const FRouteStep& Step = Steps[Index];
+				std::fprintf(File, "%.3f,%.1f,%.1f,%.1f,%d\n", (float)(Index + 1) / StepRate, Step.Location.X, Step.Location.Y, Step.Location.Z, (int)Step.Mode);
+			}
+		}
+		std::fclose(File);
+		return true;
+	}
+
+	bool FRouteModel::FStateKey::operator==(const FStateKey& Other) const
+	{
+		for (int Index = 0; Index < 7; ++Index)
+		{
+			if (Values[Index] != Other.Values[Index])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	size_t FRouteModel::FStateKeyHash::operator()(const FStateKey& Key) const
+	{
+		uint64_t Hash = 14695981039346656037ull;
+		for (int Index = 0; Index < 7; ++Index)
+		{
+			Hash = (Hash ^ (uint32_t)Key.Values[Index]) * 1099511628211ull;
+		}
+		return (size_t)Hash;
+	}
+
+	FRouteModel::FRouteModel(const ISceneQuery& InScene, const FParkourConfig& InConfig, int InStepRate)
+		: Scene(InScene)
+		, Config(InConfig)
+		, StepRate(InStepRate)
+	{
+	}
+
+	FHeadlessSnapshot FRouteModel::MakeStart(const FVec3& Location, float Yaw) const
+	{
+		FHeadlessCharacter Character(Scene, StepRate);
+		Character.Sim.Config = Config;
+		Character.Params = Config.DefaultParams;
+		Character.Location = Location;
+		Character.Yaw = Yaw;
+		Character.PlaceOnFloor();
+
+		FHeadlessSnapshot Snapshot;
+		Character.Save(Snapshot);
+		return Snapshot;
+	}
+
+	FRouteModel::FStateKey FRouteModel::MakeKey(const FHeadlessSnapshot& State, const FRouteSettings& Settings) const
+	{
+		const float BucketDegrees = 360.f / Settings.HeadingBuckets;
+		int Heading = (int)std::floor(State.Yaw / BucketDegrees + 0.5f) % Settings.HeadingBuckets;
+		Heading += Heading < 0 ? Settings.HeadingBuckets : 0;
+
+		FStateKey Key;
+		Key.Values[0] = (int32_t)std::floor(State.Location.X / Settings.CellSize);
+		Key.Values[1] = (int32_t)std::floor(State.Location.Y / Settings.CellSize);
+		Key.Values[2] = (int32_t)std::floor(State.Location.Z / Settings.CellHeight);
+		Key.Values[3] = Heading;
+		Key.Values[4] = (int32_t)(Size2D(State.Velocity) / Settings.SpeedBand);
+		//rising, level or falling
+		Key.Values[5] = State.Velocity.Z > 100.f ? 1 : (State.Velocity.Z < -100.f ? -1 : 0);
+		Key.Values[6] = ((int)State.Movement << 8) | ((int)State.Mode << 1) | (State.bCrouched ? 1 : 0);
+		return Key;
+	}
+
+	static bool IsWallRunMode(EParkourMode Mode)
+	{
+		return Mode == EParkourMode::RightWallRun || Mode == EParkourMode::LeftWallRun;
+	}
+
+	template <typename T>
+	static void AppendBytes(std::string& Out, const T& Value)
+	{
+		Out.append(reinterpret_cast<const char*>(&Value), sizeof(T));
+	}
+
+	FRouteModel::FTransitionKey FRouteModel::MakeTransitionKey(const FHeadlessSnapshot& State, int ActionIndex)
+	{
+		//field by field down to plain values, the snapshot and FParkourState both have padding Save leaves uninitialized
+		FTransitionKey Key;
+		Key.ActionIndex = ActionIndex;
+		Key.State.reserve(sizeof(FHeadlessSnapshot));
+		AppendBytes(Key.State, State.Location);
+		AppendBytes(Key.State, State.Velocity);
+		AppendBytes(Key.State, State.PendingLaunchVelocity);
+		AppendBytes(Key.State, State.PlaneNormal);
+		AppendBytes(Key.State, State.Yaw);
+		AppendBytes(Key.State, State.Params.GravityScale);
+		AppendBytes(Key.State, State.Params.GroundFriction);
+		AppendBytes(Key.State, State.Params.BrakingDecelerationWalking);
+		AppendBytes(Key.State, State.Params.MaxWalkSpeed);
+		AppendBytes(Key.State, State.Params.MaxWalkSpeedCrouched);
+		AppendBytes(Key.State, State.StepIndex);
+		AppendBytes(Key.State, State.CooldownStep);
+		AppendBytes(Key.State, State.CooldownPeriod);
+		const FParkourState& Parkour = State.Parkour;
+		AppendBytes(Key.State, Parkour.WallRunHitNormal);
+		AppendBytes(Key.State, Parkour.PrevWallRunHitNormal);
+		AppendBytes(Key.State, Parkour.WallClimbHitNormal);
+		AppendBytes(Key.State, Parkour.MantlePosition);
+		AppendBytes(Key.State, Parkour.MantleTraceDistance);
+		AppendBytes(Key.State, Parkour.bWallRunEnabled);
+		AppendBytes(Key.State, Parkour.bWallClimbEnabled);
+		AppendBytes(Key.State, Parkour.bMantleEnabled);
+		AppendBytes(Key.State, Parkour.bMantleCheckEnabled);
+		AppendBytes(Key.State, Parkour.bSprintEnabled);
+		AppendBytes(Key.State, Parkour.bSlidingEnabled);
+		AppendBytes(Key.State, Parkour.IntentTimes);
+		AppendBytes(Key.State, Parkour.Intents);
+		AppendBytes(Key.State, Parkour.IntentHead);
+		AppendBytes(Key.State, Parkour.IntentCount);
+		AppendBytes(Key.State, State.Movement);
+		AppendBytes(Key.State, State.Mode);
+		AppendBytes(Key.State, State.bCrouched);
+		AppendBytes(Key.State, State.bPlaneConstrained);
+		AppendBytes(Key.State, State.bPendingLaunch);
+		return Key;
+	}
+
+	FRouteModel::FTransitionPtr FRouteModel::Expand(FHeadlessCharacter& Character, const FHeadlessSnapshot& State, int ActionIndex, const FRouteSettings& Settings)
+	{
+		const FTransitionKey TransitionKey = MakeTransitionKey(State, ActionIndex);
+		{
+			std::lock_guard<std::mutex> Lock(TransitionMutex);
+			const auto Found = Transitions.find(TransitionKey);
+			if (Found != Transitions.end())
+			{
+				++TransitionHits;
+				return Found->second;
+			}
+			++TransitionMisses;
+		}
+
+		const FRouteAction& Action = GetRouteActions()[ActionIndex];
+		std::shared_ptr<FTransition> Transition = std::make_shared<FTransition>();
+		Transition->Steps.reserve(Action.Steps);
+
+		Character.Restore(State);
+		for (int& Count : Character.EventCounts)
+		{
+			Count = 0;
+		}
+
+		const EParkourMode StartMode = Character.Mode;
+		for (int StepIndex = 0; StepIndex < Action.Steps; ++StepIndex)
+		{
+			//forward is relative to the yaw after the turn, same as FInputTracePlayer
+			FHeadlessInput Input;
+			Input.YawDelta = StepIndex == 0 ? Action.Turn : 0.f;
+			Input.Buttons = StepIndex == 0 ? Action.Buttons : 0;
+			const float Yaw = (Character.Yaw + Input.YawDelta) * (3.14159265358979f / 180.f);
+			Input.MoveInput = FVec3(std::cos(Yaw), std::sin(Yaw), 0.f);
+
+			Character.Step(Input);
+
+			if (!std::isfinite(Character.Location.X) || !std::isfinite(Character.Location.Y) || !std::isfinite(Character.Location.Z))
+			{
+				Transition->bDead = true;
+				break;
+			}
+
+			FRouteStep Step;
+			Step.Location = Character.Location;
+			Step.Input = Input;
+			Step.Mode = Character.Mode;
+			Step.Movement = Character.Movement;
+			Transition->Steps.push_back(Step);
+
+			switch (Character.Mode)
+			{
+			case EParkourMode::Sprint: Transition->Primitives |= ERoutePrimitive::Sprint; break;
+			case EParkourMode::Slide: Transition->Primitives |= ERoutePrimitive::Slide; break;
+			case EParkourMode::LeftWallRun: Transition->Primitives |= ERoutePrimitive::LeftWallRun; break;
+			case EParkourMode::RightWallRun: Transition->Primitives |= ERoutePrimitive::RightWallRun; break;
+			case EParkourMode::WallClimb: Transition->Primitives |= ERoutePrimitive::WallClimb; break;
+			case EParkourMode::LedgeGrab: Transition->Primitives |= ERoutePrimitive::LedgeGrab; break;
+			default: break;
+			}
+		}
+
+		if (IsWallRunMode(StartMode) && (Action.Buttons & EHeadlessButton::Jump))
+		{
+			Transition->Primitives |= ERoutePrimitive::WallJump;
+		}
+		if (Character.EventCounts[(int)EParkourEvent::Mantled] > 0)
+		{
+			Transition->Primitives |= ERoutePrimitive::Mantle;
+		}
+		if (Character.EventCounts[(int)EParkourEvent::QuickMantled] > 0)
+		{
+			Transition->Primitives |= ERoutePrimitive::QuickMantle;
+		}
+		if (Transition->Primitives == 0)
+		{
+			Transition->Primitives = ERoutePrimitive::Run;
+		}
+		Character.Save(Transition->End);
+
+		std::lock_guard<std::mutex> Lock(TransitionMutex);
+		//another thread may have filled it meanwhile, keep the first so everyone sees the same move
+		return Transitions.emplace(TransitionKey, Transition).first->second;
+	}
+
+	FRoute FRouteModel::FindRoute(const FHeadlessSnapshot& Start, const FRouteSettings& Settings)
+	{
+		struct FNode
+		{
+			FHeadlessSnapshot State;
+			FStateKey Key;
+			FTransitionPtr From;
+			int Parent = -1;
+			int ActionIndex = -1;
+			//steps of From actually taken, fewer than all of them when the goal is reached part way
+			int NumSteps = 0;
+			float Seconds = 0.f;
+			bool bGoal = false;
+		};
+
+		struct FOpenEntry
+		{
+			float Cost;
+			int Node;
+
+			//lowest cost first, then oldest node, so the order never depends on timing
+			bool operator<(const FOpenEntry& Other) const { return Cost != Other.Cost ? Cost > Other.Cost : Node > Other.Node; }
+		};
+
+		const float HeuristicSpeed = Settings.HeuristicSpeed > 0.f ? Settings.HeuristicSpeed : 1.5f * std::max(Config.SprintSpeed, Config.DefaultParams.MaxWalkSpeed);
+		const float DeltaSeconds = 1.f / StepRate;
+		const int NumActions = (int)GetRouteActions().size();
+
+		auto Heuristic = [&](const FVec3& Location)
+		{
+			const float Remaining = Distance(Location, Settings.Goal) - Settings.GoalRadius;
+			return Remaining > 0.f ? Settings.HeuristicWeight * Remaining / HeuristicSpeed : 0.f;
+		};
+
+		std::vector<FNode> Nodes;
+		std::priority_queue<FOpenEntry> Open;
+		std::unordered_set<FStateKey, FStateKeyHash> Closed;
+		std::unordered_map<FStateKey, float, FStateKeyHash> BestSeconds;
+
+		FNode Root;
+		Root.State = Start;
+		Root.Key = MakeKey(Start, Settings);
+		Root.bGoal = Heuristic(Start.Location) <= 0.f;
+		Nodes.push_back(Root);
+		Open.push(FOpenEntry{ Heuristic(Start.Location), 0 });
+
+		//one character per worker, set up once
+		const int NumThreads = std::max(1, Settings.Threads);
+		std::vector<std::unique_ptr<FHeadlessCharacter>> Characters;
+		for (int Index = 0; Index < NumThreads; ++Index)
+		{
+			Characters.emplace_back(new FHeadlessCharacter(Scene, StepRate));
+			Characters.back()->Sim.Config = Config;
+		}
+
+		FRoute Route;
+		Route.StepRate = StepRate;
+		int GoalNode = -1;
+
+		std::vector<int> Batch;
+		std::vector<FTransitionPtr> Results;
+		while (!Open.empty() && GoalNode < 0 && Route.Expansions < Settings.MaxExpansions)
+		{
+			//take the best unexpanded states
+			Batch.clear();
+			while (!Open.empty() && (int)Batch.size() < Settings.BatchSize)
+			{
+				const int NodeIndex = Open.top().Node;
+				Open.pop();
+				if (Nodes[NodeIndex].bGoal)
+				{
+					GoalNode = NodeIndex;
+					break;
+				}
+				if (Closed.insert(Nodes[NodeIndex].Key).second)
+				{
+					Batch.push_back(NodeIndex);
+				}
+			}
+			if (GoalNode >= 0 || Batch.empty())
+			{
+				break;
+			}
+			Route.Expansions += (int)Batch.size();
+
+			//every move from every state of the batch, spread over the workers
+			const int NumJobs = (int)Batch.size() * NumActions;
+			Results.assign(NumJobs, FTransitionPtr());
+			std::atomic<int> NextJob(0);
+			auto Worker = [&](int WorkerIndex)
+			{
+				for (int Job = NextJob++; Job < NumJobs; Job = NextJob++)
+				{
+					const FNode& Node = Nodes[Batch[Job / NumActions]];
+					Results[Job] = Expand(*Characters[WorkerIndex], Node.State, Job % NumActions, Settings);
+				}
+			};
+			std::vector<std::thread> Workers;
+			for (int Index = 1; Index < NumThreads && Index < NumJobs; ++Index)
+			{
+				Workers.emplace_back(Worker, Index);
+			}
+			Worker(0);
+			for (std::thread& Thread : Workers)
+			{
+				Thread.join();
+			}
+
+			//merge in job order
+			for (int Job = 0; Job < NumJobs; ++Job)
+			{
+				const FTransitionPtr& Transition = Results[Job];
+				if (Transition->bDead || Transition->Steps.empty())
+				{
+					continue;
+				}
+
+				const int ParentIndex = Batch[Job / NumActions];
+				FNode Child;
+				Child.From = Transition;
+				Child.Parent = ParentIndex;
+				Child.ActionIndex = Job % NumActions;
+				Child.NumSteps = (int)Transition->Steps.size();
+				Child.State = Transition->End;
+
+				bool bFellOut = false;
+				for (int StepIndex = 0; StepIndex < (int)Transition->Steps.size(); ++StepIndex)
+				{
+					const FVec3& Location = Transition->Steps[StepIndex].Location;
+					if (Location.Z < Settings.KillZ)
+					{
+						bFellOut = true;
+						break;
+					}
+					if (Distance(Location, Settings.Goal) <= Settings.GoalRadius)
+					{
+						Child.NumSteps = StepIndex + 1;
+						Child.bGoal = true;
+						break;
+					}
+				}
+				if (bFellOut)
+				{
+					continue;
+				}
+
+				Child.Seconds = Nodes[ParentIndex].Seconds + Child.NumSteps * DeltaSeconds;
+				Child.Key = MakeKey(Child.State, Settings);
+				if (!Child.bGoal)
+				{
+					if (Closed.count(Child.Key))
+					{
+						continue;
+					}
+					const auto Best = BestSeconds.find(Child.Key);
+					if (Best != BestSeconds.end() && Best->second <= Child.Seconds)
+					{
+						continue;
+					}
+					BestSeconds[Child.Key] = Child.Seconds;
+				}
+
+				const float Cost = Child.Seconds + (Child.bGoal ? 0.f : Heuristic(Child.State.Location));
+				Nodes.push_back(Child);
+				Open.push(FOpenEntry{ Cost, (int)Nodes.size() - 1 });
+			}
+		}
+
+		if (GoalNode < 0)
+		{
+			return Route;
+		}
+
+		//walk back to the start and lay the moves out in order
+		std::vector<int> Path;
+		for (int NodeIndex = GoalNode; Nodes[NodeIndex].Parent >= 0; NodeIndex = Nodes[NodeIndex].Parent)
+		{
+			Path.push_back(NodeIndex);
+		}
+		std::reverse(Path.begin(), Path.end());
+
+		for (int NodeIndex : Path)
+		{
+			const FNode& Node = Nodes[NodeIndex];
+			FRouteSegment Segment;
+			Segment.ActionIndex = Node.ActionIndex;
+			Segment.Primitives = Node.From->Primitives;
+			Segment.FirstStep = (int)Route.Steps.size();
+			//the move that reaches the goal is kept whole so the input and EndState line up for the next leg
+			Segment.NumSteps = (int)Node.From->Steps.size();
+			Route.Segments.push_back(Segment);
+			Route.Steps.insert(Route.Steps.end(), Node.From->Steps.begin(), Node.From->Steps.end());
+		}
+
+		Route.bFound = true;
+		Route.Seconds = Nodes[GoalNode].Seconds;
+		Route.EndState = Nodes[GoalNode].State;
+		return Route;
+	}
+}
@@ -0,0 +1,198 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CachedSceneQuery.h"
+#include "HeadlessCharacter.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace LevelsParkour
+{
+	/** A move the search can make: a turn and a button press, then forward held for a while */
+	struct FRouteAction
+	{
+		const char* Name;
+		//degrees added to the yaw on the first step
+		float Turn;
+		//EHeadlessButton bits pressed on the first step
+		uint8_t Buttons;
+		int Steps;
+	};
+
+	/** Every move the search tries from each state */
+	const std::vector<FRouteAction>& GetRouteActions();
+
+	/** Parkour primitives seen during a move, bit flags */
+	namespace ERoutePrimitive
+	{
+		enum Type : uint16_t
+		{
+			Run = 1 << 0,
+			Sprint = 1 << 1,
+			Slide = 1 << 2,
+			LeftWallRun = 1 << 3,
+			RightWallRun = 1 << 4,
+			WallJump = 1 << 5,
+			WallClimb = 1 << 6,
+			LedgeGrab = 1 << 7,
+			Mantle = 1 << 8,
+			QuickMantle = 1 << 9,
+			Num = 10
+		};
+	}
+
+	/** Name of one primitive bit */
+	const char* GetRoutePrimitiveName(int Bit);
+
+	/** Comma separated names of every primitive in Primitives */
+	std::string DescribeRoutePrimitives(int Primitives);
+
+	/** One step of a route */
+	struct FRouteStep
+	{
+		FVec3 Location;
+		FHeadlessInput Input;
+		EParkourMode Mode = EParkourMode::None;
+		EBaseMovement Movement = EBaseMovement::Walking;
+	};
+
+	/** One move of a route */
+	struct FRouteSegment
+	{
+		int ActionIndex = 0;
+		int Primitives = 0;
+		int FirstStep = 0;
+		int NumSteps = 0;
+	};
+
+	/** A route found by FRouteModel::FindRoute */
+	struct FRoute
+	{
+		bool bFound = false;
+		//when the goal was reached, the last move carries on a little past it
+		float Seconds = 0.f;
+		int StepRate = 60;
+		int Expansions = 0;
+		std::vector<FRouteStep> Steps;
+		std::vector<FRouteSegment> Segments;
+		//where the route ends, for starting the next leg
+		FHeadlessSnapshot EndState;
+
+		int GetPrimitives() const;
+
+		/** Writes the route's input as a time,forward,right,yaw,buttons trace the game can replay */
+		bool WriteInputTrace(const std::string& Filename) const;
+
+		/** Writes "time,x,y,z,mode" points every Interval seconds, for building a spline in the editor */
+		bool WriteSpline(const std::string& Filename, float Interval) const;
+	};
+
+	/** One search */
+	struct FRouteSettings
+	{
+		FVec3 Goal;
+		float GoalRadius = 150.f;
+
+		//the search treats states in the same cell, heading, speed band and mode as the same state
+		float CellSize = 100.f;
+		float CellHeight = 50.f;
+		int HeadingBuckets = 8;
+		float SpeedBand = 400.f;
+
+		//how fast the heuristic assumes the character can go, 0 for one and a half times the sprint speed
+		float HeuristicSpeed = 0.f;
+		//above 1 trusts the heuristic more: far fewer states for a route that may be a little slower than the best
+		float HeuristicWeight = 1.5f;
+
+		int MaxExpansions = 200000;
+		//states expanded together each round, fixed so the route doesn't depend on the thread count
+		int BatchSize = 32;
+		int Threads = 1;
+
+		//falling below this is a dead end
+		float KillZ = -1000.f;
+	};
+
+	/**
+	 * Searches for the fastest way between two points using the moves of GetRouteActions on the headless
+	 * character. Best-first over discretized states: each round the best BatchSize states are expanded in
+	 * parallel, every move simulated from each, and the results merged back in a fixed order.
+	 *
+	 * Moves are cached by the exact state they start from, so repeated searches over the same map share work
+	 * and a cached move always replays to the same end state; the scene traces are cached as well. Route times
+	 * are what the search found, not a proven optimum; the heuristic assumes a top speed rather than
+	 * guaranteeing a lower bound.
+	 */
+	class FRouteModel
+	{
+	public:
+		FRouteModel(const ISceneQuery& InScene, const FParkourConfig& InConfig, int InStepRate = 60);
+
+		/** Character standing at Location facing Yaw, as a search start */
+		FHeadlessSnapshot MakeStart(const FVec3& Location, float Yaw) const;
+
+		FRoute FindRoute(const FHeadlessSnapshot& Start, const FRouteSettings& Settings);
+
+		const FCachedSceneQuery& GetSceneCache() const { return Scene; }
+		uint64_t GetTransitionHits() const { return TransitionHits; }
+		uint64_t GetTransitionMisses() const { return TransitionMisses; }
+
+	private:
+		struct FStateKey
+		{
+			int32_t Values[7];
+
+			bool operator==(const FStateKey& Other) const;
+		};
+
+		struct FStateKeyHash
+		{
+			size_t operator()(const FStateKey& Key) const;
+		};
+
+		/** Every field of the start state, packed without padding, and the move taken from it */
+		struct FTransitionKey
+		{
+			std::string State;
+			int ActionIndex;
+
+			bool operator==(const FTransitionKey& Other) const { return ActionIndex == Other.ActionIndex && State == Other.State; }
+		};
+
+		struct FTransitionKeyHash
+		{
+			size_t operator()(const FTransitionKey& Key) const { return std::hash<std::string>()(Key.State) * 31 + Key.ActionIndex; }
+		};
+
+		/** What one move did */
+		struct FTransition
+		{
+			FHeadlessSnapshot End;
+			std::vector<FRouteStep> Steps;
+			int Primitives = 0;
+			bool bDead = false;
+		};
+
+		typedef std::shared_ptr<const FTransition> FTransitionPtr;
+
+		FCachedSceneQuery Scene;
+		FParkourConfig Config;
+		int StepRate;
+
+		std::mutex TransitionMutex;
+		std::unordered_map<FTransitionKey, FTransitionPtr, FTransitionKeyHash> Transitions;
+		uint64_t TransitionHits = 0;
+		uint64_t TransitionMisses = 0;
+
+		FStateKey MakeKey(const FHeadlessSnapshot& State, const FRouteSettings& Settings) const;
+
+		static FTransitionKey MakeTransitionKey(const FHeadlessSnapshot& State, int ActionIndex);
+
+		/** Runs one move from State, or returns the cached result */
+		FTransitionPtr Expand(FHeadlessCharacter& Character, const FHeadlessSnapshot& State, int ActionIndex, const FRouteSettings& Settings);
+	};
+}
@@ -0,0 +1,206 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ParkourRoute.h"
+#include "BoxScene.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+using namespace LevelsParkour;
+
+//Finds the fastest route through a map with the parkour moves, for level validation and par times.
+//
+//  ParkourRoute --scene Saved/Parkour/Demonstration.boxes --from 0,0,100 --to 4000,1200,300 --out-trace par.csv
+//
+//Scenes are box files, written for a map by the LevelsSceneExport commandlet. Several --to points make a
+//route through checkpoints, each leg starting where the last one ended. The input trace replays in game with
+//-LevelsInputTrace=<file>, the spline file has a point every tenth of a second.
+//
+//Exits with 2 when a leg can't be reached or the route is slower than --par, so it can gate a build.
+
+static void PrintUsage()
+{
+	std::printf(
+		"usage: ParkourRoute --scene <file.boxes> --from x,y,z[,yaw] --to x,y,z [--to x,y,z ...] [options]\n"
+		"  --radius <r>           how close counts as reaching a point (default 150)\n"
+		"  --cell <size>          search cell size (default 100)\n"
+		"  --threads <n>          worker threads (default: all cores)\n"
+		"  --batch <n>            states expanded per round (default 32)\n"
+		"  --max-expansions <n>   gives up on a leg after this many states (default 200000)\n"
+		"  --weight <w>           heuristic weight, 1 for the fastest route at many times the cost (default 1.5)\n"
+		"  --par <seconds>        fail if the route takes longer\n"
+		"  --out-trace <file>     input trace of the route\n"
+		"  --out-spline <file>    points along the route\n");
+}
+
+static bool ParseVector(const char* Text, FVec3& OutVector, float* OutYaw)
+{
+	float Yaw = 0.f;
+	const int Count = std::sscanf(Text, "%f,%f,%f,%f", &OutVector.X, &OutVector.Y, &OutVector.Z, &Yaw);
+	if (OutYaw)
+	{
+		*OutYaw = Yaw;
+	}
+	return Count >= 3;
+}
+
+int main(int argc, char** argv)
+{
+	std::string SceneFile;
+	std::string TraceFile;
+	std::string SplineFile;
+	FVec3 From;
+	float FromYaw = 0.f;
+	bool bHasFrom = false;
+	std::vector<FVec3> Checkpoints;
+	float Par = 0.f;
+
+	FRouteSettings Settings;
+	Settings.Threads = (int)std::thread::hardware_concurrency();
+
+	for (int Index = 1; Index + 1 < argc; Index += 2)
+	{
+		const char* Arg = argv[Index];
+		const char* Value = argv[Index + 1];
+
+		if (std::strcmp(Arg, "--scene") == 0)
+		{
+			SceneFile = Value;
+		}
+		else if (std::strcmp(Arg, "--from") == 0)
+		{
+			bHasFrom = ParseVector(Value, From, &FromYaw);
+		}
+		else if (std::strcmp(Arg, "--to") == 0)
+		{
+			FVec3 Checkpoint;
+			if (!ParseVector(Value, Checkpoint, nullptr))
+			{
+				PrintUsage();
+				return 1;
+			}
+			Checkpoints.push_back(Checkpoint);
+		}
+		else if (std::strcmp(Arg, "--radius") == 0)
+		{
+			Settings.GoalRadius = (float)std::atof(Value);
+		}
+		else if (std::strcmp(Arg, "--cell") == 0)
+		{
+			Settings.CellSize = (float)std::atof(Value);
+		}
+		else if (std::strcmp(Arg, "--threads") == 0)
+		{
+			Settings.Threads = std::atoi(Value);
+		}
+		else if (std::strcmp(Arg, "--batch") == 0)
+		{
+			Settings.BatchSize = std::max(1, std::atoi(Value));
+		}
+		else if (std::strcmp(Arg, "--max-expansions") == 0)
+		{
+			Settings.MaxExpansions = std::atoi(Value);
+		}
+		else if (std::strcmp(Arg, "--weight") == 0)
+		{
+			Settings.HeuristicWeight = std::max(1.f, (float)std::atof(Value));
+		}
+		else if (std::strcmp(Arg, "--par") == 0)
+		{
+			Par = (float)std::atof(Value);
+		}
+		else if (std::strcmp(Arg, "--out-trace") == 0)
+		{
+			TraceFile = Value;
+		}
+		else if (std::strcmp(Arg, "--out-spline") == 0)
+		{
+			SplineFile = Value;
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (SceneFile.empty() || !bHasFrom || Checkpoints.empty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	FBoxScene Scene;
+	if (!Scene.LoadBoxes(SceneFile))
+	{
+		std::fprintf(stderr, "could not load scene %s\n", SceneFile.c_str());
+		return 1;
+	}
+	Scene.BuildGrid();
+
+	FRouteModel Model(Scene, FParkourConfig());
+	FHeadlessSnapshot Start = Model.MakeStart(From, FromYaw);
+
+	FRoute Full;
+	Full.bFound = true;
+	const std::chrono::steady_clock::time_point Begin = std::chrono::steady_clock::now();
+
+	for (size_t Leg = 0; Leg < Checkpoints.size(); ++Leg)
+	{
+		Settings.Goal = Checkpoints[Leg];
+		const FRoute Route = Model.FindRoute(Start, Settings);
+		if (!Route.bFound)
+		{
+			std::printf("leg %zu: no route to %.0f,%.0f,%.0f after %d states\n", Leg + 1, Settings.Goal.X, Settings.Goal.Y, Settings.Goal.Z, Route.Expansions);
+			Full.bFound = false;
+			break;
+		}
+
+		std::printf("leg %zu: %.2fs, %d states, %s\n", Leg + 1, Route.Seconds, Route.Expansions, DescribeRoutePrimitives(Route.GetPrimitives()).c_str());
+		for (const FRouteSegment& Segment : Route.Segments)
+		{
+			std::printf("  %6.2fs  %-16s %s\n", (float)(Full.Steps.size() + Segment.FirstStep) / Route.StepRate, GetRouteActions()[Segment.ActionIndex].Name, DescribeRoutePrimitives(Segment.Primitives).c_str());
+		}
+
+		//legs join up on whole moves, so the time so far is the length of everything before this leg
+		Full.Seconds = (float)Full.Steps.size() / Route.StepRate + Route.Seconds;
+		Full.Expansions += Route.Expansions;
+		Full.Steps.insert(Full.Steps.end(), Route.Steps.begin(), Route.Steps.end());
+		Start = Route.EndState;
+	}
+
+	const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Begin).count();
+	const FCachedSceneQuery& Cache = Model.GetSceneCache();
+	const double TraceCount = (double)(Cache.GetHits() + Cache.GetMisses());
+	const double MoveCount = (double)(Model.GetTransitionHits() + Model.GetTransitionMisses());
+	std::printf("searched %d states in %.1fs, trace cache %.0f%% hits, move cache %.0f%% hits\n",
+		Full.Expansions, Seconds,
+		TraceCount > 0.0 ? 100.0 * Cache.GetHits() / TraceCount : 0.0,
+		MoveCount > 0.0 ? 100.0 * Model.GetTransitionHits() / MoveCount : 0.0);
+
+	if (!Full.bFound)
+	{
+		return 2;
+	}
+
+	std::printf("route: %.2fs\n", Full.Seconds);
+	if (!TraceFile.empty() && !Full.WriteInputTrace(TraceFile))
+	{
+		std::fprintf(stderr, "could not write %s\n", TraceFile.c_str());
+		return 1;
+	}
+	if (!SplineFile.empty() && !Full.WriteSpline(SplineFile, 0.1f))
+	{
+		std::fprintf(stderr, "could not write %s\n", SplineFile.c_str());
+		return 1;
+	}
+	if (Par > 0.f && Full.Seconds > Par)
+	{
+		std::printf("slower than par %.2fs\n", Par);
+		return 2;
+	}
+	return 0;
+}
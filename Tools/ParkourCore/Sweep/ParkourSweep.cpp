@@ -0,0 +1,372 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ParkourSweep.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+namespace LevelsParkour
+{
+#define SWEEP_TUNABLE(Name, Member) { Name, [](FParkourConfig& Config) -> float& { return Config.Member; } }
+
+	const std::vector<FSweepTunable>& GetSweepTunables()
+	{
+		static const std::vector<FSweepTunable> Tunables = {
+			SWEEP_TUNABLE("WallRunGravity", WallRunGravity),
+			SWEEP_TUNABLE("WallRunCooldown", WallRunCooldown),
+			SWEEP_TUNABLE("WallRunJumpCooldown", WallRunJumpCooldown),
+			SWEEP_TUNABLE("WallRunJumpHeight", WallRunJumpHeight),
+			SWEEP_TUNABLE("WallRunJumpForce", WallRunJumpForce),
+			SWEEP_TUNABLE("WallRunSpeedRequirement", WallRunSpeedRequirement),
+			SWEEP_TUNABLE("WallClimbSpeed", WallClimbSpeed),
+			SWEEP_TUNABLE("MantleSpeed", MantleSpeed),
+			SWEEP_TUNABLE("QuickMantleSpeed", QuickMantleSpeed),
+			SWEEP_TUNABLE("MantleHeight", MantleHeight),
+			SWEEP_TUNABLE("LedgeGrabJumpForce", LedgeGrabJumpForce),
+			SWEEP_TUNABLE("LedgeGrabJumpHeight", LedgeGrabJumpHeight),
+			SWEEP_TUNABLE("SlideImpulseForce", SlideImpulseForce),
+			SWEEP_TUNABLE("SprintSpeed", SprintSpeed),
+			SWEEP_TUNABLE("SlideEndSpeed", SlideEndSpeed),
+			SWEEP_TUNABLE("SlideBrakingDeceleration", SlideBrakingDeceleration),
+			SWEEP_TUNABLE("CrouchSpeed", CrouchSpeed),
+			SWEEP_TUNABLE("StartBoostSpeed", StartBoostSpeed),
+			SWEEP_TUNABLE("StartBoostAcceleration", StartBoostAcceleration),
+			SWEEP_TUNABLE("MaxWalkSpeed", DefaultParams.MaxWalkSpeed),
+			SWEEP_TUNABLE("GroundFriction", DefaultParams.GroundFriction),
+			SWEEP_TUNABLE("BrakingDecelerationWalking", DefaultParams.BrakingDecelerationWalking),
+			SWEEP_TUNABLE("GravityScale", DefaultParams.GravityScale),
+		};
+		return Tunables;
+	}
+
+#undef SWEEP_TUNABLE
+
+	const FSweepTunable* FindSweepTunable(const std::string& Name)
+	{
+		for (const FSweepTunable& Tunable : GetSweepTunables())
+		{
+			if (Name == Tunable.Name)
+			{
+				return &Tunable;
+			}
+		}
+		return nullptr;
+	}
+
+	static bool ParseFloat(const std::string& Text, float& OutValue)
+	{
+		char* End = nullptr;
+		OutValue = std::strtof(Text.c_str(), &End);
+		return End != Text.c_str() && *End == '\0';
+	}
+
+	bool FSweepAxis::Parse(const std::string& Text, FSweepAxis& OutAxis, std::string& OutError)
+	{
+		const size_t Equals = Text.find('=');
+		if (Equals == std::string::npos)
+		{
+			OutError = "expected Name=values in '" + Text + "'";
+			return false;
+		}
+
+		const std::string Name = Text.substr(0, Equals);
+		OutAxis.Tunable = FindSweepTunable(Name);
+		if (!OutAxis.Tunable)
+		{
+			OutError = "unknown tunable '" + Name + "'";
+			return false;
+		}
+
+		const std::string Values = Text.substr(Equals + 1);
+		OutAxis.Values.clear();
+
+		//Min:Max:Count
+		const size_t FirstColon = Values.find(':');
+		if (FirstColon != std::string::npos)
+		{
+			const size_t SecondColon = Values.find(':', FirstColon + 1);
+			float Min = 0.f;
+			float Max = 0.f;
+			float Count = 0.f;
+			if (SecondColon == std::string::npos
+				|| !ParseFloat(Values.substr(0, FirstColon), Min)
+				|| !ParseFloat(Values.substr(FirstColon + 1, SecondColon - FirstColon - 1), Max)
+				|| !ParseFloat(Values.substr(SecondColon + 1), Count)
+				|| Count < 1.f)
+			{
+				OutError = "expected Min:Max:Count in '" + Text + "'";
+				return false;
+			}
+
+			const int Steps = (int)Count;
+			for (int Index = 0; Index < Steps; ++Index)
+			{
+				OutAxis.Values.push_back(Steps == 1 ? Min : Min + (Max - Min) * Index / (Steps - 1));
+			}
+			return true;
+		}
+
+		//comma separated list
+		size_t Begin = 0;
+		while (Begin <= Values.size())
+		{
+			size_t Comma = Values.find(',', Begin);
+			if (Comma == std::string::npos)
+			{
+				Comma = Values.size();
+			}
+
+			float Value = 0.f;
+			if (!ParseFloat(Values.substr(Begin, Comma - Begin), Value))
+			{
+				OutError = "bad value list in '" + Text + "'";
+				return false;
+			}
+			OutAxis.Values.push_back(Value);
+			Begin = Comma + 1;
+		}
+		return true;
+	}
+
+	size_t FSweepGrid::GetNumPoints() const
+	{
+		size_t Count = 1;
+		for (const FSweepAxis& Axis : Axes)
+		{
+			Count *= Axis.Values.size();
+		}
+		return Count;
+	}
+
+	float FSweepGrid::GetValue(size_t PointIndex, size_t AxisIndex) const
+	{
+		//last axis changes fastest
+		for (size_t Index = Axes.size(); Index-- > AxisIndex + 1;)
+		{
+			PointIndex /= Axes[Index].Values.size();
+		}
+		const std::vector<float>& Values = Axes[AxisIndex].Values;
+		return Values[PointIndex % Values.size()];
+	}
+
+	FParkourConfig FSweepGrid::MakeConfig(const FParkourConfig& Base, size_t PointIndex) const
+	{
+		FParkourConfig Config = Base;
+		for (size_t AxisIndex = 0; AxisIndex < Axes.size(); ++AxisIndex)
+		{
+			Axes[AxisIndex].Tunable->Get(Config) = GetValue(PointIndex, AxisIndex);
+		}
+		return Config;
+	}
+
+	bool FSweepGrid::Load(const std::string& Filename, std::string& OutError)
+	{
+		std::ifstream File(Filename);
+		if (!File)
+		{
+			OutError = "can't open " + Filename;
+			return false;
+		}
+
+		std::string Line;
+		while (std::getline(File, Line))
+		{
+			//strip whitespace, axes never contain any
+			std::string Text;
+			for (char Character : Line)
+			{
+				if (Character == '#')
+				{
+					break;
+				}
+				if (Character != ' ' && Character != '\t' && Character != '\r')
+				{
+					Text += Character;
+				}
+			}
+			if (Text.empty())
+			{
+				continue;
+			}
+
+			FSweepAxis Axis;
+			if (!FSweepAxis::Parse(Text, Axis, OutError))
+			{
+				OutError = Filename + ": " + OutError;
+				return false;
+			}
+			Axes.push_back(Axis);
+		}
+		return true;
+	}
+
+	void FSweepPointResult::Add(const FSweepRunMetrics& Run)
+	{
+		++Runs;
+		Failures += Run.bFailed ? 1 : 0;
+		Seconds += Run.Seconds;
+		AirSeconds += Run.AirSeconds;
+		Distance += Run.Distance;
+		WallRuns += Run.WallRuns;
+		WallJumps += Run.WallJumps;
+		WallJumpSpeedRetained += Run.WallJumpSpeedRetained;
+		Mantles += Run.Mantles;
+		Slides += Run.Slides;
+	}
+
+	static bool IsWallRunMode(EParkourMode Mode)
+	{
+		return Mode == EParkourMode::RightWallRun || Mode == EParkourMode::LeftWallRun;
+	}
+
+	static bool IsFinite(const FVec3& V)
+	{
+		return std::isfinite(V.X) && std::isfinite(V.Y) && std::isfinite(V.Z);
+	}
+
+	FSweepRunMetrics RunSweepSimulation(const FBoxScene& Scene, const FParkourConfig& Config, const FInputTrace& Trace, const FSweepSettings& Settings)
+	{
+		FHeadlessCharacter Character(Scene, Settings.StepRate);
+		Character.Sim.Config = Config;
+		Character.Params = Config.DefaultParams;
+		Character.Location = Settings.Start;
+		Character.Yaw = Settings.StartYaw;
+		Character.PlaceOnFloor();
+
+		FInputTracePlayer Player(Trace);
+		FSweepRunMetrics Metrics;
+
+		const float DeltaSeconds = Character.GetDeltaSeconds();
+		const int MaxSteps = (int)(Settings.MaxSeconds * Settings.StepRate);
+		const int StuckSteps = (int)(Settings.StuckSeconds * Settings.StepRate);
+
+		FVec3 StuckCheckLocation = Character.Location;
+		int StuckCheckStep = 0;
+		bool bHeldDirection = true;
+
+		for (int StepIndex = 0; StepIndex < MaxSteps && !Player.IsFinished(); ++StepIndex)
+		{
+			const FHeadlessInput Input = Player.Next(Character);
+			const FVec3 PreviousLocation = Character.Location;
+			const float PreviousSpeed = Size2D(Character.Velocity);
+			const EParkourMode PreviousMode = Character.Mode;
+			const int PreviousMantles = Character.EventCounts[(int)EParkourEvent::Mantled] + Character.EventCounts[(int)EParkourEvent::QuickMantled];
+			const int PreviousSlides = Character.EventCounts[(int)EParkourEvent::SlideStarted];
+
+			Character.Step(Input);
+			Metrics.Seconds += DeltaSeconds;
+
+			if (!IsFinite(Character.Location) || !IsFinite(Character.Velocity) || Character.Location.Z < Settings.KillZ)
+			{
+				Metrics.bFailed = true;
+				break;
+			}
+
+			Metrics.Distance += Size2D(Character.Location - PreviousLocation);
+			Metrics.AirSeconds += Character.Movement == EBaseMovement::Falling ? DeltaSeconds : 0.f;
+			Metrics.Mantles += Character.EventCounts[(int)EParkourEvent::Mantled] + Character.EventCounts[(int)EParkourEvent::QuickMantled] - PreviousMantles;
+			Metrics.Slides += Character.EventCounts[(int)EParkourEvent::SlideStarted] - PreviousSlides;
+
+			if (IsWallRunMode(Character.Mode) && !IsWallRunMode(PreviousMode))
+			{
+				++Metrics.WallRuns;
+			}
+			//a jump that took the character off a wall, the launch is already in the velocity
+			if (IsWallRunMode(PreviousMode) && !IsWallRunMode(Character.Mode) && (Input.Buttons & EHeadlessButton::Jump))
+			{
+				++Metrics.WallJumps;
+				Metrics.WallJumpSpeedRetained += Size2D(Character.Velocity) / (PreviousSpeed > 1.f ? PreviousSpeed : 1.f);
+			}
+
+			//stuck against something while trying to move
+			bHeldDirection = bHeldDirection && SizeSquared(Input.MoveInput) > 0.f;
+			if (StepIndex - StuckCheckStep >= StuckSteps)
+			{
+				if (bHeldDirection && Distance(Character.Location, StuckCheckLocation) < Settings.StuckDistance)
+				{
+					Metrics.bFailed = true;
+					break;
+				}
+				StuckCheckLocation = Character.Location;
+				StuckCheckStep = StepIndex;
+				bHeldDirection = true;
+			}
+		}
+		return Metrics;
+	}
+
+	std::vector<FSweepPointResult> RunSweep(const FBoxScene& Scene, const FParkourConfig& Base, const FSweepGrid& Grid, const std::vector<FInputTrace>& Traces, const FSweepSettings& Settings, int Threads)
+	{
+		const size_t NumPoints = Grid.GetNumPoints();
+		std::vector<FSweepPointResult> Results(NumPoints);
+
+		//workers take grid points one at a time, each writes only its own slot
+		std::atomic<size_t> NextPoint(0);
+		auto Worker = [&]()
+		{
+			for (size_t PointIndex = NextPoint++; PointIndex < NumPoints; PointIndex = NextPoint++)
+			{
+				const FParkourConfig Config = Grid.MakeConfig(Base, PointIndex);
+				for (const FInputTrace& Trace : Traces)
+				{
+					Results[PointIndex].Add(RunSweepSimulation(Scene, Config, Trace, Settings));
+				}
+			}
+		};
+
+		const int NumThreads = Threads > 1 ? Threads : 1;
+		std::vector<std::thread> Workers;
+		for (int Index = 1; Index < NumThreads; ++Index)
+		{
+			Workers.emplace_back(Worker);
+		}
+		Worker();
+		for (std::thread& Thread : Workers)
+		{
+			Thread.join();
+		}
+		return Results;
+	}
+
+	FBoxScene MakeSweepCourse()
+	{
+		FBoxScene Scene;
+		Scene.AddBox(FBox(FVec3(-12000.f, -12000.f, -100.f), FVec3(12000.f, 12000.f, 0.f)));
+
+		//a lattice of walls and ledges so wandering traces keep running into something, the
+		//first cell is skipped to leave room at the start
+		const float Spacing = 1500.f;
+		for (int X = -6; X <= 6; ++X)
+		{
+			for (int Y = -6; Y <= 6; ++Y)
+			{
+				if (X == 0 && Y == 0)
+				{
+					continue;
+				}
+
+				const FVec3 Center(X * Spacing, Y * Spacing, 0.f);
+				const int Variant = (X * 7 + Y * 13) & 3;
+
+				//walls alternate direction so runs start from any heading
+				if ((X + Y) & 1)
+				{
+					Scene.AddBox(FBox(Center + FVec3(-500.f, 300.f, 0.f), Center + FVec3(500.f, 350.f, 600.f)));
+				}
+				else
+				{
+					Scene.AddBox(FBox(Center + FVec3(300.f, -500.f, 0.f), Center + FVec3(350.f, 500.f, 600.f)));
+				}
+
+				//ledges from a quick mantle up to a full ledge grab
+				const float LedgeHeight = 90.f + 40.f * Variant;
+				Scene.AddBox(FBox(Center + FVec3(-450.f, -450.f, 0.f), Center + FVec3(-150.f, -150.f, LedgeHeight)));
+			}
+		}
+
+		Scene.BuildGrid();
+		return Scene;
+	}
+}
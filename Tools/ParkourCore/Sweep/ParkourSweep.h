@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "BoxScene.h"
+#include "InputTrace.h"
+#include <string>
+#include <vector>
+
+namespace LevelsParkour
+{
+	/** A tunable the sweep can vary, by the name designers know from the component */
+	struct FSweepTunable
+	{
+		const char* Name;
+		float& (*Get)(FParkourConfig& Config);
+	};
+
+	/** Every tunable the sweep knows about */
+	const std::vector<FSweepTunable>& GetSweepTunables();
+
+	/** Finds a tunable by name, nullptr if there is none */
+	const FSweepTunable* FindSweepTunable(const std::string& Name);
+
+	/** One axis of the grid: a tunable and the values to try */
+	struct FSweepAxis
+	{
+		const FSweepTunable* Tunable = nullptr;
+		std::vector<float> Values;
+
+		/**
+		 * Parses "Name=1,2,3" for a list or "Name=Min:Max:Count" for evenly spaced values. Returns false and
+		 * fills OutError if the name is unknown or the values don't parse.
+		 */
+		static bool Parse(const std::string& Text, FSweepAxis& OutAxis, std::string& OutError);
+	};
+
+	/** Every combination of the axes' values */
+	struct FSweepGrid
+	{
+		std::vector<FSweepAxis> Axes;
+
+		size_t GetNumPoints() const;
+
+		/** Base with the values of one grid point applied, points are numbered with the last axis changing fastest */
+		FParkourConfig MakeConfig(const FParkourConfig& Base, size_t PointIndex) const;
+
+		/** Value of one axis at a grid point */
+		float GetValue(size_t PointIndex, size_t AxisIndex) const;
+
+		/** Reads axes from a file, one per line in FSweepAxis::Parse format, # for comments */
+		bool Load(const std::string& Filename, std::string& OutError);
+	};
+
+	/** What happened in one simulation */
+	struct FSweepRunMetrics
+	{
+		float Seconds = 0.f;
+		float AirSeconds = 0.f;
+		float Distance = 0.f;
+		int WallRuns = 0;
+		int WallJumps = 0;
+		//horizontal speed after each wall jump over the speed before it, summed
+		float WallJumpSpeedRetained = 0.f;
+		int Mantles = 0;
+		int Slides = 0;
+		bool bFailed = false;
+	};
+
+	/** Metrics of one grid point over every trace */
+	struct FSweepPointResult
+	{
+		int Runs = 0;
+		int Failures = 0;
+		float AirSeconds = 0.f;
+		float Distance = 0.f;
+		float Seconds = 0.f;
+		int WallRuns = 0;
+		int WallJumps = 0;
+		float WallJumpSpeedRetained = 0.f;
+		int Mantles = 0;
+		int Slides = 0;
+
+		void Add(const FSweepRunMetrics& Run);
+
+		float GetFailureRate() const { return Runs > 0 ? (float)Failures / Runs : 0.f; }
+		float GetAverageSpeedRetained() const { return WallJumps > 0 ? WallJumpSpeedRetained / WallJumps : 0.f; }
+	};
+
+	/** Setup shared by every simulation of a sweep */
+	struct FSweepSettings
+	{
+		FVec3 Start = FVec3(0.f, 0.f, 200.f);
+		float StartYaw = 0.f;
+		//simulations stop here even if the trace is longer
+		float MaxSeconds = 30.f;
+		int StepRate = 60;
+		//falling below this counts as a failure
+		float KillZ = -1000.f;
+		//moving less than StuckDistance over StuckSeconds while holding a direction counts as a failure
+		float StuckSeconds = 3.f;
+		float StuckDistance = 50.f;
+	};
+
+	/** Runs one trace with one config */
+	FSweepRunMetrics RunSweepSimulation(const FBoxScene& Scene, const FParkourConfig& Config, const FInputTrace& Trace, const FSweepSettings& Settings);
+
+	/**
+	 * Runs every grid point against every trace, spread over Threads worker threads. Results come back in grid
+	 * order whatever the thread count, so two sweeps of the same inputs give the same file.
+	 */
+	std::vector<FSweepPointResult> RunSweep(const FBoxScene& Scene, const FParkourConfig& Base, const FSweepGrid& Grid, const std::vector<FInputTrace>& Traces, const FSweepSettings& Settings, int Threads);
+
+	/** Test course of runnable walls, ledges and gaps, used when no scene file is given */
+	FBoxScene MakeSweepCourse();
+}
@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ParkourSweep.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+using namespace LevelsParkour;
+
+//Batch tuning for the parkour movement. Runs every combination of the given tunables against every input
+//trace on the headless character and writes one CSV row of metrics per combination.
+//
+//  ParkourSweep --grid Sweep/ExampleGrid.txt --scripted 16 --out sweep.csv
+//  ParkourSweep --param SprintSpeed=1200:1800:7 --param WallRunJumpForce=0.9,1.1,1.3 --trace run.csv
+//
+//Traces are the CSVs the game records and replays (FLevelsInputFrame), --scripted adds seeded runs of the
+//bot script. Without --scene the built-in course is used, --scene takes a box file (see FBoxScene::LoadBoxes).
+
+static void PrintUsage()
+{
+	std::printf(
+		"usage: ParkourSweep [options]\n"
+		"  --grid <file>          tunables to vary, one Name=values per line\n"
+		"  --param <Name=values>  a tunable to vary, values are a,b,c or Min:Max:Count\n"
+		"  --trace <file.csv>     input trace to run, repeatable\n"
+		"  --scripted <count>     adds this many seeded bot script traces (default 8 if no --trace)\n"
+		"  --seconds <s>          length of scripted traces and cap on every run (default 30)\n"
+		"  --scene <file>         box file to run in instead of the built-in course\n"
+		"  --threads <n>          worker threads (default: all cores)\n"
+		"  --out <file.csv>       results, default stdout\n"
+		"  --list                 prints the tunables and their defaults\n");
+}
+
+static void ListTunables()
+{
+	FParkourConfig Defaults;
+	for (const FSweepTunable& Tunable : GetSweepTunables())
+	{
+		std::printf("%-28s %g\n", Tunable.Name, Tunable.Get(Defaults));
+	}
+}
+
+static void WriteResults(FILE* File, const FSweepGrid& Grid, const std::vector<FSweepPointResult>& Results)
+{
+	for (const FSweepAxis& Axis : Grid.Axes)
+	{
+		std::fprintf(File, "%s,", Axis.Tunable->Name);
+	}
+	std::fprintf(File, "runs,failure_rate,air_seconds,distance,speed,wall_runs,wall_jumps,wall_jump_speed_retained,mantles,slides\n");
+
+	for (size_t PointIndex = 0; PointIndex < Results.size(); ++PointIndex)
+	{
+		for (size_t AxisIndex = 0; AxisIndex < Grid.Axes.size(); ++AxisIndex)
+		{
+			std::fprintf(File, "%g,", Grid.GetValue(PointIndex, AxisIndex));
+		}
+
+		//per run averages so sweeps with different trace counts compare
+		const FSweepPointResult& Result = Results[PointIndex];
+		const float Runs = Result.Runs > 0 ? (float)Result.Runs : 1.f;
+		std::fprintf(File, "%d,%.3f,%.2f,%.0f,%.0f,%.2f,%.2f,%.3f,%.2f,%.2f\n",
+			Result.Runs,
+			Result.GetFailureRate(),
+			Result.AirSeconds / Runs,
+			Result.Distance / Runs,
+			Result.Seconds > 0.f ? Result.Distance / Result.Seconds : 0.f,
+			Result.WallRuns / Runs,
+			Result.WallJumps / Runs,
+			Result.GetAverageSpeedRetained(),
+			Result.Mantles / Runs,
+			Result.Slides / Runs);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	FSweepGrid Grid;
+	FSweepSettings Settings;
+	std::vector<FInputTrace> Traces;
+	int ScriptedCount = -1;
+	int Threads = (int)std::thread::hardware_concurrency();
+	std::string SceneFile;
+	std::string OutFile;
+	std::string Error;
+
+	for (int Index = 1; Index < argc; ++Index)
+	{
+		const char* Arg = argv[Index];
+		const char* Value = Index + 1 < argc ? argv[Index + 1] : nullptr;
+		const bool bHasValue = Value != nullptr;
+
+		if (std::strcmp(Arg, "--list") == 0)
+		{
+			ListTunables();
+			return 0;
+		}
+		if (std::strcmp(Arg, "--help") == 0 || !bHasValue)
+		{
+			PrintUsage();
+			return std::strcmp(Arg, "--help") == 0 ? 0 : 1;
+		}
+
+		++Index;
+		if (std::strcmp(Arg, "--grid") == 0)
+		{
+			if (!Grid.Load(Value, Error))
+			{
+				std::fprintf(stderr, "%s\n", Error.c_str());
+				return 1;
+			}
+		}
+		else if (std::strcmp(Arg, "--param") == 0)
+		{
+			FSweepAxis Axis;
+			if (!FSweepAxis::Parse(Value, Axis, Error))
+			{
+				std::fprintf(stderr, "%s\n", Error.c_str());
+				return 1;
+			}
+			Grid.Axes.push_back(Axis);
+		}
+		else if (std::strcmp(Arg, "--trace") == 0)
+		{
+			FInputTrace Trace;
+			if (!Trace.Load(Value))
+			{
+				std::fprintf(stderr, "could not load input trace %s\n", Value);
+				return 1;
+			}
+			Traces.push_back(Trace);
+		}
+		else if (std::strcmp(Arg, "--scripted") == 0)
+		{
+			ScriptedCount = std::atoi(Value);
+		}
+		else if (std::strcmp(Arg, "--seconds") == 0)
+		{
+			Settings.MaxSeconds = (float)std::atof(Value);
+		}
+		else if (std::strcmp(Arg, "--scene") == 0)
+		{
+			SceneFile = Value;
+		}
+		else if (std::strcmp(Arg, "--threads") == 0)
+		{
+			Threads = std::atoi(Value);
+		}
+		else if (std::strcmp(Arg, "--out") == 0)
+		{
+			OutFile = Value;
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (ScriptedCount < 0)
+	{
+		ScriptedCount = Traces.empty() ? 8 : 0;
+	}
+	for (int Seed = 0; Seed < ScriptedCount; ++Seed)
+	{
+		Traces.push_back(FInputTrace::MakeScripted((uint32_t)Seed, Settings.MaxSeconds, Settings.StepRate));
+	}
+	if (Traces.empty())
+	{
+		std::fprintf(stderr, "nothing to run, give --trace or --scripted\n");
+		return 1;
+	}
+
+	FBoxScene Scene;
+	if (SceneFile.empty())
+	{
+		Scene = MakeSweepCourse();
+	}
+	else
+	{
+		if (!Scene.LoadBoxes(SceneFile))
+		{
+			std::fprintf(stderr, "could not load scene %s\n", SceneFile.c_str());
+			return 1;
+		}
+		Scene.BuildGrid();
+	}
+
+	const size_t NumPoints = Grid.GetNumPoints();
+	std::fprintf(stderr, "%zu parameter sets x %zu traces on %d threads\n", NumPoints, Traces.size(), Threads > 1 ? Threads : 1);
+
+	const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+	const std::vector<FSweepPointResult> Results = RunSweep(Scene, FParkourConfig(), Grid, Traces, Settings, Threads);
+	const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+	double SimulatedSeconds = 0.0;
+	for (const FSweepPointResult& Result : Results)
+	{
+		SimulatedSeconds += Result.Seconds;
+	}
+	std::fprintf(stderr, "%zu simulations in %.1fs, %.0f simulated seconds per second\n", NumPoints * Traces.size(), Seconds, Seconds > 0.0 ? SimulatedSeconds / Seconds : 0.0);
+
+	FILE* File = OutFile.empty() ? stdout : std::fopen(OutFile.c_str(), "w");
+	if (!File)
+	{
+		std::fprintf(stderr, "could not write %s\n", OutFile.c_str());
+		return 1;
+	}
+	WriteResults(File, Grid, Results);
+	if (File != stdout)
+	{
+		std::fclose(File);
+	}
+	return 0;
+}
@@ -0,0 +1,572 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ParkourSim.h"
+#include "BoxScene.h"
+#include "HeadlessCharacter.h"
+#include "ParkourSweep.h"
+#include "ParkourRoute.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace LevelsParkour;
+
+//Minimal test runner, the core has no dependencies and the tests keep it that way
+
+struct FTestCase
+{
+	const char* Name;
+	void (*Function)();
+};
+
+static std::vector<FTestCase>& GetTests()
+{
+	static std::vector<FTestCase> Tests;
+	return Tests;
+}
+
+struct FTestRegistrar
+{
+	FTestRegistrar(const char* Name, void (*Function)()) { GetTests().push_back(FTestCase{ Name, Function }); }
+};
+
+static int FailureCount = 0;
+
+#define PARKOUR_TEST(Name) \
+	static void Name(); \
+	static FTestRegistrar Name##Registrar(#Name, &Name); \
+	static void Name()
+
+#define EXPECT_TRUE(Condition) \
+	do { if (!(Condition)) { std::printf("  %s:%d: expected %s\n", __FILE__, __LINE__, #Condition); ++FailureCount; } } while (0)
+
+#define EXPECT_NEAR(Actual, Expected, Tolerance) \
+	do { const double ActualValue = (Actual), ExpectedValue = (Expected); if (std::fabs(ActualValue - ExpectedValue) > (Tolerance)) { std::printf("  %s:%d: %s is %f, expected %f\n", __FILE__, __LINE__, #Actual, ActualValue, ExpectedValue); ++FailureCount; } } while (0)
+
+#define EXPECT_VEC_NEAR(Actual, Expected, Tolerance) \
+	do { const FVec3 ActualVector = (Actual), ExpectedVector = (Expected); EXPECT_NEAR(ActualVector.X, ExpectedVector.X, Tolerance); EXPECT_NEAR(ActualVector.Y, ExpectedVector.Y, Tolerance); EXPECT_NEAR(ActualVector.Z, ExpectedVector.Z, Tolerance); } while (0)
+
+//Scenario helpers
+
+static FBoxScene MakeFloorScene()
+{
+	FBoxScene Scene;
+	Scene.AddBox(FBox(FVec3(-5000.f, -5000.f, -100.f), FVec3(5000.f, 5000.f, 0.f)));
+	return Scene;
+}
+
+static FHeadlessInput Forward(uint8_t Buttons = 0)
+{
+	FHeadlessInput Input;
+	Input.MoveInput = FVec3(1.f, 0.f, 0.f);
+	Input.Buttons = Buttons;
+	return Input;
+}
+
+static void RunForward(FHeadlessCharacter& Character, int Steps)
+{
+	for (int Index = 0; Index < Steps; ++Index)
+	{
+		Character.Step(Forward());
+	}
+}
+
+//Pure functions
+
+PARKOUR_TEST(WallRunProbeReachesSidewaysAndBack)
+{
+	FParkourConfig Config;
+	const FWallRunProbe Probe = ComputeWallRunProbe(Config, FVec3(100.f, 0.f, 50.f), FVec3(1.f, 0.f, 0.f), FVec3(0.f, 1.f, 0.f));
+
+	EXPECT_VEC_NEAR(Probe.Start, FVec3(100.f, 0.f, 50.f), 1e-4);
+	EXPECT_VEC_NEAR(Probe.RightEnd, FVec3(65.f, 75.f, 50.f), 1e-4);
+	EXPECT_VEC_NEAR(Probe.LeftEnd, FVec3(65.f, -75.f, 50.f), 1e-4);
+}
+
+PARKOUR_TEST(WallRunNormalMustBeUpright)
+{
+	FParkourConfig Config;
+	EXPECT_TRUE(IsWallRunnableNormal(Config, FVec3(0.f, -1.f, 0.f)));
+	EXPECT_TRUE(IsWallRunnableNormal(Config, FVec3(0.f, -0.86f, 0.51f)));
+	EXPECT_TRUE(IsWallRunnableNormal(Config, FVec3(0.f, -0.86f, -0.51f)));
+	EXPECT_TRUE(!IsWallRunnableNormal(Config, FVec3(0.f, -0.85f, 0.52f)));
+	EXPECT_TRUE(!IsWallRunnableNormal(Config, FVec3(0.f, -0.85f, -0.52f)));
+	EXPECT_TRUE(!IsWallRunnableNormal(Config, FVec3(0.f, 0.f, 1.f)));
+}
+
+PARKOUR_TEST(CornerTransitionRejectsRightAngles)
+{
+	const FVec3 Wall(0.f, -0.999f, 0.04f);
+	const FVec3 Perpendicular(-0.999f, 0.f, 0.04f);
+	const FVec3 Curved(0.26f, -0.96f, 0.04f);
+
+	EXPECT_TRUE(IsCornerTransition(Wall, Perpendicular));
+	EXPECT_TRUE(!IsCornerTransition(Wall, Curved));
+	EXPECT_TRUE(!IsCornerTransition(Wall, Wall));
+	//no previous wall, nothing to compare against
+	EXPECT_TRUE(!IsCornerTransition(FVec3(), Perpendicular));
+}
+
+PARKOUR_TEST(MantleProbeSpansEyesToKnees)
+{
+	FParkourConfig Config;
+	const FMantleProbe Probe = ComputeMantleProbe(Config, FVec3(0.f, 0.f, 164.f), FVec3(0.f, 0.f, 100.f), FVec3(0.f, 1.f, 0.f), 96.f);
+
+	EXPECT_VEC_NEAR(Probe.Eye, FVec3(0.f, 50.f, 214.f), 1e-4);
+	EXPECT_VEC_NEAR(Probe.Feet, FVec3(0.f, 50.f, 44.f), 1e-4);
+}
+
+PARKOUR_TEST(SlideEndsAtThreshold)
+{
+	FParkourConfig Config;
+	EXPECT_TRUE(ShouldEndSlide(Config, FVec3(350.f, 0.f, 0.f)));
+	EXPECT_TRUE(ShouldEndSlide(Config, FVec3(200.f, 200.f, 0.f)));
+	EXPECT_TRUE(!ShouldEndSlide(Config, FVec3(351.f, 0.f, 0.f)));
+}
+
+PARKOUR_TEST(WalkingStartIsBoosted)
+{
+	FParkourConfig Config;
+	const FVec3 Boosted = BoostWalkingAcceleration(Config, FVec3(10.f, 0.f, 0.f), FVec3(100.f, 0.f, 0.f));
+	const FVec3 Unchanged = BoostWalkingAcceleration(Config, FVec3(10.f, 0.f, 0.f), FVec3(800.f, 0.f, 0.f));
+
+	EXPECT_VEC_NEAR(Boosted, FVec3(2048.f, 0.f, 0.f), 1e-3);
+	EXPECT_VEC_NEAR(Unchanged, FVec3(10.f, 0.f, 0.f), 1e-6);
+}
+
+PARKOUR_TEST(InterpMatchesEngine)
+{
+	EXPECT_NEAR(FInterpTo(1.f, 0.1f, 1.f / 60.f, 30.f), 0.55f, 1e-6);
+	EXPECT_NEAR(FInterpTo(1.f, 0.1f, 1.f, 30.f), 0.1f, 1e-6);
+	EXPECT_NEAR(FInterpTo(1.f, 0.1f, 1.f, 0.f), 0.1f, 1e-6);
+	EXPECT_VEC_NEAR(VInterpTo(FVec3(), FVec3(100.f, 0.f, 0.f), 0.05f, 10.f), FVec3(50.f, 0.f, 0.f), 1e-4);
+	EXPECT_VEC_NEAR(VInterpTo(FVec3(), FVec3(0.001f, 0.f, 0.f), 0.05f, 10.f), FVec3(0.001f, 0.f, 0.f), 1e-9);
+}
+
+//Scenarios against the headless character
+
+PARKOUR_TEST(JumpingAlongAWallStartsAWallRun)
+{
+	FBoxScene Scene = MakeFloorScene();
+	Scene.AddBox(FBox(FVec3(200.f, 100.f, 0.f), FVec3(3000.f, 150.f, 600.f)));
+
+	FHeadlessCharacter Character(Scene);
+	Character.Location = FVec3(0.f, 30.f, 200.f);
+	Character.PlaceOnFloor();
+
+	RunForward(Character, 30);
+	Character.Step(Forward(EHeadlessButton::Jump));
+	EXPECT_TRUE(Character.EventCounts[(int)EParkourEvent::Jumped] == 1);
+
+	bool bWallRan = false;
+	for (int Index = 0; Index < 60 && !bWallRan; ++Index)
+	{
+		Character.Step(Forward());
+		bWallRan = Character.Mode == EParkourMode::RightWallRun;
+	}
+	EXPECT_TRUE(bWallRan);
+	EXPECT_VEC_NEAR(Character.Sim.State.WallRunHitNormal, FVec3(0.f, -1.f, 0.f), 1e-6);
+	//running along the wall keeps the character off the floor
+	EXPECT_TRUE(Character.Movement == EBaseMovement::Falling);
+
+	//the wall ends, so does the run, and it can't start again until the cooldown is over
+	for (int Index = 0; Index < 600 && Character.Location.X < 3100.f; ++Index)
+	{
+		Character.Step(Forward());
+	}
+	EXPECT_TRUE(Character.Mode != EParkourMode::RightWallRun);
+	EXPECT_TRUE(!Character.Sim.State.bWallRunEnabled);
+}
+
+PARKOUR_TEST(SprintThenCrouchSlides)
+{
+	FBoxScene Scene = MakeFloorScene();
+	FHeadlessCharacter Character(Scene);
+	Character.Location = FVec3(-4000.f, 0.f, 200.f);
+	Character.PlaceOnFloor();
+
+	Character.Step(Forward(EHeadlessButton::Sprint));
+	EXPECT_TRUE(Character.Mode == EParkourMode::Sprint);
+	EXPECT_NEAR(Character.Params.MaxWalkSpeed, Character.Sim.Config.SprintSpeed, 1e-6);
+
+	RunForward(Character, 90);
+	EXPECT_TRUE(Size2D(Character.Velocity) > 1000.f);
+
+	Character.Step(Forward(EHeadlessButton::Crouch));
+	EXPECT_TRUE(Character.Mode == EParkourMode::Slide);
+	EXPECT_TRUE(Character.bCrouched);
+	EXPECT_TRUE(Character.EventCounts[(int)EParkourEvent::SlideStarted] == 1);
+
+	//the slide bleeds speed until it drops under the threshold and hands back to a sprint
+	int Steps = 0;
+	while (Character.Mode == EParkourMode::Slide && Steps < 600)
+	{
+		Character.Step(Forward());
+		++Steps;
+	}
+	EXPECT_TRUE(Steps < 600);
+	EXPECT_TRUE(Character.Mode == EParkourMode::Sprint);
+	EXPECT_TRUE(!Character.bCrouched);
+}
+
+PARKOUR_TEST(CrouchTogglesWithoutSpeed)
+{
+	FBoxScene Scene = MakeFloorScene();
+	FHeadlessCharacter Character(Scene);
+	Character.Location = FVec3(0.f, 0.f, 200.f);
+	Character.PlaceOnFloor();
+
+	FHeadlessInput Crouch;
+	Crouch.Buttons = EHeadlessButton::Crouch;
+
+	Character.Step(Crouch);
+	EXPECT_TRUE(Character.Mode == EParkourMode::Crouch);
+	EXPECT_NEAR(Character.Params.MaxWalkSpeed, Character.Sim.Config.CrouchSpeed, 1e-6);
+
+	Character.Step(Crouch);
+	EXPECT_TRUE(Character.Mode == EParkourMode::None);
+	EXPECT_NEAR(Character.Params.MaxWalkSpeed, Character.Sim.Config.DefaultParams.MaxWalkSpeed, 1e-6);
+}
+
+//sprints up to speed, jumps and presses crouch on the way down once the floor is Height below
+static bool SprintJumpCrouchSlides(float Height)
+{
+	FBoxScene Scene = MakeFloorScene();
+	FHeadlessCharacter Character(Scene);
+	Character.Location = FVec3(-4000.f, 0.f, 200.f);
+	Character.PlaceOnFloor();
+	const float FloorZ = Character.Location.Z;
+
+	Character.Step(Forward(EHeadlessButton::Sprint));
+	RunForward(Character, 90);
+	Character.Step(Forward(EHeadlessButton::Jump));
+
+	bool bPressed = false;
+	for (int Index = 0; Index < 240 && (!bPressed || Character.Movement != EBaseMovement::Walking); ++Index)
+	{
+		const bool bPress = !bPressed && Character.Velocity.Z < 0.f && Character.Location.Z - FloorZ < Height;
+		Character.Step(Forward(bPress ? EHeadlessButton::Crouch : 0));
+		bPressed |= bPress;
+	}
+	Character.Step(Forward());
+	return Character.Mode == EParkourMode::Slide;
+}
+
+PARKOUR_TEST(CrouchBeforeLandingSlides)
+{
+	EXPECT_TRUE(SprintJumpCrouchSlides(20.f));
+	//pressed at the top of the jump it has run out by the landing
+	EXPECT_TRUE(!SprintJumpCrouchSlides(1000.f));
+}
+
+PARKOUR_TEST(JumpBeforeLandingJumpsAgain)
+{
+	FBoxScene Scene = MakeFloorScene();
+	FHeadlessCharacter Character(Scene);
+	Character.Location = FVec3(0.f, 0.f, 200.f);
+	Character.PlaceOnFloor();
+	const float FloorZ = Character.Location.Z;
+
+	Character.Step(Forward(EHeadlessButton::Jump));
+	EXPECT_TRUE(Character.Movement == EBaseMovement::Falling);
+	while (Character.Velocity.Z >= 0.f || Character.Location.Z - FloorZ > 15.f)
+	{
+		Character.Step(Forward());
+	}
+	//too early for a jump of its own, the press waits for the floor
+	Character.Step(Forward(EHeadlessButton::Jump));
+	EXPECT_TRUE(Character.EventCounts[(int)EParkourEvent::Jumped] == 1);
+
+	for (int Index = 0; Index < 10 && Character.EventCounts[(int)EParkourEvent::Jumped] == 1; ++Index)
+	{
+		Character.Step(Forward());
+	}
+	EXPECT_TRUE(Character.EventCounts[(int)EParkourEvent::Jumped] == 2);
+	EXPECT_TRUE(Character.Velocity.Z > 0.f);
+	EXPECT_TRUE(!Character.Sim.HasIntent(EIntent::Jump));
+}
+
+PARKOUR_TEST(JumpingAtALedgeGrabsAndMantles)
+{
+	FBoxScene Scene = MakeFloorScene();
+	Scene.AddBox(FBox(FVec3(200.f, -500.f, 0.f), FVec3(600.f, 500.f, 150.f)));
+
+	FHeadlessCharacter Character(Scene);
+	Character.Location = FVec3(0.f, 0.f, 200.f);
+	Character.PlaceOnFloor();
+
+	RunForward(Character, 20);
+	Character.Step(Forward(EHeadlessButton::Jump));
+
+	//hold forward until the mantle is over and the character is back on its feet
+	const int* Events = Character.EventCounts;
+	for (int Index = 0; Index < 240; ++Index)
+	{
+		Character.Step(Forward());
+		if (Events[(int)EParkourEvent::Mantled] + Events[(int)EParkourEvent::QuickMantled] > 0 && Character.Movement == EBaseMovement::Walking)
+		{
+			break;
+		}
+	}
+
+	EXPECT_TRUE(Character.EventCounts[(int)EParkourEvent::LedgeGrabbed] >= 1);
+	EXPECT_TRUE(Character.EventCounts[(int)EParkourEvent::Mantled] + Character.EventCounts[(int)EParkourEvent::QuickMantled] >= 1);
+	//stood up on top of the box
+	EXPECT_TRUE(Character.Movement == EBaseMovement::Walking);
+	EXPECT_NEAR(Character.Location.Z, 150.f + Character.StandingHalfHeight, 1.0);
+	EXPECT_TRUE(Character.Location.X > 200.f);
+}
+
+PARKOUR_TEST(SameInputsGiveTheSameResult)
+{
+	FBoxScene Scene = MakeFloorScene();
+	Scene.AddBox(FBox(FVec3(200.f, 100.f, 0.f), FVec3(3000.f, 150.f, 600.f)));
+	Scene.AddBox(FBox(FVec3(3400.f, -500.f, 0.f), FVec3(3800.f, 500.f, 150.f)));
+
+	FHeadlessCharacter First(Scene);
+	FHeadlessCharacter Second(Scene);
+	First.Location = Second.Location = FVec3(0.f, 30.f, 200.f);
+	First.PlaceOnFloor();
+	Second.PlaceOnFloor();
+
+	for (int Index = 0; Index < 900; ++Index)
+	{
+		FHeadlessInput Input = Forward();
+		Input.Buttons = (Index % 97 == 30) ? EHeadlessButton::Jump : ((Index % 131 == 5) ? EHeadlessButton::Sprint : 0);
+		Input.YawDelta = (Index % 200 < 100) ? 0.2f : -0.2f;
+		First.Step(Input);
+		Second.Step(Input);
+	}
+
+	EXPECT_TRUE(std::memcmp(&First.Location, &Second.Location, sizeof(FVec3)) == 0);
+	EXPECT_TRUE(std::memcmp(&First.Velocity, &Second.Velocity, sizeof(FVec3)) == 0);
+	EXPECT_TRUE(First.Mode == Second.Mode);
+	EXPECT_TRUE(std::memcmp(&First.Sim.State, &Second.Sim.State, sizeof(FParkourState)) == 0);
+}
+
+//Box scene
+
+PARKOUR_TEST(GridTracesMatchLinearTraces)
+{
+	//adding a box drops the grid the course was built with
+	FBoxScene Linear = MakeSweepCourse();
+	Linear.AddBox(FBox(FVec3(0.f, 0.f, -5000.f), FVec3(1.f, 1.f, -4999.f)));
+	FBoxScene Gridded = Linear;
+	Gridded.BuildGrid();
+
+	int Hits = 0;
+	for (int Index = 0; Index < 2000; ++Index)
+	{
+		const FVec3 Start(-9000.f + Index * 9.1f, -9000.f + Index * 8.7f, 20.f + (Index % 7) * 30.f);
+		const FVec3 End = Start + FVec3((Index % 5) * 60.f - 120.f, (Index % 3) * 80.f - 80.f, -40.f);
+
+		FTraceHit LinearHit;
+		FTraceHit GridHit;
+		const bool bLinear = Linear.CapsuleTrace(Start, End, 20.f, 10.f, LinearHit);
+		const bool bGrid = Gridded.CapsuleTrace(Start, End, 20.f, 10.f, GridHit);
+		EXPECT_TRUE(bLinear == bGrid);
+		EXPECT_NEAR(LinearHit.Distance, GridHit.Distance, 1e-4);
+		Hits += bLinear ? 1 : 0;
+	}
+	EXPECT_TRUE(Hits > 0);
+}
+
+//Sweep
+
+PARKOUR_TEST(SweepAxesParse)
+{
+	FSweepAxis Axis;
+	std::string Error;
+
+	EXPECT_TRUE(FSweepAxis::Parse("SprintSpeed=1200:1800:4", Axis, Error));
+	EXPECT_TRUE(Axis.Values.size() == 4);
+	EXPECT_NEAR(Axis.Values[1], 1400.f, 1e-3);
+	EXPECT_NEAR(Axis.Values[3], 1800.f, 1e-3);
+
+	EXPECT_TRUE(FSweepAxis::Parse("WallRunJumpForce=0.9,1.1", Axis, Error));
+	EXPECT_TRUE(Axis.Values.size() == 2);
+
+	EXPECT_TRUE(!FSweepAxis::Parse("NotATunable=1", Axis, Error));
+	EXPECT_TRUE(!FSweepAxis::Parse("SprintSpeed=1,,2", Axis, Error));
+	EXPECT_TRUE(!FSweepAxis::Parse("SprintSpeed=1:2", Axis, Error));
+}
+
+PARKOUR_TEST(SweepGridCoversEveryCombination)
+{
+	FSweepGrid Grid;
+	std::string Error;
+	Grid.Axes.resize(2);
+	EXPECT_TRUE(FSweepAxis::Parse("SprintSpeed=1000,2000,3000", Grid.Axes[0], Error));
+	EXPECT_TRUE(FSweepAxis::Parse("MaxWalkSpeed=500,700", Grid.Axes[1], Error));
+
+	EXPECT_TRUE(Grid.GetNumPoints() == 6);
+	//last axis changes fastest
+	const FParkourConfig Config = Grid.MakeConfig(FParkourConfig(), 3);
+	EXPECT_NEAR(Config.SprintSpeed, 2000.f, 1e-6);
+	EXPECT_NEAR(Config.DefaultParams.MaxWalkSpeed, 700.f, 1e-6);
+	EXPECT_NEAR(Config.WallRunGravity, FParkourConfig().WallRunGravity, 1e-6);
+}
+
+PARKOUR_TEST(SweepResultsDontDependOnThreads)
+{
+	const FBoxScene Scene = MakeSweepCourse();
+	FSweepGrid Grid;
+	std::string Error;
+	Grid.Axes.resize(1);
+	EXPECT_TRUE(FSweepAxis::Parse("SprintSpeed=1000:1800:5", Grid.Axes[0], Error));
+
+	FSweepSettings Settings;
+	Settings.MaxSeconds = 6.f;
+	std::vector<FInputTrace> Traces;
+	Traces.push_back(FInputTrace::MakeScripted(1, Settings.MaxSeconds, Settings.StepRate));
+	Traces.push_back(FInputTrace::MakeScripted(2, Settings.MaxSeconds, Settings.StepRate));
+
+	const std::vector<FSweepPointResult> Single = RunSweep(Scene, FParkourConfig(), Grid, Traces, Settings, 1);
+	const std::vector<FSweepPointResult> Multi = RunSweep(Scene, FParkourConfig(), Grid, Traces, Settings, 4);
+
+	EXPECT_TRUE(Single.size() == 5 && Multi.size() == 5);
+	float TotalDistance = 0.f;
+	for (size_t Index = 0; Index < Single.size() && Index < Multi.size(); ++Index)
+	{
+		EXPECT_TRUE(Single[Index].Runs == 2);
+		EXPECT_TRUE(std::memcmp(&Single[Index], &Multi[Index], sizeof(FSweepPointResult)) == 0);
+		TotalDistance += Single[Index].Distance;
+	}
+	EXPECT_TRUE(TotalDistance > 0.f);
+}
+
+PARKOUR_TEST(TraceButtonsActOnPress)
+{
+	FBoxScene Scene = MakeFloorScene();
+	FHeadlessCharacter Character(Scene);
+
+	FInputTrace Trace;
+	FInputFrame Frame;
+	Frame.Forward = 1.f;
+	Frame.Buttons = 1 << 1;
+	Trace.Frames.push_back(Frame);
+	Frame.Time = 0.05f;
+	Frame.Buttons = (1 << 1) | (1 << 0);
+	Trace.Frames.push_back(Frame);
+	Frame.Time = 0.1f;
+	Frame.Buttons = 0;
+	Trace.Frames.push_back(Frame);
+
+	FInputTracePlayer Player(Trace);
+	int CrouchChecks = 0;
+	int Jumps = 0;
+	while (!Player.IsFinished())
+	{
+		const FHeadlessInput Input = Player.Next(Character);
+		CrouchChecks += (Input.Buttons & EHeadlessButton::Crouch) ? 1 : 0;
+		Jumps += (Input.Buttons & EHeadlessButton::Jump) ? 1 : 0;
+		EXPECT_NEAR(Input.MoveInput.X, 1.f, 1e-6);
+	}
+	//crouch on press and release, jump once
+	EXPECT_TRUE(CrouchChecks == 2);
+	EXPECT_TRUE(Jumps == 1);
+}
+
+//Routes
+
+static FBoxScene MakeRouteScene()
+{
+	//same course as Route/ExampleCourse.boxes: a gap with a wall alongside, then a ledge
+	FBoxScene Scene;
+	Scene.AddBox(FBox(FVec3(-500.f, -1000.f, -100.f), FVec3(2600.f, 1000.f, 0.f)));
+	Scene.AddBox(FBox(FVec3(3000.f, -1000.f, -100.f), FVec3(6000.f, 1000.f, 0.f)));
+	Scene.AddBox(FBox(FVec3(2000.f, 150.f, 0.f), FVec3(3400.f, 200.f, 600.f)));
+	Scene.AddBox(FBox(FVec3(4000.f, -1000.f, 0.f), FVec3(5000.f, 1000.f, 150.f)));
+	return Scene;
+}
+
+PARKOUR_TEST(RouteCrossesTheGapAndReplays)
+{
+	const FBoxScene Scene = MakeRouteScene();
+	FRouteModel Model(Scene, FParkourConfig());
+
+	FRouteSettings Settings;
+	Settings.Goal = FVec3(4500.f, 0.f, 250.f);
+	Settings.Threads = 2;
+	const FRoute Route = Model.FindRoute(Model.MakeStart(FVec3(0.f, 0.f, 100.f), 0.f), Settings);
+
+	EXPECT_TRUE(Route.bFound);
+	EXPECT_TRUE(Route.Seconds > 2.f && Route.Seconds < 6.f);
+	EXPECT_TRUE(!Route.Steps.empty());
+	//the gap can't be walked, something parkour got it across
+	EXPECT_TRUE((Route.GetPrimitives() & ~(ERoutePrimitive::Run | ERoutePrimitive::Sprint)) != 0);
+	if (Route.Steps.empty())
+	{
+		return;
+	}
+
+	//the written input trace drives a fresh character along the same route
+	const std::string TraceFile = "ParkourRouteTestTrace.csv";
+	EXPECT_TRUE(Route.WriteInputTrace(TraceFile));
+	FInputTrace Trace;
+	EXPECT_TRUE(Trace.Load(TraceFile));
+	std::remove(TraceFile.c_str());
+
+	FHeadlessCharacter Character(Scene);
+	Character.Location = FVec3(0.f, 0.f, 100.f);
+	Character.PlaceOnFloor();
+	FInputTracePlayer Player(Trace);
+	for (size_t Index = 0; Index < Route.Steps.size(); ++Index)
+	{
+		Character.Step(Player.Next(Character));
+	}
+	EXPECT_NEAR(Distance(Character.Location, Route.Steps.back().Location), 0.0, 1.0);
+}
+
+PARKOUR_TEST(RouteDoesntDependOnThreads)
+{
+	const FBoxScene Scene = MakeRouteScene();
+	FRouteSettings Settings;
+	Settings.Goal = FVec3(4500.f, 0.f, 250.f);
+
+	FRouteModel SingleModel(Scene, FParkourConfig());
+	Settings.Threads = 1;
+	const FRoute Single = SingleModel.FindRoute(SingleModel.MakeStart(FVec3(0.f, 0.f, 100.f), 0.f), Settings);
+
+	FRouteModel MultiModel(Scene, FParkourConfig());
+	Settings.Threads = 4;
+	const FRoute Multi = MultiModel.FindRoute(MultiModel.MakeStart(FVec3(0.f, 0.f, 100.f), 0.f), Settings);
+
+	EXPECT_TRUE(Single.bFound && Multi.bFound);
+	EXPECT_TRUE(Single.Seconds == Multi.Seconds);
+	EXPECT_TRUE(Single.Expansions == Multi.Expansions);
+	EXPECT_TRUE(Single.Steps.size() == Multi.Steps.size());
+
+	//a second search on the same model reuses its moves
+	const uint64_t MissesBefore = MultiModel.GetTransitionMisses();
+	const FRoute Again = MultiModel.FindRoute(MultiModel.MakeStart(FVec3(0.f, 0.f, 100.f), 0.f), Settings);
+	EXPECT_TRUE(Again.Seconds == Multi.Seconds);
+	EXPECT_TRUE(MultiModel.GetTransitionMisses() == MissesBefore);
+}
+
+int main(int argc, char** argv)
+{
+	const char* Filter = argc > 1 ? argv[1] : nullptr;
+
+	int RunCount = 0;
+	int FailedTests = 0;
+	for (const FTestCase& Test : GetTests())
+	{
+		if (Filter && !std::strstr(Test.Name, Filter))
+		{
+			continue;
+		}
+
+		const int FailuresBefore = FailureCount;
+		Test.Function();
+		++RunCount;
+
+		const bool bPassed = FailureCount == FailuresBefore;
+		FailedTests += bPassed ? 0 : 1;
+		std::printf("%s %s\n", bPassed ? "[ OK ]" : "[FAIL]", Test.Name);
+	}
+
+	std::printf("%d of %d tests passed\n", RunCount - FailedTests, RunCount);
+	return FailedTests == 0 ? 0 : 1;
+}